@@ -78,7 +78,7 @@ int main(int argc, char* argv[]) {
         // ʹɫ
         shader.begin();
         glm::mat4 model = glm::mat4(1.0f);
-        model = glm::rotate(model, (float)(SDL_GetTicks() * 0.0001f), glm::vec3(0.5f, 1.0f, 0.0f));  // ת
+        model = glm::rotate(model, (float)(App->getTicks() * 0.0001f), glm::vec3(0.5f, 1.0f, 0.0f));  // ת
         shader.setMatrix4x4("model", model);
         shader.setMatrix4x4("view", activeCamera->getViewMatrix());
         shader.setMatrix4x4("projection", activeCamera->getProjectionMatrix());
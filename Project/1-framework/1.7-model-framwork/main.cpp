@@ -154,7 +154,7 @@ void render() {
     // 1 󶨵ǰprogram
     shader->begin();
     shader->setInt("sampler", 0);	// 󶨲Ԫ0Ϊǰ漤0
-    shader->setFloat("time", (float)(SDL_GetTicks()));	// ʱ
+    shader->setFloat("time", (float)(App->getTicks()));	// ʱ
     
     shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
     shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
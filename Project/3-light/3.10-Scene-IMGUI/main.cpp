@@ -20,6 +20,7 @@
 #include "../../../include/glframework/mesh.h"
 #include "../../../include/glframework/renderer/renderer.h"
 #include "../../../include/glframework/scene.h"
+#include "../../../include/glframework/sceneAllocator.h"
 #include "../../../include/Application/assimpLoader.h"
 
 
@@ -130,7 +131,7 @@ void prepare() {
     std::string fragmentshaderPath = "E:/IT-Furnace/OpenGl/mindray/Framework/resource/shaders/Blinn-Phong/Blinn-phong.frag";
 
     renderer = new Renderer(vertexshaderPath, fragmentshaderPath);
-    scene = new Scene();
+    scene = SceneAllocator::create<Scene>();
 
     auto testModel = AssimpLoader::load(std::string(FBX_DIR) + "/C919/C919.fbx");
 	testModel->setScale(glm::vec3{ 0.0001f });
@@ -169,6 +170,8 @@ int main(int argc, char* argv[]) {
         renderIMGUI();      // ImGui UI Ӧ3D ֮Ⱦȷ UI ʾϲ㣺
     }
 
+    // ڵ㡢塢һԹ黹أOpenGL֮ǰ
+    SceneAllocator::releaseAll();
     App->destroy();
     return 0;
 }
@@ -161,7 +161,7 @@ void initIMGUI() {
 
 void renderIMGUI() {
     // ֡
-    float currentTime = (float)SDL_GetTicks() / 1000.0f;
+    float currentTime = (float)App->getTicks() / 1000.0f;
     frameCount++;
     if (currentTime - lastFrameTime >= 1.0f) {
         fps = frameCount / (currentTime - lastFrameTime);
@@ -315,6 +315,8 @@ void prepare() {
     // 1 geometry  
     //auto PBRgeometry = Geometry::createFromSTL("E:/IT-Furnace/OpenGl/mindray/Framework/resource/objs/humanHeart/anatomical-heart.stl", true);
     auto PBRgeometry = Geometry::createFromOBJwithTangent("E:/IT-Furnace/OpenGl/mindray/Framework/resource/objs/pbrheart/pbrheart.obj");
+    // Ԥ࿪ϺӽѡԶ˳򣬸ڵĻϽ
+    PBRgeometry->buildSortedIndexOrders();
     //auto PBRgeometry = Geometry::createSphere(5.0f);
     //auto PBRgeometry = Geometry::createPlane(50.0f, 50.0f);
 
@@ -552,7 +554,7 @@ void UpdateLightAndWhite() {
 
 
 void lightTransform() {
-    float zPos = glm::sin(SDL_GetTicks() * 0.001f) + 3.0f;
+    float zPos = glm::sin(App->getTicks() * 0.001f) + 3.0f;
     meshWhite->setPosition(glm::vec3(0.0f, 0.0f, zPos));
     spotLight->setPosition(meshWhite->getPosition());
 }
@@ -166,7 +166,7 @@ void initIMGUI() {
 
 void renderIMGUI_config() {
     // 1. ֡ʼ㣨߼䣩
-    float currentTime = (float)SDL_GetTicks() / 1000.0f;
+    float currentTime = (float)App->getTicks() / 1000.0f;
     static int frameCount = 0;
     static float lastFrameTime = 0.0f;
     static float fps = 0.0f;
@@ -546,7 +546,7 @@ void UpdateCameraViewParams() {
 }
 
 void lightTransform() {
-    float zPos = glm::sin(SDL_GetTicks() * 0.001f) + 3.0f;
+    float zPos = glm::sin(App->getTicks() * 0.001f) + 3.0f;
     meshWhite->setPosition(glm::vec3(0.0f, 0.0f, zPos));
     spotLight->setPosition(meshWhite->getPosition());
 }
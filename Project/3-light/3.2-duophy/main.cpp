@@ -33,7 +33,7 @@ float specularIntensity = 0.5f;
 glm::vec3 ambientColor = glm::vec3(0.2f);
 
 // лȫַΧڼ¼һ֡ʱ䣩
-Uint32 lastTime = SDL_GetTicks();
+Uint32 lastTime = 0;
 const float rotationSpeed = glm::radians(45.0f); // תٶȣÿת45ȣתΪȣ
 
 Geometry* geometry = nullptr;
@@ -178,7 +178,7 @@ void prepareState() {
 
 void render() {
     // 1. 㵱ǰ֡һ֡ʱdeltaTimeλ룩
-    Uint32 currentTime = SDL_GetTicks();
+    Uint32 currentTime = App->getTicks();
     float deltaTime = (currentTime - lastTime) / 1000.0f; // תΪ
     lastTime = currentTime;
 
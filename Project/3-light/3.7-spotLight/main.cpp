@@ -197,7 +197,7 @@ int main(int argc, char* argv[]) {
 }
 
 void lightTransform() {
-    float zPos = glm::sin(SDL_GetTicks() * 0.001f) + 3.0f;
+    float zPos = glm::sin(App->getTicks() * 0.001f) + 3.0f;
     meshWhite->setPosition(glm::vec3(0.0f, 0.0f, zPos));
     spotLight->setPosition(meshWhite->getPosition());
 }
@@ -164,7 +164,7 @@ void initIMGUI() {
 
 void renderIMGUI() {
     // ֡
-    float currentTime = (float)SDL_GetTicks() / 1000.0f;
+    float currentTime = (float)App->getTicks() / 1000.0f;
     frameCount++;
     if (currentTime - lastFrameTime >= 1.0f) {
         fps = frameCount / (currentTime - lastFrameTime);
@@ -534,7 +534,7 @@ void UpdateLightAndWhite() {
 
 
 void lightTransform() {
-    float zPos = glm::sin(SDL_GetTicks() * 0.001f) + 3.0f;
+    float zPos = glm::sin(App->getTicks() * 0.001f) + 3.0f;
     meshWhite->setPosition(glm::vec3(0.0f, 0.0f, zPos));
     spotLight->setPosition(meshWhite->getPosition());
 }
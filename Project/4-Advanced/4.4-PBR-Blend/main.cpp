@@ -23,6 +23,7 @@
 
 #include "../../../include/glframework/mesh.h"
 #include "../../../include/glframework/renderer/renderer.h"
+#include "../../../include/glframework/renderStats.h"
 #include "../../../include/glframework/light/spotLight.h"
 
 #include "../../../include/imgui/imgui.h"
@@ -167,7 +168,7 @@ void initIMGUI() {
 
 void renderIMGUI() {
     // ֡
-    float currentTime = (float)SDL_GetTicks() / 1000.0f;
+    float currentTime = (float)App->getTicks() / 1000.0f;
     frameCount++;
     if (currentTime - lastFrameTime >= 1.0f) {
         fps = frameCount / (currentTime - lastFrameTime);
@@ -287,6 +288,72 @@ void renderIMGUI() {
     ImGui::Text("FPS: %.1f", fps);
     ImGui::End();
 
+    // ͸ģʽлȽϡȨ OIT ȰЧͺʱ
+    ImGui::Begin("Transparency");
+    const char* modeNames[] = { "Sorted", "Weighted Blended OIT", "Dual Depth Peeling" };
+    int modeIndex = static_cast<int>(renderer->getTransparencyMode());
+    if (ImGui::Combo("Mode", &modeIndex, modeNames, IM_ARRAYSIZE(modeNames))) {
+        renderer->setTransparencyMode(static_cast<TransparencyMode>(modeIndex));
+    }
+    int maxPeelLayers = renderer->getMaxPeelLayers();
+    if (ImGui::SliderInt("Max Peel Layers", &maxPeelLayers, 1, 16)) {
+        renderer->setMaxPeelLayers(maxPeelLayers);
+    }
+    bool useSortedIndices = renderer->getUseSortedIndices();
+    if (ImGui::Checkbox("Pre-sorted Triangles", &useSortedIndices)) {
+        renderer->setUseSortedIndices(useSortedIndices);
+    }
+    const TransparencyTiming& timing = renderer->getTransparencyTiming(renderer->getTransparencyMode());
+    ImGui::Text("CPU: %.3f ms  GPU: %.3f ms  Draws: %d", timing.cpuMs, timing.gpuMs, (int)timing.drawCount);
+    if (renderer->getTransparencyMode() == TransparencyMode::DualDepthPeeling) {
+        ImGui::Text("Peel Passes: %d  Layers: %d", timing.peelPassCount, timing.peelLayerCount);
+    }
+    ImGui::End();
+
+    // ԤȣAuto ģʽõĹȻԶ
+    ImGui::Begin("Depth Pre-pass");
+    const char* prepassNames[] = { "Off", "On", "Auto" };
+    int prepassIndex = static_cast<int>(renderer->getDepthPrepassMode());
+    if (ImGui::Combo("Mode", &prepassIndex, prepassNames, IM_ARRAYSIZE(prepassNames))) {
+        renderer->setDepthPrepassMode(static_cast<DepthPrepassMode>(prepassIndex));
+    }
+    if (const DepthPrepass* prepass = renderer->getDepthPrepass()) {
+        ImGui::Text("Active: %s", prepass->isActive() ? "Yes" : "No");
+        ImGui::Text("Overdraw: %.2fx", prepass->getOverdraw());
+        ImGui::Text("Shaded: %llu  Covered: %llu", (unsigned long long)prepass->getShadedSamples(), (unsigned long long)prepass->getCoveredSamples());
+    }
+    ImGui::End();
+
+    // Ȼƣͼ Mesh ƬԪ CSV ƶԤ
+    ImGui::Begin("Overdraw");
+    bool overdrawDebug = renderer->getOverdrawDebug();
+    if (ImGui::Checkbox("Overdraw Debug", &overdrawDebug)) {
+        renderer->setOverdrawDebug(overdrawDebug);
+    }
+    if (OverdrawVisualizer* overdraw = renderer->getOverdrawVisualizer()) {
+        bool showHeatmap = overdraw->getShowHeatmap();
+        if (ImGui::Checkbox("Show Heatmap", &showHeatmap)) {
+            overdraw->setShowHeatmap(showHeatmap);
+        }
+        int heatmapMax = overdraw->getHeatmapMax();
+        if (ImGui::SliderInt("Heatmap Max Layers", &heatmapMax, 2, 32)) {
+            overdraw->setHeatmapMax(heatmapMax);
+        }
+        const OverdrawFrameStat& frameStat = overdraw->getFrameStat();
+        ImGui::Text("Overdraw: %.2fx  Max Layers: %u", frameStat.ratio, frameStat.maxCount);
+        ImGui::Text("Fragments: %llu  Covered Pixels: %llu", (unsigned long long)frameStat.fragments, (unsigned long long)frameStat.coveredPixels);
+        for (const auto& meshStat : overdraw->getMeshStats()) {
+            ImGui::Text("%s: %llu fragments, %u tris", meshStat.name.c_str(), (unsigned long long)meshStat.fragments, meshStat.triangles);
+        }
+        if (ImGui::Button("Export CSV")) {
+            overdraw->exportCSV("overdraw.csv");
+        }
+    }
+    ImGui::End();
+
+    // ȾͳƣƵá״̬лԴ
+    RenderStats::drawImGui();
+
     // Ⱦ߼ֲ䣩
     ImGui::Render();
     int display_w, display_h;
@@ -348,6 +415,8 @@ void prepare() {
 	auto geometryBox = Geometry::createBox(5.0f);
 	auto geometryPlane = Geometry::createPlane(8.0f, 8.0f);
     auto geometryHeart = Geometry::createFromOBJwithTangent("E:/IT-Furnace/OpenGl/mindray/Framework/resource/objs/pbrheart/pbrheart.obj");
+    // Ԥ࿪ϺӽѡԶ˳򣬸ڵĻϽ
+    geometryHeart->buildSortedIndexOrders();
 
     std::string TalbedoPath = std::string(TEXTURE_DIR) + "/pbrheart/Albedo.png";
     std::string TaoPath = std::string(TEXTURE_DIR) + "/pbrheart/AO.png";
@@ -368,6 +437,7 @@ void prepare() {
     pbrmaterial->setShader(PBRShader);
 
 	auto meshHeart = new Mesh(geometryHeart, pbrmaterial);
+	meshHeart->setName("Heart");
 	//setModelBlend(meshHeart, true, 0.5f);       // ģͼӽڵ͸
 	meshes.push_back(meshHeart);
 
@@ -533,7 +603,7 @@ void UpdateLightAndWhite() {
 
 
 void lightTransform() {
-    float zPos = glm::sin(SDL_GetTicks() * 0.001f) + 3.0f;
+    float zPos = glm::sin(App->getTicks() * 0.001f) + 3.0f;
     meshWhite->setPosition(glm::vec3(0.0f, 0.0f, zPos));
     spotLight->setPosition(meshWhite->getPosition());
 }
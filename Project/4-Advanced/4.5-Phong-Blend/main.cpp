@@ -22,6 +22,7 @@
 
 #include "../../../include/glframework/mesh.h"
 #include "../../../include/glframework/renderer/renderer.h"
+#include "../../../include/glframework/renderStats.h"
 #include "../../../include/glframework/light/spotLight.h"
 
 #include "../../../include/imgui/imgui.h"
@@ -168,7 +169,7 @@ void initIMGUI() {
 
 void renderIMGUI_config() {
     // 1. ֡ʼ㣨߼䣩
-    float currentTime = (float)SDL_GetTicks() / 1000.0f;
+    float currentTime = (float)App->getTicks() / 1000.0f;
     static int frameCount = 0;
     static float lastFrameTime = 0.0f;
     static float fps = 0.0f;
@@ -293,6 +294,72 @@ void renderIMGUI_config() {
     ImGui::Text("FPS: %.1f", fps);
     ImGui::End();
 
+    // ͸ģʽлȽϡȨ OIT ȰЧͺʱ
+    ImGui::Begin("Transparency");
+    const char* modeNames[] = { "Sorted", "Weighted Blended OIT", "Dual Depth Peeling" };
+    int modeIndex = static_cast<int>(renderer->getTransparencyMode());
+    if (ImGui::Combo("Mode", &modeIndex, modeNames, IM_ARRAYSIZE(modeNames))) {
+        renderer->setTransparencyMode(static_cast<TransparencyMode>(modeIndex));
+    }
+    int maxPeelLayers = renderer->getMaxPeelLayers();
+    if (ImGui::SliderInt("Max Peel Layers", &maxPeelLayers, 1, 16)) {
+        renderer->setMaxPeelLayers(maxPeelLayers);
+    }
+    bool useSortedIndices = renderer->getUseSortedIndices();
+    if (ImGui::Checkbox("Pre-sorted Triangles", &useSortedIndices)) {
+        renderer->setUseSortedIndices(useSortedIndices);
+    }
+    const TransparencyTiming& timing = renderer->getTransparencyTiming(renderer->getTransparencyMode());
+    ImGui::Text("CPU: %.3f ms  GPU: %.3f ms  Draws: %d", timing.cpuMs, timing.gpuMs, (int)timing.drawCount);
+    if (renderer->getTransparencyMode() == TransparencyMode::DualDepthPeeling) {
+        ImGui::Text("Peel Passes: %d  Layers: %d", timing.peelPassCount, timing.peelLayerCount);
+    }
+    ImGui::End();
+
+    // ԤȣAuto ģʽõĹȻԶ
+    ImGui::Begin("Depth Pre-pass");
+    const char* prepassNames[] = { "Off", "On", "Auto" };
+    int prepassIndex = static_cast<int>(renderer->getDepthPrepassMode());
+    if (ImGui::Combo("Mode", &prepassIndex, prepassNames, IM_ARRAYSIZE(prepassNames))) {
+        renderer->setDepthPrepassMode(static_cast<DepthPrepassMode>(prepassIndex));
+    }
+    if (const DepthPrepass* prepass = renderer->getDepthPrepass()) {
+        ImGui::Text("Active: %s", prepass->isActive() ? "Yes" : "No");
+        ImGui::Text("Overdraw: %.2fx", prepass->getOverdraw());
+        ImGui::Text("Shaded: %llu  Covered: %llu", (unsigned long long)prepass->getShadedSamples(), (unsigned long long)prepass->getCoveredSamples());
+    }
+    ImGui::End();
+
+    // Ȼƣͼ Mesh ƬԪ CSV ƶԤ
+    ImGui::Begin("Overdraw");
+    bool overdrawDebug = renderer->getOverdrawDebug();
+    if (ImGui::Checkbox("Overdraw Debug", &overdrawDebug)) {
+        renderer->setOverdrawDebug(overdrawDebug);
+    }
+    if (OverdrawVisualizer* overdraw = renderer->getOverdrawVisualizer()) {
+        bool showHeatmap = overdraw->getShowHeatmap();
+        if (ImGui::Checkbox("Show Heatmap", &showHeatmap)) {
+            overdraw->setShowHeatmap(showHeatmap);
+        }
+        int heatmapMax = overdraw->getHeatmapMax();
+        if (ImGui::SliderInt("Heatmap Max Layers", &heatmapMax, 2, 32)) {
+            overdraw->setHeatmapMax(heatmapMax);
+        }
+        const OverdrawFrameStat& frameStat = overdraw->getFrameStat();
+        ImGui::Text("Overdraw: %.2fx  Max Layers: %u", frameStat.ratio, frameStat.maxCount);
+        ImGui::Text("Fragments: %llu  Covered Pixels: %llu", (unsigned long long)frameStat.fragments, (unsigned long long)frameStat.coveredPixels);
+        for (const auto& meshStat : overdraw->getMeshStats()) {
+            ImGui::Text("%s: %llu fragments, %u tris", meshStat.name.c_str(), (unsigned long long)meshStat.fragments, meshStat.triangles);
+        }
+        if (ImGui::Button("Export CSV")) {
+            overdraw->exportCSV("overdraw.csv");
+        }
+    }
+    ImGui::End();
+
+    // ȾͳƣƵá״̬лԴ
+    RenderStats::drawImGui();
+
     // 5. ImGui Ⱦֽӿڲ䣩
     ImGui::Render();
     int display_w, display_h;
@@ -322,6 +389,8 @@ void prepare() {
 
     // geometry  
    auto PBRgeometry = Geometry::createFromOBJ("E:/IT-Furnace/OpenGl/mindray/Framework/resource/objs/pbrheart/pbrheart.obj");
+   // Ԥ࿪ϺӽѡԶ˳򣬸ڵĻϽ
+   PBRgeometry->buildSortedIndexOrders();
 
     // Phongmaterialò
     std::string texturePath = std::string(TEXTURE_DIR) + "/pbrheart/Albedo.png";
@@ -340,6 +409,7 @@ void prepare() {
     phongmaterial->setShader(PhongShader);
 
     auto PhongMesh = new Mesh(PBRgeometry, phongmaterial);
+    PhongMesh->setName("Heart");
 
     PhongMesh->setPosition(glm::vec3(0.0f, 0.0f, 0.0f));
     PhongMesh->setAngleY(180.0f);
@@ -507,7 +577,7 @@ void UpdateCameraViewParams() {
 }
 
 void lightTransform() {
-    float zPos = glm::sin(SDL_GetTicks() * 0.001f) + 3.0f;
+    float zPos = glm::sin(App->getTicks() * 0.001f) + 3.0f;
     meshWhite->setPosition(glm::vec3(0.0f, 0.0f, zPos));
     spotLight->setPosition(meshWhite->getPosition());
 }
@@ -23,6 +23,11 @@
 
 #include "../../../include/glframework/mesh.h"
 #include "../../../include/glframework/renderer/renderer.h"
+#include "../../../include/glframework/renderStats.h"
+#include "../../../include/glframework/renderer/frameGraph.h"
+#include "../../../include/glframework/renderer/dynamicResolution.h"
+#include "../../../include/glframework/renderer/postProcessStack.h"
+#include "../../../include/glframework/renderer/progressiveAccumulator.h"
 #include "../../../include/glframework/light/spotLight.h"
 
 #include "../../../include/imgui/imgui.h"
@@ -127,8 +132,11 @@ PBRMaterialStruct PBRMaterialConfigs;
 
 // ɫ
 glm::vec3 clearColor{};
-unsigned int fbo = 0;   // ֡ID
-Texture* colorAttachment = nullptr; // FBOɫ
+FrameGraph* frameGraph = nullptr;   // ֡ͼĿ꣨ɫģ帽֡븴
+DynamicResolution* dynamicResolution = nullptr;     //  GPU ʱȾ
+PostProcessStack* postProcess = nullptr;            // Ŵ֮ImGui ֮ǰĺ
+ProgressiveAccumulator* accumulator = nullptr;      // 澲ֹʱۻ֡
+ScreenMaterial* materialScreen = nullptr;
 
 int WIDTH = 800;
 int HEIGHT = 600;
@@ -159,50 +167,100 @@ void prepareCamera() {
     //cameraControl->setMoveSpeed(0.05f);
 }
 
-void prepareFBO() {
-	// 1FBOҰ
-    glGenFramebuffers(1, &fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-
-	// 2һΪFBOɫ
-	colorAttachment = new Texture(WIDTH, HEIGHT, 0);    // һհ󶨵0ԪΪɫ
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorAttachment->getID(), 0);   // Ϊɫ, һmipmap㼶0ʾ㼶
-
-	// 3һȾΪFBOȺģ帽
-	unsigned int depthStencil;      // ģȾID
-	glGenTextures(1, &depthStencil);
-	glBindTexture(GL_TEXTURE_2D, depthStencil);     // ҪֱӰΪΪʲôҪΪǲҪֻΪʹ
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, WIDTH, HEIGHT, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthStencil, 0);// Ϊģ帽
-
-	// 4FBOǷ
-    GLenum fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    if (fboStatus != GL_FRAMEBUFFER_COMPLETE) {
-        std::cout << "FBO 룺" << fboStatus << std::endl;
-        // Ӧ뺬壨ο OpenGL ĵ
-        switch (fboStatus) {
-        case GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT:
-            std::cout << "ԭĳĸʽ֧֣򸽼δȷ" << std::endl;
-            break;
-        case GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT:
-            std::cout << "ԭFBO ûκЧ" << std::endl;
-            break;
-        case GL_FRAMEBUFFER_UNSUPPORTED:
-            std::cout << "ԭ򣺸ϵĸʽԿ֧" << std::endl;
-            break;
-        default:
-            std::cout << "ԭδȷ" << std::endl;
-        }
+void prepareFrameGraph() {
+    // Ŀ겻ֶPass Ҫĸ֡ͼȾĿȡźԶ³ߴ
+    frameGraph = new FrameGraph();
+    frameGraph->setBackbufferSize(App->getWidth(), App->getHeight());
+
+    // Ԥ 8ms 50% ~ 100% ֮
+    dynamicResolution = new DynamicResolution();
+    dynamicResolution->setTargetMs(8.0f);
+    dynamicResolution->setScaleRange(0.5f, 1.0f);
+
+    postProcess = new PostProcessStack();
+
+    // ֹʱۻ 16 ֮֡ѭ˯ߣػ棩
+    accumulator = new ProgressiveAccumulator();
+    accumulator->setMaxSamples(16);
+}
+
+// ÿ֡ĸ PassScene ȾʱɫAccumulate ϽۻĽ
+// Screen ۻŴ󵽴ڳߴ磬PostProcess 󻭵Ļϣۻ֮ Scene  Accumulate 
+void renderFrameGraph() {
+    FrameGraphResource backbuffer = frameGraph->importFramebuffer("Backbuffer", 0, App->getWidth(), App->getHeight());
+    FrameGraphResource sceneColor = -1;
+    FrameGraphResource upscaledColor = -1;
+
+    // ֱ̬ʣִڳߴ磬ֻȾ½ǵ
+    int renderWidth = App->getWidth();
+    int renderHeight = App->getHeight();
+    dynamicResolution->getRenderSize(App->getWidth(), App->getHeight(), renderWidth, renderHeight);
+
+    // ۻ仯ʱͷʼñ֡ض
+    bool renderScene = accumulator->beginFrame(camera, renderWidth, renderHeight);
+
+    // pass01 BoxȾɫ
+    if (renderScene) {
+        frameGraph->addPass("Scene",
+            [&](FrameGraph::Builder& builder) {
+                FrameGraphTextureDesc colorDesc;
+                colorDesc.format = GL_RGBA16F;
+                sceneColor = builder.write(builder.create("SceneColor", colorDesc));
+
+                // ģֻΪҪȾ弴
+                FrameGraphTextureDesc depthDesc;
+                depthDesc.format = GL_DEPTH24_STENCIL8;
+                depthDesc.renderbuffer = true;
+                builder.writeDepth(builder.create("SceneDepth", depthDesc));
+            },
+            [&](const FrameGraphContext& context) {
+                glViewport(0, 0, renderWidth, renderHeight);
+                dynamicResolution->beginScene();
+                renderer->render(meshesOffScreen, camera, dirLight, pointLights, spotLight, ambLight, context.getFramebuffer());
+                dynamicResolution->endScene();
+            });
+
+        // Ͻۻ accumulator У֡ͼ֮ɼΪã
+        frameGraph->addPass("Accumulate",
+            [&](FrameGraph::Builder& builder) {
+                builder.read(sceneColor);
+                builder.sideEffect();
+            },
+            [&](const FrameGraphContext& context) {
+                accumulator->accumulate(context.getTexture(sceneColor), glm::vec2(
+                    (float)renderWidth / (float)context.getWidth(),
+                    (float)renderHeight / (float)context.getHeight()));
+            });
     }
 
-    //  FBO
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // pass02 ۻŴ󵽴ڳߴ
+    frameGraph->addPass("Screen",
+        [&](FrameGraph::Builder& builder) {
+            FrameGraphTextureDesc colorDesc;
+            colorDesc.format = GL_RGBA16F;
+            upscaledColor = builder.write(builder.create("UpscaledColor", colorDesc));
+        },
+        [&](const FrameGraphContext& context) {
+            // ScreenMaterial û mScreenTexturescreenTexture Ĭʹ 0 Ԫ
+            // ۻȾߴ磬ŷŴ
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, accumulator->getTexture());
+            materialScreen->mUvScale = glm::vec2(1.0f);
+            renderer->render(meshesInScreen, camera, dirLight, pointLights, spotLight, ambLight, context.getFramebuffer());
+        });
+
+    // pass03 Ļ
+    frameGraph->addPass("PostProcess",
+        [&](FrameGraph::Builder& builder) {
+            builder.read(upscaledColor);
+            builder.write(backbuffer);
+        },
+        [&](const FrameGraphContext& context) {
+            postProcess->apply(context.getTexture(upscaledColor), context.getWidth(), context.getHeight(), context.getFramebuffer());
+        });
+
+    frameGraph->compile();
+    frameGraph->execute();
 }
 
 void initIMGUI() {
@@ -217,7 +275,7 @@ void initIMGUI() {
 
 void renderIMGUI() {
     // ֡
-    float currentTime = (float)SDL_GetTicks() / 1000.0f;
+    float currentTime = (float)App->getTicks() / 1000.0f;
     frameCount++;
     if (currentTime - lastFrameTime >= 1.0f) {
         fps = frameCount / (currentTime - lastFrameTime);
@@ -335,8 +393,115 @@ void renderIMGUI() {
     // ImGuiʾ֡
     ImGui::Begin("FPS Monitor");
     ImGui::Text("FPS: %.1f", fps);
+    const FrameGraph::Stats& graphStats = frameGraph->getStats();
+    ImGui::Text("Passes: %d (culled %d)", graphStats.passCount, graphStats.culledPassCount);
+    ImGui::Text("Targets: %.2f MB (virtual %.2f MB)",
+        graphStats.physicalBytes / (1024.0 * 1024.0), graphStats.virtualBytes / (1024.0 * 1024.0));
+    ImGui::End();
+
+    // ֱ̬ʣImGui ڳŴֱ֮ӻĬ֡ϣʼԭֱ
+    ImGui::Begin("Dynamic Resolution");
+    bool dynamicEnabled = dynamicResolution->isEnabled();
+    if (ImGui::Checkbox("Enabled", &dynamicEnabled)) {
+        dynamicResolution->setEnabled(dynamicEnabled);
+    }
+    float targetMs = dynamicResolution->getTargetMs();
+    if (ImGui::SliderFloat("GPU Budget (ms)", &targetMs, 1.0f, 33.0f)) {
+        dynamicResolution->setTargetMs(targetMs);
+    }
+    float minScale = dynamicResolution->getMinScale();
+    if (ImGui::SliderFloat("Min Scale", &minScale, 0.25f, 1.0f)) {
+        dynamicResolution->setScaleRange(minScale, dynamicResolution->getMaxScale());
+    }
+    ImGui::SliderFloat("Sharpness", &materialScreen->mSharpness, 0.0f, 1.0f);
+    int renderWidth = 0;
+    int renderHeight = 0;
+    dynamicResolution->getRenderSize(App->getWidth(), App->getHeight(), renderWidth, renderHeight);
+    ImGui::Text("Scale: %.0f%% (%d x %d)", dynamicResolution->getScale() * 100.0f, renderWidth, renderHeight);
+    ImGui::Text("Scene GPU: %.2f ms", dynamicResolution->getGpuMs());
+    ImGui::End();
+
+    // ػ뽥ۻֹʱۻ N ֡Ⱦѭ˯
+    ImGui::Begin("Progressive Refinement");
+    bool onDemand = App->getRedrawMode() == Application::RedrawMode::OnDemand;
+    if (ImGui::Checkbox("Render On Demand", &onDemand)) {
+        App->setRedrawMode(onDemand ? Application::RedrawMode::OnDemand : Application::RedrawMode::Continuous);
+    }
+    bool accumulate = accumulator->isEnabled();
+    if (ImGui::Checkbox("Accumulate", &accumulate)) {
+        accumulator->setEnabled(accumulate);
+    }
+    int maxSamples = accumulator->getMaxSamples();
+    if (ImGui::SliderInt("Max Samples", &maxSamples, 1, 64)) {
+        accumulator->setMaxSamples(maxSamples);
+    }
+    ImGui::Text("Samples: %d / %d%s", accumulator->getSampleCount(), accumulator->getMaxSamples(),
+        accumulator->isConverged() ? " (idle)" : "");
+    ImGui::End();
+
+    // ࣺ֡ʽ֡ơŶ֡ޣԼ뵽ӳ
+    ImGui::Begin("Frame Pacing");
+    const FramePacer& pacer = App->getFramePacer();
+    int swapMode = static_cast<int>(pacer.getSwapMode());
+    ImGui::Text("Swap");
+    ImGui::SameLine();
+    bool swapChanged = ImGui::RadioButton("Off", &swapMode, 0);
+    ImGui::SameLine();
+    swapChanged |= ImGui::RadioButton("VSync", &swapMode, 1);
+    ImGui::SameLine();
+    swapChanged |= ImGui::RadioButton("Adaptive", &swapMode, -1);
+    if (swapChanged) {
+        App->setSwapMode(static_cast<Application::SwapMode>(swapMode));
+    }
+    float frameLimit = static_cast<float>(pacer.getFrameLimit());
+    if (ImGui::SliderFloat("FPS Limit (0 = off)", &frameLimit, 0.0f, 240.0f, "%.0f")) {
+        App->setFrameLimit(frameLimit);
+    }
+    int maxQueued = pacer.getMaxQueuedFrames();
+    if (ImGui::SliderInt("Max Queued Frames (-1 = driver)", &maxQueued, -1, 3)) {
+        App->setMaxQueuedFrames(maxQueued);
+    }
+    const FramePacer::Stats& pacerStats = pacer.getStats();
+    ImGui::Text("Frame: %.2f ms (fence wait %.2f ms, limiter %.2f ms)",
+        pacerStats.frameMs, pacerStats.fenceWaitMs, pacerStats.limiterWaitMs);
+    ImGui::Text("Input -> swap: %.1f ms (avg %.1f, max %.1f)",
+        pacerStats.latencyMs, pacerStats.averageLatencyMs, pacerStats.maxLatencyMs);
     ImGui::End();
 
+    // ںЧַʽĺʱ / Ա
+    ImGui::Begin("Post Processing");
+    PostProcessSettings& postSettings = postProcess->getSettings();
+    bool fused = postProcess->getFused();
+    if (ImGui::Checkbox("Fused", &fused)) {
+        postProcess->setFused(fused);
+    }
+    ImGui::CheckboxFlags("Bloom", &postSettings.effects, POST_BLOOM);
+    ImGui::CheckboxFlags("Exposure", &postSettings.effects, POST_EXPOSURE);
+    ImGui::CheckboxFlags("Tonemap (ACES)", &postSettings.effects, POST_TONEMAP);
+    ImGui::CheckboxFlags("Color Grading LUT", &postSettings.effects, POST_COLOR_GRADING);
+    ImGui::CheckboxFlags("Vignette", &postSettings.effects, POST_VIGNETTE);
+    ImGui::CheckboxFlags("FXAA", &postSettings.effects, POST_FXAA);
+    ImGui::SliderFloat("Exposure Value", &postSettings.exposure, 0.1f, 4.0f);
+    ImGui::SliderFloat("Bloom Threshold", &postSettings.bloomThreshold, 0.0f, 2.0f);
+    ImGui::SliderFloat("Bloom Intensity", &postSettings.bloomIntensity, 0.0f, 2.0f);
+    ImGui::SliderInt("Bloom Levels", &postSettings.bloomLevels, 1, 8);
+    ImGui::SliderFloat("Vignette Intensity", &postSettings.vignetteIntensity, 0.0f, 1.0f);
+    for (int i = 1; i >= 0; i--) {
+        const PostProcessStack::Stats& postStats = postProcess->getStats(i == 1);
+        ImGui::Text("%s: %d passes, %d dispatches, %.1f MB, %.3f ms", i == 1 ? "Fused" : "Per-effect",
+            postStats.fullscreenPassCount, postStats.dispatchCount,
+            postStats.bandwidthBytes / (1024.0 * 1024.0), postStats.gpuMs);
+    }
+    const PostProcessStack::Stats& fusedStats = postProcess->getStats(true);
+    const PostProcessStack::Stats& separateStats = postProcess->getStats(false);
+    if (fusedStats.bandwidthBytes > 0 && separateStats.bandwidthBytes > 0) {
+        ImGui::Text("Bandwidth saved: %.0f%%", 100.0 * (1.0 - (double)fusedStats.bandwidthBytes / (double)separateStats.bandwidthBytes));
+    }
+    ImGui::End();
+
+    // ȾͳƣƵá״̬лԴ
+    RenderStats::drawImGui();
+
     // Ⱦ߼ֲ䣩
     ImGui::Render();
     int display_w, display_h;
@@ -373,7 +538,7 @@ void prepare() {
     std::string whiteFragmentPath = std::string(SHADER_DIR) + "/whiteShader/white.frag";
 
 	std::string screenVertexPath = std::string(SHADER_DIR) + "/4-Advanced/screenShader/screen.vert";
-	std::string screenFragmentPath = std::string(SHADER_DIR) + "/4-Advanced/screenShader/screen.frag";
+	std::string screenFragmentPath = std::string(SHADER_DIR) + "/4-Advanced/screenShader/upscale.frag";     // 񻯵ķŴ󣬶ֱ̬ʹ
 
     std::string phongVertexPath = std::string(SHADER_DIR) + "/4-Advanced/PhongBlend/vertexShader.vert";
     std::string phongFragmentPath = std::string(SHADER_DIR) + "/4-Advanced/PhongBlend/fragmentShader.frag";
@@ -397,18 +562,17 @@ void prepare() {
 	meshesOffScreen.push_back(meshBox);
 
 	auto geometryScreen = Geometry::createScreenPlane();
-	auto materialScreen = new ScreenMaterial();
+	materialScreen = new ScreenMaterial();
+	materialScreen->mSharpness = 0.5f;
 	materialScreen->setShader(ScreenShader);
-	materialScreen->mScreenTexture = colorAttachment;   // !!! FBOɫScreenMaterial, Ļʾ
-   std::cout<< materialScreen->mScreenTexture->getUnit()<<"ID"<<std::endl;
+	// ɫ֡ͼÿ֡䣬Screen Pass ִʱ󶨵 0 Ԫﲻ mScreenTexture
     auto meshScreen = new Mesh(geometryScreen, materialScreen);
     meshesInScreen.push_back(meshScreen);
     /*
 	ܽ᣺
-		prepareFBO()УǴһFBOһɫһģȾ塣
-		prepare()УǴһPBRʵĺMeshӵȾmeshesOffScreenУȾȾ󶨵fboϡ
-		ȻǴһĻƽMeshʹScreenMaterialʣfboɫֵʵmScreenTexture
-                                                                    / fboɫ
+		renderFrameGraph()УScene Pass һɫһģ帽֡ͼFBO
+		prepare()УǴһPBRʵĺMeshӵȾmeshesOffScreenУȾȾ֡ͼFBOϡ
+		ȻǴһĻƽMeshʹScreenMaterialʣScreen Pass ɫ
     */
     
     // һɫʵmesh
@@ -493,9 +657,12 @@ int main(int argc, char* argv[]) {
     GL_CALL(glViewport(0, 0, App->getWidth(), App->getHeight()));	// OpenGLӿڵĴСΪĴС)
     GL_CALL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));	// ɫRGBAĸΧ[0.0, 1.0]ÿֵԽɫԽ
 
+    // ֹĻ治ÿ֡Ⱦơ任ᴥػ
+    App->setRedrawMode(Application::RedrawMode::OnDemand);
+
     prepareEventCallback();
     prepareCamera();
-	prepareFBO();       // ׼FBO˳⣬prepare()֮ǰΪprepare()лõFBOɫ,ȴ
+	prepareFrameGraph();
     prepare();
     initIMGUI();
 
@@ -511,20 +678,18 @@ int main(int argc, char* argv[]) {
         ĻȾȫıβ colorAttachment ʾպĽ
     
     ܽ᣺
-        prepareFBO()УǴһFBOһɫһģȾ塣
-        prepare()УǴһPBRʵĺMeshӵȾmeshesOffScreenУȾȾ󶨵fboϡ
-        ȻǴһĻƽMeshʹScreenMaterialʣfboɫֵʵmScreenTextureԡ
+        Ŀ֡ͼScene Pass дɫ Screen Pass ȡ Pass ִ󸽼黹ȾĿأ
+        һֱ֡Ӹãź³ߴ·䡣
     */
-	    // 1. Ⱦ
-		// pass01 BoxȾcolorAttachmentϣµfbo
-		renderer->render(meshesOffScreen, camera, dirLight, pointLights, spotLight, ambLight, fbo);
-		// 2. ĻȾ
-		// pass02 colorAttachmentΪȾĻ
-        renderer->render(meshesInScreen, camera, dirLight, pointLights, spotLight, ambLight);
+        renderFrameGraph();
 
         renderIMGUI();      // ImGui UI Ӧ3D ֮Ⱦȷ UI ʾϲ㣺
     }
 
+    delete accumulator;
+    delete postProcess;
+    delete dynamicResolution;
+    delete frameGraph;
     App->destroy();
     // Դ
     ImGui_ImplOpenGL3_Shutdown();
@@ -584,7 +749,7 @@ void UpdateLightAndWhite() {
 
 
 void lightTransform() {
-    float zPos = glm::sin(SDL_GetTicks() * 0.001f) + 3.0f;
+    float zPos = glm::sin(App->getTicks() * 0.001f) + 3.0f;
     meshWhite->setPosition(glm::vec3(0.0f, 0.0f, zPos));
     spotLight->setPosition(meshWhite->getPosition());
 }
@@ -661,6 +826,11 @@ void onResize(int width, int height) {
 
     // ڵǰĴСûߴ
     glViewport(0, 0, width, height);
+
+    // 洰ڳߴĿ갴³ߴ·
+    if (frameGraph != nullptr) {
+        frameGraph->setBackbufferSize(width, height);
+    }
 }
 
 void PrintVec3(glm::vec3& vec) {
@@ -0,0 +1,330 @@
+#include "benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// 按数量级选择单位
+static std::string formatTime(double ns) {
+    char text[32];
+    if (ns < 1e3) {
+        snprintf(text, sizeof(text), "%.1f ns", ns);
+    }
+    else if (ns < 1e6) {
+        snprintf(text, sizeof(text), "%.2f us", ns / 1e3);
+    }
+    else if (ns < 1e9) {
+        snprintf(text, sizeof(text), "%.2f ms", ns / 1e6);
+    }
+    else {
+        snprintf(text, sizeof(text), "%.2f s", ns / 1e9);
+    }
+    return text;
+}
+
+static std::string formatRate(double perSecond, const std::string& itemName) {
+    if (perSecond <= 0.0) {
+        return "";
+    }
+    char text[48];
+    if (perSecond >= 1e9) {
+        snprintf(text, sizeof(text), "%.2f G%s/s", perSecond / 1e9, itemName.c_str());
+    }
+    else if (perSecond >= 1e6) {
+        snprintf(text, sizeof(text), "%.2f M%s/s", perSecond / 1e6, itemName.c_str());
+    }
+    else if (perSecond >= 1e3) {
+        snprintf(text, sizeof(text), "%.2f K%s/s", perSecond / 1e3, itemName.c_str());
+    }
+    else {
+        snprintf(text, sizeof(text), "%.2f %s/s", perSecond, itemName.c_str());
+    }
+    return text;
+}
+
+// 测试名称由代码给出，只需转义引号与反斜杠
+static std::string quote(const std::string& text) {
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result + "\"";
+}
+
+// 在一行 JSON 中查找 "key": 之后的字符串 / 数字（只解析 writeJSON 写出的格式）
+static bool findString(const std::string& line, const std::string& key, std::string& value) {
+    size_t position = line.find("\"" + key + "\":\"");
+    if (position == std::string::npos) {
+        return false;
+    }
+    value.clear();
+    for (size_t i = position + key.size() + 4; i < line.size(); i++) {
+        if (line[i] == '\\' && i + 1 < line.size()) {
+            value += line[++i];
+        }
+        else if (line[i] == '"') {
+            return true;
+        }
+        else {
+            value += line[i];
+        }
+    }
+    return false;
+}
+
+static bool findNumber(const std::string& line, const std::string& key, double& value) {
+    size_t position = line.find("\"" + key + "\":");
+    if (position == std::string::npos) {
+        return false;
+    }
+    const char* begin = line.c_str() + position + key.size() + 3;
+    char* end = nullptr;
+    value = std::strtod(begin, &end);
+    return end != begin;
+}
+
+void BenchRunner::run(const std::string& filter) {
+    mResults.clear();
+    printf("%-56s %12s %12s %8s %18s\n", "benchmark", "median", "min", "+/-", "throughput");
+    for (const auto& benchmark : mBenchmarks) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        // 输入有误（例如模型缺少法线）时跳过该测试
+        BenchResult result;
+        try {
+            result = measure(benchmark);
+        }
+        catch (const std::exception& e) {
+            printf("%-56s failed: %s\n", benchmark.name.c_str(), e.what());
+            continue;
+        }
+        double deviation = result.meanNs > 0.0 ? 100.0 * result.stddevNs / result.meanNs : 0.0;
+        printf("%-56s %12s %12s %7.1f%% %18s\n", result.name.c_str(), formatTime(result.medianNs).c_str(),
+            formatTime(result.minNs).c_str(), deviation, formatRate(result.itemsPerSecond, result.itemName).c_str());
+        fflush(stdout);
+        mResults.push_back(result);
+    }
+}
+
+BenchResult BenchRunner::measure(const Benchmark& benchmark) const {
+    BenchResult result;
+    result.name = benchmark.name;
+    result.itemName = benchmark.itemName;
+
+    if (benchmark.setup) {
+        benchmark.setup();
+    }
+
+    std::vector<double> samples;
+    double items = 0.0;
+    try {
+        //1 预热一次，同时估计单次耗时，决定每个样本包含多少次迭代
+        auto start = Clock::now();
+        benchmark.run();
+        double firstNs = std::max(elapsedNs(start), 1.0);
+        size_t batch = std::max<size_t>(1, static_cast<size_t>(mSampleMs * 1e6 / firstNs));
+
+        //2 采样
+        double totalNs = 0.0;
+        const size_t maxSamples = 10000;
+        while ((totalNs < mMinTimeMs * 1e6 || samples.size() < mMinSamples) && samples.size() < maxSamples) {
+            start = Clock::now();
+            for (size_t i = 0; i < batch; i++) {
+                benchmark.run();
+            }
+            double sampleNs = elapsedNs(start);
+            samples.push_back(sampleNs / batch);
+            totalNs += sampleNs;
+            result.iterations += batch;
+        }
+        items = benchmark.items ? benchmark.items() : 0.0;
+    }
+    catch (...) {
+        // 失败时同样释放 setup 中准备的数据
+        if (benchmark.teardown) {
+            benchmark.teardown();
+        }
+        throw;
+    }
+
+    if (benchmark.teardown) {
+        benchmark.teardown();
+    }
+
+    //3 统计
+    result.samples = samples.size();
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    size_t middle = sorted.size() / 2;
+    result.medianNs = sorted.size() % 2 == 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) * 0.5;
+    result.minNs = sorted.front();
+
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    result.meanNs = sum / samples.size();
+    double variance = 0.0;
+    for (double sample : samples) {
+        variance += (sample - result.meanNs) * (sample - result.meanNs);
+    }
+    result.stddevNs = samples.size() > 1 ? std::sqrt(variance / (samples.size() - 1)) : 0.0;
+
+    if (items > 0.0 && result.medianNs > 0.0) {
+        result.itemsPerSecond = items * 1e9 / result.medianNs;
+    }
+    return result;
+}
+
+bool BenchRunner::writeJSON(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR[BenchRunner]: 无法写入 " << path << std::endl;
+        return false;
+    }
+
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+    file << "{\n";
+    file << "\"version\":1,\n";
+    file << "\"build\":" << quote(build) << ",\n";
+    file << "\"hardwareThreads\":" << std::thread::hardware_concurrency() << ",\n";
+    file << "\"results\":[\n";
+    for (size_t i = 0; i < mResults.size(); i++) {
+        const BenchResult& result = mResults[i];
+        file << "{\"name\":" << quote(result.name)
+            << ",\"samples\":" << result.samples
+            << ",\"iterations\":" << result.iterations
+            << ",\"medianNs\":" << result.medianNs
+            << ",\"meanNs\":" << result.meanNs
+            << ",\"minNs\":" << result.minNs
+            << ",\"stddevNs\":" << result.stddevNs
+            << ",\"itemsPerSecond\":" << result.itemsPerSecond
+            << ",\"itemName\":" << quote(result.itemName) << "}"
+            << (i + 1 < mResults.size() ? ",\n" : "\n");
+    }
+    file << "]\n}\n";
+    return true;
+}
+
+bool BenchRunner::readJSON(const std::string& path, std::vector<BenchResult>& results) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR[BenchRunner]: 无法读取 " << path << std::endl;
+        return false;
+    }
+
+    results.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        BenchResult result;
+        double value = 0.0;
+        if (!findString(line, "name", result.name) || !findNumber(line, "medianNs", result.medianNs)) {
+            continue;
+        }
+        if (findNumber(line, "samples", value)) result.samples = static_cast<size_t>(value);
+        if (findNumber(line, "iterations", value)) result.iterations = static_cast<size_t>(value);
+        findNumber(line, "meanNs", result.meanNs);
+        findNumber(line, "minNs", result.minNs);
+        findNumber(line, "stddevNs", result.stddevNs);
+        findNumber(line, "itemsPerSecond", result.itemsPerSecond);
+        findString(line, "itemName", result.itemName);
+        results.push_back(result);
+    }
+    return true;
+}
+
+std::vector<BenchComparison> BenchRunner::compare(const std::vector<BenchResult>& baseline, double threshold) const {
+    std::vector<BenchComparison> comparisons;
+    for (const auto& result : mResults) {
+        BenchComparison comparison;
+        comparison.name = result.name;
+        comparison.currentNs = result.medianNs;
+
+        auto found = std::find_if(baseline.begin(), baseline.end(), [&result](const BenchResult& base) {
+            return base.name == result.name;
+        });
+        if (found == baseline.end() || found->medianNs <= 0.0) {
+            comparison.status = BenchStatus::New;
+            comparisons.push_back(comparison);
+            continue;
+        }
+
+        comparison.baselineNs = found->medianNs;
+        comparison.change = (result.medianNs - found->medianNs) / found->medianNs;
+        if (comparison.change > threshold) {
+            comparison.status = BenchStatus::Slower;
+        }
+        else if (comparison.change < -threshold) {
+            comparison.status = BenchStatus::Faster;
+        }
+        comparisons.push_back(comparison);
+    }
+
+    // 基线中有、本次没有运行的测试（被过滤掉或已删除）
+    for (const auto& base : baseline) {
+        auto found = std::find_if(mResults.begin(), mResults.end(), [&base](const BenchResult& result) {
+            return result.name == base.name;
+        });
+        if (found == mResults.end()) {
+            BenchComparison comparison;
+            comparison.name = base.name;
+            comparison.baselineNs = base.medianNs;
+            comparison.status = BenchStatus::Missing;
+            comparisons.push_back(comparison);
+        }
+    }
+    return comparisons;
+}
+
+void BenchRunner::printComparison(const std::vector<BenchComparison>& comparisons, double threshold) {
+    printf("\n%-56s %12s %12s %9s  %s (threshold %.1f%%)\n", "benchmark", "baseline", "current", "change", "status", threshold * 100.0);
+    for (const auto& comparison : comparisons) {
+        const char* status = "ok";
+        switch (comparison.status) {
+        case BenchStatus::Faster:
+            status = "faster";
+            break;
+        case BenchStatus::Slower:
+            status = "REGRESSION";
+            break;
+        case BenchStatus::New:
+            status = "new";
+            break;
+        case BenchStatus::Missing:
+            status = "missing";
+            break;
+        default:
+            break;
+        }
+
+        std::string baseline = comparison.baselineNs > 0.0 ? formatTime(comparison.baselineNs) : "-";
+        std::string current = comparison.currentNs > 0.0 ? formatTime(comparison.currentNs) : "-";
+        if (comparison.status == BenchStatus::New || comparison.status == BenchStatus::Missing) {
+            printf("%-56s %12s %12s %9s  %s\n", comparison.name.c_str(), baseline.c_str(), current.c_str(), "-", status);
+        }
+        else {
+            printf("%-56s %12s %12s %+8.1f%%  %s\n", comparison.name.c_str(), baseline.c_str(), current.c_str(),
+                comparison.change * 100.0, status);
+        }
+    }
+}
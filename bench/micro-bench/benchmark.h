@@ -0,0 +1,84 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+// 微基准测试：只测 CPU 热路径，不需要 OpenGL 上下文
+// 1. 每个测试分为 setup / run / teardown，只有 run 计时；setup 中准备输入，teardown 中释放，测试之间互不影响
+// 2. 先单独运行一次估计耗时，再把多次 run 合成一个样本（每个样本至少 sampleMs），
+//    一直采样到总时间达到 minTimeMs 且样本数不少于 minSamples
+// 3. 结果取样本的中位数（对偶发的调度抖动不敏感），同时给出最小值、平均值与标准差
+// 4. 输出为 JSON，可以保存为基线；比较模式下中位数变慢超过阈值的测试记为回退
+struct Benchmark {
+    std::string name;                       // 分组/名称，例如 "geometry/parseOBJ/Pangmao"
+    std::function<void()> setup;            // 计时前执行一次（可为空）
+    std::function<void()> run;              // 一次迭代（计时）
+    std::function<void()> teardown;         // 计时后执行一次（可为空）
+    std::function<double()> items;          // 每次迭代处理的元素数（三角形、节点、像素等），在 teardown 前调用；为空时不统计吞吐量
+    std::string itemName{};                 // 元素的名称，用于输出（例如 "tris"）
+};
+
+struct BenchResult {
+    std::string name;
+    size_t samples{ 0 };
+    size_t iterations{ 0 };                 // 总迭代次数
+    double medianNs{ 0.0 };                 // 以下均为每次迭代的耗时（纳秒）
+    double meanNs{ 0.0 };
+    double minNs{ 0.0 };
+    double stddevNs{ 0.0 };
+    double itemsPerSecond{ 0.0 };           // 按中位数计算
+    std::string itemName{};
+};
+
+// 与基线比较的结果
+enum class BenchStatus {
+    Same,
+    Faster,
+    Slower,         // 超过阈值的回退
+    New,            // 基线中没有
+    Missing         // 本次没有运行
+};
+
+struct BenchComparison {
+    std::string name;
+    double baselineNs{ 0.0 };
+    double currentNs{ 0.0 };
+    double change{ 0.0 };                   // (current - baseline) / baseline
+    BenchStatus status{ BenchStatus::Same };
+};
+
+class BenchRunner {
+public:
+    void add(const Benchmark& benchmark) { mBenchmarks.push_back(benchmark); }
+    const std::vector<Benchmark>& getBenchmarks() const { return mBenchmarks; }
+
+    // 采样参数
+    void setMinTimeMs(double ms) { mMinTimeMs = ms > 0.0 ? ms : 1.0; }
+    void setSampleMs(double ms) { mSampleMs = ms > 0.0 ? ms : 0.1; }
+    void setMinSamples(size_t samples) { mMinSamples = samples > 0 ? samples : 1; }
+
+    // 运行名称中包含 filter 的测试（filter 为空时全部运行），边运行边打印
+    void run(const std::string& filter);
+    const std::vector<BenchResult>& getResults() const { return mResults; }
+
+    // JSON 输出：每个结果一行，便于 diff
+    bool writeJSON(const std::string& path) const;
+
+    // 读取 writeJSON 写出的文件，失败返回 false
+    static bool readJSON(const std::string& path, std::vector<BenchResult>& results);
+
+    // 与基线比较：threshold 为允许的相对变化（0.1 表示 10%）
+    std::vector<BenchComparison> compare(const std::vector<BenchResult>& baseline, double threshold) const;
+    static void printComparison(const std::vector<BenchComparison>& comparisons, double threshold);
+
+private:
+    BenchResult measure(const Benchmark& benchmark) const;
+
+private:
+    std::vector<Benchmark> mBenchmarks{};
+    std::vector<BenchResult> mResults{};
+
+    double mMinTimeMs{ 500.0 };
+    double mSampleMs{ 5.0 };
+    size_t mMinSamples{ 5 };
+};
@@ -0,0 +1,607 @@
+// 微基准测试：引擎 CPU 热路径（不需要 GPU / OpenGL 上下文）
+// 1. geometry：OBJ 解析与顶点去重、二进制 STL 导入与法线平滑（Geometry::parseOBJ / parseSTL）
+// 2. transform：深层级的世界矩阵更新与 Object::getModelMatrx
+// 3. renderQueue：视锥剔除（BVH / 逐个）与透明物体排序
+// 4. shader：Tools::readShaderSourceWithMacros 预处理（冷缓存 / 热缓存）
+// 5. texture：图片解码后的 RGBA32 转换与 Y 轴翻转（Texture::loadSurface）
+// 输入为 resource 下的真实资源与程序生成的合成数据
+//
+// 用法：micro-bench [--filter 子串] [--min-time 毫秒] [--threads N] [--out 结果.json] [--baseline 基线.json] [--threshold 百分比] [--list]
+//   --out 保存本次结果（可作为以后的基线），--baseline 与基线比较，有测试变慢超过阈值（默认 10%）时返回 1
+#include "benchmark.h"
+#include "geometry.h"
+#include "texture.h"
+
+#include "../../include/camera/cameraType/perspectiveCamera.h"
+#include "../../include/glframework/mesh.h"
+#include "../../include/glframework/scene.h"
+#include "../../include/glframework/transformStorage.h"
+#include "../../include/glframework/renderer/renderQueue.h"
+#include "../../include/glframework/tools/tools.h"
+#include "../../include/glframework/tools/shaderPreprocessor.h"
+#include "../../include/glframework/tools/jobSystem.h"
+
+#include <SDL2/SDL_main.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// 合成数据写到当前目录，结束时删除
+static const char* SYNTHETIC_OBJ = "micro_bench_sphere.obj";
+static const char* SYNTHETIC_STL = "micro_bench_sphere.stl";
+
+static bool fileExists(const std::string& path) {
+    std::ifstream file(path);
+    return file.is_open();
+}
+
+// 经纬球面上的点（同一位置每次计算的结果完全相同，STL 中共享的顶点可以被平滑法线合并）
+static glm::vec3 spherePoint(int lat, int lon, int segments) {
+    float theta = glm::pi<float>() * lat / segments;
+    float phi = 2.0f * glm::pi<float>() * (lon % segments) / segments;
+    return glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+}
+
+// 生成四边形面的 OBJ（v/vt/vn 全部给出，面按扇形拆成三角形）
+static bool writeSphereOBJ(const std::string& path, int segments) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    for (int lat = 0; lat <= segments; lat++) {
+        for (int lon = 0; lon <= segments; lon++) {
+            glm::vec3 p = spherePoint(lat, lon, segments);
+            file << "v " << p.x << ' ' << p.y << ' ' << p.z << '\n';
+            file << "vt " << static_cast<float>(lon) / segments << ' ' << 1.0f - static_cast<float>(lat) / segments << '\n';
+            file << "vn " << p.x << ' ' << p.y << ' ' << p.z << '\n';
+        }
+    }
+    for (int lat = 0; lat < segments; lat++) {
+        for (int lon = 0; lon < segments; lon++) {
+            int a = lat * (segments + 1) + lon + 1;
+            int b = a + segments + 1;
+            file << "f " << a << '/' << a << '/' << a << ' ' << b << '/' << b << '/' << b << ' '
+                << b + 1 << '/' << b + 1 << '/' << b + 1 << ' ' << a + 1 << '/' << a + 1 << '/' << a + 1 << '\n';
+        }
+    }
+    return true;
+}
+
+// 生成二进制 STL（小端序，按平台字节序直接写出）
+static bool writeSphereSTL(const std::string& path, int segments) {
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    char header[80] = "micro-bench sphere";
+    file.write(header, sizeof(header));
+    uint32_t faceCount = static_cast<uint32_t>(segments * segments * 2);
+    file.write(reinterpret_cast<const char*>(&faceCount), sizeof(faceCount));
+
+    auto writeFace = [&file](const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        normal = glm::length(normal) > 1e-12f ? glm::normalize(normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+        float data[12] = { normal.x, normal.y, normal.z, p0.x, p0.y, p0.z, p1.x, p1.y, p1.z, p2.x, p2.y, p2.z };
+        uint16_t attribute = 0;
+        file.write(reinterpret_cast<const char*>(data), sizeof(data));
+        file.write(reinterpret_cast<const char*>(&attribute), sizeof(attribute));
+    };
+    for (int lat = 0; lat < segments; lat++) {
+        for (int lon = 0; lon < segments; lon++) {
+            glm::vec3 a = spherePoint(lat, lon, segments);
+            glm::vec3 b = spherePoint(lat + 1, lon, segments);
+            glm::vec3 c = spherePoint(lat + 1, lon + 1, segments);
+            glm::vec3 d = spherePoint(lat, lon + 1, segments);
+            writeFace(a, b, c);
+            writeFace(a, c, d);
+        }
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// 1 geometry
+
+static void addParseOBJ(BenchRunner& runner, const std::string& name, const std::string& path) {
+    auto triangles = std::make_shared<size_t>(0);
+    Benchmark benchmark;
+    benchmark.name = "geometry/parseOBJ/" + name;
+    benchmark.run = [path, triangles]() {
+        GeometryData data = Geometry::parseOBJ(path);
+        *triangles = data.indices.size() / 3;
+    };
+    benchmark.items = [triangles]() { return static_cast<double>(*triangles); };
+    benchmark.itemName = "tris";
+    runner.add(benchmark);
+}
+
+static void addParseSTL(BenchRunner& runner, const std::string& name, const std::string& path, bool smooth) {
+    auto triangles = std::make_shared<size_t>(0);
+    Benchmark benchmark;
+    benchmark.name = "geometry/parseSTL/" + name + (smooth ? "/smooth" : "/flat");
+    benchmark.run = [path, smooth, triangles]() {
+        GeometryData data = Geometry::parseSTL(path, smooth);
+        *triangles = data.indices.size() / 3;
+    };
+    benchmark.items = [triangles]() { return static_cast<double>(*triangles); };
+    benchmark.itemName = "tris";
+    runner.add(benchmark);
+}
+
+static void registerGeometry(BenchRunner& runner) {
+    const std::vector<std::string> files = {
+        "Pangmao.obj",
+        "pbrheart/pbrheart.obj",
+        "rock/Stone.obj",
+    };
+    for (const auto& file : files) {
+        std::string path = std::string(OBJ_DIR) + file;
+        if (!fileExists(path)) {
+            std::cerr << "skip " << path << ": file not found" << std::endl;
+            continue;
+        }
+        addParseOBJ(runner, file, path);
+    }
+
+    if (writeSphereOBJ(SYNTHETIC_OBJ, 256)) {
+        addParseOBJ(runner, "synthetic/sphere256", SYNTHETIC_OBJ);
+    }
+    if (writeSphereSTL(SYNTHETIC_STL, 256)) {
+        addParseSTL(runner, "synthetic/sphere256", SYNTHETIC_STL, true);
+        addParseSTL(runner, "synthetic/sphere256", SYNTHETIC_STL, false);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// 2 transform
+
+// chains 条长度为 depth 的父子链，每次迭代旋转所有根节点（整条链的世界矩阵都要重新计算）
+static void addTransformChains(BenchRunner& runner, int chains, int depth) {
+    struct State {
+        std::vector<Object*> objects;
+        std::vector<Object*> roots;
+        float angle{ 0.0f };
+        glm::mat4 sink{ 0.0f };
+    };
+    auto state = std::make_shared<State>();
+    std::string suffix = std::to_string(chains) + "x" + std::to_string(depth);
+
+    auto setup = [state, chains, depth]() {
+        for (int c = 0; c < chains; c++) {
+            Object* parent = nullptr;
+            for (int d = 0; d < depth; d++) {
+                Object* object = new Object();
+                object->setPosition(glm::vec3(0.0f, 0.1f, 0.0f));
+                object->setAngleZ(1.0f);
+                if (parent != nullptr) {
+                    parent->addChild(object);
+                }
+                else {
+                    state->roots.push_back(object);
+                }
+                state->objects.push_back(object);
+                parent = object;
+            }
+        }
+        TransformStorage::update();
+    };
+    auto teardown = [state]() {
+        for (auto object : state->objects) {
+            delete object;
+        }
+        state->objects.clear();
+        state->roots.clear();
+        TransformStorage::update();
+    };
+    auto items = [state]() { return static_cast<double>(state->objects.size()); };
+
+    Benchmark update;
+    update.name = "transform/updateChains/" + suffix;
+    update.setup = setup;
+    update.run = [state]() {
+        state->angle += 1.0f;
+        for (auto root : state->roots) {
+            root->setAngleY(state->angle);
+        }
+        TransformStorage::update();
+    };
+    update.teardown = teardown;
+    update.items = items;
+    update.itemName = "nodes";
+    runner.add(update);
+
+    // 只读取（世界矩阵已经是最新的）
+    Benchmark read;
+    read.name = "transform/getModelMatrx/" + suffix;
+    read.setup = setup;
+    read.run = [state]() {
+        glm::mat4 sum(0.0f);
+        for (auto object : state->objects) {
+            sum += object->getModelMatrx();
+        }
+        state->sink = sum;
+    };
+    read.teardown = teardown;
+    read.items = items;
+    read.itemName = "nodes";
+    runner.add(read);
+}
+
+static void registerTransform(BenchRunner& runner) {
+    addTransformChains(runner, 64, 64);
+    addTransformChains(runner, 1, 1024);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// 3 renderQueue
+
+// 只有包围盒、没有 GPU 缓冲区的几何体（析构函数会调用 OpenGL，因此不释放）
+static Geometry* getBoundsGeometry() {
+    static Geometry* geometry = nullptr;
+    if (geometry == nullptr) {
+        const float corners[6] = { -0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f };
+        geometry = new Geometry();
+        geometry->computeBounds(corners, 2);
+    }
+    return geometry;
+}
+
+enum class QueueMode {
+    CullBVH,
+    CullLinear,
+    SortTransparent,
+    UnsortedTransparent
+};
+
+// count 个 Mesh 均匀散布在 xz 平面上，相机只看到其中一部分
+static void addRenderQueue(BenchRunner& runner, const std::string& name, int count, QueueMode mode) {
+    struct State {
+        Scene* scene{ nullptr };
+        std::vector<Mesh*> meshes;
+        std::vector<Material*> materials;
+        perspectiveCamera* camera{ nullptr };
+        RenderQueue* queue{ nullptr };
+        size_t packets{ 0 };
+    };
+    auto state = std::make_shared<State>();
+    bool transparent = mode == QueueMode::SortTransparent || mode == QueueMode::UnsortedTransparent;
+
+    Benchmark benchmark;
+    benchmark.name = "renderQueue/" + name + "/" + std::to_string(count);
+    benchmark.setup = [state, count, mode, transparent]() {
+        for (int i = 0; i < 8; i++) {
+            Material* material = new Material();
+            material->mType = static_cast<MaterialType>(i % 3);
+            material->mBlend = transparent;
+            state->materials.push_back(material);
+        }
+
+        state->scene = new Scene();
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+        for (int i = 0; i < count; i++) {
+            Mesh* mesh = new Mesh(getBoundsGeometry(), state->materials[i % state->materials.size()]);
+            mesh->setPosition(glm::vec3(position(random), 0.0f, position(random)));
+            mesh->setAngleY(angle(random));
+            state->scene->addChild(mesh);
+            state->meshes.push_back(mesh);
+        }
+
+        state->camera = new perspectiveCamera(60.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+        state->camera->mPosition = glm::vec3(0.0f, 12.0f, 14.0f);
+        state->camera->mUp = glm::normalize(glm::vec3(0.0f, 1.0f, -0.8f));
+        state->camera->mRight = glm::vec3(1.0f, 0.0f, 0.0f);
+
+        state->queue = new RenderQueue();
+        state->queue->setUseBVH(mode != QueueMode::CullLinear);
+        state->queue->setFrustumCulling(!transparent);
+        state->queue->setSortTransparent(mode != QueueMode::UnsortedTransparent);
+    };
+    benchmark.run = [state]() {
+        state->queue->build(state->scene, state->camera);
+        state->packets = state->queue->getOpaquePackets().size() + state->queue->getTransparentPackets().size();
+    };
+    benchmark.teardown = [state]() {
+        delete state->queue;
+        for (auto mesh : state->meshes) {
+            delete mesh;
+        }
+        delete state->scene;
+        for (auto material : state->materials) {
+            delete material;
+        }
+        delete state->camera;
+        state->meshes.clear();
+        state->materials.clear();
+        TransformStorage::update();
+    };
+    benchmark.items = [count]() { return static_cast<double>(count); };
+    benchmark.itemName = "meshes";
+    runner.add(benchmark);
+}
+
+static void registerRenderQueue(BenchRunner& runner) {
+    // 透明排序开与关的差值即为排序本身的开销
+    for (int count : { 1000, 10000 }) {
+        addRenderQueue(runner, "cullBVH", count, QueueMode::CullBVH);
+        addRenderQueue(runner, "cullLinear", count, QueueMode::CullLinear);
+        addRenderQueue(runner, "sortTransparent", count, QueueMode::SortTransparent);
+        addRenderQueue(runner, "unsortedTransparent", count, QueueMode::UnsortedTransparent);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// 4 shader
+
+static void addShaderPreprocess(BenchRunner& runner, const std::string& name, const std::string& path,
+    const std::vector<ShaderMacro>& macros, bool cold) {
+    auto bytes = std::make_shared<size_t>(0);
+    Benchmark benchmark;
+    benchmark.name = std::string("shader/") + (cold ? "preprocessCold/" : "preprocessWarm/") + name;
+    benchmark.setup = []() { ShaderPreprocessor::clearCache(); };
+    benchmark.run = [path, macros, cold, bytes]() {
+        // 冷缓存：每次都重新读取文件并展开（计时包含清空缓存本身）
+        if (cold) {
+            ShaderPreprocessor::clearCache();
+        }
+        *bytes = Tools::readShaderSourceWithMacros(path, macros).size();
+    };
+    benchmark.teardown = []() { ShaderPreprocessor::clearCache(); };
+    benchmark.items = [bytes]() { return static_cast<double>(*bytes); };
+    benchmark.itemName = "B";
+    runner.add(benchmark);
+}
+
+static void registerShader(BenchRunner& runner) {
+    // 与 4.4-PBR-Blend 使用的宏相同
+    const std::vector<ShaderMacro> macros = {
+        ShaderMacro("MAX_POINT_LIGHTS", "4", ShaderTarget::FRAGMENT, "最大点光源数量"),
+        ShaderMacro("MAX_DIRECTION_LIGHTS", "1", ShaderTarget::FRAGMENT, "最大平行光源数量"),
+        ShaderMacro("MAX_SPOT_LIGHTS", "0", ShaderTarget::FRAGMENT, "最大聚光灯光源数量"),
+    };
+    const std::vector<std::string> files = {
+        "4-Advanced/PBRBlend/vertexShader.vert",
+        "4-Advanced/PBRBlend/fragmentShader.frag",
+        "PBR-Light/PBR-jinglian.frag",
+    };
+    for (const auto& file : files) {
+        std::string path = std::string(SHADER_DIR) + file;
+        if (!fileExists(path)) {
+            std::cerr << "skip " << path << ": file not found" << std::endl;
+            continue;
+        }
+        addShaderPreprocess(runner, file, path, macros, true);
+        addShaderPreprocess(runner, file, path, macros, false);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// 5 texture
+
+static void registerTexture(BenchRunner& runner) {
+    // 解码 + 转换 + 翻转（Texture 构造函数中上传 GPU 之前的全部工作）
+    const std::vector<std::string> files = {
+        "container2.png",
+        "wood.png",
+        "R-D.jpg",
+    };
+    for (const auto& file : files) {
+        std::string path = std::string(TEXTURE_DIR) + file;
+        if (!fileExists(path)) {
+            std::cerr << "skip " << path << ": file not found" << std::endl;
+            continue;
+        }
+        auto pixels = std::make_shared<size_t>(0);
+        Benchmark benchmark;
+        benchmark.name = "texture/loadSurface/" + file;
+        benchmark.run = [path, pixels]() {
+            SDL_Surface* surface = Texture::loadSurface(path);
+            *pixels = static_cast<size_t>(surface->w) * surface->h;
+            SDL_FreeSurface(surface);
+        };
+        benchmark.items = [pixels]() { return static_cast<double>(*pixels); };
+        benchmark.itemName = "px";
+        runner.add(benchmark);
+    }
+
+    // 合成图像：单独测量格式转换与翻转
+    const int size = 2048;
+    struct State {
+        SDL_Surface* rgb{ nullptr };
+        SDL_Surface* rgba{ nullptr };
+    };
+    auto state = std::make_shared<State>();
+    auto setup = [state, size]() {
+        state->rgb = SDL_CreateRGBSurfaceWithFormat(0, size, size, 24, SDL_PIXELFORMAT_RGB24);
+        state->rgba = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_RGBA32);
+        std::mt19937 random(3);
+        unsigned char* bytes = static_cast<unsigned char*>(state->rgb->pixels);
+        for (int i = 0; i < state->rgb->pitch * size; i++) {
+            bytes[i] = static_cast<unsigned char>(random());
+        }
+    };
+    auto teardown = [state]() {
+        SDL_FreeSurface(state->rgb);
+        SDL_FreeSurface(state->rgba);
+        state->rgb = nullptr;
+        state->rgba = nullptr;
+    };
+    auto items = [size]() { return static_cast<double>(size) * size; };
+
+    Benchmark convert;
+    convert.name = "texture/convertRGB24toRGBA32/" + std::to_string(size);
+    convert.setup = setup;
+    convert.run = [state]() {
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(state->rgb, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(converted);
+    };
+    convert.teardown = teardown;
+    convert.items = items;
+    convert.itemName = "px";
+    runner.add(convert);
+
+    Benchmark flip;
+    flip.name = "texture/flipVertically/" + std::to_string(size);
+    flip.setup = setup;
+    flip.run = [state]() { Texture::flipSurfaceVertically(state->rgba); };
+    flip.teardown = teardown;
+    flip.items = items;
+    flip.itemName = "px";
+    runner.add(flip);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// 任务系统：空任务的调度开销、细粒度 parallelFor、依赖图
+
+static void registerJobs(BenchRunner& runner) {
+    const int jobCount = 4096;
+
+    Benchmark empty;
+    empty.name = "jobs/runWait/" + std::to_string(jobCount);
+    empty.run = [jobCount]() {
+        JobCounter counter;
+        for (int i = 0; i < jobCount; i++) {
+            JobSystem::run([] {}, &counter);
+        }
+        JobSystem::wait(counter);
+    };
+    empty.items = [jobCount]() { return static_cast<double>(jobCount); };
+    empty.itemName = "job";
+    runner.add(empty);
+
+    // 每个元素很便宜，测的是切块与偷任务的开销
+    auto values = std::make_shared<std::vector<float>>(1 << 20, 1.0f);
+    Benchmark range;
+    range.name = "jobs/parallelFor/" + std::to_string(values->size());
+    range.run = [values]() {
+        JobSystem::parallelFor(values->size(), 1024, [&values](size_t begin, size_t end) {
+            float* data = values->data();
+            for (size_t i = begin; i < end; i++) {
+                data[i] = data[i] * 0.5f + 0.5f;
+            }
+        });
+    };
+    range.items = [values]() { return static_cast<double>(values->size()); };
+    range.itemName = "elem";
+    runner.add(range);
+
+    // 菱形依赖的宽图：1 -> 256 -> 1，每次重新 run
+    auto graph = std::make_shared<TaskGraph>();
+    auto sink = std::make_shared<std::atomic<int>>(0);
+    TaskGraph::TaskId root = graph->add([] {});
+    std::vector<TaskGraph::TaskId> middle;
+    for (int i = 0; i < 256; i++) {
+        middle.push_back(graph->add([sink] { sink->fetch_add(1, std::memory_order_relaxed); }, { root }));
+    }
+    graph->add([] {}, middle);
+
+    Benchmark graphRun;
+    graphRun.name = "jobs/taskGraph/" + std::to_string(graph->size());
+    graphRun.run = [graph]() { graph->run(); };
+    graphRun.items = [graph]() { return static_cast<double>(graph->size()); };
+    graphRun.itemName = "task";
+    runner.add(graphRun);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string outPath;
+    std::string baselinePath;
+    double threshold = 0.10;
+    double minTimeMs = 500.0;
+    int threads = -1;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) {
+            filter = argv[++i];
+        }
+        else if (arg == "--out" && hasValue) {
+            outPath = argv[++i];
+        }
+        else if (arg == "--baseline" && hasValue) {
+            baselinePath = argv[++i];
+        }
+        else if (arg == "--threshold" && hasValue) {
+            threshold = std::atof(argv[++i]) / 100.0;
+        }
+        else if (arg == "--min-time" && hasValue) {
+            minTimeMs = std::atof(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue) {
+            threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--list") {
+            listOnly = true;
+        }
+        else {
+            std::cerr << "usage: micro-bench [--filter text] [--min-time ms] [--threads n] [--out result.json] "
+                "[--baseline baseline.json] [--threshold percent] [--list]" << std::endl;
+            return 2;
+        }
+    }
+
+    // 先读取基线，文件有误时不必运行；被过滤掉的测试不参与比较
+    std::vector<BenchResult> baseline;
+    if (!baselinePath.empty() && !BenchRunner::readJSON(baselinePath, baseline)) {
+        return 2;
+    }
+    baseline.erase(std::remove_if(baseline.begin(), baseline.end(), [&filter](const BenchResult& result) {
+        return !filter.empty() && result.name.find(filter) == std::string::npos;
+    }), baseline.end());
+
+    // 渲染队列的并行部分使用 JobSystem，固定线程数便于在不同机器之间比较
+    if (threads >= 0) {
+        JobSystem::setWorkerCount(static_cast<size_t>(threads));
+    }
+
+    BenchRunner runner;
+    runner.setMinTimeMs(minTimeMs);
+    registerGeometry(runner);
+    registerTransform(runner);
+    registerRenderQueue(runner);
+    registerShader(runner);
+    registerTexture(runner);
+    registerJobs(runner);
+
+    int exitCode = 0;
+    if (listOnly) {
+        for (const auto& benchmark : runner.getBenchmarks()) {
+            std::cout << benchmark.name << std::endl;
+        }
+    }
+    else {
+        runner.run(filter);
+        if (!outPath.empty() && !runner.writeJSON(outPath)) {
+            exitCode = 2;
+        }
+        if (!baselinePath.empty()) {
+            auto comparisons = runner.compare(baseline, threshold);
+            BenchRunner::printComparison(comparisons, threshold);
+            for (const auto& comparison : comparisons) {
+                if (comparison.status == BenchStatus::Slower) {
+                    exitCode = 1;
+                }
+            }
+        }
+    }
+
+    std::remove(SYNTHETIC_OBJ);
+    std::remove(SYNTHETIC_STL);
+    JobSystem::shutdown();
+    return exitCode;
+}
@@ -0,0 +1,233 @@
+// 拾取性能测试：加载 resource/objs 下的模型，测量三角形 BVH 的构建时间与射线求交吞吐量（rays/s）
+// 1. 单个几何体：随机射线直接在 TriangleBVH 中求交，与逐个三角形暴力求交对比
+// 2. 整个场景：模型按网格摆放，随机屏幕坐标通过 Picker 拾取（单线程 / JobSystem 多线程）
+#include "core.h"
+#include "Application.h"
+#include "geometry.h"
+
+#include "../../include/camera/cameraType/perspectiveCamera.h"
+#include "../../include/glframework/material/whiteMaterial.h"
+#include "../../include/glframework/mesh.h"
+#include "../../include/glframework/scene.h"
+#include "../../include/glframework/picker.h"
+#include "../../include/glframework/tools/jobSystem.h"
+
+#include <SDL2/SDL_main.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cfloat>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 逐个三角形求交（对照组）
+static bool bruteForce(const TriangleBVH* bvh, const glm::vec3& origin, const glm::vec3& direction, float& closest) {
+    bool found = false;
+    for (uint32_t i = 0; i < bvh->getTriangleCount(); i++) {
+        glm::vec3 p0, p1, p2;
+        bvh->getTriangle(i, p0, p1, p2);
+        glm::vec3 e1 = p1 - p0;
+        glm::vec3 e2 = p2 - p0;
+        glm::vec3 p = glm::cross(direction, e2);
+        float determinant = glm::dot(e1, p);
+        if (std::abs(determinant) < 1e-12f) {
+            continue;
+        }
+        float invDeterminant = 1.0f / determinant;
+        glm::vec3 s = origin - p0;
+        float u = glm::dot(s, p) * invDeterminant;
+        glm::vec3 q = glm::cross(s, e1);
+        float v = glm::dot(direction, q) * invDeterminant;
+        float t = glm::dot(e2, q) * invDeterminant;
+        if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t < closest) {
+            closest = t;
+            found = true;
+        }
+    }
+    return found;
+}
+
+// 从包围球外朝包围盒内随机一点发射射线
+static void randomRay(std::mt19937& random, const glm::vec3& boundsMin, const glm::vec3& boundsMax, glm::vec3& origin, glm::vec3& direction) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    float radius = glm::length(boundsMax - boundsMin) * 0.5f + 1e-3f;
+
+    glm::vec3 dir(unit(random) * 2.0f - 1.0f, unit(random) * 2.0f - 1.0f, unit(random) * 2.0f - 1.0f);
+    if (glm::length(dir) < 1e-3f) {
+        dir = glm::vec3(0.0f, 0.0f, 1.0f);
+    }
+    origin = center + glm::normalize(dir) * radius * 2.0f;
+    glm::vec3 target = boundsMin + (boundsMax - boundsMin) * glm::vec3(unit(random), unit(random), unit(random));
+    direction = glm::normalize(target - origin);
+}
+
+int main(int, char*[]) {   // SDL_main 要求这个参数列表，参数不使用所以不命名
+    // OBJ 工厂函数会上传 GPU 缓冲区，需要先创建 OpenGL 上下文
+    if (!App->init(320, 240, "pick bench")) {
+        return -1;
+    }
+
+    const std::vector<std::string> files = {
+        "Pangmao.obj",
+        "humanHeart/Human_Heart.obj",
+        "mountain/mount.blend1.obj",
+        "pbrheart/pbrheart.obj",
+        "rock/Stone.obj",
+    };
+    const int rayCount = 200000;
+    const int bruteForceRays = 200;
+
+    std::vector<Geometry*> geometries;
+    std::vector<std::string> names;
+    for (const auto& file : files) {
+        try {
+            auto loadStart = Clock::now();
+            Geometry* geometry = Geometry::createFromOBJ(std::string(OBJ_DIR) + file);
+            std::cout << "load " << file << ": " << elapsedMs(loadStart) << " ms" << std::endl;
+            geometries.push_back(geometry);
+            names.push_back(file);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "skip " << file << ": " << e.what() << std::endl;
+        }
+    }
+
+    // 1 等待后台线程构建完成
+    auto waitStart = Clock::now();
+    for (auto geometry : geometries) {
+        while (geometry->getTriangleBVH() == nullptr) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    if (geometries.empty()) {
+        std::cerr << "no model loaded" << std::endl;
+        App->destroy();
+        return -1;
+    }
+    std::cout << "wait for background builds: " << elapsedMs(waitStart) << " ms" << std::endl << std::endl;
+
+    // 2 单个几何体
+    std::cout << "model                          tris   nodes  build(ms)    Mrays/s  hit%   speedup" << std::endl;
+    for (size_t i = 0; i < geometries.size(); i++) {
+        const TriangleBVH* bvh = geometries[i]->getTriangleBVH();
+        const glm::vec3& boundsMin = geometries[i]->getBoundsMin();
+        const glm::vec3& boundsMax = geometries[i]->getBoundsMax();
+
+        std::mt19937 random(1234);
+        std::vector<glm::vec3> origins(rayCount), directions(rayCount);
+        for (int r = 0; r < rayCount; r++) {
+            randomRay(random, boundsMin, boundsMax, origins[r], directions[r]);
+        }
+
+        int hits = 0;
+        auto start = Clock::now();
+        for (int r = 0; r < rayCount; r++) {
+            TriangleBVH::Hit hit;
+            hits += bvh->intersect(origins[r], directions[r], FLT_MAX, hit) ? 1 : 0;
+        }
+        double bvhMs = elapsedMs(start);
+
+        // 暴力求交只测少量射线，同时校验结果
+        int mismatches = 0;
+        start = Clock::now();
+        for (int r = 0; r < bruteForceRays; r++) {
+            float closest = FLT_MAX;
+            bool found = bruteForce(bvh, origins[r], directions[r], closest);
+            TriangleBVH::Hit hit;
+            bool bvhFound = bvh->intersect(origins[r], directions[r], FLT_MAX, hit);
+            if (found != bvhFound || (found && std::abs(closest - hit.t) > 1e-3f * std::max(1.0f, closest))) {
+                mismatches++;
+            }
+        }
+        double bruteMs = elapsedMs(start) / bruteForceRays;
+
+        printf("%-26s %9zu %7zu %10.2f %10.2f %5.1f %9.0fx\n", names[i].c_str(), bvh->getTriangleCount(), bvh->getNodeCount(),
+            bvh->getBuildTimeMs(), rayCount / bvhMs / 1000.0, 100.0 * hits / rayCount, bruteMs / (bvhMs / rayCount));
+        if (mismatches > 0) {
+            std::cerr << "  " << mismatches << " rays differ from brute force" << std::endl;
+        }
+    }
+
+    // 3 整个场景：模型缩放到单位大小后按网格摆放
+    Scene* scene = new Scene();
+    auto material = new WhiteMaterial();
+    const int grid = 8;
+    for (int x = 0; x < grid; x++) {
+        for (int z = 0; z < grid; z++) {
+            Geometry* geometry = geometries[(x * grid + z) % geometries.size()];
+            glm::vec3 size = geometry->getBoundsMax() - geometry->getBoundsMin();
+            float scale = 1.5f / std::max(std::max(size.x, size.y), std::max(size.z, 1e-6f));
+            auto mesh = new Mesh(geometry, material);
+            mesh->setScale(glm::vec3(scale));
+            mesh->setAngleY(static_cast<float>((x * 37 + z * 11) % 360));
+            mesh->setPosition(glm::vec3((x - grid / 2) * 2.0f, 0.0f, (z - grid / 2) * 2.0f)
+                - (geometry->getBoundsMin() + geometry->getBoundsMax()) * 0.5f * scale);
+            scene->addChild(mesh);
+        }
+    }
+
+    auto camera = new perspectiveCamera(60.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+    camera->mPosition = glm::vec3(0.0f, 12.0f, 14.0f);
+    camera->mUp = glm::normalize(glm::vec3(0.0f, 1.0f, -0.8f));
+    camera->mRight = glm::vec3(1.0f, 0.0f, 0.0f);
+
+    const int width = 1280;
+    const int height = 720;
+    Picker picker(scene);
+    picker.setViewport(width, height);
+    picker.update();
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> unitX(0.0f, static_cast<float>(width));
+    std::uniform_real_distribution<float> unitY(0.0f, static_cast<float>(height));
+    std::vector<glm::vec3> origins(rayCount), directions(rayCount);
+    for (int r = 0; r < rayCount; r++) {
+        picker.screenToRay(camera, unitX(random), unitY(random), origins[r], directions[r]);
+    }
+
+    int hits = 0;
+    auto start = Clock::now();
+    for (int r = 0; r < rayCount; r++) {
+        PickResult result;
+        hits += picker.pickRay(origins[r], directions[r], FLT_MAX, result) ? 1 : 0;
+    }
+    double singleMs = elapsedMs(start);
+    printf("\nscene (%d meshes) single thread: %.2f Mrays/s, hit %.1f%%\n", grid * grid, rayCount / singleMs / 1000.0, 100.0 * hits / rayCount);
+
+    // Picker 内部有复用的临时数组，每个线程一个
+    std::vector<Picker*> pickers(JobSystem::getThreadCount());
+    for (auto& p : pickers) {
+        p = new Picker(scene);
+        p->update();
+    }
+    std::atomic<int> parallelHits{ 0 };
+    start = Clock::now();
+    JobSystem::parallelFor(rayCount, 1024, [&](size_t begin, size_t end) {
+        Picker* local = pickers[JobSystem::getThreadIndex()];
+        int localHits = 0;
+        for (size_t r = begin; r < end; r++) {
+            PickResult result;
+            localHits += local->pickRay(origins[r], directions[r], FLT_MAX, result) ? 1 : 0;
+        }
+        parallelHits += localHits;
+    });
+    double parallelMs = elapsedMs(start);
+    printf("scene (%d meshes) %zu threads:    %.2f Mrays/s, hit %.1f%%\n", grid * grid, pickers.size(), rayCount / parallelMs / 1000.0,
+        100.0 * parallelHits.load() / rayCount);
+
+    for (auto p : pickers) {
+        delete p;
+    }
+    JobSystem::shutdown();
+    App->destroy();
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "imageCompare.h"
+#include <algorithm>
+#include <iostream>
+
+// 两种颜色的 YIQ 距离平方，最大值为 35215（纯黑与纯白）
+static double colorDelta(const Uint8* a, const Uint8* b) {
+    double r = a[0] - b[0];
+    double g = a[1] - b[1];
+    double bl = a[2] - b[2];
+    double y = r * 0.29889531 + g * 0.58662247 + bl * 0.11448223;
+    double i = r * 0.59597799 - g * 0.27417610 - bl * 0.32180189;
+    double q = r * 0.21147017 - g * 0.52261711 + bl * 0.31114694;
+    return 0.5053 * y * y + 0.299 * i * i + 0.1957 * q * q;
+}
+
+SDL_Surface* loadImage(const std::string& path) {
+    SDL_Surface* loaded = SDL_LoadBMP(path.c_str());
+    if (loaded == nullptr) {
+        return nullptr;
+    }
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (converted == nullptr) {
+        std::cerr << "ERROR[imageCompare]: 无法转换图片格式 " << path << ": " << SDL_GetError() << std::endl;
+    }
+    return converted;
+}
+
+ImageDiff compareImages(SDL_Surface* expected, SDL_Surface* actual, double pixelThreshold, SDL_Surface* diffImage) {
+    ImageDiff diff;
+    diff.width = actual->w;
+    diff.height = actual->h;
+    diff.sizeMatch = expected->w == actual->w && expected->h == actual->h;
+    if (!diff.sizeMatch) {
+        return diff;
+    }
+
+    const double maxDelta = 35215.0;
+    const double threshold = maxDelta * pixelThreshold * pixelThreshold;
+    bool writeDiff = diffImage != nullptr && diffImage->w == actual->w && diffImage->h == actual->h;
+
+    for (int y = 0; y < actual->h; y++) {
+        const Uint8* expectedRow = static_cast<const Uint8*>(expected->pixels) + y * expected->pitch;
+        const Uint8* actualRow = static_cast<const Uint8*>(actual->pixels) + y * actual->pitch;
+        Uint8* diffRow = writeDiff ? static_cast<Uint8*>(diffImage->pixels) + y * diffImage->pitch : nullptr;
+
+        for (int x = 0; x < actual->w; x++) {
+            const Uint8* a = expectedRow + x * 4;
+            const Uint8* b = actualRow + x * 4;
+            double delta = colorDelta(a, b);
+            diff.maxDelta = std::max(diff.maxDelta, delta / maxDelta);
+
+            bool different = delta > threshold;
+            if (different) {
+                diff.differentPixels++;
+            }
+
+            if (diffRow != nullptr) {
+                Uint8* target = diffRow + x * 4;
+                if (different) {
+                    target[0] = 255;
+                    target[1] = 0;
+                    target[2] = 0;
+                }
+                else {
+                    // 参考图的亮度，淡化到 [178, 255] 作为背景
+                    Uint8 gray = static_cast<Uint8>(178 + (a[0] * 0.299 + a[1] * 0.587 + a[2] * 0.114) * 0.3);
+                    target[0] = gray;
+                    target[1] = gray;
+                    target[2] = gray;
+                }
+                target[3] = 255;
+            }
+        }
+    }
+
+    size_t total = static_cast<size_t>(actual->w) * actual->h;
+    diff.differentRatio = total > 0 ? static_cast<double>(diff.differentPixels) / total : 0.0;
+    return diff;
+}
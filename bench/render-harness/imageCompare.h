@@ -0,0 +1,21 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string>
+
+// 图片比较：按 YIQ 色彩空间计算感知上的颜色差（与 pixelmatch 相同的加权），
+// 对驱动之间细微的光栅化 / 舍入差异不敏感，对颜色、形状的变化敏感
+struct ImageDiff {
+    bool sizeMatch{ false };
+    int width{ 0 };
+    int height{ 0 };
+    size_t differentPixels{ 0 };
+    double differentRatio{ 0.0 };           // differentPixels / 像素总数
+    double maxDelta{ 0.0 };                 // 最大的归一化颜色差（0 ~ 1）
+};
+
+// 读取 BMP 并转换为 RGBA32，失败返回 nullptr（调用者负责 SDL_FreeSurface）
+SDL_Surface* loadImage(const std::string& path);
+
+// pixelThreshold：单个像素的容差（0 ~ 1，归一化的 YIQ 距离），超过则记为不同
+// diffImage 不为空时写入差异图：参考图灰度淡化，不同的像素标红
+ImageDiff compareImages(SDL_Surface* expected, SDL_Surface* actual, double pixelThreshold, SDL_Surface* diffImage = nullptr);
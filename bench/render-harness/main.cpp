@@ -0,0 +1,508 @@
+// 离屏回归测试：依次运行 Project 下的示例，比较最后一帧画面与金标准图片，并检查帧时间是否回退
+// 1. 每个示例通过环境变量进入 RenderHarness 模式（见 include/Application/renderHarness.h）：
+//    窗口隐藏、关闭垂直同步、固定时间步长、注入鼠标拖动作为相机路径，跑完 --frames 帧后写出 <name>.bmp / <name>.json
+// 2. 画面按 YIQ 感知色差比较：单个像素超过 --pixel-threshold 记为不同，不同像素的比例超过 --max-diff 时失败，
+//    同时写出 <name>.diff.bmp；没有金标准图片时只提示，--update-golden 用本次结果生成
+// 3. 帧时间的 CPU / GPU p50、p90 写入 <out-dir>/timings.json（每个示例一行），可以作为以后的基线；
+//    --baseline 比较时，任一值变慢超过 --threshold（且绝对值超过 --min-delta-ms）记为回退
+// 4. 有示例失败、画面不一致或帧时间回退时返回 1，参数有误返回 2
+//
+// 用法：render-harness [--build-dir 目录] [--config Debug] [--golden-dir 目录] [--out-dir 目录] [--filter 子串]
+//                      [--frames N] [--warmup N] [--orbit dx,dy] [--pixel-threshold 0.1] [--max-diff 百分比]
+//                      [--baseline timings.json] [--threshold 百分比] [--min-delta-ms 毫秒] [--timeout 秒]
+//                      [--software] [--video-driver 名称] [--update-golden] [--list]
+//
+// Linux CI 上没有显示器时，用 Mesa 的 llvmpipe 软件渲染，并由 Xvfb 提供虚拟显示：
+//   xvfb-run -a -s "-screen 0 1920x1080x24" ./render-harness --software --baseline timings.json
+//   --software 设置 LIBGL_ALWAYS_SOFTWARE / GALLIUM_DRIVER=llvmpipe，并把 GL 版本覆盖为 4.6（示例需要 4.6 核心模式）
+#include "imageCompare.h"
+
+#include <SDL2/SDL_main.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// 示例列表：名称与 CMake 目标一致，目录相对于构建目录
+// 1.1-get-start 与 frame_test 没有使用 Application，不支持离屏模式
+struct Sample {
+    const char* name;
+    const char* directory;
+};
+
+static const Sample sSamples[] = {
+    { "1.2-get-Application",     "Project/1-framework/1.2-get-Application" },
+    { "1.3-use-shader",          "Project/1-framework/1.3-use-shader" },
+    { "1.4-use-texture",         "Project/1-framework/1.4-use-texture" },
+    { "1.5-use-camera",          "Project/1-framework/1.5-use-camera" },
+    { "1.6-event-callback",      "Project/1-framework/1.6-event-callback" },
+    { "1.7-model-framwork",      "Project/1-framework/1.7-model-framwork" },
+    { "obj_test",                "Project/2-read-objfile/obj_test" },
+    { "3.1-set-light",           "Project/3-light/3.1-set-light" },
+    { "3.2-duophy",              "Project/3-light/3.2-duophy" },
+    { "3.3-Materials",           "Project/3-light/3.3-Materials" },
+    { "3.4-Demo",                "Project/3-light/3.4-Demo" },
+    { "3.5-SpecularMask",        "Project/3-light/3.5-SpecularMask" },
+    { "3.6-dotLight",            "Project/3-light/3.6-dotLight" },
+    { "3.7-spotLight",           "Project/3-light/3.7-spotLight" },
+    { "3.8-MultiLight",          "Project/3-light/3.8-MultiLight" },
+    { "3.9-LightArray",          "Project/3-light/3.9-LightArray" },
+    { "3.10-Scene-IMGUI",        "Project/3-light/3.10-Scene-IMGUI" },
+    { "3.11-PBR",                "Project/3-light/3.11-PBR" },
+    { "3.12-PBR-Heart",          "Project/3-light/3.12-PBR-Heart" },
+    { "3.13-Blinn-Phong-Heart",  "Project/3-light/3.13-Blinn-Phong-Heart" },
+    { "4.1-Depth-test",          "Project/4-Advanced/4.1-Depth-test" },
+    { "4.2-Stencil-test",        "Project/4-Advanced/4.2-Stencil-test" },
+    { "4.3-Color-Blending",      "Project/4-Advanced/4.3-Color-Blending" },
+    { "4.4-PBR-Blend",           "Project/4-Advanced/4.4-PBR-Blend" },
+    { "4.5-Phong-Blend",         "Project/4-Advanced/4.5-Phong-Blend" },
+    { "4.6-FBO",                 "Project/4-Advanced/4.6-FBO" },
+    { "4.7-OIT",                 "Project/4-Advanced/4.7-OIT" },
+    { "stress-scene",            "bench/stress-scene" },
+};
+
+// 帧时间统计（毫秒），对应 RenderHarness 写出的 JSON
+struct Timings {
+    std::string name;
+    double cpuP50{ 0.0 };
+    double cpuP90{ 0.0 };
+    double gpuP50{ 0.0 };
+    double gpuP90{ 0.0 };
+};
+
+struct Options {
+    std::string buildDir{ HARNESS_BUILD_DIR };
+    std::string config{ HARNESS_CONFIG };
+    std::string goldenDir{ HARNESS_GOLDEN_DIR };
+    std::string outDir{ "render-harness-out" };
+    std::string filter;
+    std::string baselinePath;
+    std::string orbit{ "4,0" };
+    std::string videoDriver;
+    int frames{ 120 };
+    int warmup{ 10 };
+    int timeoutSeconds{ 300 };
+    double pixelThreshold{ 0.1 };
+    double maxDiff{ 0.005 };
+    double threshold{ 0.20 };
+    double minDeltaMs{ 0.5 };
+    bool software{ false };
+    bool updateGolden{ false };
+    bool listOnly{ false };
+};
+
+static void setEnv(const char* name, const std::string& value) {
+#ifdef _WIN32
+    _putenv_s(name, value.c_str());
+#else
+    setenv(name, value.c_str(), 1);
+#endif
+}
+
+static void makeDirectory(const std::string& path) {
+#ifdef _WIN32
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+}
+
+static bool fileExists(const std::string& path) {
+    std::ifstream file(path);
+    return file.good();
+}
+
+static bool copyFile(const std::string& from, const std::string& to) {
+    std::ifstream source(from, std::ios::binary);
+    std::ofstream target(to, std::ios::binary);
+    if (!source.is_open() || !target.is_open()) {
+        return false;
+    }
+    target << source.rdbuf();
+    return true;
+}
+
+// 可执行文件路径：多配置生成器（Visual Studio）下在 <config> 子目录中
+static std::string executablePath(const Options& options, const Sample& sample) {
+    std::string path = options.buildDir + "/" + sample.directory + "/";
+    if (!options.config.empty()) {
+        path += options.config + "/";
+    }
+    path += sample.name;
+#ifdef _WIN32
+    path += ".exe";
+#endif
+    return path;
+}
+
+// 在 JSON 中 "object":{ 之后查找 "key": 的数字（只解析 RenderHarness / writeTimings 写出的格式）
+static bool findNumber(const std::string& text, const std::string& object, const std::string& key, double& value) {
+    size_t position = 0;
+    if (!object.empty()) {
+        position = text.find("\"" + object + "\":{");
+        if (position == std::string::npos) {
+            return false;
+        }
+    }
+    position = text.find("\"" + key + "\":", position);
+    if (position == std::string::npos) {
+        return false;
+    }
+    const char* begin = text.c_str() + position + key.size() + 3;
+    char* end = nullptr;
+    value = std::strtod(begin, &end);
+    return end != begin;
+}
+
+static bool readTimings(const std::string& path, const std::string& name, Timings& timings) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    timings.name = name;
+    return findNumber(text, "cpuMs", "p50", timings.cpuP50) && findNumber(text, "cpuMs", "p90", timings.cpuP90)
+        && findNumber(text, "gpuMs", "p50", timings.gpuP50) && findNumber(text, "gpuMs", "p90", timings.gpuP90);
+}
+
+// 结果文件中的单个顶层数字，没有该项时返回 false
+static bool readNumber(const std::string& path, const std::string& key, double& value) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return findNumber(buffer.str(), "", key, value);
+}
+
+// 每个示例一行，格式与基线相同
+static bool writeTimings(const std::string& path, const std::vector<Timings>& results) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR[render-harness]: 无法写入 " << path << std::endl;
+        return false;
+    }
+    for (const auto& timings : results) {
+        file << "{\"name\":\"" << timings.name << "\",\"cpuP50\":" << timings.cpuP50 << ",\"cpuP90\":" << timings.cpuP90
+            << ",\"gpuP50\":" << timings.gpuP50 << ",\"gpuP90\":" << timings.gpuP90 << "}\n";
+    }
+    return true;
+}
+
+static bool readBaseline(const std::string& path, std::vector<Timings>& baseline) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR[render-harness]: 无法读取 " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t begin = line.find("\"name\":\"");
+        if (begin == std::string::npos) {
+            continue;
+        }
+        begin += 8;
+        size_t end = line.find('"', begin);
+        if (end == std::string::npos) {
+            continue;
+        }
+
+        Timings timings;
+        timings.name = line.substr(begin, end - begin);
+        findNumber(line, "", "cpuP50", timings.cpuP50);
+        findNumber(line, "", "cpuP90", timings.cpuP90);
+        findNumber(line, "", "gpuP50", timings.gpuP50);
+        findNumber(line, "", "gpuP90", timings.gpuP90);
+        baseline.push_back(timings);
+    }
+    return true;
+}
+
+// 变慢超过相对阈值且超过绝对阈值时记为回退（绝对阈值避免很短的帧被噪声误判）
+static bool regressed(double baseline, double current, const Options& options) {
+    return baseline > 0.0 && current - baseline > options.minDeltaMs && (current - baseline) / baseline > options.threshold;
+}
+
+static std::string compareTimings(const Timings& baseline, const Timings& current, const Options& options) {
+    struct Field {
+        const char* name;
+        double base;
+        double now;
+    };
+    const Field fields[] = {
+        { "cpu p50", baseline.cpuP50, current.cpuP50 },
+        { "cpu p90", baseline.cpuP90, current.cpuP90 },
+        { "gpu p50", baseline.gpuP50, current.gpuP50 },
+        { "gpu p90", baseline.gpuP90, current.gpuP90 },
+    };
+
+    std::string message;
+    char text[96];
+    for (const auto& field : fields) {
+        if (regressed(field.base, field.now, options)) {
+            snprintf(text, sizeof(text), "%s%s %.2f -> %.2f ms (%+.0f%%)", message.empty() ? "" : ", ",
+                field.name, field.base, field.now, (field.now - field.base) / field.base * 100.0);
+            message += text;
+        }
+    }
+    return message;
+}
+
+// 比较画面，返回 false 表示不一致；没有金标准图片时 message 说明原因并返回 true
+static bool compareGolden(const Options& options, const Sample& sample, const std::string& imagePath, std::string& message) {
+    std::string goldenPath = options.goldenDir + "/" + sample.name + ".bmp";
+    if (options.updateGolden) {
+        if (!copyFile(imagePath, goldenPath)) {
+            message = "cannot write " + goldenPath;
+            return false;
+        }
+        message = "golden updated";
+        return true;
+    }
+    if (!fileExists(goldenPath)) {
+        message = "no golden image";
+        return true;
+    }
+
+    SDL_Surface* expected = loadImage(goldenPath);
+    SDL_Surface* actual = loadImage(imagePath);
+    if (expected == nullptr || actual == nullptr) {
+        SDL_FreeSurface(expected);
+        SDL_FreeSurface(actual);
+        message = std::string("cannot load image: ") + SDL_GetError();
+        return false;
+    }
+
+    SDL_Surface* diffImage = SDL_CreateRGBSurfaceWithFormat(0, actual->w, actual->h, 32, SDL_PIXELFORMAT_RGBA32);
+    ImageDiff diff = compareImages(expected, actual, options.pixelThreshold, diffImage);
+    bool passed = diff.sizeMatch && diff.differentRatio <= options.maxDiff;
+
+    char text[128];
+    if (!diff.sizeMatch) {
+        snprintf(text, sizeof(text), "size %dx%d, golden %dx%d", actual->w, actual->h, expected->w, expected->h);
+    }
+    else {
+        snprintf(text, sizeof(text), "%.3f%% pixels differ (max delta %.3f)", diff.differentRatio * 100.0, diff.maxDelta);
+    }
+    message = text;
+
+    if (!passed && diffImage != nullptr && diff.sizeMatch) {
+        std::string diffPath = options.outDir + "/" + sample.name + ".diff.bmp";
+        SDL_SaveBMP(diffImage, diffPath.c_str());
+        message += ", see " + diffPath;
+    }
+
+    SDL_FreeSurface(diffImage);
+    SDL_FreeSurface(expected);
+    SDL_FreeSurface(actual);
+    return passed;
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--build-dir" && hasValue) {
+            options.buildDir = argv[++i];
+        }
+        else if (arg == "--config" && hasValue) {
+            options.config = argv[++i];
+        }
+        else if (arg == "--golden-dir" && hasValue) {
+            options.goldenDir = argv[++i];
+        }
+        else if (arg == "--out-dir" && hasValue) {
+            options.outDir = argv[++i];
+        }
+        else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        }
+        else if (arg == "--baseline" && hasValue) {
+            options.baselinePath = argv[++i];
+        }
+        else if (arg == "--orbit" && hasValue) {
+            options.orbit = argv[++i];
+        }
+        else if (arg == "--video-driver" && hasValue) {
+            options.videoDriver = argv[++i];
+        }
+        else if (arg == "--frames" && hasValue) {
+            options.frames = std::atoi(argv[++i]);
+        }
+        else if (arg == "--warmup" && hasValue) {
+            options.warmup = std::atoi(argv[++i]);
+        }
+        else if (arg == "--timeout" && hasValue) {
+            options.timeoutSeconds = std::atoi(argv[++i]);
+        }
+        else if (arg == "--pixel-threshold" && hasValue) {
+            options.pixelThreshold = std::atof(argv[++i]);
+        }
+        else if (arg == "--max-diff" && hasValue) {
+            options.maxDiff = std::atof(argv[++i]) / 100.0;
+        }
+        else if (arg == "--threshold" && hasValue) {
+            options.threshold = std::atof(argv[++i]) / 100.0;
+        }
+        else if (arg == "--min-delta-ms" && hasValue) {
+            options.minDeltaMs = std::atof(argv[++i]);
+        }
+        else if (arg == "--software") {
+            options.software = true;
+        }
+        else if (arg == "--update-golden") {
+            options.updateGolden = true;
+        }
+        else if (arg == "--list") {
+            options.listOnly = true;
+        }
+        else {
+            return false;
+        }
+    }
+    return options.frames > options.warmup && options.warmup >= 0;
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "usage: render-harness [--build-dir dir] [--config name] [--golden-dir dir] [--out-dir dir] [--filter text] "
+            "[--frames n] [--warmup n] [--orbit dx,dy] [--pixel-threshold 0-1] [--max-diff percent] "
+            "[--baseline timings.json] [--threshold percent] [--min-delta-ms ms] [--timeout seconds] "
+            "[--software] [--video-driver name] [--update-golden] [--list]" << std::endl;
+        return 2;
+    }
+
+    if (options.listOnly) {
+        for (const auto& sample : sSamples) {
+            std::cout << sample.name << "  " << executablePath(options, sample) << std::endl;
+        }
+        return 0;
+    }
+
+    std::vector<Timings> baseline;
+    if (!options.baselinePath.empty() && !readBaseline(options.baselinePath, baseline)) {
+        return 2;
+    }
+
+    // 只用到 SDL 的图片读写，不需要初始化视频子系统
+    if (SDL_Init(0) < 0) {
+        std::cerr << "ERROR[render-harness]: SDL 初始化失败: " << SDL_GetError() << std::endl;
+        return 2;
+    }
+
+    makeDirectory(options.outDir);
+    if (options.updateGolden) {
+        makeDirectory(options.goldenDir);
+    }
+
+    //1 子进程通过环境变量进入离屏模式
+    setEnv("ENGINE_HARNESS_FRAMES", std::to_string(options.frames));
+    setEnv("ENGINE_HARNESS_WARMUP", std::to_string(options.warmup));
+    setEnv("ENGINE_HARNESS_ORBIT", options.orbit);
+    // GL 错误检查：DEBUG 构建也用 Sampled 模式，保持检查但不让每次调用的 glGetError 扭曲帧时间（可以用环境变量覆盖）
+    if (std::getenv("ENGINE_GL_DEBUG") == nullptr) {
+        setEnv("ENGINE_GL_DEBUG", "sampled:30");
+    }
+    if (options.software) {
+        setEnv("LIBGL_ALWAYS_SOFTWARE", "1");
+        setEnv("GALLIUM_DRIVER", "llvmpipe");
+        setEnv("MESA_GL_VERSION_OVERRIDE", "4.6");
+        setEnv("MESA_GLSL_VERSION_OVERRIDE", "460");
+    }
+    if (!options.videoDriver.empty()) {
+        setEnv("SDL_VIDEODRIVER", options.videoDriver);
+    }
+
+    int failures = 0;
+    int ran = 0;
+    std::vector<Timings> results;
+    printf("%-26s %-6s %10s %10s %10s %10s  %s\n", "sample", "result", "cpu p50", "cpu p90", "gpu p50", "gpu p90", "details");
+    for (const auto& sample : sSamples) {
+        if (!options.filter.empty() && std::string(sample.name).find(options.filter) == std::string::npos) {
+            continue;
+        }
+        ran++;
+
+        //2 运行示例
+        std::string executable = executablePath(options, sample);
+        std::string prefix = options.outDir + "/" + sample.name;
+        std::remove((prefix + ".bmp").c_str());
+        std::remove((prefix + ".json").c_str());
+        setEnv("ENGINE_HARNESS_OUTPUT", prefix);
+
+        if (!fileExists(executable)) {
+            printf("%-26s %-6s %10s %10s %10s %10s  %s not found\n", sample.name, "FAIL", "-", "-", "-", "-", executable.c_str());
+            failures++;
+            continue;
+        }
+
+#ifdef _WIN32
+        std::string command = "\"\"" + executable + "\"\"";
+#else
+        std::string command = "timeout " + std::to_string(options.timeoutSeconds) + " \"" + executable + "\"";
+#endif
+        int status = std::system(command.c_str());
+
+        Timings timings;
+        if (!readTimings(prefix + ".json", sample.name, timings) || !fileExists(prefix + ".bmp")) {
+            printf("%-26s %-6s %10s %10s %10s %10s  exited with %d without results\n", sample.name, "FAIL", "-", "-", "-", "-", status);
+            failures++;
+            continue;
+        }
+        results.push_back(timings);
+
+        //3 画面与帧时间
+        std::string details;
+        bool passed = compareGolden(options, sample, prefix + ".bmp", details);
+
+        // 示例运行中报告的 GL 错误（Sampled 模式每 N 帧检查一次，不影响帧时间）
+        double glErrors = 0.0;
+        if (readNumber(prefix + ".json", "glErrors", glErrors) && glErrors > 0.0) {
+            passed = false;
+            details += "; " + std::to_string(static_cast<long long>(glErrors)) + " GL errors";
+        }
+
+        auto found = std::find_if(baseline.begin(), baseline.end(), [&sample](const Timings& base) {
+            return base.name == sample.name;
+        });
+        if (found != baseline.end()) {
+            std::string regression = compareTimings(*found, timings, options);
+            if (!regression.empty()) {
+                passed = false;
+                details += "; slower: " + regression;
+            }
+        }
+        else if (!options.baselinePath.empty()) {
+            details += "; not in baseline";
+        }
+
+        if (!passed) {
+            failures++;
+        }
+        printf("%-26s %-6s %10.2f %10.2f %10.2f %10.2f  %s\n", sample.name, passed ? "ok" : "FAIL",
+            timings.cpuP50, timings.cpuP90, timings.gpuP50, timings.gpuP90, details.c_str());
+        fflush(stdout);
+    }
+
+    std::string timingsPath = options.outDir + "/timings.json";
+    writeTimings(timingsPath, results);
+    printf("\n%d / %d samples passed, timings written to %s\n", ran - failures, ran, timingsPath.c_str());
+
+    SDL_Quit();
+    return failures > 0 ? 1 : 0;
+}
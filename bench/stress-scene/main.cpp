@@ -0,0 +1,435 @@
+// 压力测试场景：用 SceneGenerator 生成大规模场景，测量 Renderer 随场景规模的扩展性
+// 1. 单个场景（默认）：按参数生成场景，用轨迹球相机交互浏览；也可以由 render-harness 在离屏模式下运行
+// 2. 扫描（--sweep 参数=值1,值2,...，可以给多个，依次扫描，其余参数保持基础值）：
+//    每个取值重新生成场景，预热后测量 --frames 帧，输出每帧的 CPU 提交耗时、帧时间、GPU 耗时、
+//    绘制次数、三角形数与吞吐量（每秒 Mesh 数 / 三角形数），以及相对第一个取值的扩展效率，写入 CSV 便于画曲线
+//    扫描时关闭垂直同步并隐藏窗口；Linux CI 上与 render-harness 相同，在 xvfb-run 下使用 llvmpipe 运行
+// 3. --path scene 使用 Renderer::render(Scene*, ...)（渲染队列、剔除、排序，使用第一个平行光与全部点光源）；
+//    --path list 使用 Renderer::render(meshes, ...)（使用材质自己的 shader，另外使用第一个聚光灯）
+// 4. --render-thread（只用于单个场景、--path scene）：渲染放到渲染线程（Application::startRenderThread），
+//    主线程更新相机并生成帧快照，两者并行；交互时每秒输出帧时间的平均值 / 标准差 / 最大值，
+//    渲染线程模式下另外输出模拟、提交与两边等待的时间，与不加这个参数的结果对比
+//
+// 用法：stress-scene [--seed N] [--meshes N] [--geometries N] [--phong N] [--pbr N] [--white N]
+//                    [--transparent 0-1] [--depth N] [--dir-lights N] [--point-lights N] [--spot-lights N] [--spacing F]
+//                    [--path scene|list] [--no-cull] [--render-thread] [--sweep 参数=值,...] [--frames N] [--warmup N] [--csv 文件]
+//   可扫描的参数：meshes geometries phong pbr white transparent depth dir-lights point-lights spot-lights
+//   例：stress-scene --sweep meshes=1000,2000,4000,8000,16000,32000 --sweep point-lights=1,4,16,64 --csv sweep.csv
+#include "core.h"
+#include "Application.h"
+#include "checkError.h"
+
+#include "../../include/camera/cameraType/perspectiveCamera.h"
+#include "../../include/camera/cameraControl/trackBallCameraControl.h"
+#include "../../include/glframework/sceneGenerator.h"
+#include "../../include/glframework/sceneAllocator.h"
+#include "../../include/glframework/renderStats.h"
+#include "../../include/glframework/renderer/renderer.h"
+
+#include <SDL2/SDL_main.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct Options {
+    SceneGeneratorConfig config{};
+    bool listPath{ false };
+    bool frustumCulling{ true };
+    bool renderThread{ false };
+    int frames{ 60 };
+    int warmup{ 10 };
+    std::string csvPath{ "stress-sweep.csv" };
+    std::vector<std::pair<std::string, std::vector<double>>> sweeps{};
+};
+
+// 扫描的一个点
+struct SweepResult {
+    std::string param;
+    double value{ 0.0 };
+    size_t meshes{ 0 };
+    size_t transparent{ 0 };
+    size_t sceneTriangles{ 0 };
+    uint64_t drawCalls{ 0 };
+    uint64_t triangles{ 0 };
+    double submitMs{ 0.0 };         // renderer->render 的 CPU 耗时（p50）
+    double frameMs{ 0.0 };          // 相邻两帧之间的时间（p50）
+    double frameP90Ms{ 0.0 };
+    double gpuMs{ 0.0 };            // render 前后 GL_TIMESTAMP 之差（p50）
+    double meshesPerSecond{ 0.0 };
+    double trianglesPerSecond{ 0.0 };
+    double efficiency{ 1.0 };       // 每个 Mesh 的成本相对第一个点的比值的倒数，1 表示线性扩展
+};
+
+perspectiveCamera* camera = nullptr;
+TrackBallCameraControl* cameraControl = nullptr;
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+// 参数名与配置项的对应，返回 false 表示没有这个参数
+static bool setParam(SceneGeneratorConfig& config, const std::string& name, double value) {
+    int count = static_cast<int>(value);
+    if (name == "seed") config.seed = static_cast<uint32_t>(value);
+    else if (name == "meshes") config.meshCount = count;
+    else if (name == "geometries") config.geometryCount = count;
+    else if (name == "phong") config.phongMaterialCount = count;
+    else if (name == "pbr") config.pbrMaterialCount = count;
+    else if (name == "white") config.whiteMaterialCount = count;
+    else if (name == "transparent") config.transparentRatio = static_cast<float>(value);
+    else if (name == "depth") config.hierarchyDepth = count;
+    else if (name == "dir-lights") config.directionalLightCount = count;
+    else if (name == "point-lights") config.pointLightCount = count;
+    else if (name == "spot-lights") config.spotLightCount = count;
+    else if (name == "spacing") config.spacing = static_cast<float>(value);
+    else return false;
+    return true;
+}
+
+// "meshes=1000,2000,4000"
+static bool parseSweep(const std::string& text, Options& options) {
+    size_t equal = text.find('=');
+    if (equal == std::string::npos) {
+        return false;
+    }
+    std::string name = text.substr(0, equal);
+    SceneGeneratorConfig probe;
+    if (!setParam(probe, name, 0.0)) {
+        return false;
+    }
+
+    std::vector<double> values;
+    size_t start = equal + 1;
+    while (start < text.size()) {
+        size_t comma = text.find(',', start);
+        std::string item = text.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        if (!item.empty()) {
+            values.push_back(std::atof(item.c_str()));
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    if (values.empty()) {
+        return false;
+    }
+    options.sweeps.emplace_back(name, values);
+    return true;
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg.size() > 2 && arg.compare(0, 2, "--") == 0 && hasValue && setParam(options.config, arg.substr(2), std::atof(argv[i + 1]))) {
+            i++;
+        }
+        else if (arg == "--path" && hasValue) {
+            std::string path = argv[++i];
+            if (path != "scene" && path != "list") {
+                return false;
+            }
+            options.listPath = path == "list";
+        }
+        else if (arg == "--no-cull") {
+            options.frustumCulling = false;
+        }
+        else if (arg == "--render-thread") {
+            options.renderThread = true;
+        }
+        else if (arg == "--sweep" && hasValue) {
+            if (!parseSweep(argv[++i], options)) {
+                return false;
+            }
+        }
+        else if (arg == "--frames" && hasValue) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--warmup" && hasValue) {
+            options.warmup = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--csv" && hasValue) {
+            options.csvPath = argv[++i];
+        }
+        else {
+            return false;
+        }
+    }
+    // 扫描在主线程上用 GL 查询计时；渲染线程只消费 render(Scene*, ...) 路径的快照
+    return !options.renderThread || (options.sweeps.empty() && !options.listPath);
+}
+
+// 按场景半径放置相机（看向原点），远裁剪面包住整个场景
+static void prepareCamera(const GeneratedScene& scene) {
+    delete camera;
+    camera = new perspectiveCamera(60.0f, (float)App->getWidth() / (float)App->getHeight(), 0.1f, scene.mRadius * 4.0f);
+    camera->mPosition = glm::vec3(0.0f, scene.mRadius * 0.5f, scene.mRadius * 1.5f);
+    cameraControl->setCamera(camera);
+}
+
+static Renderer* createRenderer(const Options& options) {
+    std::string shaderDir = SHADER_DIR;
+    Renderer* renderer = new Renderer(
+        shaderDir + SceneGenerator::getPhongVertexPath(), shaderDir + SceneGenerator::getPhongFragmentPath(),
+        shaderDir + SceneGenerator::getWhiteVertexPath(), shaderDir + SceneGenerator::getWhiteFragmentPath(),
+        shaderDir + SceneGenerator::getPBRVertexPath(), shaderDir + SceneGenerator::getPBRFragmentPath(),
+        SceneGenerator::getShaderMacros(options.config));
+    renderer->getRenderQueue().setFrustumCulling(options.frustumCulling);
+    renderer->setClearColor(glm::vec3(0.1f));
+    return renderer;
+}
+
+static void renderScene(Renderer* renderer, const GeneratedScene& scene, bool listPath) {
+    if (listPath) {
+        renderer->render(scene.mMeshes, camera, scene.mDirectionalLights[0], scene.mPointLights, scene.mSpotLights[0], scene.mAmbientLight);
+    }
+    else {
+        renderer->render(scene.mScene, camera, scene.mDirectionalLights[0], scene.mPointLights, scene.mAmbientLight);
+    }
+}
+
+static void printSummary(const SceneGeneratorConfig& config, const GeneratedScene& scene) {
+    printf("seed %u: %zu meshes (%zu transparent), %zu geometries, %zu materials, depth %d, lights %d dir / %d point / %d spot, %zu triangles\n",
+        config.seed, scene.mMeshes.size(), scene.mTransparentCount, scene.mGeometries.size(), scene.mMaterials.size(),
+        config.hierarchyDepth, config.directionalLightCount, config.pointLightCount, config.spotLightCount, scene.mTriangleCount);
+}
+
+// 扫描中的一个点：生成场景，预热后测量；窗口被关闭时返回 false
+static bool measure(Options options, const std::string& param, double value, SweepResult& result) {
+    setParam(options.config, param, value);
+    GeneratedScene* scene = SceneGenerator::generate(options.config);
+    Renderer* renderer = createRenderer(options);
+    prepareCamera(*scene);
+
+    int total = options.warmup + options.frames;
+    std::vector<GLuint> queries(total * 2);
+    glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+
+    std::vector<double> submitMs;
+    std::vector<double> frameMs;
+    uint64_t drawCalls = 0;
+    uint64_t triangles = 0;
+    bool running = true;
+    Clock::time_point lastFrame = Clock::now();
+    for (int frame = 0; frame < total; frame++) {
+        glQueryCounter(queries[frame * 2], GL_TIMESTAMP);
+        Clock::time_point start = Clock::now();
+        renderScene(renderer, *scene, options.listPath);
+        double submit = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        glQueryCounter(queries[frame * 2 + 1], GL_TIMESTAMP);
+
+        if (!App->update()) {
+            running = false;
+            break;
+        }
+        Clock::time_point now = Clock::now();
+        if (frame >= options.warmup) {
+            submitMs.push_back(submit);
+            frameMs.push_back(std::chrono::duration<double, std::milli>(now - lastFrame).count());
+            // RenderStats::endFrame 已在 update 中调用，getFrame 为刚结束的这一帧
+            drawCalls += RenderStats::getFrame()[RenderCounter::DrawCalls];
+            triangles += RenderStats::getFrame()[RenderCounter::Triangles];
+        }
+        lastFrame = now;
+    }
+
+    // 结束后一次性读取时间戳，测量过程中不等待 GPU
+    glFinish();
+    std::vector<double> gpuMs;
+    for (int frame = options.warmup; running && frame < total; frame++) {
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(queries[frame * 2], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(queries[frame * 2 + 1], GL_QUERY_RESULT, &end);
+        gpuMs.push_back(static_cast<double>(end - begin) / 1e6);
+    }
+    glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+
+    result.param = param;
+    result.value = value;
+    result.meshes = scene->mMeshes.size();
+    result.transparent = scene->mTransparentCount;
+    result.sceneTriangles = scene->mTriangleCount;
+    if (!frameMs.empty()) {
+        result.drawCalls = drawCalls / frameMs.size();
+        result.triangles = triangles / frameMs.size();
+    }
+    result.submitMs = percentile(submitMs, 50.0);
+    result.frameMs = percentile(frameMs, 50.0);
+    result.frameP90Ms = percentile(frameMs, 90.0);
+    result.gpuMs = percentile(gpuMs, 50.0);
+    if (result.frameMs > 0.0) {
+        result.meshesPerSecond = result.meshes * 1000.0 / result.frameMs;
+        result.trianglesPerSecond = result.triangles * 1000.0 / result.frameMs;
+    }
+
+    delete renderer;
+    delete scene;
+    return running;
+}
+
+static int runSweeps(const Options& options) {
+    std::ofstream csv(options.csvPath);
+    if (!csv.is_open()) {
+        std::cerr << "ERROR[stress-scene]: 无法写入 " << options.csvPath << std::endl;
+        return 2;
+    }
+    csv << "param,value,meshes,transparent,sceneTriangles,drawCalls,triangles,submitMsP50,frameMsP50,frameMsP90,gpuMsP50,"
+        "meshesPerSecond,trianglesPerSecond,efficiency\n";
+
+    // 扫描时测量真实的帧时间：关闭垂直同步，隐藏窗口
+    App->setSwapMode(Application::SwapMode::Off);
+    SDL_HideWindow(App->getWindow());
+
+    for (const auto& sweep : options.sweeps) {
+        printf("\nsweep %s (%s path)\n", sweep.first.c_str(), options.listPath ? "list" : "scene");
+        printf("%10s %8s %9s %10s %10s %10s %10s %10s %12s %10s\n", "value", "meshes", "draws", "triangles",
+            "submit ms", "frame ms", "gpu ms", "Mmesh/s", "Mtri/s", "scaling");
+
+        double firstCostPerMesh = 0.0;
+        for (double value : sweep.second) {
+            SweepResult result;
+            if (!measure(options, sweep.first, value, result)) {
+                std::cerr << "ERROR[stress-scene]: 窗口已关闭，扫描中止" << std::endl;
+                return 1;
+            }
+
+            // 扩展效率：每个 Mesh 的帧时间相对第一个点，1 表示线性，小于 1 表示开始失去扩展性
+            double costPerMesh = result.meshes > 0 ? result.frameMs / result.meshes : 0.0;
+            if (firstCostPerMesh <= 0.0) {
+                firstCostPerMesh = costPerMesh;
+            }
+            result.efficiency = costPerMesh > 0.0 ? firstCostPerMesh / costPerMesh : 0.0;
+
+            printf("%10g %8zu %9llu %10llu %10.3f %10.3f %10.3f %10.2f %12.2f %9.2fx\n", result.value, result.meshes,
+                (unsigned long long)result.drawCalls, (unsigned long long)result.triangles, result.submitMs, result.frameMs,
+                result.gpuMs, result.meshesPerSecond / 1e6, result.trianglesPerSecond / 1e6, result.efficiency);
+            fflush(stdout);
+
+            csv << result.param << ',' << result.value << ',' << result.meshes << ',' << result.transparent << ','
+                << result.sceneTriangles << ',' << result.drawCalls << ',' << result.triangles << ','
+                << result.submitMs << ',' << result.frameMs << ',' << result.frameP90Ms << ',' << result.gpuMs << ','
+                << result.meshesPerSecond << ',' << result.trianglesPerSecond << ',' << result.efficiency << '\n';
+            csv.flush();
+        }
+    }
+    printf("\nresults written to %s\n", options.csvPath.c_str());
+    return 0;
+}
+
+// 每秒输出一次帧节奏：帧时间的平均值 / 标准差 / 最大值（最近 120 帧），渲染线程模式下加上两个线程各自的耗时
+static void printPacing(bool threaded) {
+    FramePacer::Stats pacing = App->getFramePacer().getStats();
+    printf("frame %.2f ms avg, %.2f ms stddev, %.2f ms max", pacing.averageFrameMs, pacing.frameStdDevMs, pacing.maxFrameMs);
+    if (threaded) {
+        RenderThread::Stats stats = App->getRenderThreadStats();
+        printf(" | simulation %.2f ms, render %.2f ms, main wait %.2f ms, render idle %.2f ms",
+            stats.simulationMs, stats.renderMs, stats.mainWaitMs, stats.renderIdleMs);
+    }
+    printf("\n");
+}
+
+static int runInteractive(const Options& options) {
+    GeneratedScene* scene = SceneGenerator::generate(options.config);
+    Renderer* renderer = createRenderer(options);
+    prepareCamera(*scene);
+    printSummary(options.config, *scene);
+
+    // 渲染线程模式：主线程用自己的渲染队列生成快照，渲染线程只提交；启动失败（离屏回归测试模式）时仍在主线程渲染
+    bool threaded = options.renderThread &&
+        App->startRenderThread([renderer](const FrameSnapshot& snapshot) { renderer->render(snapshot); });
+    RenderQueue snapshotQueue;
+    snapshotQueue.setFrustumCulling(options.frustumCulling);
+
+    Clock::time_point lastReport = Clock::now();
+    while (App->update()) {
+        cameraControl->update();
+        if (threaded) {
+            FrameSnapshot& snapshot = App->beginSnapshot();
+            snapshot.capture(snapshotQueue, scene->mScene, camera,
+                scene->mDirectionalLights[0], scene->mPointLights, scene->mAmbientLight);
+            App->submitSnapshot();
+        }
+        else {
+            renderScene(renderer, *scene, options.listPath);
+        }
+
+        Clock::time_point now = Clock::now();
+        if (now - lastReport >= std::chrono::seconds(1)) {
+            printPacing(threaded);
+            lastReport = now;
+        }
+    }
+
+    // 渲染器的 GL 资源在主线程释放，先收回上下文
+    App->stopRenderThread();
+    delete renderer;
+    delete scene;
+    return 0;
+}
+
+void onKeyboard(int scancode, int sym, int state, int mod) {
+    if (state == SDL_PRESSED && sym == SDLK_ESCAPE) {
+        App->quit();
+    }
+    cameraControl->onKey(scancode, state, mod);
+}
+
+void OnMouseButton(int button, int state, int x, int y, int /*mod*/) {
+    App->getCursorPosition(&x, &y);
+    cameraControl->onMouse(button, state, x, y);
+}
+
+void OnMouseMotion(int xpos, int ypos, int /*dx*/, int /*dy*/, int /*buttonState*/) {
+    cameraControl->onCursor(xpos, ypos);
+}
+
+void OnMouseWheel(int /*scrollX*/, int scrollY) {
+    cameraControl->onScroll(scrollY);
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "usage: stress-scene [--seed n] [--meshes n] [--geometries n] [--phong n] [--pbr n] [--white n] "
+            "[--transparent ratio] [--depth n] [--dir-lights n] [--point-lights n] [--spot-lights n] [--spacing f] "
+            "[--path scene|list] [--no-cull] [--render-thread] [--sweep param=v1,v2,...] [--frames n] [--warmup n] [--csv file]" << std::endl;
+        return 2;
+    }
+
+    if (!App->init(1280, 720, "Stress Scene")) {
+        std::cout << "Application init failed!" << std::endl;
+        return -1;
+    }
+    GL_CALL(glViewport(0, 0, App->getWidth(), App->getHeight()));
+
+    App->setKeyBoardCallback(onKeyboard);
+    App->setMouseButtonCallback(OnMouseButton);
+    App->setMouseMotionCallback(OnMouseMotion);
+    App->setMouseWheelCallback(OnMouseWheel);
+
+    cameraControl = new TrackBallCameraControl();
+    cameraControl->setSensitivity(0.4f);
+
+    int result = options.sweeps.empty() ? runInteractive(options) : runSweeps(options);
+
+    // 场景节点在 SceneGenerator 中已释放，这里释放池本身保留的资源
+    SceneAllocator::releaseAll();
+    delete cameraControl;
+    delete camera;
+    App->destroy();
+    return result;
+}
@@ -4,6 +4,9 @@
 #include <SDL2/SDL.h>
 #include <glad/glad.h>
 #include <functional>
+#include "renderHarness.h"
+#include "framePacer.h"
+#include "renderThread.h"
 
 #define App Application::getInstance()  // һ꣬
 
@@ -16,6 +19,15 @@ public:
     using MouseMotionCallback = std::function<void(int x, int y, int dx, int dy, int state)>;
     using MouseWheelCallback = std::function<void(int x, int y)>;
 
+    // ػ淽ʽ
+    // ContinuousÿѭԭΪ
+    // OnDemandֻ RedrawTracker Ҫ֡ʱأ SDL_WaitEventֹĻ治ռ CPU / GPU
+    //   ơ任¼Զǣı仭Ĵ루粻 Object Ķƹ markDirty
+    enum class RedrawMode {
+        Continuous,
+        OnDemand
+    };
+
     // ģʽ
     static Application* getInstance();
 
@@ -32,9 +44,43 @@ public:
     // ˳Ӧ
     void quit() { mRunning = false; }
 
+    // ػ淽ʽ ENGINE_REDRAWcontinuous | ondemandȣعģʽ Continuous
+    void setRedrawMode(RedrawMode mode);
+    RedrawMode getRedrawMode() const { return mRedrawMode; }
+
+    // ݱ仯OnDemand ģʽ֮ frames ֡ử
+    void markDirty(int frames = 1);
+
+    // ֡ࣨ FramePacerʽ֡ƣ0 رգŶ֡ޣ-1 رգ
+    // عģʽ²ʹãʵ֡ʱ
+    // Ⱦ߳ģʽתȾ߳һ֡ãsetSwapMode Ƿ truegetFramePacer Ķȡ߳
+    using SwapMode = FramePacer::SwapMode;
+    bool setSwapMode(SwapMode mode);
+    void setFrameLimit(double fps);
+    void setMaxQueuedFrames(int frames);
+    const FramePacer& getFramePacer() const { return mPacer; }
+
+    // Ⱦ߳ģʽ RenderThreadGL ĽȾ̣߳߳ÿ֡ beginSnapshot -> ³capture -> submitSnapshot
+    // Ⱦ̶߳ÿݿյ callbackupdate ֻ¼֡ࡢ֡ͳƶȾ߳
+    // 1. ̲߳ GL ģGL ã細ڴСصе glViewport JobSystem::runOnMainThread Ⱦ̣߳
+    //    첽صϴȾִ߳Уص update ̣߳JobSystem::pumpSimulationThreadֱ޸ĳ
+    // 2. ޸ġɾõļ塢shader ֮ǰ flushRenderThreadڿиֱ޸ģ
+    // 3. ֧ ImGui֡״ֻ̬һ߳ʹãعģʽ
+    using RenderCallback = RenderThread::RenderCallback;
+    bool startRenderThread(RenderCallback callback);
+    void stopRenderThread();
+    bool isRenderThreadRunning() const { return mRenderThread.isRunning(); }
+    FrameSnapshot& beginSnapshot() { return mRenderThread.acquire(); }
+    void submitSnapshot() { mRenderThread.publish(mPacer.takeInput()); }
+    void flushRenderThread() { mRenderThread.flush(); }
+    RenderThread::Stats getRenderThreadStats() const { return mRenderThread.getStats(); }
+
     // ȡλ
     void getCursorPosition(int* x, int* y);
 
+    // ȡʱ䣨룩عģʽ°֡ŷع̶ʱ䣬ٶ޹
+    Uint32 getTicks() const;
+
     // ص÷
     void setResizeCallback(ResizeCallback callback) { mResizeCallback = callback; }
     void setKeyBoardCallback(KeyBoardCallback callback) { mKeyBoardCallback = callback; }
@@ -49,6 +95,13 @@ public:
     int getWidth() const { return mWidth; }
     int getHeight() const { return mHeight; }
 
+private:
+    // һ¼OnDemand ģʽͬʱػ
+    void handleEvent(const SDL_Event& event);
+
+    // OnDemand ģʽûҪ֡ʱȴ¼
+    void waitForRedraw();
+
 private:
     // ģʽ˽й캯
     Application();
@@ -65,6 +118,17 @@ private:
     int mWidth;
     int mHeight;
     bool mRunning;
+    RedrawMode mRedrawMode{ RedrawMode::Continuous };
+    bool mRedrawModeFromEnv{ false };
+
+    // عԣɻ
+    RenderHarness mHarness;
+
+    // ֡ӳ
+    FramePacer mPacer;
+
+    // Ⱦ̣߳ѡ
+    RenderThread mRenderThread;
 
     // صԱ
     ResizeCallback mResizeCallback;
@@ -0,0 +1,125 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <glad/glad.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// 帧节奏控制：交换方式、帧率限制、排队帧数上限与输入延迟测量，由 Application 在交换缓冲区之后调用
+// 1. 交换方式：Off（0，立即交换）、VSync（1）、Adaptive（-1，错过垂直同步时立即交换，不支持时退回 VSync）
+// 2. 帧率限制：先 sleep 到截止时间前 spinMs，再自旋到截止时间（系统 sleep 的精度只有 1 ~ 15ms）；
+//    落后超过一帧时不追赶，从当前时间重新计时
+// 3. 排队帧数上限：每次交换后插入 glFenceSync，排队的栅栏多于 N 个时 glClientWaitSync 等待最早的一个；
+//    驱动默认可以排队 2 ~ 3 帧，每一帧都会让输入到画面多等一帧；N = 0 时每帧都等 GPU 执行完
+// 4. 输入延迟：记录一帧内第一条输入事件的时间戳，到渲染这一帧的交换返回为止（N = 0 时为 GPU 执行完），
+//    事件时间戳只有毫秒精度
+// 5. 帧时间：最近 FRAME_WINDOW 帧的平均值、标准差与最大值，衡量帧节奏是否平稳
+// Application 在交换之后依次：afterSwap（测量、等待）-> 处理事件 -> 渲染，等待之后才读取输入，输入尽量新
+// 渲染线程模式（RenderThread）：输入在主线程处理，takeInput 取出后随帧快照交给渲染线程，由 afterSwap(&input) 结算；
+// afterSwap 在渲染线程调用，设置类接口也要在渲染线程调用，getStats 与读取设置的接口可以在任意线程调用（设置项是原子变量）
+// 环境变量：ENGINE_SWAP（off | vsync | adaptive）、ENGINE_FPS_LIMIT（帧率，0 关闭）、ENGINE_MAX_QUEUED_FRAMES（-1 关闭）
+class FramePacer {
+public:
+    enum class SwapMode : int {
+        Off = 0,
+        VSync = 1,
+        Adaptive = -1
+    };
+
+    struct Stats {
+        double latencyMs{ 0.0 };            // 最近一次有输入的帧的输入延迟
+        double averageLatencyMs{ 0.0 };     // 最近 LATENCY_WINDOW 个样本
+        double maxLatencyMs{ 0.0 };
+        double frameMs{ 0.0 };              // 相邻两次交换之间的时间
+        double fenceWaitMs{ 0.0 };          // 本帧等待栅栏的时间
+        double limiterWaitMs{ 0.0 };        // 本帧帧率限制等待的时间
+        int queuedFrames{ 0 };              // 等待之后还在排队的帧数
+        uint64_t latencySamples{ 0 };
+
+        double averageFrameMs{ 0.0 };       // 最近 FRAME_WINDOW 帧的帧时间
+        double frameStdDevMs{ 0.0 };
+        double maxFrameMs{ 0.0 };
+        uint64_t frameSamples{ 0 };
+    };
+
+    // 一帧的第一条输入：在 SDL 队列中等待的时间 + 处理的时刻
+    struct InputSample {
+        bool valid{ false };
+        double queueMs{ 0.0 };
+        std::chrono::steady_clock::time_point handled{};
+    };
+
+    FramePacer() = default;
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // 需要当前线程有 GL 上下文；Adaptive 不支持时退回 VSync 并返回 false
+    bool setSwapMode(SwapMode mode);
+    SwapMode getSwapMode() const { return mSwapMode.load(std::memory_order_relaxed); }
+
+    // 目标帧率，0 关闭
+    void setFrameLimit(double fps);
+    double getFrameLimit() const { return mFrameLimit.load(std::memory_order_relaxed); }
+
+    // 截止时间前多久开始自旋（毫秒）
+    void setSpinMs(double ms) { mSpinMs = ms > 0.0 ? ms : 0.0; }
+
+    // 排队帧数上限，-1 关闭（由驱动决定）
+    void setMaxQueuedFrames(int frames);
+    int getMaxQueuedFrames() const { return mMaxQueuedFrames.load(std::memory_order_relaxed); }
+
+    // 读取环境变量（覆盖程序中的设置）
+    void configureFromEnvironment();
+
+    // 处理输入事件时调用（SDL 事件时间戳，毫秒）
+    void onInput(Uint32 timestamp);
+
+    // 取出并清空本帧的输入（与 onInput 在同一线程调用）
+    InputSample takeInput();
+
+    // 交换缓冲区之后调用：测量输入延迟，等待栅栏，限制帧率
+    // input 为空时结算 onInput 记录的输入，否则结算 input（这一帧快照携带的输入）
+    void afterSwap(const InputSample* input = nullptr);
+
+    // 删除 GL 上下文之前调用：删除未完成的栅栏
+    void shutdown();
+
+    Stats getStats() const;
+
+private:
+    double waitFences(int maxQueuedFrames);
+    double limitFrameRate(double fps);
+    void recordLatency(double latencyMs);
+    void recordFrameTime(double frameMs);
+
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t LATENCY_WINDOW = 120;
+    static constexpr size_t FRAME_WINDOW = 120;
+
+private:
+    // 渲染线程模式下在渲染线程写入，主线程通过 get 接口读取
+    std::atomic<SwapMode> mSwapMode{ SwapMode::VSync };
+    std::atomic<double> mFrameLimit{ 0.0 };
+    double mSpinMs{ 2.0 };
+    std::atomic<int> mMaxQueuedFrames{ -1 };
+
+    std::deque<GLsync> mFences{};
+    Clock::time_point mLastSwap{};
+    Clock::time_point mNextFrame{};
+
+    // 正在渲染的帧的第一条输入（上一次 afterSwap 之后处理），下一次交换时结算：
+    // 在 SDL 队列中等待的时间（毫秒精度）+ 处理到交换返回的时间
+    InputSample mInput{};
+
+    std::vector<double> mLatencies{};
+    size_t mLatencyNext{ 0 };
+    std::vector<double> mFrameTimes{};
+    size_t mFrameNext{ 0 };
+
+    // 渲染线程模式下主线程也会读取统计
+    mutable std::mutex mStatsMutex;
+    Stats mStats{};
+};
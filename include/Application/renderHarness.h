@@ -0,0 +1,71 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <glad/glad.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// 离屏回归测试模式：由环境变量开启，示例程序不需要修改
+//   ENGINE_HARNESS_FRAMES   运行的帧数，设置后开启（窗口隐藏、关闭垂直同步），跑完后 Application::update 返回 false
+//   ENGINE_HARNESS_OUTPUT   输出路径前缀（默认 "harness"）：<prefix>.bmp 为最后一帧画面，<prefix>.json 为帧时间统计与 GL 错误数（GLDebug）
+//   ENGINE_HARNESS_WARMUP   不计入帧时间统计的前几帧（默认 10）
+//   ENGINE_HARNESS_ORBIT    相机路径：每帧注入的鼠标左键拖动量 "dx,dy"（默认 "4,0"），由示例自己的相机控制器处理
+//   ENGINE_HARNESS_STEP_MS  固定时间步长（默认 16），Application::getTicks 按帧号返回时间，动画只与帧号有关
+// 1. CPU 帧时间：相邻两次交换缓冲区之间的时间
+// 2. GPU 帧时间：每帧交换前写一个 GL_TIMESTAMP，相邻时间戳之差；结束时统一读取，运行中不等待 GPU
+//    （时间戳查询不占用 GL_TIME_ELAPSED，不影响示例中的 GpuTimer）
+// 3. 结果给出 p50 / p90 / p99 / 最大值 / 平均值，与金标准图片的比较由 bench/render-harness 完成
+class RenderHarness {
+public:
+    RenderHarness() = default;
+
+    RenderHarness(const RenderHarness&) = delete;
+    RenderHarness& operator=(const RenderHarness&) = delete;
+
+    // 读取环境变量，没有设置 ENGINE_HARNESS_FRAMES 时返回 false
+    bool configure();
+    bool isEnabled() const { return mEnabled; }
+
+    // 窗口与 OpenGL 上下文创建之后调用
+    void begin(SDL_Window* window);
+
+    // 交换缓冲区之前：写入时间戳，最后一帧读取画面
+    void beforeSwap();
+
+    // 交换缓冲区之后：记录 CPU 帧时间并注入下一帧的输入；全部帧完成后写出结果并返回 false
+    bool afterSwap();
+
+    // 固定步长的时间（毫秒）
+    Uint32 getTicks() const { return static_cast<Uint32>(mFrame * mStepMs); }
+
+    // 注入的鼠标位置（示例在按键回调里查询光标位置）
+    void getCursorPosition(int* x, int* y) const;
+
+private:
+    void pushInput();
+    void capture();
+    bool writeResults();
+
+private:
+    bool mEnabled{ false };
+    int mFrameCount{ 0 };
+    int mWarmup{ 10 };
+    int mStepMs{ 16 };
+    int mOrbitX{ 4 };
+    int mOrbitY{ 0 };
+    std::string mOutput{ "harness" };
+
+    SDL_Window* mWindow{ nullptr };
+    int mFrame{ 0 };
+    int mCursorX{ 0 };
+    int mCursorY{ 0 };
+
+    std::chrono::high_resolution_clock::time_point mLastSwap{};
+    std::vector<double> mCpuMs{};
+    std::vector<GLuint> mTimestamps{};      // 每帧一个，结束时读取
+
+    // 最后一帧的画面（RGBA，已经按自上而下排列）
+    std::vector<unsigned char> mPixels{};
+    int mCaptureWidth{ 0 };
+    int mCaptureHeight{ 0 };
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include "framePacer.h"
+#include "../glframework/renderer/frameSnapshot.h"
+
+// 渲染线程：独占 GL 上下文，消费主线程产生的帧快照，模拟（主线程）与渲染（渲染线程）并行
+// 1. 两个快照槽轮流使用（双缓冲），交接只用两个原子计数：mPublished（主线程写）、mConsumed（渲染线程写），
+//    主线程写第 mPublished % 2 个槽，渲染线程读第 mConsumed % 2 个槽，两者之差不超过 2；没有锁，等待用 atomic::wait
+// 2. 背压而不是丢帧：两个槽都没用完时 acquire 阻塞，主线程最多领先一帧，输入延迟有上界
+// 3. 渲染线程每帧：执行 JobSystem::runOnMainThread 的任务（GPU 上传）-> 回调（提交 GL 命令）-> 交换缓冲区 -> FramePacer::afterSwap
+//    -> 渲染统计、性能分析的帧结束；渲染线程启动后就是 JobSystem 的 GL 线程，模拟线程仍是主线程（修改场景的任务交回主线程）
+// 4. stop 时先画完已经提交的快照再退出，退出前释放 GL 上下文，由调用者在原线程重新绑定
+// 快照中的材质是主线程复制的副本，渲染包引用的几何体、纹理、shader 由两个线程共享，见 FrameSnapshot
+class RenderThread {
+public:
+    using RenderCallback = std::function<void(const FrameSnapshot& snapshot)>;
+
+    struct Stats {
+        double simulationMs{ 0.0 };     // 主线程：acquire 返回到 publish（更新与生成快照）
+        double mainWaitMs{ 0.0 };       // 主线程：acquire 等待空闲槽（渲染跟不上）
+        double renderMs{ 0.0 };         // 渲染线程：回调提交 GL 命令的时间
+        double renderIdleMs{ 0.0 };     // 渲染线程：等待快照（模拟跟不上）
+        uint64_t frames{ 0 };           // 渲染完成的帧数
+    };
+
+    RenderThread() = default;
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // 调用前先在当前线程释放 context；渲染线程绑定上下文失败时返回 false
+    bool start(SDL_Window* window, SDL_GLContext context, FramePacer* pacer, RenderCallback callback);
+    void stop();
+    bool isRunning() const { return mThread.joinable(); }
+
+    // 主线程：取一个空闲的快照槽（可能等待渲染线程），填好后 publish
+    FrameSnapshot& acquire();
+    void publish(const FramePacer::InputSample& input);
+
+    // 主线程：等待已经提交的快照全部画完（修改、删除共享资源之前调用）
+    void flush();
+
+    Stats getStats() const;
+
+private:
+    // ready：绑定上下文的结果
+    void threadLoop(std::promise<bool>& ready);
+
+    using Clock = std::chrono::steady_clock;
+    static constexpr uint64_t STOP_BIT = 1ull << 63;   // 与 mPublished 合在一起，停止时也能唤醒 atomic::wait
+    static constexpr uint64_t COUNT_MASK = STOP_BIT - 1;
+
+private:
+    SDL_Window* mWindow{ nullptr };
+    SDL_GLContext mContext{ nullptr };
+    FramePacer* mPacer{ nullptr };
+    RenderCallback mCallback{};
+    std::thread mThread{};
+
+    FrameSnapshot mSlots[2]{};
+    FramePacer::InputSample mInputs[2]{};
+    std::atomic<uint64_t> mPublished{ 0 };
+    std::atomic<uint64_t> mConsumed{ 0 };
+
+    Clock::time_point mAcquired{};      // 主线程：上一次 acquire 返回的时间
+
+    mutable std::mutex mStatsMutex;
+    Stats mStats{};
+};
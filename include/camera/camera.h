@@ -6,7 +6,7 @@
 class Camera {
 public:
 	Camera();
-	~Camera();
+	virtual ~Camera();	// ָͨɾ͸ӡ
 
 	glm::mat4 getViewMatrix();
 	virtual glm::mat4 getProjectionMatrix();		// д麯
@@ -38,4 +38,11 @@ public:
 
 	float mNear = 0.0f;
 	float mFar = 0.0f;
+
+	// ضNDC λһΪ 2 / ȣۻʱÿ֡òͬƫƣƽʱΪ 0
+	glm::vec2 mJitter{ 0.0f,0.0f };
+
+protected:
+	// ͶӰ֮ƽ mJitter͸ͶӰƽ w֮Ļǹ̶ƫ
+	glm::mat4 applyJitter(const glm::mat4& projection) const;
 };
\ No newline at end of file
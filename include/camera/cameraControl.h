@@ -9,7 +9,7 @@
 class CameraControl {
 public:
     CameraControl();
-    ~CameraControl();
+    virtual ~CameraControl();   // 通过基类指针删除子类控制器
 
     void setCamera(Camera* camera) { mCamera = camera; }
     void setSensitivity(float sensitivity) { mSensitivity = sensitivity; }
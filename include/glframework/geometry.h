@@ -10,7 +10,17 @@
 #include <string>  // OBJļ·string
 #include <tuple>
 #include <map>
+#include <functional>
 #include "../wrapper/checkError.h"
+#include "triangleBVH.h"
+
+// ģļ CPU ˵Ľδϴ GPUÿλ xyzUV xyzԼ
+struct GeometryData {
+    std::vector<GLfloat> positions;
+    std::vector<GLfloat> uvs;       // STL û꣬Ϊ
+    std::vector<GLfloat> normals;
+    std::vector<GLuint> indices;
+};
 
 class Geometry {
 public:
@@ -45,19 +55,75 @@ public:
     // ֶ֧STLuseSmoothNormalsǷƽ
     static Geometry* createFromSTL(const std::string& stlFilePath, bool useSmoothNormals = true);
 
+    // ֻ CPU ˵ĽȡȥءƽߣҪ OpenGL ģĹڴ˻ϴ
+    // ʧʱ빤һ׳ std::runtime_error
+    static GeometryData parseOBJ(const std::string& objFilePath);
+    static GeometryData parseSTL(const std::string& stlFilePath, bool useSmoothNormals = true);
+
+    // ɽҪ OpenGL ģlabel ڵԱǩû UV ʱ UV 
+    static Geometry* createFromData(GeometryData data, const std::string& label);
+
+    // 첽أ JobSystem Ĺִ߳У֮ GL ̣߳JobSystem::pumpMainThread
+    // ģ̣߳JobSystem::pumpSimulationThread onLoadedʧʱ onLoaded յ nullptrģ̵߳
+    static void createFromOBJAsync(const std::string& objFilePath, std::function<void(Geometry*)> onLoaded);
+    static void createFromSTLAsync(const std::string& stlFilePath, bool useSmoothNormals, std::function<void(Geometry*)> onLoaded);
+
     // ȡVAOȾʱ󶨣
     GLuint getVAO() const { return mVao; }
+
+    // ֻλԵ VAOԤȵֻҪλõ pass ʹã VAO λ VBO  EBOһεʱ
+    GLuint getDepthVAO();
     // ȡglDrawElementsʹã
     GLsizei getIndicesCount() const { return mIndicesCount; }
 
+    // ֲռΧУ׶޳ûаΧеļ壨Ļƽ棩޳
+    bool hasBounds() const { return mHasBounds; }
+    const glm::vec3& getBoundsMin() const { return mBoundsMin; }
+    const glm::vec3& getBoundsMax() const { return mBoundsMax; }
+
+    // ݶλüΧУstride Ϊڶ֮ float 
+    void computeBounds(const float* positions, size_t vertexCount, size_t stride = 3);
+
+    //  BVHCPU ʰȡãģʱں̨̹߳ǰ nullptr
+    const TriangleBVH* getTriangleBVH() const {
+        return (mTriangleBVH != nullptr && mTriangleBVH->isReady()) ? mTriangleBVH : nullptr;
+    }
+
+    // һ CPU ˵λãxyz ̨̹߳ BVH
+    void buildTriangleBVHAsync(std::vector<float> positions, std::vector<unsigned int> indices);
+
+    // ӽصԤ͸ڵ
+    // Ϊ directionCount ȷֲϵĹ۲췽򣬸һݰԶ
+    // ԭʼһͬһ EBO Уԭʼ˳ƫ 0 k  (k + 1) *  
+    // ֻб CPU ݵļ壨ģ鹹ļ壩ɣʧܷ false
+    bool buildSortedIndexOrders(int directionCount = 16);
+    bool hasSortedIndexOrders() const { return !mSortDirections.empty(); }
+
+    // ֲռ۲췽ָ壩ӽǷ EBO еֽƫƣûԤʱ 0
+    size_t pickSortedIndexOffset(const glm::vec3& localViewDirection) const;
+
+private:
+    // ǰĴСԴͳƣɡ·仺ã
+    void updateMemoryStats();
+
 private:
     GLuint mVao;        // 󣨹VBO/EBO״̬
     GLuint mPosVbo;     // λVBO
     GLuint mUvVbo;      // UVVBO
 	GLuint mNormalVbo;  // VBOҪ߿ã
     GLuint mEbo;        // EBO
-    GLuint mTangentVbo; // VBO
+    GLuint mTangentVbo{ 0 }; // VBOֻдߵģͲŴ
+    GLuint mDepthVao{ 0 };  // ֻλԵVAOλVBOEBO
     GLsizei mIndicesCount;  // ʱ贫룩
+    int64_t mBufferBytes{ 0 };  // Ѽ RenderStats ĻС
+
+    bool mHasBounds{ false };           // ǷѼΧ
+    glm::vec3 mBoundsMin{ 0.0f };       // ΧС
+    glm::vec3 mBoundsMax{ 0.0f };       // Χ
+
+    TriangleBVH* mTriangleBVH{ nullptr };   //  BVHֻдģļļŹ
+
+    std::vector<glm::vec3> mSortDirections{};   // ԤӦĹ۲췽򣨾ֲռ䣬λ
 };
 
 #endif // GEOMETRY_H
\ No newline at end of file
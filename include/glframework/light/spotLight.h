@@ -8,7 +8,7 @@ public:
 	SpotLight();
 	~SpotLight();
 	glm::vec3 getTargetDirection() { return mTargetDirection; }
-	void setTargetDirection(glm::vec3& TargetDirection) {mTargetDirection = TargetDirection;}
+	void setTargetDirection(const glm::vec3& TargetDirection) {mTargetDirection = TargetDirection;}
 
 	float getInnerAngle() { return mInnerAngle; }
 	void setInnerAngle(float VisibleAngle) { mInnerAngle = VisibleAngle; }
@@ -11,4 +11,8 @@ public:
 	Texture* mScreenTexture{ nullptr };	// Ļ			
 	Texture* mColorWeightTexture{ nullptr };		// OITcolorweight					
 	Texture* mWeightSumTexture{ nullptr };			// OITweightܺ
+
+	// ֱ̬ʣֻȾ½ǵ mUvScale ڣŴʱñ
+	glm::vec2 mUvScale{ 1.0f };
+	float mSharpness{ 0.0f };		// Ŵǿȣ0 Ϊ˫
 };
\ No newline at end of file
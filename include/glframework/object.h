@@ -1,5 +1,7 @@
 #pragma once
 #include "core.h"
+#include "transformStorage.h"
+#include <string>
 enum class ObjectType {
 	Object,
 	Mesh,
@@ -9,10 +11,14 @@ enum class ObjectType {
 class Object {
 public:
 	Object();
-	~Object();
+	virtual ~Object();
+
+	// 任ݱ TransformStorage УObject ֻоֹ
+	Object(const Object&) = delete;
+	Object& operator=(const Object&) = delete;
 
 	void setPosition(glm::vec3 pos);
-	glm::vec3 getPosition() const { return mPosition; }
+	glm::vec3 getPosition() const { return TransformStorage::getPosition(mTransform); }
 
 	// ת
 	void rotateX(float angle);
@@ -23,28 +29,34 @@ public:
 	void setAngleX(float angle);
 	void setAngleY(float angle);
 	void setAngleZ(float angle);
+	glm::vec3 getAngles() const { return TransformStorage::getAngles(mTransform); }
 
 	void setScale(glm::vec3 scale);
+	glm::vec3 getScale() const { return TransformStorage::getScale(mTransform); }
 
 	glm::mat4 getModelMatrx();
 
 	// ӹϵ
 	void addChild(Object* obj);
-	std::vector<Object*> getChildren();
-	Object* getParent();
+	const std::vector<Object*>& getChildren() const;
+	Object* getParent() const;
 
 	// ȡϢ
 	ObjectType getType() const { return mType; }
 
-protected:
-	glm::vec3 mPosition{ 0.0f };
+	// ƣѡͳƣȻƵMeshʶ
+	void setName(const std::string& name) { mName = name; }
+	const std::string& getName() const { return mName; }
 
-	// unityת׼pitch yaw roll
-	float mAngleX{ 0.0f };
-	float mAngleY{ 0.0f };
-	float mAngleZ{ 0.0f };
+	// 任ֱӲѯ TransformStorage汾ţ
+	TransformHandle getTransformHandle() const { return mTransform; }
 
-	glm::vec3 mScale{ 1.0f };
+protected:
+	// SceneAllocator ͷʱֱӶϿӹϵ
+	friend class SceneAllocator;
+
+	// λáתunityת׼pitch yaw rollԼ󶼴 TransformStorage 
+	TransformHandle mTransform{ INVALID_TRANSFORM };
 
 	// ӹϵ
 	std::vector<Object*> mChildren{};
@@ -52,4 +64,6 @@ protected:
 
 	// ͼ¼
 	ObjectType mType;
+
+	std::string mName{};
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include "core.h"
+#include "mesh.h"
+#include "scene.h"
+#include "sceneBVH.h"
+#include "../camera/camera.h"
+
+// 拾取结果
+struct PickResult {
+    Mesh* mesh{ nullptr };
+    uint32_t triangle{ 0xFFFFFFFFu };       // 几何体中的三角形编号
+    glm::vec3 barycentric{ 0.0f };          // 重心坐标（对应三角形的三个顶点）
+    glm::vec3 worldPosition{ 0.0f };        // 交点的世界坐标
+    float distance{ 0.0f };                 // 相机到交点的距离
+};
+
+// CPU 射线拾取
+// 1. 鼠标坐标反投影得到世界空间射线
+// 2. 场景 BVH 找出包围盒与射线相交的 Mesh（由近到远）
+// 3. 射线变换到 Mesh 的局部空间，在几何体的三角形 BVH 中求交
+// 4. 已经找到的交点比下一个包围盒更近时提前结束
+// 三角形 BVH 尚未构建完成的 Mesh 会被跳过
+class Picker {
+public:
+    Picker(Scene* scene);
+    ~Picker();
+
+    // 窗口大小（像素），鼠标坐标以窗口左上角为原点
+    void setViewport(int width, int height);
+
+    bool pick(Camera* camera, float mouseX, float mouseY, PickResult& result);
+
+    // 世界空间射线拾取（direction 不要求单位长度）
+    bool pickRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, PickResult& result);
+
+    // 鼠标坐标对应的世界空间射线
+    void screenToRay(Camera* camera, float mouseX, float mouseY, glm::vec3& origin, glm::vec3& direction) const;
+
+    // 场景变化后需要在拾取前同步（每帧调用一次即可）
+    void update();
+
+    SceneBVH& getSceneBVH() { return mSceneBVH; }
+
+private:
+    Scene* mScene{ nullptr };
+    SceneBVH mSceneBVH{};
+    std::vector<SceneBVH::RayHit> mCandidates{};
+    int mWidth{ 1 };
+    int mHeight{ 1 };
+};
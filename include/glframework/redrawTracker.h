@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// 按需重绘的脏标记：画面内容变化的地方标记"脏"，Application 在按需模式下没有需要画的帧时阻塞在 SDL_WaitEvent
+// 1. markDirty：内容变化（相机控制、变换、动画、ImGui 的点击与按键），代数加一，渐进累积据此重新开始；
+//    frames 为之后还需要连续画的帧数（ImGui 的控件状态要几帧才能稳定）
+// 2. requestFrame：内容没有变化，只是还需要再画（渐进累积未完成、ImGui 悬停高亮），不改变代数
+// 3. 可以在任意线程调用（例如资源加载完成）；主线程正在等待事件时推送一个 SDL_USEREVENT 唤醒它
+class RedrawTracker {
+public:
+    static void markDirty(int frames = 1);
+    static void requestFrame(int frames = 1);
+
+    // 还有需要画的帧
+    static bool needsFrame() { return sPendingFrames.load() > 0; }
+
+    // 内容的代数：每次 markDirty 加一
+    static uint64_t getGeneration() { return sGeneration.load(std::memory_order_acquire); }
+
+    // 开始画一帧（Application 决定继续渲染时调用）：消耗一帧，本帧之内的标记会留到下一帧
+    static void beginFrame();
+
+    // 主线程进入 / 离开 SDL_WaitEvent
+    static void setWaiting(bool waiting) { sWaiting.store(waiting); }
+
+    RedrawTracker(const RedrawTracker&) = delete;
+    RedrawTracker& operator=(const RedrawTracker&) = delete;
+
+private:
+    RedrawTracker() = default;
+
+    static void raisePending(int frames);
+
+private:
+    static std::atomic<uint64_t> sGeneration;
+    static std::atomic<int> sPendingFrames;
+    static std::atomic<bool> sWaiting;
+};
@@ -0,0 +1,139 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 渲染统计的计数项
+enum class RenderCounter : int {
+    DrawCalls,          // glDraw* 次数
+    Triangles,          // 提交的三角形数
+    ShaderBinds,        // glUseProgram 次数
+    TextureBinds,       // Texture::bind 次数
+    UniformUploads,     // Shader::set* 次数
+    StateChanges,       // Renderer 设置深度 / 模板 / 混合 / 剔除等状态的次数
+    Count
+};
+
+constexpr int RENDER_COUNTER_COUNT = static_cast<int>(RenderCounter::Count);
+
+struct RenderCounterValues {
+    uint64_t values[RENDER_COUNTER_COUNT]{};
+
+    uint64_t operator[](RenderCounter counter) const { return values[static_cast<int>(counter)]; }
+};
+
+// 一个 pass 在一帧中的计数（同名 pass 多次出现时累加）
+struct RenderPassStats {
+    std::string name;
+    RenderCounterValues counters{};
+    double cpuMs{ 0.0 };
+    int calls{ 0 };
+};
+
+// 每帧的渲染统计
+// 1. 计数写入各线程自己的计数器（单写者，relaxed 原子读写，没有锁与总线锁），
+//    endFrame 汇总所有线程并与上一帧的总数相减，得到本帧的值
+// 2. pass 细分：beginPass / endPass（或 RenderStatsScope）记录调用线程在这段时间内的计数，可以嵌套（内层计入外层）
+// 3. 滚动平均：最近 windowSize 帧
+// 4. 显存：Geometry 的缓冲区与 Texture 在创建 / 销毁时增减
+// 5. 输出：ImGui 面板，或每帧一行 JSON（JSON Lines）写入文件，供 CI 与线上遥测比较
+class RenderStats {
+public:
+    // 热路径：只写本线程的计数器
+    static void add(RenderCounter counter, uint64_t count = 1) {
+        std::atomic<uint64_t>& value = local().values[static_cast<int>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+
+    static void addBufferMemory(int64_t bytes) { sBufferBytes.fetch_add(bytes, std::memory_order_relaxed); }
+    static void addTextureMemory(int64_t bytes) { sTextureBytes.fetch_add(bytes, std::memory_order_relaxed); }
+    static int64_t getBufferMemory() { return sBufferBytes.load(std::memory_order_relaxed); }
+    static int64_t getTextureMemory() { return sTextureBytes.load(std::memory_order_relaxed); }
+
+    // pass 细分：name 在 endPass 之前必须保持有效
+    static void beginPass(const char* name);
+    static void endPass();
+
+    // 每帧调用一次（交换缓冲区之后）：结束本帧、更新平均值、写出 JSON，然后开始下一帧
+    static void endFrame();
+
+    static const RenderCounterValues& getFrame() { return sFrame; }
+    static RenderCounterValues getAverage();
+    static double getFrameMs() { return sFrameMs; }
+    static double getAverageFrameMs();
+    static uint64_t getFrameIndex() { return sFrameIndex; }
+    static const std::vector<RenderPassStats>& getPasses() { return sFramePasses; }
+
+    static void setWindowSize(size_t frames) { sWindowSize = frames > 0 ? frames : 1; }
+
+    // JSON Lines 输出：之后每次 endFrame 追加一行；path 为空时关闭
+    static bool setJsonOutput(const std::string& path);
+    static void writeJson(std::ostream& out);
+
+    // 计数项名称（JSON 的键）
+    static const char* getCounterName(RenderCounter counter);
+
+    // ImGui 面板：需要在 ImGui::NewFrame 与 ImGui::Render 之间调用
+    static void drawImGui(const char* title = "Render Stats");
+
+private:
+    struct ThreadCounters {
+        std::atomic<uint64_t> values[RENDER_COUNTER_COUNT]{};
+    };
+
+    struct ActivePass {
+        size_t index{ 0 };
+        RenderCounterValues start{};
+        std::chrono::high_resolution_clock::time_point startTime{};
+    };
+
+    static ThreadCounters& local() {
+        if (sLocal == nullptr) {
+            sLocal = registerThread();
+        }
+        return *sLocal;
+    }
+    static ThreadCounters* registerThread();
+    static RenderCounterValues snapshot(const ThreadCounters& counters);
+
+private:
+    static thread_local ThreadCounters* sLocal;
+    static std::mutex sThreadMutex;
+    static std::vector<std::unique_ptr<ThreadCounters>> sThreads;   // 线程退出后保留，计数仍计入总数
+
+    static std::atomic<int64_t> sBufferBytes;
+    static std::atomic<int64_t> sTextureBytes;
+
+    // 以下只在调用 endFrame 与 pass 的线程（GL 线程）访问
+    static RenderCounterValues sLastTotal;
+    static RenderCounterValues sFrame;
+    static std::deque<RenderCounterValues> sHistory;
+    static std::deque<double> sHistoryMs;
+    static size_t sWindowSize;
+    static double sFrameMs;
+    static uint64_t sFrameIndex;
+    static std::chrono::high_resolution_clock::time_point sFrameStart;
+
+    static std::vector<RenderPassStats> sPasses;        // 当前帧，条目跨帧复用
+    static std::vector<RenderPassStats> sFramePasses;   // 上一帧完成的结果（只保留出现过的 pass）
+    static std::vector<ActivePass> sPassStack;
+
+    static std::ofstream sJsonFile;
+};
+
+// 作用域内的计数计入名为 name 的 pass
+class RenderStatsScope {
+public:
+    explicit RenderStatsScope(const char* name) { RenderStats::beginPass(name); }
+    ~RenderStatsScope() { RenderStats::endPass(); }
+
+    RenderStatsScope(const RenderStatsScope&) = delete;
+    RenderStatsScope& operator=(const RenderStatsScope&) = delete;
+};
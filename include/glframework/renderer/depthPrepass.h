@@ -0,0 +1,94 @@
+#pragma once
+#include "../core.h"
+#include "../shader.h"
+#include "../material/material.h"
+#include "../../camera/camera.h"
+#include <vector>
+
+// 预深度的开关方式
+enum class DepthPrepassMode {
+    Off,
+    On,
+    Auto        // 按测得的过度绘制逐帧决定
+};
+
+// 预深度（Depth Pre-pass）
+// 1. 先用只有位置属性的 VAO 与空片段着色器把不透明物体的深度画一遍，主 pass 再以 GL_EQUAL、关闭深度写入着色，
+//    每个像素只着色一次
+// 2. 过度绘制 = 不开预深度时着色的片元数 / 覆盖的像素数，用 GL_SAMPLES_PASSED 查询测量（几帧之前的结果，不等待 GPU）：
+//    开启时预深度 pass 通过深度测试的片元数就是不开时会着色的片元数（绘制顺序相同），主 pass 的片元数就是覆盖的像素数；
+//    关闭时只能测到着色的片元数，覆盖像素数沿用上一次的值，并每隔一段时间开启一帧重新测量
+// 3. Auto：过度绘制超过开启阈值时开启，低于关闭阈值时关闭（两个阈值之间保持不变，避免来回切换）
+class DepthPrepass {
+public:
+    DepthPrepass(int queryCount = 4);
+    ~DepthPrepass();
+
+    DepthPrepass(const DepthPrepass&) = delete;
+    DepthPrepass& operator=(const DepthPrepass&) = delete;
+
+    void setMode(DepthPrepassMode mode) { mMode = mode; }
+    DepthPrepassMode getMode() const { return mMode; }
+
+    // Auto 模式的开启 / 关闭阈值（过度绘制倍数）
+    void setThresholds(float enableOverdraw, float disableOverdraw);
+
+    // 材质是否可以参与预深度：不透明、写深度、GL_LESS / GL_LEQUAL，且 shader 通过 PerDraw 数据块取模型矩阵
+    // （PerDraw 着色器的位置计算顺序与 depthOnly.vert 相同，GL_EQUAL 才能通过）
+    static bool isEligible(const Material* material, Shader* shader);
+
+    // 每帧开始时调用：决定本帧是否执行预深度
+    bool beginFrame();
+    bool isActive() const { return mActive; }
+
+    // 预深度 pass：设置状态（不写颜色、关闭模板与混合）并开始计数；draw 之间调用 drawDepth
+    void beginPrepass(Camera* camera);
+    Shader* getShader() const { return mShader; }
+    void endPrepass();
+
+    // 主 pass 的不透明物体：开始 / 结束计数
+    void beginOpaque();
+    void endOpaque();
+
+    // 主 pass 中参与了预深度的物体：深度相等才通过，不再写深度
+    void applyEqualDepthState() const;
+
+    // 暂停计数：同一时刻只能有一个遮挡查询，过度绘制调试模式逐 Mesh 查询时由 Renderer 暂停这里的查询
+    // 暂停期间 Auto 沿用暂停前的决定
+    void setQueriesSuspended(bool suspended) { mQueriesSuspended = suspended; }
+
+    // 最近一次测得的过度绘制（覆盖像素未知时为 0）
+    float getOverdraw() const { return mOverdraw; }
+    uint64_t getShadedSamples() const { return mShadedSamples; }
+    uint64_t getCoveredSamples() const { return mCoveredSamples; }
+
+private:
+    struct Slot {
+        GLuint prepassQuery{ 0 };
+        GLuint opaqueQuery{ 0 };
+        bool prepass{ false };        // 这一帧是否执行了预深度
+        bool pending{ false };
+    };
+
+    void collect();
+    void readSlot(Slot& slot);
+    void updateDecision();
+
+private:
+    DepthPrepassMode mMode{ DepthPrepassMode::Auto };
+    float mEnableOverdraw{ 1.5f };
+    float mDisableOverdraw{ 1.2f };
+    int mProbeInterval{ 60 };        // 关闭时每隔多少帧开启一帧重新测量覆盖像素数
+
+    Shader* mShader{ nullptr };
+    std::vector<Slot> mSlots{};
+    int mCurrent{ 0 };
+    bool mActive{ false };
+    bool mAutoEnabled{ false };
+    int mFramesSinceProbe{ 0 };
+    bool mQueriesSuspended{ false };
+
+    float mOverdraw{ 0.0f };
+    uint64_t mShadedSamples{ 0 };
+    uint64_t mCoveredSamples{ 0 };
+};
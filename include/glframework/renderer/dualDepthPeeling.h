@@ -0,0 +1,96 @@
+#pragma once
+#include "../core.h"
+#include "../shader.h"
+
+// 双向深度剥离（Dual Depth Peeling，Bavoil & Myers 2008）的渲染目标与各个 pass
+// 1. 每个 pass 同时剥离最近层与最远层：深度目标 RG32F 存 (-最近, 最远)，三个附件都用 MAX 混合
+//    前层颜色在剥离目标中由前往后累积，最远层每个 pass 混合到单独的后层目标
+// 2. 两套剥离目标交替读写；深度附件的格式跟随场景目标，每帧复制一次不透明物体的深度
+// 3. 最多剥离 maxLayers 层（ceil(maxLayers / 2) 个 pass）；每次后层混合都包在遮挡查询中，
+//    没有写入任何片段说明所有层都已剥离完，提前结束
+// 4. 所有附件跨帧复用，只在尺寸或深度格式变化时重建
+//
+// 使用方式：
+//   if (peeling->begin(fbo, w, h, maxLayers)) {
+//       do { 绘制所有透明物体（shader 使用 DEPTH_PEEL_PASS 变体，并调用 applyUniforms） } while (peeling->nextPass());
+//       peeling->composite(fbo);
+//   }
+class DualDepthPeeling {
+public:
+    // 剥离 shader 读取上一次结果使用的纹理单元，避开材质贴图常用的低位单元
+    static const int DEPTH_TEXTURE_UNIT = 14;
+    static const int FRONT_TEXTURE_UNIT = 15;
+
+    DualDepthPeeling();
+    ~DualDepthPeeling();
+
+    DualDepthPeeling(const DualDepthPeeling&) = delete;
+    DualDepthPeeling& operator=(const DualDepthPeeling&) = delete;
+
+    // 开始剥离：准备附件、复制 sceneFbo 的深度并设置初始化 pass 的状态
+    // 返回 false 表示附件创建失败，调用方应退回排序混合
+    bool begin(GLuint sceneFbo, int width, int height, int maxLayers);
+
+    // 结束当前 pass：初始化 pass 之后直接进入第一个剥离 pass；
+    // 剥离 pass 之后把最远层混合到后层目标，遮挡查询为 0 或达到层数上限时返回 false
+    bool nextPass();
+
+    // 合成到 sceneFbo，结束后恢复常用状态（开启深度测试与深度写入、关闭混合）
+    void composite(GLuint sceneFbo);
+
+    // 为当前 pass 设置剥离 shader 的 uniform（shader 需要已经 begin）
+    void applyUniforms(Shader* shader) const;
+
+    // 本帧执行的剥离 pass 数与最多剥离出的层数
+    int getPassCount() const { return mPassCount; }
+    int getLayerCount() const { return mLayerCount; }
+
+    int getWidth() const { return mWidth; }
+    int getHeight() const { return mHeight; }
+
+    // 附件占用的显存（字节，估算值）
+    size_t getMemoryBytes() const;
+
+private:
+    bool createTargets(int width, int height, GLenum depthFormat);
+    void destroyTargets();
+
+    // 绑定第 index 套剥离目标，清空并设置 MAX 混合
+    void beginPeelTarget(int index, bool init);
+
+    // 把第 index 套的最远层混合到后层目标，返回写入的片段是否为 0（不需要结果时不读取查询）
+    bool blendBackLayer(int index, bool readQuery);
+
+    // 全屏三角形
+    void drawFullscreen();
+
+private:
+    // 剥离目标：附件0 深度范围，附件1 前层颜色，附件2 本次最远层
+    GLuint mPeelFbos[2]{ 0, 0 };
+    GLuint mDepthTextures[2]{ 0, 0 };
+    GLuint mFrontTextures[2]{ 0, 0 };
+    GLuint mBackTextures[2]{ 0, 0 };
+
+    // 后层目标：由后往前混合所有剥离出的最远层
+    GLuint mBackBlendFbo{ 0 };
+    GLuint mBackBlendTexture{ 0 };
+
+    GLuint mDepthBuffer{ 0 };       // 两套剥离目标共用，保存不透明物体的深度
+    GLenum mDepthFormat{ GL_NONE };
+    bool mHasStencil{ false };
+    int mWidth{ 0 };
+    int mHeight{ 0 };
+
+    GLuint mQuery{ 0 };             // GL_ANY_SAMPLES_PASSED 遮挡查询
+
+    // 本帧的剥离进度
+    int mMaxPasses{ 0 };
+    int mPassCount{ 0 };            // 已经完成的剥离 pass 数（不含初始化 pass）
+    int mLayerCount{ 0 };
+    int mCurrent{ 0 };              // 当前写入的剥离目标
+    bool mInit{ false };            // 当前是初始化 pass
+
+    Shader* mBlendShader{ nullptr };
+    Shader* mCompositeShader{ nullptr };
+    GLuint mEmptyVao{ 0 };          // 全屏三角形由 gl_VertexID 生成，核心模式下仍需要绑定一个 VAO
+};
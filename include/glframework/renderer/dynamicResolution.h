@@ -0,0 +1,60 @@
+#pragma once
+#include "../core.h"
+#include <vector>
+
+// 动态分辨率：按 GPU 耗时调整场景的渲染比例，让场景耗时保持在预算内
+// 1. 场景渲染在全尺寸目标左下角的缩放区域内（视口缩小），目标本身不随比例重建，放大由 ScreenMaterial 的 uvScale 完成
+// 2. 计时用 GL_TIMESTAMP 查询对，可以与 Renderer 内部的 GL_TIME_ELAPSED 计时（透明物体）同时使用；结果落后几帧读取，不会等待 GPU
+// 3. 像素数与比例的平方成正比：按 sqrt(预算 / 耗时) 估算目标比例，超出预算时快速下降，有余量时缓慢回升
+// 4. 对外的比例按 1/20 量化，减少依赖视口尺寸的附件（如 OIT 目标）的重建
+class DynamicResolution {
+public:
+    DynamicResolution(int queryCount = 4);
+    ~DynamicResolution();
+
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return mEnabled; }
+
+    // 场景的 GPU 耗时预算（毫秒）
+    void setTargetMs(float targetMs) { mTargetMs = targetMs > 0.1f ? targetMs : 0.1f; }
+    float getTargetMs() const { return mTargetMs; }
+
+    // 比例范围，如 0.5 ~ 1.0
+    void setScaleRange(float minScale, float maxScale);
+    float getMinScale() const { return mMinScale; }
+    float getMaxScale() const { return mMaxScale; }
+
+    // 包围场景渲染的 GPU 命令；endScene 读取已完成的结果并更新比例
+    void beginScene();
+    void endScene();
+
+    // 当前比例（已量化），关闭时为 1
+    float getScale() const;
+
+    // 按当前比例计算场景的渲染尺寸
+    void getRenderSize(int width, int height, int& renderWidth, int& renderHeight) const;
+
+    // 最近一次可读取的场景 GPU 耗时（毫秒）
+    double getGpuMs() const { return mGpuMs; }
+
+private:
+    void collect();
+    void updateScale(double gpuMs);
+
+private:
+    std::vector<GLuint> mStartQueries{};
+    std::vector<GLuint> mEndQueries{};
+    std::vector<bool> mPending{};
+    int mNext{ 0 };
+    bool mActive{ false };
+
+    bool mEnabled{ true };
+    float mTargetMs{ 8.0f };
+    float mMinScale{ 0.5f };
+    float mMaxScale{ 1.0f };
+    float mScale{ 1.0f };       // 控制器内部的连续比例
+    double mGpuMs{ 0.0 };
+};
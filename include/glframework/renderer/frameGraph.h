@@ -0,0 +1,155 @@
+#pragma once
+#include "../core.h"
+#include "renderTargetPool.h"
+#include <vector>
+#include <string>
+#include <functional>
+
+// 帧图中的资源描述
+// 1. width / height 为 0 时按 scale 跟随后台缓冲尺寸（窗口缩放后自动变化），否则为固定尺寸
+// 2. renderbuffer 为 true 时只能作为附件写入，不能在后续 Pass 中采样
+struct FrameGraphTextureDesc {
+    GLenum format{ GL_RGBA8 };
+    float scale{ 1.0f };
+    int width{ 0 };
+    int height{ 0 };
+    bool renderbuffer{ false };
+};
+
+// 资源句柄（帧图内部的虚拟资源编号），-1 为无效句柄
+using FrameGraphResource = int;
+
+class FrameGraph;
+
+// Pass 执行时可用的上下文：当前 Pass 的 FBO 与读取资源对应的实际纹理
+class FrameGraphContext {
+public:
+    // 当前 Pass 写入的 FBO（已经绑定，视口已设为目标尺寸）
+    GLuint getFramebuffer() const { return mFramebuffer; }
+
+    // 资源对应的 GL 对象（纹理或渲染缓冲）
+    GLuint getTexture(FrameGraphResource resource) const;
+
+    int getWidth() const { return mWidth; }
+    int getHeight() const { return mHeight; }
+
+private:
+    friend class FrameGraph;
+    const FrameGraph* mGraph{ nullptr };
+    GLuint mFramebuffer{ 0 };
+    int mWidth{ 0 };
+    int mHeight{ 0 };
+};
+
+// 帧图：每帧由若干 Pass 组成，Pass 在 setup 中声明读写的资源，在 execute 中发出绘制命令
+// 1. compile：从导入资源（后台缓冲等）和有副作用的 Pass 反向引用计数，没有被用到的 Pass 被剔除
+// 2. execute：临时资源在第一次使用前从渲染目标池取出，最后一次使用后立即归还，
+//    描述相同、生命周期不重叠的资源共用同一个纹理（GL 没有跨格式的显存别名，复用同描述的对象即可省下显存）
+// 3. 窗口缩放：setBackbufferSize 只释放旧尺寸下跟随后台缓冲的目标，固定尺寸的目标保留
+// 用法：每帧 addPass ... -> compile -> execute，execute 结束后 Pass 列表清空
+class FrameGraph {
+public:
+    class Builder {
+    public:
+        // 创建临时资源
+        FrameGraphResource create(const std::string& name, const FrameGraphTextureDesc& desc);
+
+        // 在 execute 中采样该资源
+        FrameGraphResource read(FrameGraphResource resource);
+
+        // 作为颜色附件写入，按调用顺序挂到 GL_COLOR_ATTACHMENTi；导入的 FBO 直接作为目标
+        FrameGraphResource write(FrameGraphResource resource);
+
+        // 作为深度（模板）附件写入
+        FrameGraphResource writeDepth(FrameGraphResource resource);
+
+        // 标记 Pass 有外部可见的副作用（不会被剔除）
+        void sideEffect();
+
+    private:
+        friend class FrameGraph;
+        Builder(FrameGraph* graph, int pass) : mGraph(graph), mPass(pass) {}
+        FrameGraph* mGraph{ nullptr };
+        int mPass{ -1 };
+    };
+
+    using SetupFunction = std::function<void(Builder&)>;
+    using ExecuteFunction = std::function<void(const FrameGraphContext&)>;
+
+    FrameGraph();
+    ~FrameGraph();
+
+    FrameGraph(const FrameGraph&) = delete;
+    FrameGraph& operator=(const FrameGraph&) = delete;
+
+    // 后台缓冲尺寸（窗口缩放回调中调用）
+    void setBackbufferSize(int width, int height);
+    int getBackbufferWidth() const { return mBackbufferWidth; }
+    int getBackbufferHeight() const { return mBackbufferHeight; }
+
+    // 导入外部 FBO（如默认帧缓冲 0），写入它的 Pass 视为最终输出
+    FrameGraphResource importFramebuffer(const std::string& name, GLuint fbo, int width, int height);
+
+    void addPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute);
+
+    // 剔除无用 Pass，计算资源生命周期
+    void compile();
+
+    // 按顺序执行未被剔除的 Pass，然后清空本帧的 Pass 与资源
+    void execute();
+
+    RenderTargetPool* getPool() { return &mPool; }
+
+    // 统计信息（最近一次 execute）
+    struct Stats {
+        int passCount{ 0 };
+        int culledPassCount{ 0 };
+        int resourceCount{ 0 };         // 临时资源（虚拟）个数
+        size_t virtualBytes{ 0 };       // 每个临时资源单独分配时需要的显存
+        size_t physicalBytes{ 0 };      // 渲染目标池实际占用的显存
+    };
+    const Stats& getStats() const { return mStats; }
+
+private:
+    struct Resource {
+        std::string name{};
+        FrameGraphTextureDesc desc{};
+        bool imported{ false };
+        GLuint importedFbo{ 0 };
+        int importedWidth{ 0 };
+        int importedHeight{ 0 };
+
+        int refCount{ 0 };
+        int producer{ -1 };     // 最后一个写入它的 Pass
+        int firstUse{ -1 };
+        int lastUse{ -1 };
+        GLuint object{ 0 };
+    };
+
+    struct Pass {
+        std::string name{};
+        ExecuteFunction execute{};
+        std::vector<FrameGraphResource> reads{};
+        std::vector<FrameGraphResource> colorWrites{};
+        FrameGraphResource depthWrite{ -1 };
+        bool sideEffect{ false };
+        int refCount{ 0 };
+        bool culled{ false };
+    };
+
+    RenderTargetDesc resolveDesc(const Resource& resource) const;
+    bool isValid(FrameGraphResource resource) const;
+
+private:
+    friend class FrameGraphContext;
+
+    std::vector<Resource> mResources{};
+    std::vector<Pass> mPasses{};
+    bool mCompiled{ false };
+
+    int mBackbufferWidth{ 0 };
+    int mBackbufferHeight{ 0 };
+
+    RenderTargetPool mPool;
+    Stats mStats{};
+};
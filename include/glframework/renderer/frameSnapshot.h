@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "../core.h"
+#include "../../camera/camera.h"
+#include "../light/directionalLight.h"
+#include "../light/pointLight.h"
+#include "../light/ambientLight.h"
+#include "../material/phongMaterial.h"
+#include "../material/whiteMaterial.h"
+#include "../material/PBRMaterial.h"
+#include "../material/DepthMaterial.h"
+#include "../material/screenMaterial.h"
+#include "renderQueue.h"
+
+// 点光源在一帧中的参数：PointLight 是场景节点，位置存放在 TransformStorage 中，渲染线程不能直接读取
+struct PointLightData {
+    glm::vec3 position{ 0.0f };
+    glm::vec3 color{ 1.0f };
+    float specularIntensity{ 1.0f };
+    glm::vec3 ambient{ 1.0f };
+    glm::vec3 diffuse{ 1.0f };
+    glm::vec3 specular{ 1.0f };
+    float kc{ 1.0f };
+    float k1{ 0.09f };
+    float k2{ 0.032f };
+};
+
+// 一帧使用的光源：平行光与环境光按值复制，点光源只保留参数
+// Renderer::render(Scene*, ...) 每帧开始时也转换成这个结构，之后的渲染包不再逐个访问光源对象
+struct FrameLights {
+    DirectionalLight directional{};
+    AmbientLight ambient{};
+    std::vector<PointLightData> points{};
+
+    // 为空的光源使用默认参数
+    void capture(const DirectionalLight* dirLight, const std::vector<PointLight*>& pointLights, const AmbientLight* ambLight);
+};
+
+// 快照中的相机：保存视图参数与投影矩阵（包括抖动），不依赖原相机的类型
+class SnapshotCamera : public Camera {
+public:
+    SnapshotCamera() = default;
+
+    void capture(Camera* camera);
+
+    glm::mat4 getProjectionMatrix() override { return mProjection; }
+
+public:
+    glm::mat4 mProjection{ 1.0f };
+};
+
+// 帧快照：主线程一帧产生的全部渲染输入（相机、光源、排好序的渲染包），渲染线程只读
+// 1. 每帧的数据（矩阵、光源参数）按值复制，主线程可以立即开始模拟下一帧
+// 2. 材质按值复制：渲染包引用的每个材质在快照中有一份副本（渲染状态、透明度、PBR 参数、颜色等），渲染包的 material 指向副本，
+//    主线程在渲染线程绘制期间修改材质参数不会被读到；同一个材质的渲染包共用一份副本，按材质分组与 uniform 去重照常有效
+//    Mesh 的名字也复制一份（过度绘制统计用），渲染包的 name 指向副本，渲染线程不访问 Mesh
+// 3. Geometry / Texture / Shader 是共享的 GL 资源，不复制：修改或删除前先等渲染线程用完（RenderThread::flush），
+//    或者交给渲染线程执行（JobSystem::runOnMainThread）
+// 4. 快照对象跨帧复用，各数组保留容量，稳定后不再分配内存
+struct FrameSnapshot {
+    uint64_t frameIndex{ 0 };
+    SnapshotCamera camera{};
+    FrameLights lights{};
+    std::vector<RenderPacket> opaque{};
+    std::vector<RenderPacket> transparent{};
+
+    // 在主线程调用：用 queue 构建渲染包（剔除、排序）后复制到快照中
+    void capture(RenderQueue& queue, Scene* scene, Camera* sourceCamera,
+        const DirectionalLight* dirLight, const std::vector<PointLight*>& pointLights, const AmbientLight* ambLight);
+
+private:
+    // 复制渲染包引用的材质，并把渲染包的 material 改为指向副本
+    void copyMaterials();
+
+    // 复制渲染包引用的 Mesh 名字，并把渲染包的 name 改为指向副本
+    void copyNames();
+
+private:
+    std::vector<Material*> mMaterialSources{};      // 排序去重后的原材质
+    std::vector<Material*> mMaterialCopies{};       // 与 mMaterialSources 一一对应的副本
+    std::vector<PhongMaterial> mPhongMaterials{};
+    std::vector<WhiteMaterial> mWhiteMaterials{};
+    std::vector<PBRMaterial> mPBRMaterials{};
+    std::vector<DepthMaterial> mDepthMaterials{};
+    std::vector<ScreenMaterial> mScreenMaterials{};
+    std::vector<std::string> mMeshNames{};          // 按渲染包顺序（先不透明后透明）
+};
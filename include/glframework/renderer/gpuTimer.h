@@ -0,0 +1,39 @@
+#pragma once
+#include "../core.h"
+#include <vector>
+
+// GPU 计时器：用 GL_TIME_ELAPSED 查询测量一段 GL 命令在 GPU 上的耗时
+// 1. 查询对象轮流使用（默认 4 个），读取的是几帧之前的结果，不会让 CPU 等待 GPU
+// 2. 结果未就绪时保持上一次的值
+// 3. GL_TIME_ELAPSED 查询不能嵌套，同一时刻只能有一个计时器处于 begin/end 之间
+class GpuTimer {
+public:
+    GpuTimer(int queryCount = 4);
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void begin();
+    void end();
+
+    // 最近一次可读取的结果（毫秒）
+    double getLastMs();
+
+    // 累计平均值（毫秒）
+    double getAverageMs() const { return mResultCount > 0 ? mTotalMs / mResultCount : 0.0; }
+
+private:
+    // 读取所有已经完成的查询
+    void collect();
+
+private:
+    std::vector<GLuint> mQueries{};
+    std::vector<bool> mPending{};       // 查询已提交但结果尚未读取
+    int mNext{ 0 };
+    bool mActive{ false };
+
+    double mLastMs{ 0.0 };
+    double mTotalMs{ 0.0 };
+    uint64_t mResultCount{ 0 };
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include "../core.h"
+#include "../shader.h"
+#include "../transformStorage.h"
+#include <string>
+#include <vector>
+
+// 单个 Mesh 的着色片元数（GL_SAMPLES_PASSED）
+struct OverdrawMeshStat {
+    std::string name;
+    uint32_t triangles{ 0 };
+    uint64_t fragments{ 0 };
+};
+
+// 一帧的过度绘制统计（GPU 归约的结果）
+struct OverdrawFrameStat {
+    uint64_t fragments{ 0 };        // 着色的片元数
+    uint64_t coveredPixels{ 0 };    // 至少着色一次的像素数
+    uint32_t maxCount{ 0 };         // 单个像素最多着色的次数
+    float ratio{ 0.0f };            // 过度绘制 = fragments / coveredPixels
+};
+
+// 过度绘制可视化（调试渲染模式）
+// 1. Renderer 把每次绘制的着色器换成计数着色器：状态（深度、模板、预深度的 GL_EQUAL 等）保持不变，
+//    每个通过测试的片元对 R32UI 计数图像原子加一，计数的就是实际着色的片元
+// 2. 计算着色器对计数图像做归约，得到着色片元数、覆盖像素数与最大层数；结果放在环形 SSBO 中，几帧之后读取，不等待 GPU
+// 3. 每个 Mesh 的绘制包在 GL_SAMPLES_PASSED 查询中，结果在下一帧可用时读取
+// 4. 最后用热力图覆盖本帧的画面，统计可以导出为 CSV
+class OverdrawVisualizer {
+public:
+    OverdrawVisualizer(int readbackCount = 3);
+    ~OverdrawVisualizer();
+
+    OverdrawVisualizer(const OverdrawVisualizer&) = delete;
+    OverdrawVisualizer& operator=(const OverdrawVisualizer&) = delete;
+
+    // 每帧开始时调用（glClear 之后）：读取之前的结果，按当前视口准备并清空计数图像
+    void beginFrame();
+
+    // 计数着色器：位置计算与 depthOnly.vert 相同，模型矩阵取自 PerDraw 数据块
+    Shader* getShader() const { return mCountShader; }
+
+    // 逐 Mesh 计数：包住一次绘制；参数来自渲染包（渲染线程上不读取 Mesh），名字为空时用 "Mesh <句柄>"
+    void beginMesh(const std::string& name, TransformHandle handle, uint32_t triangles);
+    void endMesh();
+
+    // 每帧结束时调用：归约计数并把热力图画到 fbo 上
+    void endFrame(GLuint fbo);
+
+    // 热力图达到白色的层数
+    void setHeatmapMax(int layers) { mHeatmapMax = layers > 1 ? layers : 1; }
+    int getHeatmapMax() const { return mHeatmapMax; }
+
+    // 关闭时只统计，不覆盖画面
+    void setShowHeatmap(bool show) { mShowHeatmap = show; }
+    bool getShowHeatmap() const { return mShowHeatmap; }
+
+    const OverdrawFrameStat& getFrameStat() const { return mFrameStat; }
+
+    // 最近一次可读取的逐 Mesh 结果（绘制顺序）
+    const std::vector<OverdrawMeshStat>& getMeshStats() const { return mMeshStats; }
+
+    // 导出：一行一个 Mesh，最后一行为整帧合计；失败时返回 false
+    bool exportCSV(const std::string& path) const;
+
+    // 计数图像与回读缓冲占用的显存（字节）
+    size_t getMemoryBytes() const;
+
+private:
+    struct Readback {
+        GLuint buffer{ 0 };
+        GLsync fence{ nullptr };
+    };
+
+    struct QuerySet {
+        std::vector<GLuint> queries{};
+        std::vector<OverdrawMeshStat> meshes{};
+        size_t used{ 0 };
+    };
+
+    void resizeCounts(int width, int height);
+    void collectTotals();
+    void collectMeshes(QuerySet& set);
+
+private:
+    Shader* mCountShader{ nullptr };
+    Shader* mReduceShader{ nullptr };
+    Shader* mHeatmapShader{ nullptr };
+    GLuint mEmptyVao{ 0 };
+
+    GLuint mCountTexture{ 0 };
+    int mWidth{ 0 };
+    int mHeight{ 0 };
+    GLint mViewport[4]{ 0, 0, 0, 0 };
+
+    std::vector<Readback> mReadbacks{};
+    int mCurrentReadback{ 0 };
+
+    QuerySet mQuerySets[2]{};       // 本帧写入一组，读取上一帧的另一组
+    int mCurrentQuerySet{ 0 };
+    bool mQueryActive{ false };
+
+    int mHeatmapMax{ 8 };
+    bool mShowHeatmap{ true };
+
+    OverdrawFrameStat mFrameStat{};
+    std::vector<OverdrawMeshStat> mMeshStats{};
+};
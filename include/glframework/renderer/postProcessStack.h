@@ -0,0 +1,105 @@
+#pragma once
+#include "../core.h"
+#include "../shader.h"
+#include "../texture.h"
+#include "gpuTimer.h"
+#include <vector>
+#include <unordered_map>
+
+// 后处理效果（可以按位组合）
+enum PostProcessEffect : unsigned int {
+    POST_BLOOM = 1u << 0,
+    POST_EXPOSURE = 1u << 1,
+    POST_TONEMAP = 1u << 2,
+    POST_COLOR_GRADING = 1u << 3,
+    POST_VIGNETTE = 1u << 4,
+    POST_FXAA = 1u << 5,
+};
+
+// 后处理参数
+struct PostProcessSettings {
+    unsigned int effects{ POST_BLOOM | POST_VIGNETTE | POST_FXAA };
+
+    float exposure{ 1.0f };
+
+    float bloomThreshold{ 0.8f };
+    float bloomKnee{ 0.2f };
+    float bloomIntensity{ 0.6f };
+    float bloomRadius{ 1.0f };      // 上采样帐篷滤波的半径（以下一层像素为单位）
+    int bloomLevels{ 5 };           // 金字塔层数，第 0 层为源图的一半
+
+    Texture* colorGradingLut{ nullptr };    // 横向展开的 2D LUT（宽 = size * size，高 = size），为空时跳过调色
+    float vignetteIntensity{ 0.5f };
+    float vignetteRadius{ 0.75f };
+};
+
+// 后处理栈：把 HDR 场景纹理处理后输出到目标 FBO
+// 1. 逐像素效果（泛光合成、曝光、色调映射、调色、暗角）由同一份源码按启用的效果集合加宏编译，融合成一个全屏 Pass，
+//    中间结果留在寄存器里，不再经过显存；变体按效果组合缓存
+// 2. 泛光金字塔用计算着色器：下采样先把源图块读入共享内存再滤波，上采样逐层叠加，整条金字塔在一张带 mip 的纹理里
+// 3. FXAA 需要邻域的最终颜色，放在融合 Pass 之后单独一个 Pass
+// 4. 关闭融合时每个逐像素效果单独一个 Pass（经过 RGBA16F 中间目标），用于对比耗时与带宽
+class PostProcessStack {
+public:
+    PostProcessStack();
+    ~PostProcessStack();
+
+    PostProcessStack(const PostProcessStack&) = delete;
+    PostProcessStack& operator=(const PostProcessStack&) = delete;
+
+    PostProcessSettings& getSettings() { return mSettings; }
+
+    void setFused(bool fused) { mFused = fused; }
+    bool getFused() const { return mFused; }
+
+    // sourceTexture 为 width x height 的场景颜色，结果写到 targetFbo（视口设为 width x height）
+    void apply(GLuint sourceTexture, int width, int height, GLuint targetFbo);
+
+    // 统计信息：融合与逐效果两种方式分开记录，方便对比
+    struct Stats {
+        int fullscreenPassCount{ 0 };
+        int dispatchCount{ 0 };
+        size_t bandwidthBytes{ 0 };     // 估算的显存读写量（每个像素的读写字节数 x 像素数）
+        double gpuMs{ 0.0 };
+    };
+    const Stats& getStats(bool fused) const { return mStats[fused ? 1 : 0]; }
+
+    // 中间目标占用的显存（字节，估算值）
+    size_t getMemoryBytes() const;
+
+private:
+    bool ensureTargets(int width, int height);
+    void destroyTargets();
+
+    // 泛光金字塔，返回实际生成的层数
+    int renderBloom(GLuint sourceTexture, int width, int height, Stats& stats);
+
+    // 逐像素效果组合对应的着色器（第一次使用时编译）
+    Shader* getCompositeShader(unsigned int effects);
+
+    // 一个全屏 Pass：effects 为本 Pass 包含的逐像素效果
+    void drawComposite(unsigned int effects, GLuint input, GLuint targetFbo, int width, int height, Stats& stats, bool finalTarget);
+    void drawFxaa(GLuint input, GLuint targetFbo, int width, int height, Stats& stats);
+
+private:
+    PostProcessSettings mSettings{};
+    bool mFused{ true };
+
+    std::unordered_map<unsigned int, Shader*> mCompositeShaders{};
+    Shader* mFxaaShader{ nullptr };
+    Shader* mDownsamplePrefilterShader{ nullptr };
+    Shader* mDownsampleShader{ nullptr };
+    Shader* mUpsampleShader{ nullptr };
+
+    // 中间目标：两张 RGBA16F 轮流读写，泛光金字塔是一张带 mip 的 RGBA16F 纹理
+    GLuint mPingPongFbos[2]{ 0, 0 };
+    GLuint mPingPongTextures[2]{ 0, 0 };
+    GLuint mBloomTexture{ 0 };
+    int mBloomLevels{ 0 };
+    int mWidth{ 0 };
+    int mHeight{ 0 };
+
+    GLuint mEmptyVao{ 0 };      // 全屏三角形由 gl_VertexID 生成
+    GpuTimer* mTimers[2]{ nullptr, nullptr };
+    Stats mStats[2]{};
+};
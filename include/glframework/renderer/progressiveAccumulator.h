@@ -0,0 +1,70 @@
+#pragma once
+#include "../core.h"
+#include "../shader.h"
+#include "../../camera/camera.h"
+
+// 渐进累积：画面静止时每帧给相机一个不同的亚像素抖动，把结果平均到一张 RGBA32F 纹理中，得到超采样的抗锯齿
+// 1. 第 n 帧（从 0 开始）以权重 1 / (n + 1) 混合进累积纹理（GL_CONSTANT_ALPHA），结果始终是前 n + 1 帧的平均
+// 2. 抖动取 Halton(2, 3) 序列，第 0 帧不抖动，与普通渲染的画面一致；累积满 N 帧后停止，之后直接使用累积纹理
+// 3. 画面变化时从头开始：RedrawTracker 的代数变化（相机控制、变换、输入）、相机矩阵变化或渲染尺寸变化
+// 4. 未累积满时向 RedrawTracker 请求下一帧，按需重绘模式下累积完成后主循环才进入睡眠
+class ProgressiveAccumulator {
+public:
+    ProgressiveAccumulator();
+    ~ProgressiveAccumulator();
+
+    ProgressiveAccumulator(const ProgressiveAccumulator&) = delete;
+    ProgressiveAccumulator& operator=(const ProgressiveAccumulator&) = delete;
+
+    // 关闭时每帧都渲染场景，不抖动，累积纹理只保存最新一帧
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return mEnabled; }
+
+    // 累积的帧数上限 N
+    void setMaxSamples(int samples);
+    int getMaxSamples() const { return mMaxSamples; }
+
+    // 已经累积的帧数
+    int getSampleCount() const { return mSampleCount; }
+    bool isConverged() const { return mEnabled && mSampleCount >= mMaxSamples; }
+
+    // 渲染场景之前调用：width x height 为场景的渲染尺寸，需要时从头开始并给相机设置本帧的抖动；
+    // 返回 false 表示已经累积满，本帧不需要渲染场景（也不调用 accumulate），直接使用 getTexture
+    bool beginFrame(Camera* camera, int width, int height);
+
+    // 渲染场景之后调用：把场景颜色混合进累积纹理，并清除相机的抖动；
+    // uvScale 为场景在源纹理中所占的比例（动态分辨率下小于 1）
+    void accumulate(GLuint sourceTexture, glm::vec2 uvScale = glm::vec2(1.0f));
+
+    // 累积结果（渲染尺寸），采样时 uvScale 为 1
+    GLuint getTexture() const { return mTexture; }
+
+private:
+    bool ensureTarget(int width, int height);
+    void destroyTarget();
+    void reset();
+
+    // Halton 低差异序列的第 index 项（index 从 1 开始），范围 [0, 1)
+    static float halton(int index, int base);
+
+private:
+    Shader* mShader{ nullptr };
+    GLuint mEmptyVao{ 0 };      // 全屏三角形由 gl_VertexID 生成
+
+    GLuint mFbo{ 0 };
+    GLuint mTexture{ 0 };
+    int mWidth{ 0 };
+    int mHeight{ 0 };
+
+    bool mEnabled{ true };
+    int mMaxSamples{ 16 };
+    int mSampleCount{ 0 };
+
+    // 判断画面是否变化
+    uint64_t mGeneration{ 0 };
+    glm::mat4 mViewMatrix{ 0.0f };
+    glm::mat4 mProjectionMatrix{ 0.0f };
+
+    Camera* mCamera{ nullptr };     // beginFrame 设置了抖动的相机，accumulate 时清除
+    bool mFrameActive{ false };
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "../core.h"
+#include "../mesh.h"
+#include "../scene.h"
+#include "../../camera/camera.h"
+#include "../tools/frameArena.h"
+#include "../sceneBVH.h"
+
+// 渲染包：提交一次绘制所需的全部 CPU 数据，由工作线程预先计算好
+struct RenderPacket {
+    uint64_t sortKey{ 0 };              // 排序键：不透明按 shader/材质/由近到远，透明按由远到近
+    glm::mat4 modelMatrix{ 1.0f };      // 世界矩阵
+    glm::mat3 normalMatrix{ 1.0f };     // 法线矩阵
+    float viewDepth{ 0.0f };            // 相机空间深度（正数，越大越远）
+    Material* material{ nullptr };
+    Geometry* geometry{ nullptr };
+
+    // 调试信息（过度绘制统计）：渲染线程不能读取 Mesh，名字在帧快照中有一份副本
+    const std::string* name{ nullptr };
+    TransformHandle transformHandle{ 0 };
+    uint32_t triangleCount{ 0 };
+};
+
+// 渲染队列：每帧由工作线程遍历场景、做视锥剔除、生成渲染包
+// 1. 默认用 SceneBVH 做层次视锥剔除，只为可见的 Mesh 生成渲染包；关闭 BVH 时逐个遍历场景节点
+//    每个线程写入自己的缓冲区，无需加锁
+// 2. 合并后按排序键排序，GL 线程只负责按顺序提交
+// 3. 所有缓冲区跨帧复用，合并后的列表放在每帧的 FrameArena 中，稳定后不再分配内存
+class RenderQueue {
+public:
+    RenderQueue();
+    ~RenderQueue();
+
+    // 构建本帧的渲染包（调用前 TransformStorage 会先在当前线程完成更新）
+    void build(Scene* scene, Camera* camera);
+
+    // 排序后的不透明 / 透明渲染包（位于 FrameArena 中，下一次 build 后失效）
+    ArrayView<RenderPacket> getOpaquePackets() const { return mOpaquePackets; }
+    ArrayView<RenderPacket> getTransparentPackets() const { return mTransparentPackets; }
+
+    // 视锥剔除开关
+    void setFrustumCulling(bool enable) { mFrustumCulling = enable; }
+
+    // 是否使用场景 BVH 剔除（关闭时逐个 Mesh 检测）
+    void setUseBVH(bool enable) { mUseBVH = enable; }
+    const SceneBVH& getSceneBVH() const { return mSceneBVH; }
+
+    // 透明渲染包是否由远到近排序（顺序无关透明模式下不需要排序）
+    void setSortTransparent(bool enable) { mSortTransparent = enable; }
+
+    // 单个任务最少处理的子树个数
+    void setMinBatch(size_t minBatch) { mMinBatch = minBatch; }
+
+    // 统计信息
+    size_t getVisitedCount() const { return mVisitedCount; }
+    size_t getCulledCount() const { return mCulledCount; }
+    double getBuildTimeMs() const { return mBuildTimeMs; }
+    const FrameArena& getFrameArena() const { return mFrameArena; }
+
+private:
+    // 遍历任务：node 为起点，recursive 为 false 时只处理节点本身
+    struct TraverseTask {
+        Object* node{ nullptr };
+        bool recursive{ true };
+    };
+
+    // 每个线程独立的输出与遍历栈
+    struct ThreadBuffer {
+        std::vector<RenderPacket> opaque;
+        std::vector<RenderPacket> transparent;
+        std::vector<Object*> stack;
+        size_t visited{ 0 };
+        size_t culled{ 0 };
+    };
+
+    // 把场景根部展开成足够多的子树，保证各线程任务均衡
+    void collectTasks(Scene* scene, size_t threadCount);
+
+    void processTask(const TraverseTask& task, ThreadBuffer& buffer);
+    void processNode(Object* node, ThreadBuffer& buffer);
+
+    // 为 Mesh 生成渲染包，cull 为 true 时先做视锥检测
+    void processMesh(Mesh* mesh, ThreadBuffer& buffer, bool cull);
+
+    // 世界空间包围盒是否与视锥相交
+    bool isVisible(const Geometry* geometry, const glm::mat4& modelMatrix) const;
+
+    uint64_t makeSortKey(const Material* material, float viewDepth, bool transparent) const;
+
+private:
+    std::vector<ThreadBuffer> mThreadBuffers{};
+    std::vector<TraverseTask> mTasks{};
+    std::vector<Object*> mFrontier{};
+    std::vector<Object*> mNextFrontier{};
+
+    // 每帧的临时内存：合并后的渲染包列表
+    FrameArena mFrameArena{ 256 * 1024 };
+    ArrayView<RenderPacket> mOpaquePackets{};
+    ArrayView<RenderPacket> mTransparentPackets{};
+
+    // 本帧相机数据
+    glm::mat4 mViewMatrix{ 1.0f };
+    glm::vec4 mFrustumPlanes[6]{};
+    float mFar{ 1.0f };
+
+    bool mFrustumCulling{ true };
+    bool mUseBVH{ true };
+    bool mSortTransparent{ true };
+
+    // 场景 BVH 与本帧查询到的可见 Mesh
+    SceneBVH mSceneBVH{};
+    std::vector<Mesh*> mVisibleMeshes{};
+    size_t mMinBatch{ 16 };
+
+    size_t mVisitedCount{ 0 };
+    size_t mCulledCount{ 0 };
+    double mBuildTimeMs{ 0.0 };
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include "../core.h"
+#include <vector>
+#include <cstdint>
+
+// 渲染目标描述：尺寸 + 内部格式 + 存储类型，池中的对象按描述完全相同才复用
+struct RenderTargetDesc {
+    int width{ 0 };
+    int height{ 0 };
+    GLenum internalFormat{ GL_RGBA8 };
+    bool renderbuffer{ false };     // 只作为附件、不会被采样的资源用渲染缓冲
+    bool backbufferRelative{ false };   // 尺寸跟随后台缓冲（窗口缩放后整体释放），固定尺寸的目标为 false
+
+    bool operator==(const RenderTargetDesc& other) const {
+        return width == other.width && height == other.height &&
+            internalFormat == other.internalFormat && renderbuffer == other.renderbuffer &&
+            backbufferRelative == other.backbufferRelative;
+    }
+};
+
+// 渲染目标池：管理临时的纹理 / 渲染缓冲与由它们组成的 FBO
+// 1. acquire 优先返回描述相同的空闲对象，没有时才创建；release 后同一帧内的其它资源即可复用（生命周期不重叠的资源共用显存）
+// 2. 对象跨帧保留，稳定后不再创建；超过若干帧没有使用的对象由 trim 释放
+// 3. FBO 按附件组合缓存，附件被释放时一并删除
+// 所有函数都必须在 GL 线程调用
+class RenderTargetPool {
+public:
+    RenderTargetPool();
+    ~RenderTargetPool();
+
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    // 每帧开始时调用（用于记录对象最近一次使用的帧）
+    void beginFrame();
+
+    // 取得一个符合描述的对象（纹理或渲染缓冲），失败返回 0
+    GLuint acquire(const RenderTargetDesc& desc);
+
+    // 归还对象，之后可以被其它资源复用
+    void release(GLuint object);
+
+    // 由颜色附件（纹理）与深度附件组成的 FBO，相同组合返回同一个 FBO
+    GLuint getFramebuffer(const std::vector<GLuint>& colors, GLuint depth);
+
+    // 释放超过 maxIdleFrames 帧没有使用的空闲对象
+    void trim(int maxIdleFrames = 3);
+
+    // 立即释放尺寸跟随后台缓冲的空闲对象（窗口缩放后，旧尺寸的目标不会再被用到）
+    void purgeBackbufferRelative();
+
+    // 释放全部对象
+    void clear();
+
+    // 统计信息
+    size_t getTargetCount() const { return mEntries.size(); }
+    size_t getFramebufferCount() const { return mFramebuffers.size(); }
+    size_t getMemoryBytes() const;              // 池中所有对象占用的显存（估算值）
+    uint64_t getCreatedCount() const { return mCreatedCount; }   // 累计创建的对象数
+
+    // 描述对应的显存大小（字节，估算值）
+    static size_t getMemoryBytes(const RenderTargetDesc& desc);
+
+    // 内部格式是否为深度 / 深度模板格式
+    static bool isDepthFormat(GLenum internalFormat);
+    static bool hasStencil(GLenum internalFormat);
+
+private:
+    struct Entry {
+        RenderTargetDesc desc{};
+        GLuint object{ 0 };
+        bool inUse{ false };
+        uint64_t lastUsedFrame{ 0 };
+    };
+
+    struct Framebuffer {
+        std::vector<GLuint> colors{};
+        GLuint depth{ 0 };
+        GLuint fbo{ 0 };
+    };
+
+    GLuint createObject(const RenderTargetDesc& desc);
+    void destroyEntry(size_t index);
+    const Entry* findEntry(GLuint object) const;
+
+private:
+    std::vector<Entry> mEntries{};
+    std::vector<Framebuffer> mFramebuffers{};
+    uint64_t mFrame{ 0 };
+    uint64_t mCreatedCount{ 0 };
+};
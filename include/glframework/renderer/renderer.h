@@ -1,5 +1,7 @@
 #pragma once
 #include <vector>
+#include <functional>
+#include <chrono>
 #include "../core.h"
 #include "../mesh.h"
 #include "../../camera/camera.h"
@@ -9,6 +11,30 @@
 #include "../light/spotLight.h"
 #include "../shader.h"
 #include "../scene.h"
+#include "renderQueue.h"
+#include "frameSnapshot.h"
+#include "uniformRingBuffer.h"
+#include "gpuTimer.h"
+#include "weightedBlendedOIT.h"
+#include "dualDepthPeeling.h"
+#include "depthPrepass.h"
+#include "overdrawVisualizer.h"
+
+// ͸Ⱦʽ
+enum class TransparencyMode {
+	Sorted,				// ԶϣĬϣ
+	WeightedBlended,	// Ȩ OITһۻ + һκϳ
+	DualDepthPeeling	// ˫Ȱ룺ÿ pass Զ㣬˳ȷԽԽ
+};
+
+// ͸׶εĺʱͳƣÿģʽֱ¼һеĽ
+struct TransparencyTiming {
+	double cpuMs{ 0.0 };		// CPU ύʱ
+	double gpuMs{ 0.0 };		// GPU ʱ֮֡ǰĽȴ GPU
+	size_t drawCount{ 0 };		// ͸Ⱦ
+	int peelPassCount{ 0 };		// Ȱ룺ִ֡еİ pass ڵѯΪ 0 ʱǰ
+	int peelLayerCount{ 0 };	// Ȱ룺֡Ĳ
+};
 
 class Renderer
 {
@@ -17,7 +43,8 @@ public:
 	Renderer(const std::string &vertexshaderPath, const std::string& fragmentshaderPath);
 	Renderer(const std::string& phongVertexPath , const std::string& phongFragmentPath ,
 		const std::string& whiteVertexPath , const std::string& whiteFragmentPath ,
-		const std::string& pbrVertexPath , const std::string& pbrFragmentPath);
+		const std::string& pbrVertexPath , const std::string& pbrFragmentPath,
+		const std::vector<ShaderMacro>& macros = std::vector<ShaderMacro>{});	//  shader õĺ꣨Դ
 	~Renderer();
 
 	// Ⱦܺ
@@ -31,6 +58,9 @@ public:
 		unsigned int fbo = 0	// Ĭ00ϵͳĬϵFBO
 	);
 
+	// Ⱦ̲߳֡գȾ߳ģʽ render(Scene*, ...) ֻͬ˹Ⱦ
+	void render(const FrameSnapshot& snapshot, unsigned int fbo = 0);
+
 	void renderObject(
 		Object* object,
 		Camera* camera,
@@ -93,15 +123,125 @@ public:
 
 	void setClearColor(glm::vec3 color);
 
+	// ȾʹõȾУڵ޳ءȡͳϢ
+	RenderQueue& getRenderQueue() { return mRenderQueue; }
+
+	// ÿλݵĻλһȾʱɶȡͣͳƣδʱΪ nullptr
+	UniformRingBuffer* getPerDrawBuffer() const { return mPerDrawBuffer; }
+
+	// ͸Ⱦʽʱл
+	// Ӱ render(Scene*, ...) Դ render(meshes, ...)ߵ Sorted ģʽִ˳򣬲ʱ
+	// WeightedBlended / DualDepthPeeling Ҫ shader  common/fragmentOutput.glsl԰ϻ
+	void setTransparencyMode(TransparencyMode mode);
+	TransparencyMode getTransparencyMode() const { return mTransparencyMode; }
+	const TransparencyTiming& getTransparencyTiming(TransparencyMode mode) const { return mTransparencyTimings[static_cast<int>(mode)]; }
+
+	// ȰĲĬ 8 4  passĲ㱻
+	void setMaxPeelLayers(int layers) { mMaxPeelLayers = layers < 1 ? 1 : layers; }
+	int getMaxPeelLayers() const { return mMaxPeelLayers; }
+
+	// ͸ļԤGeometry::buildSortedIndexOrdersʱӽѡӽһݣĬϿ
+	void setUseSortedIndices(bool enable) { mUseSortedIndices = enable; }
+	bool getUseSortedIndices() const { return mUseSortedIndices; }
+
+	// ԤȣӰ render(Scene*, ...) Դ render(meshes, ...)ĬϹر
+	void setDepthPrepassMode(DepthPrepassMode mode) { mDepthPrepassMode = mode; }
+	DepthPrepassMode getDepthPrepassMode() const { return mDepthPrepassMode; }
+
+	// ԤȵͳƣȻƵȣһοǰΪ nullptr
+	const DepthPrepass* getDepthPrepass() const { return mDepthPrepass; }
+
+	// ԤȻãΪǰ FBOʱȻѾвԤȵĲ͸壬
+	// ӰSSAO Ҫȵ pass ︴ƻʹȣٻһ飻صغ°󶨸 FBO
+	void setDepthPrepassCallback(const std::function<void(unsigned int)>& callback) { mDepthPrepassCallback = callback; }
+
+	// ȻƵģʽӰ render(Scene*, ...) Դ render(meshes, ...)
+	// ÿλƸüɫ滻ͼ͸尴ϵķʽ
+	void setOverdrawDebug(bool enabled) { mOverdrawDebug = enabled; }
+	bool getOverdrawDebug() const { return mOverdrawDebug; }
+
+	// ȻƵͳơͼ CSV һοǰΪ nullptr
+	OverdrawVisualizer* getOverdrawVisualizer() const { return mOverdraw; }
+
 private:
 	Shader* pickShader(MaterialType type);
+
+	// ǰ͸ pass ʹõ shaderͨΪ baseOIT / ȰΪͬһԴӺı壬֧ʱ nullptr
+	Shader* passShader(Shader* base);
 	void setDepthState(Material* material);
 	void setPolygonOffsetState(Material* material);
 	void setStencilState(Material* material);
 	void setBlenderState(Material* material);
 	void setFaceCullingState(Material* material);
 
-	void projectObject(Object* obj);	// жڵmesh͸ǲ͸Ӧ
+	// ÿrenderʼʱãµһ֡ʱлλһ֡fenceձrendershaderʼ¼
+	void beginPerDrawFrame();
+
+	// shaderڱrenderǷһʹãÿ֡uniformֻһΣ
+	bool isFirstUseInFrame(Shader* shader);
+
+	// shader һõĲʳǷ materialʱ¼ false÷ϴ
+	bool isMaterialBound(Shader* shader, const Material* material);
+
+	// ÿλƵݣshaderPerDrawݿд뻷λ󶨣ûݿľ shader ʹ glUniform
+	void setPerDrawData(Shader* shader, const Material* material, const glm::mat4& modelMatrix, const glm::mat3& normalMatrix);
+
+	// VAOƣϵ͸Ԥʱѡ뵱ǰӽӽһ
+	void drawGeometry(Geometry* geometry, const Material* material, const glm::mat4& modelMatrix, Camera* camera);
+
+	// Ԥȣ֡ǷִУִʱ count ͸ drawDepth(i)ɵ÷жܷ룩֮ʼ pass ļ
+	// ر֡ǷִԤȣ pass  endOpaquePass
+	bool renderDepthPrepass(unsigned int fbo, Camera* camera, size_t count, const std::function<void(size_t)>& drawDepth);
+	void endOpaquePass();
+
+	// Ԥлһ壺ֻλԵ VAO޳ƫ pass һ
+	void drawDepthOnly(Geometry* geometry, Material* material, const glm::mat4& modelMatrix);
+
+	// ȻƵԣÿ render ʼ / ʱãδʱʲô
+	void beginOverdrawFrame();
+	void endOverdrawFrame(unsigned int fbo);
+
+	// ˳޹͸OIT / Ȱ룩ĸ passÿ pass б draw(i)
+	// shaderOf(i) ص i ͨ shaderûбŽ fallbackɵ÷ںϳɺϻ
+	//  false ʾǰģʽ򸽼ʧܣ÷Ӧȫϻ
+	bool renderOrderIndependent(
+		unsigned int fbo,
+		size_t count,
+		const std::function<Shader*(size_t)>& shaderOf,
+		const std::function<void(size_t)>& draw,
+		std::vector<size_t>& fallback
+	);
+
+	// ͸׶μʱ¼ǰģʽͳ
+	void beginTransparencyTiming();
+	void endTransparencyTiming(size_t drawCount);
+
+	// render(Scene*, ...)  render(snapshot) ã״̬
+	void beginSceneFrame(unsigned int fbo);
+
+	// render(Scene*, ...)  render(snapshot) ãԤȡ͸͸
+	void renderPackets(
+		unsigned int fbo,
+		Camera* camera,
+		const FrameLights& lights,
+		ArrayView<RenderPacket> opaquePackets,
+		ArrayView<RenderPacket> transparentPackets
+	);
+
+	// Ⱦ͸壺ǰģʽѡϡOIT Ȱ룬¼ʱ
+	void renderTransparent(
+		unsigned int fbo,
+		Camera* camera,
+		const FrameLights& lights,
+		ArrayView<RenderPacket> packets
+	);
+
+	// ύȾ״̬uniformƣȾм
+	void renderPacket(
+		const RenderPacket& packet,
+		Camera* camera,
+		const FrameLights& lights
+	);
 private:
 	// ɶֲͬshader󣬿ʹö֣ÿμǵڹ캯ɼ
 	// ݲ͵Ĳͬѡʹһshader
@@ -109,8 +249,51 @@ private:
 	Shader* mWhiteShader{ nullptr };
 	Shader* mPBRShader{ nullptr };
 
-	// ͸͸Ķ
-	// ע⣡ÿһ֡ǰҪ
-	std::vector<Mesh*> mOpaqueObjects{};		// ͸
-	std::vector<Mesh*> mTransparentObjects{};	// ͸
+	// ͸͸Ⱦ
+	// ÿһ֡ɹ̱߳޳ɣGLֻ߳ύ
+	RenderQueue mRenderQueue{};
+
+	// ֡ĹԴrender(Scene*, ...) ÿ֡תһΣȾֱӶȡ
+	FrameLights mFrameLights{};
+	SnapshotCamera mSnapshotCamera{};		// render(snapshot) ʹõֻģ
+
+	// ÿλݣģ;󡢷߾󡢲ʱĳ־ӳ价λʹ
+	UniformRingBuffer* mPerDrawBuffer{ nullptr };
+	std::vector<Shader*> mFrameShaders{};	// renderѾùÿ֡uniformshader
+	std::vector<std::pair<Shader*, const Material*>> mShaderMaterials{};	// renderÿshaderõĲ
+	uint64_t mPerDrawFrameIndex{ 0 };		// λǰ֡
+	bool mPerDrawFrameStarted{ false };
+
+	// ͸
+	// ͸׶εǰ pass renderPacket ʹĸ shader ״̬
+	enum class TransparentPass {
+		Forward,			// ͨ
+		WeightedBlended,	//  OIT Ŀۻ
+		DepthPeel			// Ȱ루ʼ pass
+	};
+	static const int TRANSPARENCY_MODE_COUNT = 3;
+
+	TransparencyMode mTransparencyMode{ TransparencyMode::Sorted };
+	TransparentPass mTransparentPass{ TransparentPass::Forward };
+	WeightedBlendedOIT* mOIT{ nullptr };				// һʹ OIT ʱ
+	DualDepthPeeling* mPeeling{ nullptr };				// һʹȰʱĿ֡
+	int mMaxPeelLayers{ 8 };
+	bool mUseSortedIndices{ true };
+	std::vector<size_t> mOrderIndependentItems{};		// ֡б͸
+	std::vector<size_t> mFallbackItems{};				// ûб͸壬ϳɺ
+	std::vector<Mesh*> mTransparentMeshes{};			// render(meshes, ...) ӺƵ͸ Mesh
+	GpuTimer* mTransparencyTimers[TRANSPARENCY_MODE_COUNT]{ nullptr, nullptr, nullptr };
+	TransparencyTiming mTransparencyTimings[TRANSPARENCY_MODE_COUNT]{};
+	std::chrono::high_resolution_clock::time_point mTransparencyStart{};
+
+	// Ԥ
+	DepthPrepassMode mDepthPrepassMode{ DepthPrepassMode::Off };
+	DepthPrepass* mDepthPrepass{ nullptr };				// һοʱ֮رҲͳɫƬԪ
+	bool mDepthPrepassActive{ false };					//  pass Ĳ͸Ƿ GL_EQUAL
+	std::function<void(unsigned int)> mDepthPrepassCallback{};
+
+	// ȻƵ
+	bool mOverdrawDebug{ false };
+	OverdrawVisualizer* mOverdraw{ nullptr };			// һοʱ
+	bool mOverdrawActive{ false };						//  render Ƿڼ
 };
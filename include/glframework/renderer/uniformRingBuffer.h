@@ -0,0 +1,90 @@
+#pragma once
+#include "../core.h"
+#include <cstdint>
+#include <vector>
+
+// 每次绘制的数据，布局与 shaders/common/perDraw.glsl 中的 PerDraw 数据块一致（std140）
+struct PerDrawData {
+    glm::mat4 modelMatrix{ 1.0f };      // 模型矩阵
+    glm::mat4 normalMatrix{ 1.0f };     // 法线矩阵（左上角 3x3 有效）
+    glm::vec4 material{ 1.0f, 0.0f, 1.0f, 1.0f };   // x=opacity y=metallic z=roughness w=ao
+};
+
+// 持久映射的环形缓冲区：
+// 1. glBufferStorage + GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT，只映射一次，CPU 直接写入
+// 2. 缓冲区分成 regionCount（默认 3）个帧区域，每帧写一个区域，结束时插入 glFenceSync
+// 3. 重新使用某个区域前等待它的 fence，保证 GPU 已经读完；等待的次数与时长会被统计
+// 4. 分配出的每块数据按 GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 对齐，用 glBindBufferRange 按偏移绑定
+// 5. 一帧内区域写满时插入 fence 并换到下一个区域继续写（必要时等待），下一帧开始时把区域扩大一倍重新分配
+// 6. 驱动不支持 glBufferStorage 时退回普通缓冲区 + glBufferSubData，调用方的用法不变
+class UniformRingBuffer {
+public:
+    UniformRingBuffer(size_t regionSize, int regionCount = 3, GLenum target = GL_UNIFORM_BUFFER);
+    ~UniformRingBuffer();
+
+    UniformRingBuffer(const UniformRingBuffer&) = delete;
+    UniformRingBuffer& operator=(const UniformRingBuffer&) = delete;
+
+    // 缓冲区是否创建成功
+    bool isValid() const { return mBuffer != 0; }
+
+    // 是否为持久映射（false 表示退回了 glBufferSubData）
+    bool isPersistent() const { return mMappedData != nullptr; }
+
+    // 开始一帧：上一帧写满过时先扩大区域，然后切换到下一个区域，必要时等待该区域上一次使用的 fence
+    void beginFrame();
+
+    // 结束一帧：为当前区域插入 fence
+    void endFrame();
+
+    // 分配 size 字节并拷贝数据；只有不在 beginFrame/endFrame 之间或单块数据大于整个区域时返回 false
+    bool push(const void* data, size_t size, size_t& offset);
+
+    // 把 [offset, offset + size) 绑定到指定绑定点
+    void bindRange(GLuint bindingPoint, size_t offset, size_t size) const;
+
+    // 统计信息
+    uint64_t getStallCount() const { return mStallCount; }          // 等待 fence 的次数
+    double getStallTimeMs() const { return mStallTimeMs; }          // 等待 fence 的累计时长
+    uint64_t getOverflowCount() const { return mOverflowCount; }    // 一帧内区域写满、换到下一个区域的次数
+    uint64_t getGrowCount() const { return mGrowCount; }            // 区域扩大（重新分配缓冲区）的次数
+    size_t getLastFrameBytes() const { return mLastFrameBytes; }    // 上一帧使用的字节数
+    size_t getRegionSize() const { return mRegionSize; }
+
+    // 打印统计信息
+    void printStats() const;
+
+private:
+    // 按 mRegionSize * mRegionCount 创建缓冲区 / 释放缓冲区与所有 fence
+    void create();
+    void destroy();
+
+    // 为 region 插入 fence / 等待并删除 region 的 fence
+    void fenceRegion(int region);
+    void waitRegion(int region);
+
+    // 在当前区域预留 size 字节，区域写满时换到下一个区域
+    bool reserve(size_t size, size_t& offset);
+
+private:
+    GLenum mTarget{ GL_UNIFORM_BUFFER };
+    GLuint mBuffer{ 0 };
+    uint8_t* mMappedData{ nullptr };
+
+    size_t mRegionSize{ 0 };
+    size_t mPendingRegionSize{ 0 };     // 写满后要扩大到的区域大小，下一次 beginFrame 时生效
+    int mRegionCount{ 3 };
+    size_t mAlignment{ 256 };
+
+    int mCurrentRegion{ -1 };
+    bool mInFrame{ false };             // 处于 beginFrame 与 endFrame 之间
+    size_t mRegionOffset{ 0 };          // 当前区域内已使用的字节数
+    size_t mFrameBytes{ 0 };            // 本帧在之前（已写满的）区域中使用的字节数
+    std::vector<GLsync> mFences{};      // 每个区域一个 fence
+
+    uint64_t mStallCount{ 0 };
+    double mStallTimeMs{ 0.0 };
+    uint64_t mOverflowCount{ 0 };
+    uint64_t mGrowCount{ 0 };
+    size_t mLastFrameBytes{ 0 };
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include "../core.h"
+#include "../shader.h"
+
+// 加权混合 OIT（Weighted Blended Order-Independent Transparency）的渲染目标与合成
+// 1. 累积目标 RGBA16F：sum(color * alpha * w) 与 sum(alpha * w)；透射率目标 R16F：prod(1 - alpha)
+// 2. 深度附件的格式跟随场景目标（默认帧缓冲或外部 FBO），每帧把不透明物体的深度复制过来，透明物体只做深度测试不写深度
+// 3. 尺寸或深度格式变化时重新创建附件（窗口缩放后自动跟随）
+// 4. 合成：全屏三角形把平均颜色按透射率叠加到场景目标上
+class WeightedBlendedOIT {
+public:
+    WeightedBlendedOIT();
+    ~WeightedBlendedOIT();
+
+    WeightedBlendedOIT(const WeightedBlendedOIT&) = delete;
+    WeightedBlendedOIT& operator=(const WeightedBlendedOIT&) = delete;
+
+    // 开始累积：准备附件、复制 sceneFbo 的深度、清空累积目标并设置混合状态；之后绑定的是 OIT 的 FBO
+    // 返回 false 表示附件创建失败，调用方应退回排序混合
+    bool begin(GLuint sceneFbo, int width, int height);
+
+    // 合成到 sceneFbo，结束后恢复常用状态（开启深度测试与深度写入、关闭混合）
+    void composite(GLuint sceneFbo);
+
+    int getWidth() const { return mWidth; }
+    int getHeight() const { return mHeight; }
+
+    // 附件占用的显存（字节，估算值）
+    size_t getMemoryBytes() const;
+
+    // 查询 fbo 的深度 / 模板格式，没有深度附件时返回 GL_NONE（深度剥离也用它创建同格式的深度附件）
+    static GLenum queryDepthFormat(GLuint fbo, bool& hasStencil);
+
+private:
+    bool createTargets(int width, int height, GLenum depthFormat);
+    void destroyTargets();
+
+private:
+    GLuint mFbo{ 0 };
+    GLuint mAccumTexture{ 0 };
+    GLuint mRevealageTexture{ 0 };
+    GLuint mDepthBuffer{ 0 };
+    GLenum mDepthFormat{ GL_NONE };
+    bool mHasStencil{ false };
+    int mWidth{ 0 };
+    int mHeight{ 0 };
+
+    Shader* mCompositeShader{ nullptr };
+    GLuint mEmptyVao{ 0 };      // 全屏三角形由 gl_VertexID 生成，核心模式下仍需要绑定一个 VAO
+};
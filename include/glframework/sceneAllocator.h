@@ -0,0 +1,93 @@
+#pragma once
+#include "core.h"
+#include "object.h"
+#include "tools/pool.h"
+
+// 场景对象分配器：Object / Mesh / Scene / Material / Geometry 等按类型放入各自的 Pool
+// 1. create<T>() 代替 new T()，返回的指针在对象释放前一直有效
+// 2. getHandle() 取得带代数的句柄，get() 时可以检测出已经释放的对象
+// 3. destroyTree() 释放一棵子树；releaseAll() 一次性释放所有池中的对象（卸载整个场景）
+// 4. 池只增不减，反复加载/卸载场景时不再向系统申请内存
+// 注意：池本身在程序退出时不析构（那时 OpenGL 上下文已经销毁），需要释放 GL 资源请在退出前调用 releaseAll()
+class SceneAllocator {
+public:
+    template<typename T, typename... Args>
+    static T* create(Args&&... args) {
+        return getPool<T>().create(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    static PoolHandle<T> getHandle(const T* object) {
+        return getPool<T>().getHandle(object);
+    }
+
+    // 句柄已失效时返回 nullptr
+    template<typename T>
+    static T* get(PoolHandle<T> handle) {
+        return getPool<T>().get(handle);
+    }
+
+    // 释放单个对象，句柄已失效或对象不在池中时返回 false
+    // 场景节点请使用 destroyTree，它会同时处理父子关系
+    template<typename T>
+    static bool destroy(PoolHandle<T> handle) {
+        return getPool<T>().destroy(handle);
+    }
+
+    template<typename T>
+    static bool destroy(T* object) {
+        Pool<T>& pool = getPool<T>();
+        if (object == nullptr || !pool.owns(object)) {
+            return false;
+        }
+        return pool.destroy(object);
+    }
+
+    // 释放 root 及其所有后代：池中的节点归还给池，其余节点（new 出来的）直接 delete
+    // 不会释放 Mesh 引用的几何体与材质（它们可能被多个 Mesh 共享）
+    static void destroyTree(Object* root);
+
+    // 释放所有池中的对象，场景节点的变换数据一次性批量删除
+    static void releaseAll();
+
+    // 统计信息：存活对象总数、向系统申请内存块的累计次数
+    static size_t getLiveCount();
+    static size_t getBlockAllocations();
+
+private:
+    SceneAllocator() = default;
+
+    // 类型擦除后的池，用于 releaseAll 与统计
+    struct PoolEntry {
+        void* pool{ nullptr };
+        void (*clear)(void* pool){ nullptr };
+        size_t (*liveCount)(const void* pool){ nullptr };
+        size_t (*blockAllocations)(const void* pool){ nullptr };
+    };
+
+    template<typename T>
+    static Pool<T>& getPool() {
+        // 每个类型一个池，第一次使用时创建并登记
+        static Pool<T>* pool = registerPool(new Pool<T>());
+        return *pool;
+    }
+
+    template<typename T>
+    static Pool<T>* registerPool(Pool<T>* pool) {
+        PoolEntry entry;
+        entry.pool = pool;
+        entry.clear = [](void* p) { static_cast<Pool<T>*>(p)->clear(); };
+        entry.liveCount = [](const void* p) { return static_cast<const Pool<T>*>(p)->getLiveCount(); };
+        entry.blockAllocations = [](const void* p) { return static_cast<const Pool<T>*>(p)->getBlockAllocations(); };
+        getEntries().push_back(entry);
+        return pool;
+    }
+
+    static std::vector<PoolEntry>& getEntries();
+
+    // 释放单个节点（已经断开父子关系、删除了变换数据）
+    static void releaseNode(Object* node);
+
+    // 断开 nodes 之间以及与外部的父子关系，批量删除变换数据
+    static void detachNodes(const std::vector<Object*>& nodes);
+};
@@ -0,0 +1,131 @@
+#pragma once
+#include "core.h"
+#include "mesh.h"
+#include "scene.h"
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+// 场景包围体层次（BVH）：叶子为 Mesh 的世界空间包围盒
+// 1. 构建：SAH 分桶（最长轴）选择划分，根部几层串行展开后各子树交给 JobSystem 并行构建
+// 2. 物体移动：只重新计算移动过的 Mesh 包围盒，并沿父链向上 refit
+// 3. refit 后某个节点的表面积比构建时膨胀超过阈值，说明树已经退化，对该子树局部重建
+// 4. 场景结构变化（增删节点、修改父子关系）时整体重建
+// 5. 查询：视锥（带平面掩码，整棵子树在视锥内时不再逐个检测）、AABB、球、射线
+class SceneBVH {
+public:
+    // 32 字节的节点：count > 0 为叶子，first 指向图元列表；否则 first 为左孩子，右孩子为 first + 1
+    struct Node {
+        glm::vec3 boundsMin{ 0.0f };
+        uint32_t first{ 0 };
+        glm::vec3 boundsMax{ 0.0f };
+        uint32_t count{ 0 };
+    };
+
+    // 射线命中：t 为射线进入包围盒时的参数
+    struct RayHit {
+        Mesh* mesh{ nullptr };
+        float t{ 0.0f };
+    };
+
+    SceneBVH();
+    ~SceneBVH();
+
+    // 每帧调用：结构变化时重建，否则增量 refit（调用前 TransformStorage 需要已经更新）
+    void update(Scene* scene);
+
+    // 重新收集场景中的 Mesh 并完整构建
+    void build(Scene* scene);
+
+    // 只更新移动过的 Mesh，必要时局部重建
+    void refit();
+
+    // 视锥查询：planes 为 6 个平面（法线指向视锥内部），结果追加到 out 中
+    void queryFrustum(const glm::vec4 planes[6], std::vector<Mesh*>& out) const;
+    void queryAABB(const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<Mesh*>& out) const;
+    void querySphere(const glm::vec3& center, float radius, std::vector<Mesh*>& out) const;
+
+    // 射线查询：返回包围盒与射线相交的 Mesh，按 t 从近到远排序
+    void queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<RayHit>& out) const;
+
+    // 没有包围盒的 Mesh（查询时总是视为可见）
+    const std::vector<Mesh*>& getUnboundedMeshes() const { return mUnbounded; }
+
+    // 局部重建阈值：节点表面积超过构建时的 factor 倍即视为退化
+    void setDegradeFactor(float factor) { mDegradeFactor = factor; }
+
+    // 统计信息
+    size_t getMeshCount() const { return mMeshes.size(); }
+    size_t getNodeCount() const { return mNodeCount; }
+    size_t getLastVisitedNodes() const { return mVisitedNodes.load(std::memory_order_relaxed); }   // 最近一次查询访问的节点数
+    size_t getRefitCount() const { return mRefitCount; }          // 最近一次 refit 更新的 Mesh 数
+    size_t getPartialRebuilds() const { return mPartialRebuilds; }  // 累计局部重建次数
+    size_t getFullRebuilds() const { return mFullRebuilds; }        // 累计完整重建次数
+    double getLastUpdateTimeMs() const { return mUpdateTimeMs; }
+
+    // 把 Mesh 的局部包围盒变换到世界空间
+    static void computeWorldBounds(const Geometry* geometry, const glm::mat4& modelMatrix, glm::vec3& boundsMin, glm::vec3& boundsMax);
+
+private:
+    // 构建任务：把图元区间 [begin, end) 构建到节点 nodeIndex 上
+    struct BuildTask {
+        uint32_t nodeIndex{ 0 };
+        uint32_t begin{ 0 };
+        uint32_t end{ 0 };
+    };
+
+    // 构建子树；parallelTasks 非空时，大于阈值的子树不继续展开而是放入任务列表
+    void buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, std::vector<BuildTask>* parallelTasks);
+
+    // 对区间 [begin, end) 做 SAH 分桶，返回划分位置；不值得划分时返回 begin
+    uint32_t partition(uint32_t begin, uint32_t end, const glm::vec3& centroidMin, const glm::vec3& centroidMax);
+
+    // 重建整棵树（图元已经收集好）
+    void rebuild();
+
+    // 重建以 nodeIndex 为根的子树（新节点追加在数组末尾）
+    void rebuildSubtree(uint32_t nodeIndex);
+
+    uint32_t allocateNodePair();
+
+    static float surfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+private:
+    // 图元数据（下标为图元编号）
+    std::vector<Mesh*> mMeshes{};
+    std::vector<glm::vec3> mPrimMin{};
+    std::vector<glm::vec3> mPrimMax{};
+    std::vector<glm::vec3> mPrimCentroid{};
+    std::vector<uint32_t> mPrimVersion{};       // 上次计算包围盒时的世界矩阵版本号
+    std::vector<uint32_t> mPrimLeaf{};          // 图元所在的叶子节点
+
+    // 叶子引用的图元编号，每棵子树的图元在其中是连续的
+    std::vector<uint32_t> mPrimIndices{};
+
+    // 节点数据：热数据放在 mNodes，构建/refit 用到的冷数据放在并列数组中
+    std::vector<Node> mNodes{};
+    std::vector<uint32_t> mNodeParents{};
+    std::vector<uint32_t> mNodeRangeBegin{};    // 子树的图元区间
+    std::vector<uint32_t> mNodeRangeEnd{};
+    std::vector<float> mNodeBuildArea{};        // 构建时的表面积
+    std::atomic<uint32_t> mNodeAllocator{ 0 };
+    uint32_t mNodeCount{ 0 };
+    uint32_t mOrphanNodes{ 0 };                 // 局部重建后废弃的旧节点数
+    uint32_t mParallelGrain{ 1024 };            // 图元数不超过该值的子树作为一个并行构建任务
+
+    std::vector<Mesh*> mUnbounded{};
+
+    // refit 临时数据，跨帧复用
+    std::vector<uint32_t> mDirtyNodes{};
+    std::vector<uint8_t> mNodeFlags{};
+
+    Scene* mScene{ nullptr };
+    uint64_t mStructureVersion{ 0 };
+    float mDegradeFactor{ 2.0f };
+
+    mutable std::atomic<size_t> mVisitedNodes{ 0 };
+    size_t mRefitCount{ 0 };
+    size_t mPartialRebuilds{ 0 };
+    size_t mFullRebuilds{ 0 };
+    double mUpdateTimeMs{ 0.0 };
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include "core.h"
+#include "scene.h"
+#include "mesh.h"
+#include "light/directionalLight.h"
+#include "light/pointLight.h"
+#include "light/spotLight.h"
+#include "light/ambientLight.h"
+#include "tools/tools.h"
+#include <cstdint>
+#include <vector>
+
+// 压力测试场景的参数
+struct SceneGeneratorConfig {
+    uint32_t seed{ 1 };                 // 相同的参数与种子生成完全相同的场景（与平台、标准库实现无关）
+
+    int meshCount{ 1000 };
+    int geometryCount{ 16 };            // 不同几何体的个数（立方体 / 球 / 平面轮流，尺寸与细分随机），Mesh 随机共享
+    int phongMaterialCount{ 4 };        // 各类材质的个数，Mesh 随机选用
+    int pbrMaterialCount{ 4 };
+    int whiteMaterialCount{ 1 };
+    float transparentRatio{ 0.0f };     // 透明 Mesh 的比例（0 ~ 1），透明 Mesh 使用对应材质的混合版本
+    int hierarchyDepth{ 1 };            // 层级深度，1 表示所有 Mesh 都直接挂在 Scene 下
+
+    int directionalLightCount{ 1 };
+    int pointLightCount{ 4 };
+    int spotLightCount{ 1 };
+
+    float spacing{ 3.0f };              // 相邻 Mesh 的平均间距，场景边长随 Mesh 数的立方根增长，密度不变
+};
+
+// 生成的场景：持有所有节点、几何体、材质、shader 与光源，析构时释放（需要 OpenGL 上下文）
+class GeneratedScene {
+public:
+    GeneratedScene() = default;
+    ~GeneratedScene();
+
+    GeneratedScene(const GeneratedScene&) = delete;
+    GeneratedScene& operator=(const GeneratedScene&) = delete;
+
+public:
+    Scene* mScene{ nullptr };                   // 场景根节点，用于 Renderer::render(Scene*, ...)
+    std::vector<Mesh*> mMeshes{};               // 所有 Mesh（按生成顺序），用于 Renderer::render(meshes, ...)
+    std::vector<Geometry*> mGeometries{};
+    std::vector<Material*> mMaterials{};        // 不透明材质在前，混合版本在后
+    std::vector<Shader*> mShaders{};            // 材质使用的 shader（点光源数量与场景一致）
+
+    std::vector<DirectionalLight*> mDirectionalLights{};
+    std::vector<PointLight*> mPointLights{};
+    std::vector<SpotLight*> mSpotLights{};
+    AmbientLight* mAmbientLight{ nullptr };
+
+    // 场景以原点为中心，半径用于放置相机
+    float mRadius{ 0.0f };
+    size_t mTriangleCount{ 0 };                 // 所有 Mesh 的三角形总数（每帧全部可见时提交的数量）
+    size_t mTransparentCount{ 0 };
+};
+
+// 程序化生成压力测试场景，用于测量渲染器随规模的扩展性
+// 1. 随机数只使用 std::mt19937 的原始输出（标准规定了序列），不用 std::uniform_*_distribution（各实现不同）
+// 2. 节点由 SceneAllocator 分配，析构时 destroyTree 批量释放
+// 3. 材质的 shader 按点光源数量编译（POINT_LIGHT_COUNT），Renderer 需要用 getShaderMacros 的宏创建同样的 shader
+class SceneGenerator {
+public:
+    static GeneratedScene* generate(const SceneGeneratorConfig& config);
+
+    // 各类材质使用的 shader（相对 SHADER_DIR）
+    static const char* getPhongVertexPath() { return "/PBR-Light/PBR.vert"; }
+    static const char* getPhongFragmentPath() { return "/PBR-Light/Blinn-phong-point-direct.frag"; }
+    static const char* getPBRVertexPath() { return "/PBR-Light/PBR.vert"; }
+    static const char* getPBRFragmentPath() { return "/PBR-Light/PBR-jinglian_1.frag"; }
+    static const char* getWhiteVertexPath() { return "/whiteShader/white.vert"; }
+    static const char* getWhiteFragmentPath() { return "/whiteShader/white.frag"; }
+
+    // shader 的宏：点光源数组的大小
+    static std::vector<ShaderMacro> getShaderMacros(const SceneGeneratorConfig& config);
+};
@@ -4,8 +4,12 @@
 #include<glad/glad.h>	// Ҫ glfw3.h ǰ
 #include <glm/glm.hpp>  // ھ/ͣsetMatrix4x4/setVector3
 #include <string>
+#include <unordered_map>
 #include "tools.h"
 
+// ÿλݿ PerDraw shaders/common/perDraw.glsl̶ʹõİ󶨵
+#define PER_DRAW_BLOCK_BINDING 0
+
 // ShaderࣺļزOpenGLɫ
 class Shader {
 public:
@@ -15,6 +19,9 @@ public:
     // 캯Դַأֱù෵صַ
     Shader(const char* vertexSource, const char* fragmentSource, std::vector<ShaderMacro> macros);
 
+    // ɫҪ OpenGL 4.3ͬ ShaderMacro 
+    static Shader* createCompute(const char* computePath, std::vector<ShaderMacro> macros = std::vector<ShaderMacro>{});
+
     // ͷOpenGL shaderԴ
     ~Shader();
 
@@ -27,6 +34,8 @@ public:
     void setFloat(const std::string& name, float value);
     // Uniformbool
     void setBool(const std::string& name, bool value);
+    // Uniformvec2
+    void setVector2(const std::string& name, glm::vec2 value);
     // Uniformvec3ͣ1x/y/z
     void setVector3(const std::string& name, float x, float y, float z);
     // Uniformvec3ͣ2float飩
@@ -39,9 +48,38 @@ public:
 
     void setMatrix3x3(const std::string& name, glm::mat3 value);
 
+    // ѯuniformλã棬ÿֻѯһΣ
+    GLint getUniformLocation(const std::string& name);
+
+    // Ƿ PerDraw ݿ飨ÿλƵͨλ룩
+    bool hasPerDrawBlock() const { return mHasPerDrawBlock; }
+
+    // ƬɫǷֵָ OIT  oitRevealage
+    bool hasFragmentOutput(const std::string& name) const;
+
+    // ͬһԴټһƬɫı壨͸ģʽ OIT_PASSһʹʱ벢
+    // û requiredOutput ԴûаӦĹļʱ nullptr֮ظ
+    Shader* getVariant(const std::string& macro, const std::string& requiredOutput);
+
+private:
+    // ɫ createCompute 
+    Shader() : mProgram(0) {}
+
 private:
     GLuint mProgram;  // 洢OpenGL shaderID
 
+    // Դļ·꣬ڱ
+    std::string mVertexPath{};
+    std::string mFragmentPath{};
+    std::vector<ShaderMacro> mMacros{};
+    std::unordered_map<std::string, Shader*> mVariants{};  //  -> 壨֧ʱΪ nullptr
+
+    std::unordered_map<std::string, GLint> mUniformLocations{};    // uniform -> λ
+    bool mHasPerDrawBlock{ false };
+
+    // ˽зӺ uniform ݿ󶨵̶İ󶨵
+    void bindUniformBlocks();
+
     // ˽зshader/Ӵ
     void checkShaderErrors(GLuint target, std::string type);
 };
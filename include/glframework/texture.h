@@ -5,6 +5,7 @@
 #include <SDL2/SDL.h>
 #include <glad/glad.h>  // GLuintδ
 #include <map>
+#include <functional>
 #include <windows.h> // Ensure this header is included for APIENTRY definition
 #include <GL/gl.h> // Include OpenGL header for GLuint
 
@@ -20,14 +21,14 @@ private:
     // ṹѾصظͬһ
 
 private:
-    // ֱתSDL
-    void flipSurfaceVertically(SDL_Surface* surface);
-
     // ʼSDL_imageֵ֧ͼʽTIF
     static bool initImageFormats();
     // ̬ԱȷSDL_imageֻʼһ
     static bool sInitialized;
 
+    // ѾתõRGBA32洴ӹܱͷ
+    Texture(SDL_Surface* rgbaSurface, const std::string& label, unsigned int unit);
+
 public:
     // ̬
     // Ӳ̶ȡļʹظ
@@ -41,6 +42,18 @@ public:
         uint32_t heightIn
     );
 
+    // 첽أ JobSystem Ĺִ߳У֮ GL ̣߳JobSystem::pumpMainThreadϴ
+    // ģ̣߳JobSystem::pumpSimulationThread onLoadedʧʱ onLoaded յ nullptrѾصģ̵߳
+    static void createTextureAsync(const std::string& path, unsigned int unit, std::function<void(Texture*)> onLoaded);
+    //  loadSurface Ľ棨Ҫ OpenGL ģӹܱͷ
+    static Texture* createTextureFromSurface(SDL_Surface* rgbaSurface, const std::string& path, unsigned int unit);
+
+    // ȡͼƬתΪRGBA32תYᣨϴǰCPU֣ҪOpenGLģ
+    // صıɵ÷SDL_FreeSurfaceͷţʧʱ׳std::runtime_error
+    static SDL_Surface* loadSurface(const std::string& path);
+    // ֱתSDL棨SDLԭϽǣOpenGL½ǣ
+    static void flipSurfaceVertically(SDL_Surface* surface);
+
     // 캯ļ·Ӳжȡݴ
     Texture(const std::string& path, unsigned int unit);
 
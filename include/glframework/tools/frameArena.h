@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+// 每帧的线性分配器：只用于当帧有效的临时数据（渲染列表等）
+// 1. 分配只是移动偏移量，不单独释放，reset() 时整体归零
+// 2. 当前内存块用完时临时追加新块；reset() 时把多块合并成一块足够大的内存
+//    所以几帧之后容量稳定，每帧不再向系统申请内存
+// 3. 只能存放可平凡析构的类型，reset() 不会调用析构函数
+class FrameArena {
+public:
+    explicit FrameArena(size_t initialSize = 64 * 1024);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // 分配 size 字节，按 alignment 对齐
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // 分配 count 个 T（未初始化）
+    template<typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena only holds trivially destructible types");
+        if (count == 0) {
+            return nullptr;
+        }
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // 帧结束：所有分配作废
+    void reset();
+
+    size_t getUsedBytes() const { return mUsedBytes; }                  // 本帧已分配的字节数
+    size_t getPeakBytes() const { return mPeakBytes; }                  // 历史最大值
+    size_t getCapacity() const;
+    size_t getBlockAllocations() const { return mBlockAllocations; }    // 向系统申请内存块的累计次数
+
+private:
+    struct Block {
+        unsigned char* data{ nullptr };
+        size_t size{ 0 };
+        size_t offset{ 0 };
+    };
+
+    void addBlock(size_t minSize);
+
+private:
+    std::vector<Block> mBlocks{};
+    size_t mUsedBytes{ 0 };
+    size_t mPeakBytes{ 0 };
+    size_t mBlockAllocations{ 0 };
+};
+
+// 数组视图：指向一段连续元素（例如 FrameArena 中的数据），不拥有内存
+template<typename T>
+class ArrayView {
+public:
+    ArrayView() = default;
+    ArrayView(const T* data, size_t count) : mData(data), mCount(count) {}
+
+    const T* begin() const { return mData; }
+    const T* end() const { return mData + mCount; }
+    const T& operator[](size_t index) const { return mData[index]; }
+    const T* data() const { return mData; }
+    size_t size() const { return mCount; }
+    bool empty() const { return mCount == 0; }
+
+private:
+    const T* mData{ nullptr };
+    size_t mCount{ 0 };
+};
@@ -0,0 +1,357 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define JOB_SYSTEM_COROUTINES 1
+#endif
+
+// 定长的任务函数：可调用对象直接构造在内部缓冲区中，提交、偷取、执行都不分配内存（std::function 的小对象缓冲区只有两三个指针大）
+// 超过 STORAGE_SIZE 字节或移动可能抛异常的可调用对象退回堆上分配；引擎内部提交的任务都不超过
+// 只能移动，移动时把可调用对象搬到目标的缓冲区中
+class JobFunction {
+public:
+    static constexpr size_t STORAGE_SIZE = 64;
+
+    JobFunction() = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, JobFunction>>>
+    JobFunction(F&& func) {
+        using T = std::decay_t<F>;
+        if constexpr (sizeof(T) <= STORAGE_SIZE && alignof(T) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<T>) {
+            new (mStorage) T(std::forward<F>(func));
+            mOps = &InlineOps<T>::sOps;
+        }
+        else {
+            new (mStorage) T*(new T(std::forward<F>(func)));
+            mOps = &HeapOps<T>::sOps;
+        }
+    }
+
+    JobFunction(JobFunction&& other) noexcept { moveFrom(other); }
+    JobFunction& operator=(JobFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    JobFunction(const JobFunction&) = delete;
+    JobFunction& operator=(const JobFunction&) = delete;
+
+    ~JobFunction() { reset(); }
+
+    explicit operator bool() const { return mOps != nullptr; }
+    void operator()() { mOps->invoke(mStorage); }
+
+    void reset() {
+        if (mOps != nullptr) {
+            mOps->destroy(mStorage);
+            mOps = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*relocate)(void* dst, void* src);     // 移动构造到 dst 并析构 src
+        void (*destroy)(void* storage);
+    };
+
+    template<typename T>
+    struct InlineOps {
+        static void invoke(void* storage) { (*static_cast<T*>(storage))(); }
+        static void relocate(void* dst, void* src) {
+            new (dst) T(std::move(*static_cast<T*>(src)));
+            static_cast<T*>(src)->~T();
+        }
+        static void destroy(void* storage) { static_cast<T*>(storage)->~T(); }
+        static constexpr Ops sOps{ &invoke, &relocate, &destroy };
+    };
+
+    template<typename T>
+    struct HeapOps {
+        static void invoke(void* storage) { (**static_cast<T**>(storage))(); }
+        static void relocate(void* dst, void* src) { new (dst) T*(*static_cast<T**>(src)); }
+        static void destroy(void* storage) { delete *static_cast<T**>(storage); }
+        static constexpr Ops sOps{ &invoke, &relocate, &destroy };
+    };
+
+    void moveFrom(JobFunction& other) {
+        if (other.mOps != nullptr) {
+            other.mOps->relocate(mStorage, other.mStorage);
+            mOps = other.mOps;
+            other.mOps = nullptr;
+        }
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char mStorage[STORAGE_SIZE];
+    const Ops* mOps{ nullptr };
+};
+
+// 任务计数器：提交任务时加一，任务执行完减一，减到 0 时依赖它的等待者（wait、co_await）继续
+// 计数器必须比提交到它上面的任务活得久
+class JobCounter {
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool isDone() const { return mValue.load(std::memory_order_acquire) == 0; }
+    int getValue() const { return mValue.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+    friend class TaskGraph;
+
+    void add(int count) { mValue.fetch_add(count, std::memory_order_relaxed); }
+
+    // 减一，减到 0 时把等待者提交给 JobSystem
+    void finish();
+
+    // 计数器为 0 时立即提交 job，否则等减到 0 时提交
+    void addWaiter(JobFunction job);
+
+private:
+    std::atomic<int> mValue{ 0 };
+    std::mutex mMutex;
+    std::vector<JobFunction> mWaiters;
+};
+
+// 任务系统：引擎唯一的线程池，剔除、渲染包生成、包围体构建、资源加载共用
+// 1. 每个线程一个双端队列：自己从尾部取（后进先出，数据还在缓存里），空闲时从其它队列头部偷（先进先出，偷到的是大块任务）；
+//    队列各自加锁，只有偷任务时才会与所有者竞争；不是工作线程的线程（主线程、渲染线程等）第一次使用时各自领取一个队列
+//    队列是容量固定的环形数组，任务函数是定长的 JobFunction，稳定后提交任务不分配内存；队列满时任务在提交线程上直接执行，
+//    后台队列除外：满了放进溢出链表（会分配内存），后台任务不会在提交线程（GL 线程）上执行
+// 2. wait 不阻塞：等待期间执行队列中的其它任务，任务内部可以再提交并等待子任务（嵌套 parallelFor），不会死锁
+// 3. 工作线程没有任务时在条件变量上睡眠，提交任务时只在有线程睡眠的情况下才加锁唤醒
+// 4. GL 线程队列：runOnMainThread 提交的任务由 GL 线程每帧调用 pumpMainThread 执行（Application::update 或渲染线程中），
+//    用于把后台解码好的数据上传到 GPU；模拟线程队列：runOnSimulationThread 提交的任务由主线程在 Application::update 中执行，
+//    用于修改场景（加载完成的回调）；协程用 co_await JobSystem::background() / mainThread() / simulationThread() 在三者之间切换
+//    没有渲染线程时 GL 线程与模拟线程是同一个线程，切换不挂起
+// 5. 后台任务（runBackground）：耗时长、不急的任务（资源解码、三角形 BVH 构建）放在单独的队列中，只有工作线程在没有普通任务时才执行，
+//    GL 线程在 wait 中帮忙时不会领到它们，不会因此卡一帧
+// 6. 线程编号：不是工作线程的线程为 0 ~ MAX_EXTERNAL_THREADS - 1（第一次使用时领取，线程退出时归还，主线程通常为 0），
+//    工作线程为 MAX_EXTERNAL_THREADS 起的 getWorkerCount() 个；每个线程的编号互不相同，可以索引大小为 getThreadCount() 的每线程缓冲区；
+//    持有某个线程的缓冲区时不要在同一个任务里等待（等待期间可能在本线程执行同一批的其它任务）
+class JobSystem {
+public:
+    using JobFunc = JobFunction;
+    using RangeFunc = std::function<void(size_t begin, size_t end)>;
+
+    // 提交一个任务，counter 不为空时加一，任务完成后减一
+    static void run(JobFunc job, JobCounter* counter = nullptr);
+
+    // 提交一个后台任务，见第 5 条
+    static void runBackground(JobFunc job, JobCounter* counter = nullptr);
+
+    // 等待计数器归零，期间执行其它任务
+    static void wait(JobCounter& counter);
+
+    // 并行执行 func(begin, end)，minBatch 为每块最少的元素个数；元素太少时直接在当前线程执行；
+    // 调用线程参与执行，返回时所有块都已完成
+    static void parallelFor(size_t count, size_t minBatch, const RangeFunc& func);
+
+    // GL 线程
+    static void setMainThread();                // 调用线程作为 GL 线程（Application::init 中调用）
+    static bool isMainThread();
+    static void runOnMainThread(JobFunc job);   // 任意线程调用
+    static size_t pumpMainThread();             // GL 线程每帧调用，返回执行的任务数
+
+    // 模拟线程：持有场景的线程（主线程），渲染线程模式下场景只能在这里修改
+    static void setSimulationThread();          // 调用线程作为模拟线程（Application::init 中调用）
+    static bool isSimulationThread();
+    static void runOnSimulationThread(JobFunc job);     // 任意线程调用
+    static size_t pumpSimulationThread();       // 模拟线程每帧调用，返回执行的任务数
+
+    // 工作线程数量（不含调用线程），第一次使用时按硬件线程数创建
+    static size_t getWorkerCount();
+
+    // 同时使用任务系统的非工作线程（各自有编号与队列）的上限：主线程、渲染线程，再留两个给加载/工具线程；
+    // 第 MAX_EXTERNAL_THREADS + 1 个线程第一次使用任务系统时断言失败并终止程序（编号共用会破坏每线程缓冲区的独占）
+    static constexpr size_t MAX_EXTERNAL_THREADS = 4;
+
+    // 当前线程编号，见第 6 条；非工作线程第一次调用时领取编号
+    static size_t getThreadIndex();
+
+    // 线程编号的上界：MAX_EXTERNAL_THREADS + getWorkerCount()，用作每线程缓冲区的大小
+    static size_t getThreadCount();
+
+    // 当前线程是否为工作线程
+    static bool isWorkerThread();
+
+    // 设置工作线程数量（0 表示按硬件线程数自动选择），会先停止已有线程（不能有未完成的任务）
+    static void setWorkerCount(size_t count);
+
+    // 停止并回收所有工作线程（程序退出前调用）
+    static void shutdown();
+
+    // 统计：执行的任务数与其中被偷走执行的任务数
+    struct Stats {
+        uint64_t executed{ 0 };
+        uint64_t stolen{ 0 };
+    };
+    static Stats getStats();
+
+#ifdef JOB_SYSTEM_COROUTINES
+    // co_await JobSystem::background()：作为后台任务在工作线程上继续
+    struct BackgroundAwaitable {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { JobSystem::runBackground([handle] { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+
+    // co_await JobSystem::mainThread()：在 GL 线程的下一次 pumpMainThread 中继续（已经在 GL 线程时不挂起）
+    struct MainThreadAwaitable {
+        bool await_ready() const noexcept { return JobSystem::isMainThread(); }
+        void await_suspend(std::coroutine_handle<> handle) const { JobSystem::runOnMainThread([handle] { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+
+    // co_await JobSystem::waitFor(counter)：计数器归零后在工作线程上继续，不占用线程
+    struct CounterAwaitable {
+        JobCounter& counter;
+        bool await_ready() const noexcept { return counter.isDone(); }
+        void await_suspend(std::coroutine_handle<> handle) const { counter.addWaiter([handle] { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+
+    // co_await JobSystem::simulationThread()：在模拟线程的下一次 pumpSimulationThread 中继续（已经在模拟线程时不挂起）
+    struct SimulationThreadAwaitable {
+        bool await_ready() const noexcept { return JobSystem::isSimulationThread(); }
+        void await_suspend(std::coroutine_handle<> handle) const { JobSystem::runOnSimulationThread([handle] { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+
+    static BackgroundAwaitable background() { return {}; }
+    static MainThreadAwaitable mainThread() { return {}; }
+    static SimulationThreadAwaitable simulationThread() { return {}; }
+    static CounterAwaitable waitFor(JobCounter& counter) { return { counter }; }
+#endif
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+private:
+    JobSystem() = default;
+
+    struct Job {
+        JobFunc func;
+        JobCounter* counter{ nullptr };
+    };
+
+    // 每个线程一个：容量固定的环形数组，[head, tail) 为队列中的任务，下标对容量取模
+    static constexpr size_t QUEUE_CAPACITY = 512;     // 2 的幂
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Job> slots;
+        size_t head{ 0 };
+        size_t tail{ 0 };
+        std::deque<Job> overflow;           // 环形数组满后的任务（只有后台队列使用），按提交顺序排在环形数组之后
+        std::atomic<size_t> size{ 0 };     // 偷任务时不加锁跳过空队列
+
+        Queue() : slots(QUEUE_CAPACITY) {}
+    };
+
+    static void start(size_t count);
+    static void workerLoop(size_t threadIndex);
+
+    // 队列满时：allowOverflow 为 true 放进溢出链表，否则返回 false，任务没有被取走
+    static bool push(Queue& queue, Job& job, bool allowOverflow);
+    static bool popBack(Queue& queue, Job& job);
+    static bool popFront(Queue& queue, Job& job);
+    static void submit(Queue& queue, JobFunc job, JobCounter* counter);
+
+    // 先取自己队列的尾部，再从其它队列头部偷，最后（工作线程）取后台队列；执行了一个任务返回 true
+    static bool runOne(size_t threadIndex);
+    static void execute(Job& job);
+
+private:
+    static std::mutex sStartMutex;
+    static std::atomic<bool> sStarted;
+    static std::vector<std::thread> sThreads;
+    static std::vector<std::unique_ptr<Queue>> sQueues;
+    static Queue sBackgroundQueue;
+
+    static std::atomic<bool> sStop;
+    static std::atomic<size_t> sPendingJobs;        // 队列中还没被取走的任务数
+    static std::atomic<size_t> sSleepingWorkers;
+    static std::mutex sSleepMutex;
+    static std::condition_variable sSleepCondition;
+
+    static std::atomic<uint64_t> sExecuted;
+    static std::atomic<uint64_t> sStolen;
+
+    // 由指定线程每帧执行的任务：两个数组交换使用，保留容量
+    struct ThreadQueue {
+        std::mutex mutex;
+        std::vector<JobFunc> jobs;
+        std::vector<JobFunc> running;       // 正在执行的任务，只有所属线程访问
+        std::atomic<std::thread::id> owner{};
+    };
+    static void post(ThreadQueue& queue, JobFunc job);
+    static size_t runPosted(ThreadQueue& queue, const char* scopeName);
+
+    static ThreadQueue sMainQueue;          // GL 线程
+    static ThreadQueue sSimulationQueue;
+};
+
+// 依赖图：按依赖关系把一组任务提交给 JobSystem，前驱全部完成后才提交后继
+// 用法：add 返回编号（依赖只能指向之前添加的任务）-> run（调用线程参与执行，返回时全部完成）；可以重复 run
+class TaskGraph {
+public:
+    using TaskId = size_t;
+
+    TaskGraph() = default;
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    TaskId add(std::function<void()> func, const std::vector<TaskId>& dependencies = {});
+    void run();
+    void clear() { mNodes.clear(); }
+    size_t size() const { return mNodes.size(); }
+
+private:
+    struct Node {
+        std::function<void()> func;
+        std::vector<TaskId> successors;
+        int dependencyCount{ 0 };
+        std::atomic<int> remaining{ 0 };
+    };
+
+    void submit(TaskId id);
+
+private:
+    std::vector<std::unique_ptr<Node>> mNodes;
+    JobCounter mCounter;
+};
+
+#ifdef JOB_SYSTEM_COROUTINES
+// 即发即弃的协程：调用时同步执行到第一个挂起点，结束后自动销毁；结果通过回调或共享状态交出
+// 协程中的异常不会传播，需要在协程内部捕获
+struct JobTask {
+    struct promise_type {
+        JobTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+#endif
@@ -0,0 +1,195 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// 池句柄：槽位编号 + 代数。槽位被释放后代数加一，旧句柄随之失效
+template<typename T>
+struct PoolHandle {
+    uint32_t index{ 0xFFFFFFFFu };
+    uint32_t generation{ 0 };
+
+    bool isNull() const { return index == 0xFFFFFFFFu; }
+    bool operator==(const PoolHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const PoolHandle& other) const { return !(*this == other); }
+};
+
+// 类型化对象池：
+// 1. 内存按块（每块 BlockSize 个槽位）申请，块只增不减，对象地址在整个生命周期内不变
+// 2. 释放的槽位进入空闲链表，下次创建直接复用，稳定后不再向系统申请内存
+// 3. 每个槽位记录代数，通过句柄访问时可以检测出已经释放（或被复用）的对象
+// 4. clear() 一次性析构所有存活对象，内存保留给下一次使用
+template<typename T, size_t BlockSize = 256>
+class Pool {
+public:
+    using Handle = PoolHandle<T>;
+
+    Pool() = default;
+    ~Pool() {
+        clear();
+        for (auto block : mBlocks) {
+            ::operator delete(block);
+        }
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    // 在池中构造一个对象
+    template<typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot = acquireSlot();
+        T* object = new (slot->storage) T(std::forward<Args>(args)...);
+        slot->alive = true;
+        mLiveCount++;
+        return object;
+    }
+
+    // 通过句柄取得对象，句柄已失效时返回 nullptr
+    T* get(Handle handle) const {
+        if (handle.index >= mSlotCount) {
+            return nullptr;
+        }
+        Slot* slot = slotAt(handle.index);
+        if (!slot->alive || slot->generation != handle.generation) {
+            return nullptr;
+        }
+        return reinterpret_cast<T*>(slot->storage);
+    }
+
+    // 取得对象当前的句柄（object 必须来自本池）
+    Handle getHandle(const T* object) const {
+        const Slot* slot = reinterpret_cast<const Slot*>(object);
+        Handle handle;
+        handle.index = slot->index;
+        handle.generation = slot->generation;
+        return handle;
+    }
+
+    // object 是否位于本池的内存中
+    bool owns(const T* object) const {
+        const unsigned char* address = reinterpret_cast<const unsigned char*>(object);
+        for (auto block : mBlocks) {
+            const unsigned char* begin = reinterpret_cast<const unsigned char*>(block);
+            if (address >= begin && address < begin + sizeof(Slot) * BlockSize) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 释放对象，句柄已失效时返回 false
+    bool destroy(Handle handle) {
+        T* object = get(handle);
+        if (object == nullptr) {
+            return false;
+        }
+        releaseSlot(reinterpret_cast<Slot*>(object));
+        return true;
+    }
+
+    bool destroy(T* object) {
+        if (object == nullptr) {
+            return false;
+        }
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        if (!slot->alive) {
+            return false;
+        }
+        releaseSlot(slot);
+        return true;
+    }
+
+    // 析构所有存活对象（保留内存块）
+    void clear() {
+        for (uint32_t i = 0; i < mSlotCount; i++) {
+            Slot* slot = slotAt(i);
+            if (slot->alive) {
+                releaseSlot(slot);
+            }
+        }
+    }
+
+    // 对每个存活对象调用 func(T*)
+    template<typename Func>
+    void forEach(Func func) {
+        for (uint32_t i = 0; i < mSlotCount; i++) {
+            Slot* slot = slotAt(i);
+            if (slot->alive) {
+                func(reinterpret_cast<T*>(slot->storage));
+            }
+        }
+    }
+
+    // 预先申请能容纳 count 个对象的内存
+    void reserve(size_t count) {
+        while (mBlocks.size() * BlockSize < count) {
+            addBlock();
+        }
+    }
+
+    size_t getLiveCount() const { return mLiveCount; }
+    size_t getCapacity() const { return mBlocks.size() * BlockSize; }
+    size_t getBlockAllocations() const { return mBlockAllocations; }   // 向系统申请内存块的累计次数
+
+private:
+    // 对象存放在槽位开头，T* 与 Slot* 可以直接互相转换
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        uint32_t index;
+        uint32_t generation;
+        uint32_t nextFree;
+        bool alive;
+    };
+
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+    Slot* slotAt(uint32_t index) const {
+        return mBlocks[index / BlockSize] + index % BlockSize;
+    }
+
+    void addBlock() {
+        Slot* block = static_cast<Slot*>(::operator new(sizeof(Slot) * BlockSize));
+        mBlocks.push_back(block);
+        mBlockAllocations++;
+    }
+
+    Slot* acquireSlot() {
+        Slot* slot = nullptr;
+        if (mFreeHead != INVALID_SLOT) {
+            slot = slotAt(mFreeHead);
+            mFreeHead = slot->nextFree;
+        }
+        else {
+            if (mSlotCount == mBlocks.size() * BlockSize) {
+                addBlock();
+            }
+            slot = slotAt(mSlotCount);
+            slot->index = mSlotCount;
+            slot->generation = 0;
+            mSlotCount++;
+        }
+        slot->nextFree = INVALID_SLOT;
+        slot->alive = false;
+        return slot;
+    }
+
+    void releaseSlot(Slot* slot) {
+        // 先标记为释放，析构过程中再通过句柄访问会得到 nullptr
+        slot->alive = false;
+        slot->generation++;
+        reinterpret_cast<T*>(slot->storage)->~T();
+        slot->nextFree = mFreeHead;
+        mFreeHead = slot->index;
+        mLiveCount--;
+    }
+
+private:
+    std::vector<Slot*> mBlocks{};
+    uint32_t mSlotCount{ 0 };           // 已经使用过的槽位数（其余槽位尚未初始化）
+    uint32_t mFreeHead{ INVALID_SLOT };
+    size_t mLiveCount{ 0 };
+    size_t mBlockAllocations{ 0 };
+};
@@ -0,0 +1,184 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// 性能分析器：记录 CPU 与 GPU 的作用域事件，导出为 Chrome trace JSON（chrome://tracing 或 ui.perfetto.dev 打开）
+// 1. 插桩使用下面的 PROFILE_* 宏；没有定义 ENABLE_PROFILER 时宏展开为空，没有任何开销
+//    （CMake 选项 ENABLE_PROFILER，默认关闭）
+// 2. CPU 事件写入各线程自己的缓冲区（单写者，写入后 release 发布计数，没有锁），一个作用域结束时写入一条
+//    包含开始与结束时间的事件；缓冲区写满后丢弃并计数
+// 3. GPU 事件用 GL_TIMESTAMP 查询（glQueryCounter，可以嵌套，也不与 GpuTimer 的 GL_TIME_ELAPSED 冲突），
+//    每帧 endFrame 时读取已经完成的查询，不等待 GPU；会话开始时用 glGetInteger64v(GL_TIMESTAMP) 对齐 GPU 与 CPU 时钟，
+//    GPU 事件放在单独的 "GPU" 轨道上，并用 flow 箭头连到发出命令的 CPU 作用域
+// 4. 事件名称必须是静态字符串（字符串字面量、__FUNCTION__）；动态的细节（例如文件路径）用 PROFILE_SCOPE_DETAIL，
+//    字符串会被驻留（加锁，只用于加载等本身就很慢的路径）
+// 5. 只在 beginSession 与 endSession 之间记录；GPU 作用域只能在 GL 线程中使用
+class Profiler {
+public:
+    // 开始记录：之前的事件全部丢弃；eventsPerThread 为每个线程缓冲区的容量（事件数）
+    static void beginSession(size_t eventsPerThread = 1 << 16);
+
+    // 结束记录并写出 JSON（GL 线程调用：会等待所有未完成的 GPU 查询）；path 为空时只结束不写出
+    static bool endSession(const std::string& path);
+
+    static bool isRecording() { return sRecording.load(std::memory_order_relaxed); }
+
+    // 当前线程在 trace 中显示的名称（例如 "Main"、"Worker 1"）
+    static void setThreadName(const std::string& name);
+
+    // 每帧调用一次（GL 线程，交换缓冲区之后）：读取已完成的 GPU 查询，并记录帧边界
+    static void endFrame();
+
+    // 相对会话开始的时间（纳秒）
+    static uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - sEpoch).count());
+    }
+
+    // 热路径：写入本线程的缓冲区
+    static void record(const char* name, const char* detail, uint64_t beginNs, uint64_t endNs);
+
+    // GPU 作用域：返回的编号传给 endGpu，不在记录时返回 -1
+    static int beginGpu(const char* name);
+    static void endGpu(int scope);
+
+    // 驻留动态字符串，返回的指针在程序结束前有效
+    static const char* intern(const std::string& text);
+
+    static void writeJson(std::ostream& out);
+
+    // 统计：当前会话中被丢弃的事件数（缓冲区已满）
+    static uint64_t getDroppedCount();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+private:
+    Profiler() = default;
+
+    struct Event {
+        const char* name;
+        const char* detail;
+        uint64_t beginNs;
+        uint64_t endNs;
+    };
+
+    // 每个线程一份；写入只由所属线程进行，读取（导出）只读已发布的部分
+    struct ThreadBuffer {
+        uint32_t threadId{ 0 };
+        std::string name{};                         // 由 sMutex 保护
+        std::unique_ptr<Event[]> events{};
+        size_t capacity{ 0 };
+        std::atomic<size_t> count{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+        std::atomic<uint32_t> session{ 0 };         // 缓冲区内容属于哪次会话，新会话由所属线程在第一次写入时清空
+    };
+
+    struct GpuScope {
+        const char* name{ nullptr };
+        uint32_t queries[2]{ 0, 0 };                // GLuint
+        uint64_t cpuNs{ 0 };                        // 发出 begin 时 CPU 的时间，用于 flow 箭头
+        uint32_t threadId{ 0 };
+        bool ended{ false };
+    };
+
+    struct GpuEvent {
+        const char* name;
+        uint64_t beginNs;                           // 已换算为 CPU 时钟
+        uint64_t endNs;
+        uint64_t cpuNs;
+        uint32_t threadId;
+    };
+
+    static ThreadBuffer& local() {
+        if (sLocal == nullptr) {
+            sLocal = registerThread();
+        }
+        return *sLocal;
+    }
+    static ThreadBuffer* registerThread();
+
+    // 读取已完成的 GPU 查询，wait 为 true 时等待全部完成
+    static void collectGpu(bool wait);
+    static uint32_t acquireQuery();
+
+private:
+    static thread_local ThreadBuffer* sLocal;
+    static std::mutex sMutex;
+    static std::vector<std::unique_ptr<ThreadBuffer>> sThreads;    // 线程退出后保留，事件仍会导出
+    static std::unordered_set<std::string> sStrings;
+
+    static std::atomic<bool> sRecording;
+    static std::atomic<uint32_t> sSession;
+    static size_t sCapacity;
+    static std::chrono::steady_clock::time_point sEpoch;
+
+    // 以下只在 GL 线程访问
+    static int64_t sGpuOffsetNs;                    // CPU 时间 = GPU 时间 - sGpuOffsetNs
+    static std::vector<GpuScope> sGpuScopes;        // 等待读取的 GPU 作用域（按发出顺序）
+    static std::vector<GpuEvent> sGpuEvents;
+    static std::vector<uint32_t> sFreeQueries;
+    static std::vector<uint64_t> sFrameMarks;
+};
+
+// CPU 作用域：构造时记下开始时间，析构时写入一条事件
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name, const char* detail = nullptr)
+        : mName(name), mDetail(detail), mBegin(Profiler::isRecording() ? Profiler::now() : UINT64_MAX) {}
+
+    ~ProfileScope() {
+        if (mBegin != UINT64_MAX) {
+            Profiler::record(mName, mDetail, mBegin, Profiler::now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* mName;
+    const char* mDetail;
+    uint64_t mBegin;
+};
+
+// GPU 作用域：同时记录 CPU 事件（命令提交耗时）与 GPU 事件（GPU 执行耗时）
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name) : mCpu(name), mScope(Profiler::beginGpu(name)) {}
+    ~GpuProfileScope() { Profiler::endGpu(mScope); }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    ProfileScope mCpu;
+    int mScope;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_SCOPE_DETAIL(name, detail) \
+    ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name, Profiler::isRecording() ? Profiler::intern(detail) : nullptr)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_GPU_SCOPE(name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#define PROFILE_FRAME() Profiler::endFrame()
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_SCOPE_DETAIL(name, detail) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_GPU_SCOPE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif // ENABLE_PROFILER
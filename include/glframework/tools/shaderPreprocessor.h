@@ -0,0 +1,102 @@
+#pragma once
+#include "tools.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <cstdint>
+
+// Shader 预处理器：
+// 1. 解析 #include "xxx.glsl"，被包含的头文件只读取、扫描一次（头文件缓存）
+// 2. 一次遍历完成宏去重，并把宏插入到 #version 之后
+// 3. 以内容哈希缓存展开结果，同一份源码 + 同一组宏不会重复展开
+// 4. 输出 #line 指令，编译报错时可以映射回原始文件和行号
+class ShaderPreprocessor {
+public:
+    // 读取并展开 Shader 文件，宏按文件后缀（.vert/.frag）过滤
+    static std::string process(
+        const std::string& filePath,
+        const std::vector<ShaderMacro>& macros,
+        bool skipExisting = true
+    );
+
+    // 原始宏字符串版本（如 "#define USE_NORMAL_MAP"），不做类型过滤
+    static std::string process(
+        const std::string& filePath,
+        const std::vector<std::string>& rawMacros,
+        bool skipExisting = true
+    );
+
+    // 添加 #include 的搜索目录（先找当前文件所在目录，再按添加顺序查找）
+    static void addIncludeDirectory(const std::string& directory);
+
+    // 清空头文件缓存与展开缓存（修改了 Shader 文件、需要热重载时调用）
+    static void clearCache();
+
+    // 把编译日志中的 "源串编号(行号)" / "源串编号:行号" 替换为 "文件路径(行号)"
+    static std::string remapLog(const std::string& infoLog);
+
+    // 通过 #line 中的源串编号查询文件路径
+    static std::string getFileName(int fileId);
+
+    // 统计信息：文件实际读取次数、展开缓存命中次数
+    static size_t getFileReadCount() { return sFileReadCount; }
+    static size_t getCacheHitCount() { return sCacheHitCount; }
+
+private:
+    // 单个文件扫描一次后的结果
+    struct SourceFile {
+        std::string path;                           // 规范化后的文件路径
+        int id{ 0 };                                // #line 使用的源串编号
+        std::vector<std::string> lines;             // 按行切分后的源码
+        std::unordered_set<std::string> defines;    // 文件内 #define 过的宏名（不含 include 的文件）
+        std::vector<std::string> includes;          // 文件直接 include 的文件（已解析为路径）
+        int versionLine{ -1 };                      // #version 所在行（0 起），没有则为 -1
+        bool pragmaOnce{ false };                   // 是否带 #pragma once
+        uint64_t hash{ 0 };                         // 文件内容哈希
+    };
+
+    ShaderPreprocessor() = default;
+
+    // 读取文件（命中头文件缓存则直接返回），失败返回 nullptr；调用方需持有 sMutex
+    static const SourceFile* loadFile(const std::string& path);
+
+    // 解析 include 路径：先相对于当前文件目录，再查找搜索目录
+    static std::string resolveInclude(const std::string& includeName, const std::string& currentPath);
+
+    // 递归展开 include，输出带 #line 的源码；macroBlock 非空表示主文件，宏插入到 #version 之后
+    static bool expand(
+        const SourceFile* file,
+        std::string& out,
+        std::vector<std::string>& includeStack,
+        std::unordered_set<std::string>& onceFiles,
+        const std::string* macroBlock
+    );
+
+    // 收集文件及其所有 include 文件中定义的宏名
+    static void collectDefines(
+        const SourceFile* file,
+        std::unordered_set<std::string>& defines,
+        std::unordered_set<std::string>& visited
+    );
+
+    // 核心处理：macros 为 <宏名, 宏定义行>，宏名为空的行不参与去重
+    static std::string processImpl(
+        const std::string& filePath,
+        const std::vector<std::pair<std::string, std::string>>& macros,     // <宏名, 宏定义行>
+        bool skipExisting
+    );
+
+    // FNV-1a 64位哈希
+    static uint64_t hashString(const std::string& str, uint64_t seed = 14695981039346656037ull);
+
+private:
+    static std::mutex sMutex;
+    static std::unordered_map<std::string, SourceFile> sFileCache;        // 路径 -> 文件
+    static std::unordered_map<uint64_t, std::string> sExpandedCache;      // 路径、宏的哈希 -> 展开结果
+    static std::vector<std::string> sFileNames;                           // 源串编号 -> 路径
+    static std::vector<std::string> sIncludeDirectories;                  // include 搜索目录
+    static size_t sFileReadCount;
+    static size_t sCacheHitCount;
+};
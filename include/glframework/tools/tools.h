@@ -6,6 +6,7 @@
 enum class ShaderTarget {
     VERTEX,    // ɫ.vert
     FRAGMENT,  // Ƭɫ.frag
+    COMPUTE,   // ɫ.comp
     ALL        // ɫĬϣ
 };
 
@@ -81,11 +82,10 @@ public:
     );
 
 private:
-    // ļ·ж Shader ͣ.vertVERTEX.fragFRAGMENT
-    static ShaderTarget getShaderTypeFromPath(const std::string& filePath);
+    friend class ShaderPreprocessor;    // Ԥжַ
 
-    // ǷѴԴ
-    static bool isMacroExists(const std::string& source, const std::string& macroName);
+    // ļ·ж Shader ͣ.vertVERTEX.fragFRAGMENT.compCOMPUTE
+    static ShaderTarget getShaderTypeFromPath(const std::string& filePath);
 
     //  ShaderMacro תΪ GLSL ַ
     static std::string macroToString(const ShaderMacro& macro);
@@ -0,0 +1,95 @@
+#pragma once
+#include "core.h"
+#include <cstdint>
+
+// 变换句柄：Object 只保存这个编号，真正的数据放在 TransformStorage 的连续数组中
+using TransformHandle = uint32_t;
+constexpr TransformHandle INVALID_TRANSFORM = 0xFFFFFFFFu;
+
+// 结构体数组（SoA）形式的变换存储：
+// 1. 位置、欧拉角、缩放、局部矩阵、世界矩阵分别存放在连续数组中
+// 2. 节点按层级深度排序，父节点一定排在子节点之前
+// 3. 世界矩阵逐层更新：同一层之间没有依赖，分块交给 JobSystem 并行计算，矩阵乘法使用 SSE
+// 4. 只有被修改过（或父节点被修改过）的节点才会重新计算矩阵
+// 5. 写入与原值相同时直接忽略；真正的修改会通知 RedrawTracker，按需重绘模式下触发新的一帧
+class TransformStorage {
+public:
+    // 创建 / 销毁一个变换节点
+    static TransformHandle create();
+    static void destroy(TransformHandle handle);
+
+    // 批量销毁（handles 中不能有重复）：一次遍历压缩所有数组，用于整个场景的卸载
+    static void destroyBatch(const std::vector<TransformHandle>& handles);
+
+    // 父子关系（parent 为 INVALID_TRANSFORM 表示根节点）
+    static void setParent(TransformHandle child, TransformHandle parent);
+
+    // 局部变换数据的读写
+    static void setPosition(TransformHandle handle, const glm::vec3& position);
+    static glm::vec3 getPosition(TransformHandle handle);
+
+    static void setAngles(TransformHandle handle, const glm::vec3& angles);     // 角度制，unity旋转标准：pitch yaw roll
+    static glm::vec3 getAngles(TransformHandle handle);
+
+    static void setScale(TransformHandle handle, const glm::vec3& scale);
+    static glm::vec3 getScale(TransformHandle handle);
+
+    // 获取世界矩阵，如有修改会先执行 update()；工作线程上要求已经更新过（断言），并行读取前先调用 update()
+    static glm::mat4 getWorldMatrix(TransformHandle handle);
+
+    // 重新按层级排序（如有需要）并更新所有脏节点的世界矩阵
+    // 多线程读取世界矩阵之前，应先在主线程调用一次
+    static void update();
+
+    // 世界矩阵版本号：该节点的世界矩阵每重新计算一次加一，可用来判断节点是否移动过
+    static uint32_t getWorldVersion(TransformHandle handle) { return sWorldVersions[handle]; }
+
+    // 结构版本号：创建、销毁节点或修改父子关系时加一
+    static uint64_t getStructureVersion() { return sStructureVersion; }
+
+    // 是否存在未更新的修改
+    static bool isDirty() { return sHierarchyDirty || sTransformDirty; }
+
+    // 节点数量、层级数量
+    static size_t getCount() { return sPositions.size(); }
+    static size_t getLevelCount() { return sLevelOffsets.empty() ? 0 : sLevelOffsets.size() - 1; }
+
+    // 单层节点数超过该值才会切分到多个线程
+    static void setParallelThreshold(size_t threshold) { sParallelThreshold = threshold; }
+
+private:
+    TransformStorage() = default;
+
+    // 按层级深度重新排列所有数组
+    static void sortByDepth();
+
+    // 更新 [begin, end) 范围内节点的局部/世界矩阵（同一层内调用）
+    static void updateRange(size_t begin, size_t end);
+
+    static void markDirty(uint32_t index);
+
+private:
+    // 按层级排序后的连续数组（下标 = 节点在存储中的位置）
+    static std::vector<glm::vec3> sPositions;
+    static std::vector<glm::vec3> sAngles;
+    static std::vector<glm::vec3> sScales;
+    static std::vector<glm::mat4> sLocalMatrices;
+    static std::vector<glm::mat4> sWorldMatrices;
+    static std::vector<int32_t> sParents;           // 父节点下标，-1 表示根节点
+    static std::vector<uint8_t> sLocalDirty;        // 局部数据被修改
+    static std::vector<uint8_t> sWorldDirty;        // 世界矩阵需要重新计算（本帧更新用）
+    static std::vector<TransformHandle> sHandles;   // 下标 -> 句柄
+
+    // 句柄 -> 下标（排序后下标会变化，句柄不变）
+    static std::vector<uint32_t> sHandleToIndex;
+    static std::vector<TransformHandle> sFreeHandles;
+    static std::vector<uint32_t> sWorldVersions;    // 按句柄存放
+    static uint64_t sStructureVersion;
+
+    // 第 i 层节点位于 [sLevelOffsets[i], sLevelOffsets[i + 1])
+    static std::vector<size_t> sLevelOffsets;
+
+    static bool sHierarchyDirty;
+    static bool sTransformDirty;
+    static size_t sParallelThreshold;
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include "core.h"
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+// 三角形级别的 BVH：用于 CPU 射线拾取与测量
+// 1. 保存一份 CPU 端的顶点位置与索引（GPU 缓冲区无法直接读取）
+// 2. SAH 分桶构建，32 字节节点，叶子最多 4 个三角形；三角形按叶子顺序预先展开为 v0 / e1 / e2，求交时不再查索引
+// 3. 射线与包围盒求交使用 SSE，先访问较近的孩子，已经找到更近的交点时跳过远处的子树
+// 4. 构建可以交给后台（buildAsync），作为任务在 JobSystem 的工作线程上执行，多个几何体可以同时构建
+class TriangleBVH {
+public:
+    struct Node {
+        glm::vec3 boundsMin{ 0.0f };
+        uint32_t first{ 0 };            // 叶子：第一个三角形；内部节点：左孩子（右孩子为 first + 1）
+        glm::vec3 boundsMax{ 0.0f };
+        uint32_t count{ 0 };            // 叶子的三角形个数，0 表示内部节点
+    };
+
+    // 求交结果：t 为射线参数，(u, v) 为重心坐标（交点 = (1 - u - v) * p0 + u * p1 + v * p2）
+    struct Hit {
+        uint32_t triangle{ 0xFFFFFFFFu };   // 原始三角形编号（indices 中的第 triangle * 3 个索引开始）
+        float t{ 0.0f };
+        float u{ 0.0f };
+        float v{ 0.0f };
+    };
+
+    // positions 为 xyz 连续存放的顶点位置，indices 每三个一组
+    TriangleBVH(std::vector<float> positions, std::vector<unsigned int> indices);
+    ~TriangleBVH();
+
+    TriangleBVH(const TriangleBVH&) = delete;
+    TriangleBVH& operator=(const TriangleBVH&) = delete;
+
+    // 在当前线程构建
+    void build();
+
+    // 交给 JobSystem 构建，完成后 isReady() 返回 true
+    static void buildAsync(TriangleBVH* bvh);
+
+    // 释放：还在构建时由构建任务在结束后删除
+    static void release(TriangleBVH* bvh);
+
+    bool isReady() const { return mReady.load(std::memory_order_acquire); }
+
+    // 最近交点，t 在 [0, maxDistance] 之外的交点忽略；未构建完成时返回 false
+    bool intersect(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Hit& hit) const;
+
+    // CPU 端数据
+    const std::vector<glm::vec3>& getPositions() const { return mPositions; }
+    const std::vector<unsigned int>& getIndices() const { return mIndices; }
+    size_t getTriangleCount() const { return mIndices.size() / 3; }
+    size_t getNodeCount() const { return mNodes.size(); }
+    double getBuildTimeMs() const { return mBuildTimeMs; }
+
+    // 三角形在局部空间的三个顶点
+    void getTriangle(uint32_t triangle, glm::vec3& p0, glm::vec3& p1, glm::vec3& p2) const;
+
+private:
+    void buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, std::vector<uint32_t>& order, const std::vector<glm::vec3>& centroids,
+        const std::vector<glm::vec3>& triMin, const std::vector<glm::vec3>& triMax, int depth);
+
+private:
+    std::vector<glm::vec3> mPositions{};
+    std::vector<unsigned int> mIndices{};
+
+    // 构建结果
+    std::vector<Node> mNodes{};
+    std::vector<glm::vec3> mTriangleData{};     // 按叶子顺序展开：每个三角形 v0, e1, e2
+    std::vector<uint32_t> mTriangleIds{};       // 展开后的下标 -> 原始三角形编号
+
+    std::atomic<bool> mReady{ false };
+    double mBuildTimeMs{ 0.0 };
+
+    // 后台构建状态（由 TriangleBVHBuilder 的锁保护）
+    enum class AsyncState { None, Queued, Building };
+    AsyncState mAsyncState{ AsyncState::None };
+    bool mDiscard{ false };
+
+    friend class TriangleBVHBuilder;
+};
@@ -1,19 +1,23 @@
 #ifndef CHECK_ERROR_H
 #define CHECK_ERROR_H
 
+#include "glDebug.h"
+
 // 1.  checkError() ں궨֮ǰΪ
 void checkError();
 
 // 2. 궨壺бз \ȷΪһ
+// DEBUGģʽµλù KHR_debug صעûлص֧ KHR_debugʱÿεú glGetError
 #ifdef DEBUG
 #define GL_CALL(function) \
 	do { \
+		GLDebug::setCallSite(__FILE__, __LINE__, #function); \
 		function; \
-		checkError(); \
+		GLDebug::afterCall(); \
 	} while (0)
 #else
-// DEBUGģʽֱִкͬȷ﷨ȷ
+// DEBUGģʽֱִкͬȷ﷨ȷ GLDebug  Sampled ģʽÿ N ֡һ
 #define GL_CALL(function) function
 #endif // DEBUG
 
-#endif // CHECK_ERROR_H
\ No newline at end of file
+#endif // CHECK_ERROR_H
@@ -0,0 +1,118 @@
+#ifndef GL_DEBUG_H
+#define GL_DEBUG_H
+
+#include <glad/glad.h>
+#include <atomic>
+#include <string>
+
+// OpenGL 调试层：用 KHR_debug（GL 4.3 的 glDebugMessageCallback）代替每次调用后的 glGetError
+// glGetError 每次都会让 CPU 等待驱动，DEBUG 构建里每个 GL_CALL 都调用一次，重场景下慢到无法使用
+// 1. Callback：驱动异步回调（不开启 GL_DEBUG_OUTPUT_SYNCHRONOUS），同一条消息（来源 + 类型 + ID）只输出第一次，
+//    退出时汇总重复次数；调用位置用 GL_CALL 记下的最近一次调用、当前调试组（GL_DEBUG_GROUP）与对象标签（setLabel）标注，
+//    异步模式下消息可能晚于调用到达，位置只是"附近"
+// 2. Synchronous：同步回调，回调发生在出错的那次调用之内，位置准确，出错时断言（单步调试用，会变慢）
+// 3. Sampled：不使用回调，每 N 帧在 endFrame 调用一次 glGetError（取出全部错误标志），报告出错的帧区间；
+//    开销可以忽略，Release 与回归测试构建默认使用
+// 4. Off：不检查
+// 默认 DEBUG 构建为 Callback，否则为 Sampled（每 60 帧）；环境变量 ENGINE_GL_DEBUG 可以覆盖：
+//    off | callback | sync | sampled | sampled:N
+// 不支持 KHR_debug 的上下文退回到 DEBUG 构建中每次调用后 glGetError（原来的行为）
+class GLDebug {
+public:
+    enum class Mode {
+        Off,
+        Callback,
+        Synchronous,
+        Sampled
+    };
+
+    // 创建窗口之前调用：读取配置，需要调试上下文时设置 SDL_GL_CONTEXT_DEBUG_FLAG
+    static void configure();
+
+    // 创建 GL 上下文并加载 glad 之后调用：安装回调
+    static void init();
+
+    // 删除 GL 上下文之前调用：输出重复消息的汇总
+    static void shutdown();
+
+    // 每帧调用一次（交换缓冲区之后），Sampled 模式在这里检查
+    static void endFrame();
+
+    static Mode getMode() { return sMode; }
+    static void setSampleInterval(int frames) { sSampleInterval = frames > 0 ? frames : 1; }
+
+    // 立即检查一次（Sampled 模式），之后 getErrorCount 包含到目前为止的所有错误
+    static void flush();
+
+    // 到目前为止报告的错误数（Callback / Synchronous 为 ERROR 类型的消息，Sampled 为 glGetError 取到的标志），
+    // 重复的消息也计数；离屏回归测试写入结果文件
+    static uint64_t getErrorCount() { return sErrorCount.load(std::memory_order_relaxed); }
+
+    // KHR_debug 回调已安装，GL_CALL 不再调用 glGetError
+    static bool isCallbackActive() { return sCallbackActive; }
+
+    // 对象标签：驱动的消息中会带上标签，也会显示在 RenderDoc 等工具中；identifier 为 GL_BUFFER / GL_TEXTURE / GL_PROGRAM 等
+    static void setLabel(GLenum identifier, GLuint name, const std::string& label);
+
+    // 调试组：出错消息会标注当时所在的组；name 必须是静态字符串
+    static void pushGroup(const char* name);
+    static void popGroup();
+
+    // GL_CALL 记下的调用位置（只是几次普通的原子写入，不与驱动同步）
+    static void setCallSite(const char* file, int line, const char* expression) {
+        sCallFile.store(file, std::memory_order_relaxed);
+        sCallLine.store(line, std::memory_order_relaxed);
+        sCallExpression.store(expression, std::memory_order_relaxed);
+    }
+
+    // GL_CALL 调用之后：Callback / Synchronous 模式但回调没有安装时退回 glGetError
+    static void afterCall();
+
+    GLDebug(const GLDebug&) = delete;
+    GLDebug& operator=(const GLDebug&) = delete;
+
+private:
+    GLDebug() = default;
+
+    static void APIENTRY onMessage(GLenum source, GLenum type, GLuint id, GLenum severity,
+        GLsizei length, const GLchar* message, const void* userParam);
+
+    // Sampled 模式：取出全部错误标志
+    static void checkSampled();
+
+    // 当前位置的描述：最近的 GL_CALL 与调试组
+    static std::string describeLocation();
+
+private:
+    static Mode sMode;
+    static int sSampleInterval;
+    static bool sCallbackActive;
+    static uint64_t sFrameIndex;
+    static uint64_t sLastCheckedFrame;
+    static std::atomic<uint64_t> sErrorCount;
+
+    static std::atomic<const char*> sCallFile;
+    static std::atomic<int> sCallLine;
+    static std::atomic<const char*> sCallExpression;
+
+    // 调试组栈（GL 线程写入，回调只读取栈顶）
+    static constexpr int MAX_GROUP_DEPTH = 32;
+    static const char* sGroups[MAX_GROUP_DEPTH];
+    static std::atomic<int> sGroupDepth;
+};
+
+// 作用域内的调试组（Callback / Synchronous 模式下才调用 glPushDebugGroup）
+class GLDebugGroup {
+public:
+    explicit GLDebugGroup(const char* name) { GLDebug::pushGroup(name); }
+    ~GLDebugGroup() { GLDebug::popGroup(); }
+
+    GLDebugGroup(const GLDebugGroup&) = delete;
+    GLDebugGroup& operator=(const GLDebugGroup&) = delete;
+};
+
+#define GL_DEBUG_CONCAT_INNER(a, b) a##b
+#define GL_DEBUG_CONCAT(a, b) GL_DEBUG_CONCAT_INNER(a, b)
+#define GL_DEBUG_GROUP(name) GLDebugGroup GL_DEBUG_CONCAT(glDebugGroup, __LINE__)(name)
+
+#endif // GL_DEBUG_H
@@ -7,17 +7,16 @@ out vec2 UV;
 out vec3 normal;
 out vec3 worldPosition;
 
-uniform mat4 ModelMatrix;
+#include "../common/perDraw.glsl"
 uniform mat4 ViewMatrix;
 uniform mat4 ProjectionMatrix;
 
-uniform mat3 normalMatrix;
 void main()
 {
     // ĶλãתΪ꣨3ά-4ά
     vec4 transformPosition = vec4(aPos, 1.0);
 
-    transformPosition = ModelMatrix * transformPosition;
+    transformPosition = perDraw.modelMatrix * transformPosition;
     
     // 㵱ǰ worldPositionfragmentShader
     worldPosition = transformPosition.xyz;
@@ -28,5 +27,5 @@ void main()
     // ģͽƽƣţת仯ʱ򣬲Ҫı䷨߷
     // ѡ񽫷߾Ϊuniform룬ʡЧʡ
 
-    normal = normalMatrix * aNormal;
+    normal = mat3(perDraw.normalMatrix) * aNormal;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #version 330 core
-out vec4 FragColor;
+// ƬͨģʽΪ FragColorOIT_PASS Ϊ OIT ۻĿ꣩
+#include "../../common/fragmentOutput.glsl"
 
 // Ӷɫı
 in vec2 UV;       
@@ -7,12 +8,10 @@ in vec3 worldPosition;
 in vec3 Normal;
 in vec3 tangent;
 
-// ͸ȿ
-uniform float opacity;
+// ͸ȡȡֲڶÿλƵݿ perDraw.material
+#include "../../common/perDraw.glsl"
 
 // ʲ
-uniform float metallic;
-uniform float roughness;
 uniform sampler2D albedoMap;     // ɫ+alphaͼ
 uniform sampler2D normalMap;     // ߿ռ䷨ͼ
 uniform sampler2D metallicMap;   // ͼ
@@ -142,8 +141,8 @@ void main(){
     // 2. /ֲڶȣͼ+uniformϣ
     float metallicTex = texture(metallicMap, UV).r;
     float roughnessTex = texture(roughnessMap, UV).r;
-    float Metallic = mix(metallicTex, metallic, 0.5); // ȨؿԶ
-    float Roughness = mix(roughnessTex, roughness, 0.5);
+    float Metallic = mix(metallicTex, perDraw.material.y, 0.5); // ȨؿԶ
+    float Roughness = mix(roughnessTex, perDraw.material.z, 0.5);
     Roughness = clamp(Roughness, 0.01, 0.99); // ⼫ֵ¹쳣
 
     // 3. ռ䷨ߣֿ֧طͼ
@@ -227,7 +226,7 @@ void main(){
     color = pow(color, vec3(1.0/2.2)); // GammaУsRGB׼
 
     // 9. ͸Ȼϣopacity * ͼalpha
-    float finalAlpha = opacity * albedoAlpha;
+    float finalAlpha = perDraw.material.x * albedoAlpha;
 
-    FragColor = vec4(color, finalAlpha);
+    writeFragment(color, finalAlpha);
 }
\ No newline at end of file
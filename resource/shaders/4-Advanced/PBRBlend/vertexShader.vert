@@ -9,18 +9,17 @@ out vec3 Normal;
 out vec3 tangent;
 out vec3 worldPosition;
 
-uniform mat4 ModelMatrix;
+#include "../../common/perDraw.glsl"
 uniform mat4 ViewMatrix;
 uniform mat4 ProjectionMatrix;
-uniform mat3 normalMatrix;
 
 void main()
 {
-    vec4 transformPosition = ModelMatrix * vec4(aPos, 1.0);
+    vec4 transformPosition = perDraw.modelMatrix * vec4(aPos, 1.0);
     worldPosition = transformPosition.xyz;
     gl_Position = ProjectionMatrix * ViewMatrix * transformPosition;
     
     UV = aUV;
-    Normal = normalize(normalMatrix * aNormal); // һȷλ
-    tangent = normalize(normalMatrix * aTangent); // ͬ任+һ
+    Normal = normalize(mat3(perDraw.normalMatrix) * aNormal); // һȷλ
+    tangent = normalize(mat3(perDraw.normalMatrix) * aTangent); // ͬ任+һ
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #version 330 core
-out vec4 FragColor;
+// ƬͨģʽΪ FragColorOIT_PASS Ϊ OIT ۻĿ꣩
+#include "../../common/fragmentOutput.glsl"
 
 in vec2 UV;       
 in vec3 normal; // ط
@@ -8,8 +9,8 @@ in vec3 worldPosition;
 uniform vec3 cameraPosition;
 uniform sampler2D sampler;
 
-// ͸
-uniform float opacity;
+// ͸ÿλƵݿ perDraw.material.x
+#include "../../common/perDraw.glsl"
 
 struct Material{
     vec3 ambient;    // ⷴɫֶ裬vec3(0.1)
@@ -123,5 +124,5 @@ void main()
     vec3 finalColor = result;
 
     float alpha = texture(sampler, UV).a;
-    FragColor = vec4(finalColor, opacity * alpha);
+    writeFragment(finalColor, perDraw.material.x * alpha);
 }
\ No newline at end of file
@@ -4,12 +4,13 @@ layout (location = 1) in vec2 aTexCoord;
 
 out vec2 TexCoord;
 
-uniform mat4 ModelMatrix;
+#include "../../common/perDraw.glsl"
 uniform mat4 ViewMatrix;
 uniform mat4 ProjectionMatrix;
 
 void main()
 {
-    gl_Position = ProjectionMatrix * ViewMatrix * ModelMatrix * vec4(aPos, 1.0);
+    vec4 transformPosition = perDraw.modelMatrix * vec4(aPos, 1.0);
+    gl_Position = ProjectionMatrix * ViewMatrix * transformPosition;
     TexCoord = aTexCoord;
 }
\ No newline at end of file
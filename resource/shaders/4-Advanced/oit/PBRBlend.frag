@@ -8,12 +8,8 @@ in vec3 worldPosition;
 in vec3 normal;
 in vec3 tangent;
 
-// ͸
-uniform float opacity;
-
-// ʲֱuniformͼ
-uniform float metallic;
-uniform float roughness;
+// ͸ȡȡֲڶȣֱuniformͼÿλƵݿ perDraw.material
+#include "../../common/perDraw.glsl"
 
 uniform sampler2D albedoMap;     // ɫͼ洢ɫ
 uniform sampler2D normalMap;     // ͼ洢΢۰͹Ϣ
@@ -184,8 +180,8 @@ void main(){
     float Metallic = texture(metallicMap, UV).r;
     float Roughness = texture(roughnessMap, UV).r;
 
-    Metallic = metallic;
-    Roughness = roughness;
+    Metallic = perDraw.material.y;
+    Roughness = perDraw.material.z;
 
     // ӽǷ
     vec3 N;
@@ -263,7 +259,7 @@ void main(){
 
     // OITģʽ2FBO
     float depth = gl_FragCoord.z * 2.0 - 1.0;
-    float weight = computeWeight(depth, opacity);
+    float weight = computeWeight(depth, perDraw.material.x);
     //FragColorWeight = vec4(color * weight, 1.0);
     //FragWeightSum = vec4(weight, 0.0, 0.0, 1.0);
 
@@ -9,8 +9,8 @@ in vec3 worldPosition;
 uniform vec3 cameraPosition;
 uniform sampler2D sampler;
 
-// ͸
-uniform float opacity;
+// ͸ÿλƵݿ perDraw.material.x
+#include "../../common/perDraw.glsl"
 
 // Ȩؼ㺯ԭ߼
 float computeWeight(float depth, float alpha) {
@@ -132,7 +132,7 @@ void main()
     float alpha = texture(sampler, UV).a;
         // OITģʽ2FBO
     float depth = gl_FragCoord.z * 2.0 - 1.0;
-    float weight = computeWeight(depth, opacity);
+    float weight = computeWeight(depth, perDraw.material.x);
 
     alpha = clamp(alpha, 0.0,1.0);
     float w = max(0.01, alpha * (1.0 - 0.5 * alpha));
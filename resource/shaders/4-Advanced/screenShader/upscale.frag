@@ -0,0 +1,35 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 UV;
+
+uniform sampler2D screenTexture;
+uniform vec2 uvScale;       // 场景占纹理的比例（动态分辨率），1 为整张纹理
+uniform float sharpness;    // 锐化强度
+
+void main(){
+	vec2 texelSize = 1.0 / vec2(textureSize(screenTexture, 0));
+
+	// 只在有效区域内采样，边缘收半个像素，避免双线性取到区域外的旧数据
+	vec2 maxUV = uvScale - 0.5 * texelSize;
+	vec2 uv = min(UV * uvScale, maxUV);
+
+	vec3 center = texture(screenTexture, uv).rgb;
+	if (sharpness <= 0.0) {
+		FragColor = vec4(center, 1.0);
+		return;
+	}
+
+	// 十字邻域：反锐化掩模，结果限制在邻域的最小/最大值之间，边缘处不会产生振铃
+	vec3 north = texture(screenTexture, min(uv + vec2(0.0, texelSize.y), maxUV)).rgb;
+	vec3 south = texture(screenTexture, max(uv - vec2(0.0, texelSize.y), vec2(0.0))).rgb;
+	vec3 east = texture(screenTexture, min(uv + vec2(texelSize.x, 0.0), maxUV)).rgb;
+	vec3 west = texture(screenTexture, max(uv - vec2(texelSize.x, 0.0), vec2(0.0))).rgb;
+
+	vec3 minColor = min(center, min(min(north, south), min(east, west)));
+	vec3 maxColor = max(center, max(max(north, south), max(east, west)));
+	vec3 blur = (north + south + east + west) * 0.25;
+
+	vec3 color = clamp(center + (center - blur) * sharpness, minColor, maxColor);
+	FragColor = vec4(color, 1.0);
+}
@@ -1,10 +1,11 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 ModelMatrix;
+#include "../common/perDraw.glsl"
 uniform mat4 ViewMatrix;
 uniform mat4 ProjectionMatrix;
 void main()
 {
-    gl_Position = ProjectionMatrix * ViewMatrix * ModelMatrix * vec4(aPos, 1.0);
+    vec4 transformPosition = perDraw.modelMatrix * vec4(aPos, 1.0);
+    gl_Position = ProjectionMatrix * ViewMatrix * transformPosition;
 }
\ No newline at end of file
@@ -46,7 +46,12 @@ struct PointLight{
 };
 
 uniform DirectionLight directionLight;
-#define POINT_LIGHT_NUM 4       
+// ԴĬ 4  ShaderMacro  POINT_LIGHT_COUNT ޸
+#ifdef POINT_LIGHT_COUNT
+#define POINT_LIGHT_NUM POINT_LIGHT_COUNT
+#else
+#define POINT_LIGHT_NUM 4
+#endif
 uniform PointLight pointLights[POINT_LIGHT_NUM];
 uniform int numPointLights;
 uniform Material material;
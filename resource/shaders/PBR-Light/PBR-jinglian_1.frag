@@ -45,7 +45,13 @@ struct AmbientLight{
     float Intensity;
 };
 
-uniform PointLight pointLights[4];
+// ԴĬ 4  ShaderMacro  POINT_LIGHT_COUNT ޸
+#ifdef POINT_LIGHT_COUNT
+#define POINT_LIGHT_NUM POINT_LIGHT_COUNT
+#else
+#define POINT_LIGHT_NUM 4
+#endif
+uniform PointLight pointLights[POINT_LIGHT_NUM];
 uniform AmbientLight ambientLight;
 uniform DirectionLight directionLight;
 uniform vec3 cameraPosition;
@@ -171,7 +177,7 @@ void main(){
 
     // 㷴䷽̣ۼеԴĹף
     vec3 Lo = vec3(0.0);
-    for(int i = 0; i < 4; ++i)
+    for(int i = 0; i < POINT_LIGHT_NUM; ++i)
     {
         vec3 L = normalize(pointLights[i].position - worldPosition);
         vec3 H = normalize(V + L);
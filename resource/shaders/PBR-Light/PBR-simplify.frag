@@ -34,65 +34,8 @@ vec3 getNormalFromMap()
 }
 
 // ----------------------------------------------------------------------------
-// GGX߷ֲNDF
-// ã㳯H΢ռȣ߹ļ/ɢ̶
-// N=ߣH=roughness=ֲڶ
-float DistributionGGX(vec3 N, vec3 H, float roughness)
-{
-    float a = roughness * roughness;    // ֲڶȵƽĽƣ
-    float a2 = a * a;                   // ֲڶȵĴη
-    float NdotH = max(dot(N, H), 0.0);  // ĵȡֵ
-    float NdotH2 = NdotH * NdotH;       // ƽ
-
-    // GGXֲʽ
-    float nom   = a2;
-    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
-    denom = PI * denom * denom;
-
-    return nom / denom;
-}
-
-// ----------------------------------------------------------------------------
-// Schlick-GGXκ
-// ã㵥ӽǻԴļڱ/Ӱ΢໥ڵ
-// NdotV=ӽǷĵroughness=ֲڶ
-float GeometrySchlickGGX(float NdotV, float roughness)
-{
-    float r = (roughness + 1.0);
-    float k = (r * r) / 8.0;  // κĴֲڶ
-
-    // ڱιʽ
-    float nom   = NdotV;
-    float denom = NdotV * (1.0 - k) + k;
-
-    return nom / denom;
-}
-
-// ----------------------------------------------------------------------------
-// Smithκ
-// ãۺϿӽǺ͹ԴļڱΣ˫ڱΣ
-// N=ߣV=ӽǷL=Դroughness=ֲڶ
-float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
-{
-    float NdotV = max(dot(N, V), 0.0);  // ӽǷĵ
-    float NdotL = max(dot(N, L), 0.0);  // Դĵ
-    
-    // ֱӽǺ͹ԴļڱΣ
-    float ggx2 = GeometrySchlickGGX(NdotV, roughness);
-    float ggx1 = GeometrySchlickGGX(NdotL, roughness);
-
-    return ggx1 * ggx2;
-}
-
-// ----------------------------------------------------------------------------
-// Schlick
-// ã㲻ͬӽµľ淴ռȣЧӦ
-// cosTheta=ӽǷļнңF0=
-vec3 fresnelSchlick(float cosTheta, vec3 F0)
-{
-    // ʽƣӽԽбԽǿ
-    return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
-}
+// BRDF DistributionGGX / GeometrySmith / fresnelSchlickͷļ
+#include "../common/brdf.glsl"
 
 // ----------------------------------------------------------------------------
 void main()
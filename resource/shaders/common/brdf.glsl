@@ -0,0 +1,64 @@
+// 公共 BRDF 函数：Cook-Torrance 镜面项使用的 NDF / 几何遮蔽 / 菲涅尔
+// 使用方式：#include "../common/brdf.glsl"（由 ShaderPreprocessor 展开），包含前需要先定义 const float PI
+#pragma once
+
+// ----------------------------------------------------------------------------
+// GGX法线分布函数（NDF）
+// 作用：计算朝向半程向量H的微表面占比，决定高光的集中/分散程度
+// 参数：N=法线，H=半程向量，roughness=粗糙度
+float DistributionGGX(vec3 N, vec3 H, float roughness)
+{
+    float a = roughness * roughness;    // 粗糙度的平方（更符合物理的近似）
+    float a2 = a * a;                   // 粗糙度的四次方
+    float NdotH = max(dot(N, H), 0.0);  // 法线与半程向量的点积（取正值）
+    float NdotH2 = NdotH * NdotH;       // 点积的平方
+
+    // GGX分布公式计算
+    float nom   = a2;
+    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
+    denom = PI * denom * denom;
+
+    return nom / denom;
+}
+
+// ----------------------------------------------------------------------------
+// Schlick-GGX几何函数（单项）
+// 作用：计算单个方向（视角或光源）的几何遮蔽/阴影（微表面相互遮挡）
+// 参数：NdotV=法线与视角方向的点积，roughness=粗糙度
+float GeometrySchlickGGX(float NdotV, float roughness)
+{
+    float r = (roughness + 1.0);
+    float k = (r * r) / 8.0;  // 几何函数的粗糙度修正因子
+
+    // 几何遮蔽公式
+    float nom   = NdotV;
+    float denom = NdotV * (1.0 - k) + k;
+
+    return nom / denom;
+}
+
+// ----------------------------------------------------------------------------
+// Smith几何函数（组合项）
+// 作用：综合考虑视角和光源方向的几何遮蔽（双向遮蔽）
+// 参数：N=法线，V=视角方向，L=光源方向，roughness=粗糙度
+float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
+{
+    float NdotV = max(dot(N, V), 0.0);  // 法线与视角方向的点积
+    float NdotL = max(dot(N, L), 0.0);  // 法线与光源方向的点积
+    
+    // 分别计算视角和光源方向的几何遮蔽，再相乘
+    float ggx2 = GeometrySchlickGGX(NdotV, roughness);
+    float ggx1 = GeometrySchlickGGX(NdotL, roughness);
+
+    return ggx1 * ggx2;
+}
+
+// ----------------------------------------------------------------------------
+// Schlick菲涅尔近似
+// 作用：计算不同视角下的镜面反射占比（菲涅尔效应）
+// 参数：cosTheta=视角方向与半程向量的夹角余弦，F0=基础反射率
+vec3 fresnelSchlick(float cosTheta, vec3 F0)
+{
+    // 菲涅尔公式近似：视角越倾斜，反射越强
+    return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
@@ -0,0 +1,80 @@
+// 片段输出：普通模式写入 FragColor；定义了 OIT_PASS 时（Renderer 的加权混合 OIT 变体）写入累积值与透射率
+// 定义了 DEPTH_PEEL_PASS 时（双向深度剥离变体）写入深度范围、前层累积颜色与本次剥离的最远层
+// 着色器最后统一调用 writeFragment(color, alpha)，同一份源码即可用于排序混合、OIT 与深度剥离三种模式
+#pragma once
+
+#ifdef OIT_PASS
+layout(location = 0) out vec4 oitAccum;        // 附件0：sum(color * alpha * w), sum(alpha * w)
+layout(location = 1) out float oitRevealage;   // 附件1：prod(1 - alpha)，由混合方程 (ZERO, ONE_MINUS_SRC_COLOR) 累乘
+
+// 深度权重（McGuire & Bavoil 2013）：离相机越近、越不透明，权重越大
+float oitWeight(float alpha) {
+    float depth = gl_FragCoord.z;
+    float w = pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - depth * 0.9, 3.0);
+    return clamp(w, 1e-2, 3e3);
+}
+
+void writeFragment(vec3 color, float alpha) {
+    float w = oitWeight(alpha);
+    oitAccum = vec4(color * alpha, alpha) * w;
+    oitRevealage = alpha;
+}
+#elif defined(DEPTH_PEEL_PASS)
+// 三个附件都使用 MAX 混合（Bavoil & Myers 2008 双向深度剥离）
+layout(location = 0) out vec2 peelDepth;        // 附件0：(-最近深度, 最远深度)，MAX 混合同时得到两端
+layout(location = 1) out vec4 peelFrontColor;   // 附件1：由前往后累积的颜色（预乘 alpha），a 为覆盖率
+layout(location = 2) out vec4 peelBackColor;    // 附件2：本次剥离出的最远层，随后由 Renderer 混合到后层目标
+
+uniform bool depthPeelInit;             // 初始化 pass：只写深度范围
+uniform sampler2D depthPeelDepth;       // 上一次的深度范围
+uniform sampler2D depthPeelFront;       // 上一次的前层累积颜色
+
+void writeFragment(vec3 color, float alpha) {
+    float depth = gl_FragCoord.z;
+    if (depthPeelInit) {
+        peelDepth = vec2(-depth, depth);
+        peelFrontColor = vec4(0.0);
+        peelBackColor = vec4(0.0);
+        return;
+    }
+
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+    vec2 lastDepth = texelFetch(depthPeelDepth, coord, 0).xy;
+    vec4 lastFront = texelFetch(depthPeelFront, coord, 0);
+    float nearestDepth = -lastDepth.x;
+    float farthestDepth = lastDepth.y;
+
+    // 默认：不参与深度范围，前层颜色原样传递（MAX 混合下保持不变）
+    peelDepth = vec2(-1.0);
+    peelFrontColor = lastFront;
+    peelBackColor = vec4(0.0);
+
+    // 已经剥离过的层
+    if (depth < nearestDepth || depth > farthestDepth) {
+        return;
+    }
+
+    // 还没有剥离的层：写入深度，参与下一次的范围
+    if (depth > nearestDepth && depth < farthestDepth) {
+        peelDepth = vec2(-depth, depth);
+        return;
+    }
+
+    // 最近层：按 under 运算叠加到前层颜色后面
+    if (depth == nearestDepth) {
+        float transmittance = 1.0 - lastFront.a;
+        peelFrontColor.rgb = lastFront.rgb + color * alpha * transmittance;
+        peelFrontColor.a = 1.0 - transmittance * (1.0 - alpha);
+    }
+    else {
+        // 最远层：输出给后层混合
+        peelBackColor = vec4(color, alpha);
+    }
+}
+#else
+out vec4 FragColor;
+
+void writeFragment(vec3 color, float alpha) {
+    FragColor = vec4(color, alpha);
+}
+#endif
@@ -0,0 +1,9 @@
+// 每次绘制的数据块：由 Renderer 写入持久映射的环形缓冲区，通过 glBindBufferRange 按偏移绑定
+// 布局必须与 C++ 端 PerDrawData（uniformRingBuffer.h）保持一致（std140）
+#pragma once
+
+layout(std140) uniform PerDraw {
+    mat4 modelMatrix;       // 模型矩阵
+    mat4 normalMatrix;      // 法线矩阵（使用时取 mat3，std140 下用 mat4 存放避免对齐问题）
+    vec4 material;          // x=opacity 透明度  y=metallic 金属度  z=roughness 粗糙度  w=ao 环境光遮蔽
+} perDraw;
@@ -0,0 +1,5 @@
+#version 330 core
+// 预深度：不输出颜色，只写深度
+void main()
+{
+}
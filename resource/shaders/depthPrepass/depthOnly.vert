@@ -0,0 +1,14 @@
+#version 330 core
+// 预深度：只有位置属性
+// gl_Position 的计算顺序必须与各材质的顶点着色器完全一致（先模型矩阵、再视图投影），主 pass 的 GL_EQUAL 测试才能逐位相等
+layout (location = 0) in vec3 aPos;
+
+#include "../common/perDraw.glsl"
+uniform mat4 ViewMatrix;
+uniform mat4 ProjectionMatrix;
+
+void main()
+{
+    vec4 transformPosition = perDraw.modelMatrix * vec4(aPos, 1.0);
+    gl_Position = ProjectionMatrix * ViewMatrix * transformPosition;
+}
@@ -0,0 +1,14 @@
+#version 330 core
+// 双向深度剥离：把本次剥离出的最远层由后往前混合到后层目标
+// 混合方程 (SRC_ALPHA, ONE_MINUS_SRC_ALPHA) / (ONE, ONE_MINUS_SRC_ALPHA)，后层目标的颜色是预乘 alpha 的结果
+out vec4 FragColor;
+
+uniform sampler2D backTexture;
+
+void main() {
+    vec4 back = texelFetch(backTexture, ivec2(gl_FragCoord.xy), 0);
+    if (back.a == 0.0) {
+        discard;    // 没有剥离出新的层，不计入遮挡查询
+    }
+    FragColor = back;
+}
@@ -0,0 +1,19 @@
+#version 330 core
+// 双向深度剥离合成：前层颜色 + (1 - 前层覆盖率) * 后层颜色（两者都是预乘 alpha）
+// 输出 alpha 为总覆盖率，混合方程 (ONE, ONE_MINUS_SRC_ALPHA) 叠加到不透明结果上
+out vec4 FragColor;
+
+uniform sampler2D frontTexture;
+uniform sampler2D backTexture;
+
+void main() {
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+    vec4 front = texelFetch(frontTexture, coord, 0);
+    vec4 back = texelFetch(backTexture, coord, 0);
+    float transmittance = 1.0 - front.a;
+    if (front.a == 0.0 && back.a == 0.0) {
+        discard;    // 没有透明物体覆盖
+    }
+
+    FragColor = vec4(front.rgb + transmittance * back.rgb, 1.0 - transmittance * (1.0 - back.a));
+}
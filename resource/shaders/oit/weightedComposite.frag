@@ -0,0 +1,24 @@
+#version 330 core
+// 加权混合 OIT 合成：平均颜色 = sum(color * alpha * w) / sum(alpha * w)
+// 输出 alpha 为透射率，混合方程 (ONE_MINUS_SRC_ALPHA, SRC_ALPHA) 把平均颜色叠加到不透明结果上
+out vec4 FragColor;
+
+uniform sampler2D accumTexture;
+uniform sampler2D revealageTexture;
+
+void main() {
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+    float revealage = texelFetch(revealageTexture, coord, 0).r;
+    if (revealage >= 0.9999) {
+        discard;    // 没有透明物体覆盖
+    }
+
+    vec4 accum = texelFetch(accumTexture, coord, 0);
+    // 半精度累积溢出时退回 alpha 作为颜色，避免出现 inf / nan
+    if (isinf(max(max(abs(accum.r), abs(accum.g)), abs(accum.b)))) {
+        accum.rgb = vec3(accum.a);
+    }
+    vec3 average = accum.rgb / max(accum.a, 1e-5);
+
+    FragColor = vec4(average, revealage);
+}
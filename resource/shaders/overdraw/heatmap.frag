@@ -0,0 +1,33 @@
+#version 330 core
+// 过度绘制热力图：0 层为黑色，之后按 蓝 -> 青 -> 绿 -> 黄 -> 红 -> 白 递增，heatmapMax 层及以上为白色
+in vec2 UV;
+out vec4 FragColor;
+
+uniform usampler2D overdrawCounts;
+uniform float heatmapMax;
+
+vec3 heat(float t) {
+    const vec3 colors[6] = vec3[6](
+        vec3(0.0, 0.0, 1.0),
+        vec3(0.0, 1.0, 1.0),
+        vec3(0.0, 1.0, 0.0),
+        vec3(1.0, 1.0, 0.0),
+        vec3(1.0, 0.0, 0.0),
+        vec3(1.0, 1.0, 1.0)
+    );
+    float x = clamp(t, 0.0, 1.0) * 5.0;
+    int index = min(int(x), 4);
+    return mix(colors[index], colors[index + 1], x - float(index));
+}
+
+void main()
+{
+    uint count = texelFetch(overdrawCounts, ivec2(gl_FragCoord.xy), 0).r;
+    if (count == 0u) {
+        FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+    // 1 层对应色带起点，heatmapMax 层对应终点
+    float t = (float(count) - 1.0) / max(heatmapMax - 1.0, 1.0);
+    FragColor = vec4(heat(t), 1.0);
+}
@@ -0,0 +1,11 @@
+#version 430 core
+// 过度绘制计数：每个通过深度 / 模板测试的片元把所在像素的计数加一
+// 写图像有副作用，必须显式要求提前测试，否则驱动会关闭 early-z，被遮挡的片元也会被计数
+layout(early_fragment_tests) in;
+
+layout(r32ui, binding = 0) uniform coherent uimage2D overdrawCounts;
+
+void main()
+{
+    imageAtomicAdd(overdrawCounts, ivec2(gl_FragCoord.xy), 1u);
+}
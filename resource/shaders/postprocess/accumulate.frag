@@ -0,0 +1,11 @@
+#version 330 core
+// 渐进累积：输出本帧的场景颜色，与累积纹理的混合由固定管线完成（GL_CONSTANT_ALPHA，权重 1 / (n + 1)）
+in vec2 UV;
+out vec4 FragColor;
+
+uniform sampler2D sourceTexture;
+uniform vec2 uvScale;       // 场景在源纹理中所占的比例
+
+void main() {
+    FragColor = vec4(texture(sourceTexture, UV * uvScale).rgb, 1.0);
+}
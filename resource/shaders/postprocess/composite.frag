@@ -0,0 +1,81 @@
+#version 330 core
+// 逐像素后处理：启用的效果以宏的形式传入，同一份源码既可以融合成一个 Pass，也可以每个效果单独一个 Pass
+// BLOOM / EXPOSURE / TONEMAP / COLOR_GRADING / VIGNETTE，按下面的顺序执行
+in vec2 UV;
+out vec4 FragColor;
+
+uniform sampler2D sourceTexture;
+
+#ifdef BLOOM
+uniform sampler2D bloomTexture;     // 泛光金字塔的第 0 层（已经逐层上采样累加）
+uniform float bloomIntensity;
+#endif
+
+#ifdef EXPOSURE
+uniform float exposure;
+#endif
+
+#ifdef COLOR_GRADING
+uniform sampler2D lutTexture;       // 横向展开的 2D LUT：宽 = size * size，高 = size，蓝色通道按切片排列
+uniform float lutSize;
+#endif
+
+#ifdef VIGNETTE
+uniform float vignetteIntensity;
+uniform float vignetteRadius;
+#endif
+
+#ifdef TONEMAP
+// ACES 拟合曲线（Narkowicz 2015）
+vec3 tonemapACES(vec3 color) {
+    const float a = 2.51;
+    const float b = 0.03;
+    const float c = 2.43;
+    const float d = 0.59;
+    const float e = 0.14;
+    return clamp((color * (a * color + b)) / (color * (c * color + d) + e), 0.0, 1.0);
+}
+#endif
+
+#ifdef COLOR_GRADING
+vec3 applyLut(vec3 color) {
+    color = clamp(color, 0.0, 1.0);
+    // 蓝色落在两个切片之间，分别采样后插值；红绿在切片内由双线性完成
+    float blue = color.b * (lutSize - 1.0);
+    float slice0 = floor(blue);
+    float slice1 = min(slice0 + 1.0, lutSize - 1.0);
+    vec2 texel = vec2(1.0 / (lutSize * lutSize), 1.0 / lutSize);
+    vec2 inSlice = vec2(color.r * (lutSize - 1.0) + 0.5, color.g * (lutSize - 1.0) + 0.5) * texel;
+    vec3 color0 = texture(lutTexture, inSlice + vec2(slice0 * lutSize * texel.x, 0.0)).rgb;
+    vec3 color1 = texture(lutTexture, inSlice + vec2(slice1 * lutSize * texel.x, 0.0)).rgb;
+    return mix(color0, color1, blue - slice0);
+}
+#endif
+
+void main() {
+    vec3 color = texture(sourceTexture, UV).rgb;
+
+#ifdef BLOOM
+    color += textureLod(bloomTexture, UV, 0.0).rgb * bloomIntensity;
+#endif
+
+#ifdef EXPOSURE
+    color *= exposure;
+#endif
+
+#ifdef TONEMAP
+    color = tonemapACES(color);
+#endif
+
+#ifdef COLOR_GRADING
+    color = applyLut(color);
+#endif
+
+#ifdef VIGNETTE
+    vec2 centered = UV - 0.5;
+    float vignette = 1.0 - smoothstep(vignetteRadius - 0.45, vignetteRadius, length(centered));
+    color *= mix(1.0, vignette, vignetteIntensity);
+#endif
+
+    FragColor = vec4(color, 1.0);
+}
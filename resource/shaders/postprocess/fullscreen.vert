@@ -0,0 +1,9 @@
+#version 330 core
+// 全屏三角形：不需要顶点缓冲，由 gl_VertexID 生成，UV 覆盖 [0, 1]
+out vec2 UV;
+
+void main() {
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    UV = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,51 @@
+#version 330 core
+// FXAA（简化版 FXAA 3.11 控制台质量）：依赖邻域像素，放在逐像素效果之后单独一个 Pass
+in vec2 UV;
+out vec4 FragColor;
+
+uniform sampler2D sourceTexture;
+
+const float FXAA_SPAN_MAX = 8.0;
+const float FXAA_REDUCE_MUL = 1.0 / 8.0;
+const float FXAA_REDUCE_MIN = 1.0 / 128.0;
+
+float luma(vec3 color) {
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(sourceTexture, 0));
+
+    vec3 colorNW = texture(sourceTexture, UV + vec2(-1.0, -1.0) * texel).rgb;
+    vec3 colorNE = texture(sourceTexture, UV + vec2(1.0, -1.0) * texel).rgb;
+    vec3 colorSW = texture(sourceTexture, UV + vec2(-1.0, 1.0) * texel).rgb;
+    vec3 colorSE = texture(sourceTexture, UV + vec2(1.0, 1.0) * texel).rgb;
+    vec3 colorM = texture(sourceTexture, UV).rgb;
+
+    float lumaNW = luma(colorNW);
+    float lumaNE = luma(colorNE);
+    float lumaSW = luma(colorSW);
+    float lumaSE = luma(colorSE);
+    float lumaM = luma(colorM);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    // 边缘方向垂直于亮度梯度
+    vec2 dir;
+    dir.x = -((lumaNW + lumaNE) - (lumaSW + lumaSE));
+    dir.y = ((lumaNW + lumaSW) - (lumaNE + lumaSE));
+    float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25 * FXAA_REDUCE_MUL, FXAA_REDUCE_MIN);
+    float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir * rcpDirMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX)) * texel;
+
+    vec3 colorA = 0.5 * (
+        texture(sourceTexture, UV + dir * (1.0 / 3.0 - 0.5)).rgb +
+        texture(sourceTexture, UV + dir * (2.0 / 3.0 - 0.5)).rgb);
+    vec3 colorB = colorA * 0.5 + 0.25 * (
+        texture(sourceTexture, UV + dir * -0.5).rgb +
+        texture(sourceTexture, UV + dir * 0.5).rgb);
+
+    // 第二次采样超出局部亮度范围时说明跨过了边缘，退回较短的采样
+    float lumaB = luma(colorB);
+    FragColor = vec4((lumaB < lumaMin || lumaB > lumaMax) ? colorA : colorB, 1.0);
+}
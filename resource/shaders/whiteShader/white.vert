@@ -6,7 +6,7 @@ layout (location = 2) in vec3 aNormal;
 out vec2 UV;
 out vec3 normal;
 
-uniform mat4 ModelMatrix;
+#include "../common/perDraw.glsl"
 uniform mat4 ViewMatrix;
 uniform mat4 ProjectionMatrix;
 
@@ -14,7 +14,7 @@ void main()
 {
     vec4 transformPosition = vec4(aPos, 1.0);
 
-    transformPosition = ModelMatrix * transformPosition;
+    transformPosition = perDraw.modelMatrix * transformPosition;
     
     gl_Position = ProjectionMatrix * ViewMatrix * transformPosition;
 
@@ -1,5 +1,12 @@
 #include "Application.h"
 #include <iostream>
+#include "../../include/glframework/renderStats.h"
+#include "../../include/glframework/redrawTracker.h"
+#include "../../include/glframework/tools/profiler.h"
+#include "../../include/glframework/tools/jobSystem.h"
+#include "../../include/wrapper/glDebug.h"
+#include <cstdlib>
+#include <cstring>
 #include "../../../include//imgui/imgui_impl_sdl2.h"
 
 // ʼ̬Ա
@@ -43,12 +50,16 @@ bool Application::init(const int& width, const int& height, const char* title) {
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
     SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 
-    // 
+    // GL 鷽ʽKHR_debug صҪģ
+    GLDebug::configure();
+
+    // ڣعģʽشڣ
+    bool harness = mHarness.configure();
     mWindow = SDL_CreateWindow(
         title,
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
         mWidth, mHeight,
-        SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE
+        SDL_WINDOW_OPENGL | (harness ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN) | SDL_WINDOW_RESIZABLE
     );
 
 
@@ -76,8 +87,51 @@ bool Application::init(const int& width, const int& height, const char* title) {
         return false;
     }
 
-    // ôֱͬ
-    SDL_GL_SetSwapInterval(1);
+    // װ KHR_debug ص Sampled ģʽÿ N ֡ glGetError
+    GLDebug::init();
+
+    //  GL ĵ̣߳첽ϴԴupdate  pumpMainThreadȾ߳Ⱦ߳̽ӹܣ
+    JobSystem::setMainThread();
+    // г̣߳첽صĻصִУupdate  pumpSimulationThread
+    JobSystem::setSimulationThread();
+
+    // ĬϴֱͬԸΪ / Ӧ֡Ŷ֡عģʽ¹رգʵ֡ʱ䣩
+    if (harness) {
+        mPacer.setSwapMode(SwapMode::Off);
+    }
+    else {
+        mPacer.setSwapMode(SwapMode::VSync);
+        mPacer.configureFromEnvironment();
+    }
+
+    if (harness) {
+        mHarness.begin(mWindow);
+    }
+
+    // ػ淽ʽڳе setRedrawModeعҪ֡ƽ Continuous
+    const char* redraw = std::getenv("ENGINE_REDRAW");
+    if (redraw != nullptr && redraw[0] != '\0') {
+        if (std::strcmp(redraw, "ondemand") == 0) {
+            setRedrawMode(RedrawMode::OnDemand);
+            mRedrawModeFromEnv = true;
+        }
+        else if (std::strcmp(redraw, "continuous") == 0) {
+            setRedrawMode(RedrawMode::Continuous);
+            mRedrawModeFromEnv = true;
+        }
+        else {
+            std::cerr << "ERROR[Application]: ENGINE_REDRAW ӦΪ continuous | ondemand" << redraw << std::endl;
+        }
+    }
+
+#ifdef ENABLE_PROFILER
+    // ܷ ENGINE_PROFILE_OUTPUTtrace ļ·ʱ￪ʼ¼destroy ʱд
+    PROFILE_THREAD("Main");
+    const char* profileOutput = std::getenv("ENGINE_PROFILE_OUTPUT");
+    if (profileOutput != nullptr && profileOutput[0] != '\0') {
+        Profiler::beginSession();
+    }
+#endif
 
     return true;
 }
@@ -85,73 +139,100 @@ bool Application::init(const int& width, const int& height, const char* title) {
 void Application::processEvents() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
-        // ؼSDL¼ݸImGuiʹӦ
-        ImGui_ImplSDL2_ProcessEvent(&event);
+        handleEvent(event);
+    }
+}
 
-        switch (event.type) {
-        case SDL_QUIT:
-            mRunning = false;
-            break;
+void Application::handleEvent(const SDL_Event& event) {
+    // ػǣûаƶֻӰ ImGui ͣ֡ı仭ۻ
+    // ͨؼı仭棬Ϊ࣬֡ ImGui Ŀؼ״̬ȶ
+    if (event.type == SDL_MOUSEMOTION && event.motion.state == 0) {
+        RedrawTracker::requestFrame(2);
+    }
+    else if (event.type != SDL_USEREVENT) {
+        RedrawTracker::markDirty(3);
+    }
 
-        case SDL_WINDOWEVENT:
-            if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
-                mWidth = event.window.data1;
-                mHeight = event.window.data2;
-                if (mResizeCallback) {
-                    mResizeCallback(mWidth, mHeight);
-                }
-                //std::cout << "Window resized to: " << mWidth << "x" << mHeight << std::endl;
-            }
-            break;
+    // ӳٴӱ֡һ¼ʱʼ
+    switch (event.type) {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+    case SDL_MOUSEMOTION:
+    case SDL_MOUSEWHEEL:
+        mPacer.onInput(event.common.timestamp);
+        break;
+    default:
+        break;
+    }
 
-        case SDL_KEYUP:
-        case SDL_KEYDOWN:
-            if (mKeyBoardCallback) {
-                mKeyBoardCallback(
-                    event.key.keysym.scancode, // ɨ
-                    event.key.keysym.sym,    // 
-                    event.key.state,         // ״̬(/ͷ)
-                    event.key.keysym.mod     // μ
-                );
-            }
-            break;
+    // ؼSDL¼ݸImGuiʹӦ
+    ImGui_ImplSDL2_ProcessEvent(&event);
 
-        case SDL_MOUSEBUTTONDOWN:
-        case SDL_MOUSEBUTTONUP:
-            if (mMouseButtonCallback) {
-                mMouseButtonCallback(
-                    event.button.button,       // ť
-                    event.button.state,        // /ͷ
-                    event.button.x, event.button.y,  // λ
-                    SDL_GetModState()          // μ
-                );
-                /*
-                    xyǰʱľλ꣬ƶҪֿ
-                */
-            }
-            break;
+    switch (event.type) {
+    case SDL_QUIT:
+        mRunning = false;
+        break;
 
-            // ƶ¼
-        case SDL_MOUSEMOTION:
-            if (mMouseMotionCallback) {
-                mMouseMotionCallback(
-                    event.motion.x, event.motion.y,  // λ
-                    event.motion.xrel, event.motion.yrel,  // ƶ
-                    event.motion.state  // ƶʱסİ
-                );
+    case SDL_WINDOWEVENT:
+        if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
+            mWidth = event.window.data1;
+            mHeight = event.window.data2;
+            if (mResizeCallback) {
+                mResizeCallback(mWidth, mHeight);
             }
-            break;
+            //std::cout << "Window resized to: " << mWidth << "x" << mHeight << std::endl;
+        }
+        break;
 
-            // ¼
-        case SDL_MOUSEWHEEL:
-            if (mMouseWheelCallback) {
-                mMouseWheelCallback(
-                    event.wheel.x,  // ˮƽ
-                    event.wheel.y   // ֱ
-                );
-            }
-            break;
+    case SDL_KEYUP:
+    case SDL_KEYDOWN:
+        if (mKeyBoardCallback) {
+            mKeyBoardCallback(
+                event.key.keysym.scancode, // ɨ
+                event.key.keysym.sym,    // 
+                event.key.state,         // ״̬(/ͷ)
+                event.key.keysym.mod     // μ
+            );
         }
+        break;
+
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        if (mMouseButtonCallback) {
+            mMouseButtonCallback(
+                event.button.button,       // ť
+                event.button.state,        // /ͷ
+                event.button.x, event.button.y,  // λ
+                SDL_GetModState()          // μ
+            );
+            /*
+                xyǰʱľλ꣬ƶҪֿ
+            */
+        }
+        break;
+
+        // ƶ¼
+    case SDL_MOUSEMOTION:
+        if (mMouseMotionCallback) {
+            mMouseMotionCallback(
+                event.motion.x, event.motion.y,  // λ
+                event.motion.xrel, event.motion.yrel,  // ƶ
+                event.motion.state  // ƶʱסİ
+            );
+        }
+        break;
+
+        // ¼
+    case SDL_MOUSEWHEEL:
+        if (mMouseWheelCallback) {
+            mMouseWheelCallback(
+                event.wheel.x,  // ˮƽ
+                event.wheel.y   // ֱ
+            );
+        }
+        break;
     }
 }
 
@@ -160,17 +241,128 @@ bool Application::update() {
         return false;
     }
 
+    // Ⱦ߳ģʽ֡ࡢ֡ͳ GL Ⱦֻ̣߳¼
+    if (mRenderThread.isRunning()) {
+        {
+            PROFILE_SCOPE("Application::processEvents");
+            processEvents();
+        }
+        if (mRedrawMode == RedrawMode::OnDemand) {
+            waitForRedraw();
+        }
+
+        // Ⱦ߳ϴɺ󽻻صĻصѼغõԴ볡ɿ֮ǰִ
+        if (JobSystem::pumpSimulationThread() > 0) {
+            RedrawTracker::markDirty();
+        }
+        RedrawTracker::beginFrame();
+        return mRunning;
+    }
+
+    // һѭȾ֡
+    {
+        PROFILE_SCOPE("SwapWindow");
+        if (mHarness.isEnabled()) {
+            mHarness.beforeSwap();
+        }
+        SDL_GL_SwapWindow(mWindow);
+    }
+
+    // ࣺ֡ӳ١Ŷ֡ޡ֡ƣڴ¼֮ǰȴһ֡ʹõ뾡
+    if (!mHarness.isEnabled()) {
+        mPacer.afterSwap();
+    }
+
+    // ֡Ⱦͳܷ
+    RenderStats::endFrame();
+    PROFILE_FRAME();
+    GLDebug::endFrame();
+
+    // عԣָ֡˳
+    if (mHarness.isEnabled() && !mHarness.afterSwap()) {
+        mRunning = false;
+        return false;
+    }
+
     // ¼
-    processEvents();
+    {
+        PROFILE_SCOPE("Application::processEvents");
+        processEvents();
+    }
 
-    // 
-    SDL_GL_SwapWindow(mWindow);
+    // ػ棺ûб仯ʱ˯ߣֱ¼̱߳
+    if (mRedrawMode == RedrawMode::OnDemand) {
+        waitForRedraw();
+    }
 
-    return true;
+    // ִ߳̽ GL ߳ģ̵߳첽صϴص˱仯
+    size_t pumped = JobSystem::pumpMainThread();
+    pumped += JobSystem::pumpSimulationThread();
+    if (pumped > 0) {
+        RedrawTracker::markDirty();
+    }
+    RedrawTracker::beginFrame();
+
+    return mRunning;
+}
+
+void Application::waitForRedraw() {
+    while (mRunning && !RedrawTracker::needsFrame()) {
+        // ڵȴټһΣ֮߳ıǻͻ¼ᶪʧ
+        RedrawTracker::setWaiting(true);
+        if (RedrawTracker::needsFrame()) {
+            RedrawTracker::setWaiting(false);
+            break;
+        }
+
+        SDL_Event event;
+        int received = 0;
+        {
+            PROFILE_SCOPE("Application::waitEvent");
+            received = SDL_WaitEvent(&event);
+        }
+        RedrawTracker::setWaiting(false);
+        if (!received) {
+            std::cerr << "ERROR[Application]: SDL_WaitEvent ʧܣ" << SDL_GetError() << std::endl;
+            break;
+        }
+
+        // һλѺŶӵ¼
+        handleEvent(event);
+        processEvents();
+    }
+}
+
+void Application::setRedrawMode(RedrawMode mode) {
+    if (mRedrawModeFromEnv || mHarness.isEnabled()) {
+        return;
+    }
+    mRedrawMode = mode;
+    RedrawTracker::markDirty();
+}
+
+void Application::markDirty(int frames) {
+    RedrawTracker::markDirty(frames);
 }
 
 void Application::destroy() {
+    // Ѿύ֡GL Ļصǰ߳
+    stopRenderThread();
+
+#ifdef ENABLE_PROFILER
+    // Ҫɾ GL ֮ǰȡʣ GPU ѯ
+    if (Profiler::isRecording()) {
+        const char* profileOutput = std::getenv("ENGINE_PROFILE_OUTPUT");
+        Profiler::endSession(profileOutput != nullptr ? profileOutput : "");
+    }
+#endif
+
+    // Ⱥ̨񣨽롢BVH ٻչ߳
+    JobSystem::shutdown();
+
     if (mGLContext) {
+        mPacer.shutdown();
+        GLDebug::shutdown();
         SDL_GL_DeleteContext(mGLContext);
         mGLContext = nullptr;
     }
@@ -183,8 +375,70 @@ void Application::destroy() {
     SDL_Quit();
 }
 
+bool Application::setSwapMode(SwapMode mode) {
+    if (mRenderThread.isRunning()) {
+        JobSystem::runOnMainThread([this, mode] { mPacer.setSwapMode(mode); });
+        return true;
+    }
+    return mPacer.setSwapMode(mode);
+}
+
+void Application::setFrameLimit(double fps) {
+    if (mRenderThread.isRunning()) {
+        JobSystem::runOnMainThread([this, fps] { mPacer.setFrameLimit(fps); });
+        return;
+    }
+    mPacer.setFrameLimit(fps);
+}
+
+void Application::setMaxQueuedFrames(int frames) {
+    if (mRenderThread.isRunning()) {
+        JobSystem::runOnMainThread([this, frames] { mPacer.setMaxQueuedFrames(frames); });
+        return;
+    }
+    mPacer.setMaxQueuedFrames(frames);
+}
+
+bool Application::startRenderThread(RenderCallback callback) {
+    if (mHarness.isEnabled()) {
+        std::cerr << "ERROR[Application]: عģʽ֧Ⱦ߳" << std::endl;
+        return false;
+    }
+    if (mGLContext == nullptr || mRenderThread.isRunning()) {
+        std::cerr << "ERROR[Application]: û GL ĻȾ߳Ѿ" << std::endl;
+        return false;
+    }
+
+    // ͬһʱֻһ߳ϰ󶨣ȴ߳ͷ
+    SDL_GL_MakeCurrent(mWindow, nullptr);
+    if (!mRenderThread.start(mWindow, mGLContext, &mPacer, std::move(callback))) {
+        SDL_GL_MakeCurrent(mWindow, mGLContext);
+        return false;
+    }
+    return true;
+}
+
+void Application::stopRenderThread() {
+    if (!mRenderThread.isRunning()) {
+        return;
+    }
+    mRenderThread.stop();
+    SDL_GL_MakeCurrent(mWindow, mGLContext);
+    JobSystem::setMainThread();
+}
+
 void Application::getCursorPosition(int* x, int* y) {
     if (x && y) {
-        SDL_GetMouseState(x, y);
+        // عģʽע¼
+        if (mHarness.isEnabled()) {
+            mHarness.getCursorPosition(x, y);
+        }
+        else {
+            SDL_GetMouseState(x, y);
+        }
     }
 }
+
+Uint32 Application::getTicks() const {
+    return mHarness.isEnabled() ? mHarness.getTicks() : SDL_GetTicks();
+}
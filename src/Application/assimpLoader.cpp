@@ -1,12 +1,16 @@
 #include "assimpLoader.h"
 #include "../glframework/tools/tools.h"
 #include "../glframework/material/phongMaterial.h"
+#include "../glframework/sceneAllocator.h"
+#include "../glframework/tools/profiler.h"
 Object* AssimpLoader::load(const std::string& path) {
+	PROFILE_SCOPE_DETAIL("AssimpLoader::load", path);
 	// óģĿ¼
 	std::size_t lastIndex = path.find_last_of("//");
 	auto rootpath = path.substr(0, lastIndex + 1);
 
-	Object* rootnode = new Object();
+	// ڵ㡢塢ʶ SceneAllocator ĳз䣬жģʱ SceneAllocator::destroyTree / releaseAll
+	Object* rootnode = SceneAllocator::create<Object>();
 
 	Assimp::Importer importer;
 	const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenNormals);	
@@ -16,6 +20,7 @@ Object* AssimpLoader::load(const std::string& path) {
 	// ֤ȡǷȷ˳
 	if (!scene || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) || !scene->mRootNode) {
 		std::cerr << "Error: Model Read Failed!" << std::endl;	// ޻壨ʾcoutܻỺ壬ų
+		SceneAllocator::destroyTree(rootnode);
 		return nullptr;
 	}
 
@@ -24,7 +29,7 @@ Object* AssimpLoader::load(const std::string& path) {
 }
 
 void AssimpLoader::processNode(aiNode* ainode, Object* parent, const aiScene* scene, const std::string& rootpath) {
-	Object* node = new Object();
+	Object* node = SceneAllocator::create<Object>();
 	parent->addChild(node);
 
 	glm::mat4 localMatrix = getMat4f(ainode->mTransformation);	// Ҫ aiMatrix4x4 תΪ glm::mat4
@@ -40,6 +45,7 @@ void AssimpLoader::processNode(aiNode* ainode, Object* parent, const aiScene* sc
 		int meshID = ainode->mMeshes[i];	// ainodeд洢mesh
 		aiMesh* aimesh = scene->mMeshes[meshID];		// sceneд洢еmesh
 		auto mesh = processMesh(aimesh, scene, rootpath);
+		mesh->setName(aimesh->mName.C_Str());
 		node->addChild(mesh);
 	}
 
@@ -95,6 +101,7 @@ Mesh* AssimpLoader::processMesh(aiMesh* aimesh) {
 */
 
 Mesh* AssimpLoader::processMesh(aiMesh* aimesh, const aiScene* scene, const std::string& rootpath) {
+	PROFILE_SCOPE("AssimpLoader::processMesh");
 	std::vector<float> positions;
 	std::vector<float> normals;
 	std::vector<float> uvs;
@@ -130,8 +137,8 @@ Mesh* AssimpLoader::processMesh(aiMesh* aimesh, const aiScene* scene, const std:
 		}
 	}
 
-	auto geometry = new Geometry(positions, normals, uvs, indices);
-	auto material = new PhongMaterial();
+	auto geometry = SceneAllocator::create<Geometry>(positions, normals, uvs, indices);
+	auto material = SceneAllocator::create<PhongMaterial>();
 	//material->mDiffuse = new Texture(std::string(TEXTURE_DIR) + +"/container2.png", 0);
 	//material->mBlinn = GL_TRUE;
 	//material->mSpecularMask = new Texture(std::string(TEXTURE_DIR) + "/container2_specular.png", 1);  // ֿ
@@ -163,13 +170,13 @@ Mesh* AssimpLoader::processMesh(aiMesh* aimesh, const aiScene* scene, const std:
 		material->mDiffuse = texture;
 	}
 	else {	// ûͼʹĬͼ
-		material->mDiffuse = new Texture(std::string(TEXTURE_DIR) + "/container2.png", 0);
+		material->mDiffuse = Texture::createTexture(std::string(TEXTURE_DIR) + "/container2.png", 0);
 	}
 
 	material->setBlinn(GL_TRUE);
-	material->mSpecularMask = new Texture(std::string(TEXTURE_DIR) + "/container2_specular.png", 1);  // ֿ
+	material->mSpecularMask = Texture::createTexture(std::string(TEXTURE_DIR) + "/container2_specular.png", 1);  // ֿ߻棬meshһ
 
-	return new Mesh(geometry, material);
+	return SceneAllocator::create<Mesh>(geometry, material);
 }
 
 glm::mat4 AssimpLoader::getMat4f(aiMatrix4x4 value) {
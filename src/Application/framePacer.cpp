@@ -0,0 +1,231 @@
+#include "framePacer.h"
+#include "../../include/glframework/tools/profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+bool FramePacer::setSwapMode(SwapMode mode) {
+    if (SDL_GL_SetSwapInterval(static_cast<int>(mode)) == 0) {
+        mSwapMode = mode;
+        return true;
+    }
+
+    // 自适应垂直同步需要 EXT_swap_control_tear / WGL_EXT_swap_control_tear
+    if (mode == SwapMode::Adaptive && SDL_GL_SetSwapInterval(static_cast<int>(SwapMode::VSync)) == 0) {
+        std::cerr << "WARNING[FramePacer]: 不支持自适应垂直同步，退回到垂直同步：" << SDL_GetError() << std::endl;
+        mSwapMode = SwapMode::VSync;
+        return false;
+    }
+    std::cerr << "ERROR[FramePacer]: 设置交换间隔失败：" << SDL_GetError() << std::endl;
+    return false;
+}
+
+void FramePacer::setFrameLimit(double fps) {
+    mFrameLimit = fps > 0.0 ? fps : 0.0;
+    mNextFrame = Clock::time_point{};
+}
+
+void FramePacer::setMaxQueuedFrames(int frames) {
+    mMaxQueuedFrames = frames < 0 ? -1 : frames;
+}
+
+void FramePacer::configureFromEnvironment() {
+    const char* swap = std::getenv("ENGINE_SWAP");
+    if (swap != nullptr && swap[0] != '\0') {
+        if (std::strcmp(swap, "off") == 0) {
+            setSwapMode(SwapMode::Off);
+        }
+        else if (std::strcmp(swap, "vsync") == 0) {
+            setSwapMode(SwapMode::VSync);
+        }
+        else if (std::strcmp(swap, "adaptive") == 0) {
+            setSwapMode(SwapMode::Adaptive);
+        }
+        else {
+            std::cerr << "ERROR[FramePacer]: ENGINE_SWAP 应为 off | vsync | adaptive：" << swap << std::endl;
+        }
+    }
+
+    const char* limit = std::getenv("ENGINE_FPS_LIMIT");
+    if (limit != nullptr && limit[0] != '\0') {
+        setFrameLimit(std::atof(limit));
+    }
+
+    const char* queued = std::getenv("ENGINE_MAX_QUEUED_FRAMES");
+    if (queued != nullptr && queued[0] != '\0') {
+        setMaxQueuedFrames(std::atoi(queued));
+    }
+}
+
+void FramePacer::onInput(Uint32 timestamp) {
+    // 只记录本帧的第一条输入，它等得最久
+    if (mInput.valid) {
+        return;
+    }
+    Uint32 ticks = SDL_GetTicks();
+    mInput.valid = true;
+    mInput.queueMs = ticks >= timestamp ? static_cast<double>(ticks - timestamp) : 0.0;
+    mInput.handled = Clock::now();
+}
+
+FramePacer::InputSample FramePacer::takeInput() {
+    InputSample input = mInput;
+    mInput = InputSample{};
+    return input;
+}
+
+void FramePacer::afterSwap(const InputSample* input) {
+    Clock::time_point swapped = Clock::now();
+    double frameMs = -1.0;
+    if (mLastSwap != Clock::time_point{}) {
+        frameMs = std::chrono::duration<double, std::milli>(swapped - mLastSwap).count();
+    }
+    mLastSwap = swapped;
+
+    // 设置项在这一帧内只读一次
+    int maxQueuedFrames = mMaxQueuedFrames.load(std::memory_order_relaxed);
+    double frameLimit = mFrameLimit.load(std::memory_order_relaxed);
+
+    // 1 排队帧数上限（N = 0 时这里就是 GPU 执行完这一帧的时间）
+    double fenceWaitMs = 0.0;
+    if (maxQueuedFrames >= 0) {
+        fenceWaitMs = waitFences(maxQueuedFrames);
+    }
+    else if (!mFences.empty()) {
+        shutdown();
+    }
+
+    // 2 输入延迟：上一次 afterSwap 之后处理的输入，由刚交换的这一帧显示
+    InputSample sample = input != nullptr ? *input : takeInput();
+    {
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        if (frameMs >= 0.0) {
+            recordFrameTime(frameMs);
+        }
+        mStats.fenceWaitMs = fenceWaitMs;
+        mStats.queuedFrames = static_cast<int>(mFences.size());
+        if (sample.valid) {
+            Clock::time_point presented = maxQueuedFrames == 0 ? Clock::now() : swapped;
+            recordLatency(sample.queueMs + std::chrono::duration<double, std::milli>(presented - sample.handled).count());
+        }
+    }
+
+    // 3 帧率限制：等待之后才处理事件，输入尽量新
+    double limiterWaitMs = frameLimit > 0.0 ? limitFrameRate(frameLimit) : 0.0;
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    mStats.limiterWaitMs = limiterWaitMs;
+}
+
+double FramePacer::waitFences(int maxQueuedFrames) {
+    PROFILE_SCOPE("FramePacer::waitFences");
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (fence != nullptr) {
+        mFences.push_back(fence);
+    }
+
+    Clock::time_point begin = Clock::now();
+    while (static_cast<int>(mFences.size()) > maxQueuedFrames) {
+        GLsync oldest = mFences.front();
+        // 第一次等待带上 FLUSH，保证栅栏已经提交给 GPU；超时只是为了能定期检查，不会放弃等待
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        GLenum result = GL_TIMEOUT_EXPIRED;
+        while (result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(oldest, flags, 100000000);   // 100ms
+            flags = 0;
+        }
+        if (result == GL_WAIT_FAILED) {
+            std::cerr << "ERROR[FramePacer]: glClientWaitSync 失败" << std::endl;
+        }
+        glDeleteSync(oldest);
+        mFences.pop_front();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+double FramePacer::limitFrameRate(double fps) {
+    PROFILE_SCOPE("FramePacer::limitFrameRate");
+    auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    Clock::time_point now = Clock::now();
+
+    // 落后超过一帧（例如按需重绘模式下刚从睡眠中醒来）时不追赶，从当前时间重新计时
+    if (mNextFrame == Clock::time_point{} || now - mNextFrame > interval) {
+        mNextFrame = now + interval;
+        return 0.0;
+    }
+
+    Clock::time_point begin = now;
+    auto spin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(mSpinMs));
+    if (mNextFrame - now > spin) {
+        std::this_thread::sleep_for(mNextFrame - now - spin);
+    }
+    while (Clock::now() < mNextFrame) {
+        std::this_thread::yield();
+    }
+
+    // 按截止时间而不是醒来的时间推进，sleep 的误差不会累积
+    mNextFrame += interval;
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+void FramePacer::recordLatency(double latencyMs) {
+    if (mLatencies.size() < LATENCY_WINDOW) {
+        mLatencies.push_back(latencyMs);
+    }
+    else {
+        mLatencies[mLatencyNext] = latencyMs;
+    }
+    mLatencyNext = (mLatencyNext + 1) % LATENCY_WINDOW;
+
+    double sum = 0.0;
+    double maxLatency = 0.0;
+    for (double latency : mLatencies) {
+        sum += latency;
+        maxLatency = std::max(maxLatency, latency);
+    }
+    mStats.latencyMs = latencyMs;
+    mStats.averageLatencyMs = sum / static_cast<double>(mLatencies.size());
+    mStats.maxLatencyMs = maxLatency;
+    mStats.latencySamples++;
+}
+
+void FramePacer::recordFrameTime(double frameMs) {
+    if (mFrameTimes.size() < FRAME_WINDOW) {
+        mFrameTimes.push_back(frameMs);
+    }
+    else {
+        mFrameTimes[mFrameNext] = frameMs;
+    }
+    mFrameNext = (mFrameNext + 1) % FRAME_WINDOW;
+
+    double sum = 0.0;
+    double maxFrame = 0.0;
+    for (double time : mFrameTimes) {
+        sum += time;
+        maxFrame = std::max(maxFrame, time);
+    }
+    double average = sum / static_cast<double>(mFrameTimes.size());
+    double variance = 0.0;
+    for (double time : mFrameTimes) {
+        variance += (time - average) * (time - average);
+    }
+    mStats.frameMs = frameMs;
+    mStats.averageFrameMs = average;
+    mStats.frameStdDevMs = std::sqrt(variance / static_cast<double>(mFrameTimes.size()));
+    mStats.maxFrameMs = maxFrame;
+    mStats.frameSamples++;
+}
+
+FramePacer::Stats FramePacer::getStats() const {
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    return mStats;
+}
+
+void FramePacer::shutdown() {
+    for (GLsync fence : mFences) {
+        glDeleteSync(fence);
+    }
+    mFences.clear();
+}
@@ -0,0 +1,220 @@
+#include "renderHarness.h"
+#include "../../include/wrapper/glDebug.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+// 读取整数环境变量，未设置时返回 fallback
+static int readEnvInt(const char* name, int fallback) {
+    const char* value = std::getenv(name);
+    return (value != nullptr && value[0] != '\0') ? std::atoi(value) : fallback;
+}
+
+// 最近秩法求百分位，values 需要已经排序
+static double percentile(const std::vector<double>& values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+    return values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+static void writeTimes(std::ofstream& file, const char* name, std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+    file << '"' << name << "\":{\"count\":" << values.size()
+        << ",\"p50\":" << percentile(values, 50.0)
+        << ",\"p90\":" << percentile(values, 90.0)
+        << ",\"p99\":" << percentile(values, 99.0)
+        << ",\"max\":" << (values.empty() ? 0.0 : values.back())
+        << ",\"mean\":" << (values.empty() ? 0.0 : sum / values.size()) << '}';
+}
+
+bool RenderHarness::configure() {
+    mFrameCount = readEnvInt("ENGINE_HARNESS_FRAMES", 0);
+    mEnabled = mFrameCount > 0;
+    if (!mEnabled) {
+        return false;
+    }
+
+    mWarmup = std::max(0, readEnvInt("ENGINE_HARNESS_WARMUP", mWarmup));
+    mStepMs = std::max(0, readEnvInt("ENGINE_HARNESS_STEP_MS", mStepMs));
+    const char* output = std::getenv("ENGINE_HARNESS_OUTPUT");
+    if (output != nullptr && output[0] != '\0') {
+        mOutput = output;
+    }
+    const char* orbit = std::getenv("ENGINE_HARNESS_ORBIT");
+    if (orbit != nullptr && std::sscanf(orbit, "%d,%d", &mOrbitX, &mOrbitY) != 2) {
+        std::cerr << "ERROR[RenderHarness]: ENGINE_HARNESS_ORBIT 格式应为 \"dx,dy\"：" << orbit << std::endl;
+        mOrbitX = 4;
+        mOrbitY = 0;
+    }
+    return true;
+}
+
+void RenderHarness::begin(SDL_Window* window) {
+    mWindow = window;
+    mFrame = 0;
+
+    mTimestamps.resize(mFrameCount);
+    glGenQueries(mFrameCount, mTimestamps.data());
+
+    // 从窗口中心开始拖动
+    int width = 0;
+    int height = 0;
+    SDL_GetWindowSize(mWindow, &width, &height);
+    mCursorX = width / 2;
+    mCursorY = height / 2;
+
+    SDL_Event event{};
+    event.type = SDL_MOUSEBUTTONDOWN;
+    event.button.windowID = SDL_GetWindowID(mWindow);
+    event.button.button = SDL_BUTTON_LEFT;
+    event.button.state = SDL_PRESSED;
+    event.button.clicks = 1;
+    event.button.x = mCursorX;
+    event.button.y = mCursorY;
+    SDL_PushEvent(&event);
+
+    mLastSwap = std::chrono::high_resolution_clock::now();
+}
+
+void RenderHarness::beforeSwap() {
+    if (mFrame >= mFrameCount) {
+        return;
+    }
+    glQueryCounter(mTimestamps[mFrame], GL_TIMESTAMP);
+    if (mFrame == mFrameCount - 1) {
+        capture();
+    }
+}
+
+bool RenderHarness::afterSwap() {
+    auto now = std::chrono::high_resolution_clock::now();
+    if (mFrame > 0 && mFrame >= mWarmup) {
+        mCpuMs.push_back(std::chrono::duration<double, std::milli>(now - mLastSwap).count());
+    }
+    mLastSwap = now;
+
+    mFrame++;
+    if (mFrame >= mFrameCount) {
+        writeResults();
+        return false;
+    }
+    pushInput();
+    return true;
+}
+
+void RenderHarness::getCursorPosition(int* x, int* y) const {
+    *x = mCursorX;
+    *y = mCursorY;
+}
+
+void RenderHarness::pushInput() {
+    if (mOrbitX == 0 && mOrbitY == 0) {
+        return;
+    }
+    mCursorX += mOrbitX;
+    mCursorY += mOrbitY;
+
+    SDL_Event event{};
+    event.type = SDL_MOUSEMOTION;
+    event.motion.windowID = SDL_GetWindowID(mWindow);
+    event.motion.state = SDL_BUTTON_LMASK;
+    event.motion.x = mCursorX;
+    event.motion.y = mCursorY;
+    event.motion.xrel = mOrbitX;
+    event.motion.yrel = mOrbitY;
+    SDL_PushEvent(&event);
+}
+
+void RenderHarness::capture() {
+    SDL_GL_GetDrawableSize(mWindow, &mCaptureWidth, &mCaptureHeight);
+    if (mCaptureWidth <= 0 || mCaptureHeight <= 0) {
+        return;
+    }
+
+    GLint readFramebuffer = 0;
+    GLint packAlignment = 4;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+
+    size_t rowBytes = static_cast<size_t>(mCaptureWidth) * 4;
+    std::vector<unsigned char> rows(rowBytes * mCaptureHeight);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glReadBuffer(GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, mCaptureWidth, mCaptureHeight, GL_RGBA, GL_UNSIGNED_BYTE, rows.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+
+    // OpenGL 原点在左下角，图片自上而下存储；默认帧缓冲的 alpha 没有意义，统一写为不透明
+    mPixels.resize(rows.size());
+    for (int y = 0; y < mCaptureHeight; y++) {
+        const unsigned char* source = rows.data() + (mCaptureHeight - 1 - y) * rowBytes;
+        unsigned char* target = mPixels.data() + y * rowBytes;
+        std::copy(source, source + rowBytes, target);
+        for (size_t x = 3; x < rowBytes; x += 4) {
+            target[x] = 255;
+        }
+    }
+}
+
+bool RenderHarness::writeResults() {
+    //1 GPU 帧时间：相邻两帧时间戳之差（结束时等待 GPU 完成后一次性读取）
+    glFinish();
+    std::vector<double> gpuMs;
+    GLuint64 previous = 0;
+    for (int i = 0; i < mFrameCount; i++) {
+        GLuint64 timestamp = 0;
+        glGetQueryObjectui64v(mTimestamps[i], GL_QUERY_RESULT, &timestamp);
+        if (i > 0 && i >= mWarmup) {
+            gpuMs.push_back(static_cast<double>(timestamp - previous) / 1e6);
+        }
+        previous = timestamp;
+    }
+    glDeleteQueries(mFrameCount, mTimestamps.data());
+    mTimestamps.clear();
+
+    // GL 错误：Sampled 模式下最后再检查一次，不在测量的帧中调用 glGetError
+    GLDebug::flush();
+
+    //2 帧时间统计
+    std::string jsonPath = mOutput + ".json";
+    std::ofstream file(jsonPath);
+    if (!file.is_open()) {
+        std::cerr << "ERROR[RenderHarness]: 无法写入 " << jsonPath << std::endl;
+        return false;
+    }
+    file << "{\"frames\":" << mFrameCount << ",\"warmup\":" << mWarmup << ",\"stepMs\":" << mStepMs
+        << ",\"width\":" << mCaptureWidth << ",\"height\":" << mCaptureHeight << ',';
+    writeTimes(file, "cpuMs", mCpuMs);
+    file << ',';
+    writeTimes(file, "gpuMs", gpuMs);
+    file << ",\"glErrors\":" << GLDebug::getErrorCount() << "}\n";
+    file.close();
+
+    //3 最后一帧画面
+    if (mPixels.empty()) {
+        std::cerr << "ERROR[RenderHarness]: 没有读取到画面" << std::endl;
+        return false;
+    }
+    std::string imagePath = mOutput + ".bmp";
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(mPixels.data(), mCaptureWidth, mCaptureHeight, 32,
+        mCaptureWidth * 4, SDL_PIXELFORMAT_RGBA32);
+    bool saved = surface != nullptr && SDL_SaveBMP(surface, imagePath.c_str()) == 0;
+    SDL_FreeSurface(surface);
+    if (!saved) {
+        std::cerr << "ERROR[RenderHarness]: 无法写入 " << imagePath << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    std::cout << "[RenderHarness] " << mFrameCount << " frames -> " << imagePath << ", " << jsonPath << std::endl;
+    return true;
+}
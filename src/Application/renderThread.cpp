@@ -0,0 +1,165 @@
+#include "renderThread.h"
+#include "../../include/glframework/renderStats.h"
+#include "../../include/glframework/redrawTracker.h"
+#include "../../include/glframework/tools/profiler.h"
+#include "../../include/glframework/tools/jobSystem.h"
+#include "../../include/wrapper/glDebug.h"
+#include <iostream>
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+bool RenderThread::start(SDL_Window* window, SDL_GLContext context, FramePacer* pacer, RenderCallback callback) {
+    if (isRunning()) {
+        std::cerr << "ERROR[RenderThread]: 渲染线程已经启动" << std::endl;
+        return false;
+    }
+    mWindow = window;
+    mContext = context;
+    mPacer = pacer;
+    mCallback = std::move(callback);
+    mPublished.store(0);
+    mConsumed.store(0);
+    mAcquired = Clock::time_point{};
+    {
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        mStats = Stats{};
+    }
+
+    std::promise<bool> ready;
+    std::future<bool> result = ready.get_future();
+    mThread = std::thread(&RenderThread::threadLoop, this, std::ref(ready));
+    if (!result.get()) {
+        mThread.join();
+        return false;
+    }
+    return true;
+}
+
+void RenderThread::stop() {
+    if (!isRunning()) {
+        return;
+    }
+    mPublished.fetch_or(STOP_BIT, std::memory_order_release);
+    mPublished.notify_one();
+    mThread.join();
+    mPublished.store(0);
+}
+
+FrameSnapshot& RenderThread::acquire() {
+    PROFILE_SCOPE("RenderThread::acquire");
+    Clock::time_point begin = Clock::now();
+
+    // 只有主线程改变 mPublished 的计数，这里读到的就是最新值
+    uint64_t published = mPublished.load(std::memory_order_relaxed) & COUNT_MASK;
+    uint64_t consumed = mConsumed.load(std::memory_order_acquire);
+    while (published - consumed >= 2) {
+        mConsumed.wait(consumed, std::memory_order_acquire);
+        consumed = mConsumed.load(std::memory_order_acquire);
+    }
+
+    mAcquired = Clock::now();
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    mStats.mainWaitMs = std::chrono::duration<double, std::milli>(mAcquired - begin).count();
+    return mSlots[published % 2];
+}
+
+void RenderThread::publish(const FramePacer::InputSample& input) {
+    uint64_t published = mPublished.load(std::memory_order_relaxed) & COUNT_MASK;
+    mSlots[published % 2].frameIndex = published;
+    mInputs[published % 2] = input;
+    {
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        mStats.simulationMs = std::chrono::duration<double, std::milli>(Clock::now() - mAcquired).count();
+    }
+
+    // release：渲染线程看到新的计数时，槽中的快照已经写完
+    mPublished.fetch_add(1, std::memory_order_release);
+    mPublished.notify_one();
+}
+
+void RenderThread::flush() {
+    if (!isRunning()) {
+        return;
+    }
+    PROFILE_SCOPE("RenderThread::flush");
+    uint64_t published = mPublished.load(std::memory_order_relaxed) & COUNT_MASK;
+    uint64_t consumed = mConsumed.load(std::memory_order_acquire);
+    while (consumed != published) {
+        mConsumed.wait(consumed, std::memory_order_acquire);
+        consumed = mConsumed.load(std::memory_order_acquire);
+    }
+}
+
+RenderThread::Stats RenderThread::getStats() const {
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    return mStats;
+}
+
+void RenderThread::threadLoop(std::promise<bool>& ready) {
+    if (SDL_GL_MakeCurrent(mWindow, mContext) != 0) {
+        std::cerr << "ERROR[RenderThread]: 绑定 GL 上下文失败：" << SDL_GetError() << std::endl;
+        ready.set_value(false);
+        return;
+    }
+    PROFILE_THREAD("Render");
+    JobSystem::setMainThread();
+    ready.set_value(true);
+
+    uint64_t consumed = 0;
+    while (true) {
+        //1 等待下一份快照；停止时先画完已经提交的
+        Clock::time_point idleBegin = Clock::now();
+        uint64_t published = mPublished.load(std::memory_order_acquire);
+        while ((published & COUNT_MASK) == consumed && (published & STOP_BIT) == 0) {
+            mPublished.wait(published, std::memory_order_acquire);
+            published = mPublished.load(std::memory_order_acquire);
+        }
+        if ((published & COUNT_MASK) == consumed) {
+            break;
+        }
+        double idleMs = std::chrono::duration<double, std::milli>(Clock::now() - idleBegin).count();
+
+        //2 其它线程交给 GL 线程的任务（异步加载的上传；回调会交回主线程执行）
+        if (JobSystem::pumpMainThread() > 0) {
+            RedrawTracker::markDirty();
+        }
+
+        //3 提交这一帧
+        size_t slot = consumed % 2;
+        Clock::time_point renderBegin = Clock::now();
+        {
+            PROFILE_SCOPE("RenderThread::render");
+            mCallback(mSlots[slot]);
+        }
+        double renderMs = std::chrono::duration<double, std::milli>(Clock::now() - renderBegin).count();
+
+        //4 交换缓冲区、帧节奏（结算这一帧快照携带的输入）、帧结束
+        {
+            PROFILE_SCOPE("SwapWindow");
+            SDL_GL_SwapWindow(mWindow);
+        }
+        if (mPacer != nullptr) {
+            mPacer->afterSwap(&mInputs[slot]);
+        }
+        RenderStats::endFrame();
+        PROFILE_FRAME();
+        GLDebug::endFrame();
+
+        {
+            std::lock_guard<std::mutex> lock(mStatsMutex);
+            mStats.renderMs = renderMs;
+            mStats.renderIdleMs = idleMs;
+            mStats.frames++;
+        }
+
+        //5 归还快照槽
+        consumed++;
+        mConsumed.store(consumed, std::memory_order_release);
+        mConsumed.notify_one();
+    }
+
+    // 剩余的 GL 任务交给重新接管上下文的线程
+    SDL_GL_MakeCurrent(mWindow, nullptr);
+}
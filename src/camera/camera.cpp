@@ -1,4 +1,6 @@
 #include"camera.h"
+#include "../../include/Application/Application.h"
+#include "../../include/glframework/redrawTracker.h"
 
 Camera::Camera() {
 
@@ -24,6 +26,13 @@ glm::mat4 Camera::getProjectionMatrix() {
 	return glm::identity<glm::mat4>();
 }
 
+glm::mat4 Camera::applyJitter(const glm::mat4& projection) const {
+	if (mJitter.x == 0.0f && mJitter.y == 0.0f) {
+		return projection;
+	}
+	return glm::translate(glm::mat4(1.0f), glm::vec3(mJitter, 0.0f)) * projection;
+}
+
 void Camera::scale(float deltScale) {
 
  }
@@ -57,7 +66,7 @@ void Camera::rotateAroundAxis(
     glm::vec3 midPosScaled = glm::normalize(midInPlane) * radius; // ŵָ뾶
 
     // 3. תǶȣ[-halfAngle, +halfAngle]Χ
-    float time = SDL_GetTicks() * 0.001f;
+    float time = App->getTicks() * 0.001f;
     float cycle = 2.0f * glm::pi<float>(); // ڣ02Ϊһѭ
     float t = fmod(time * speed, cycle);   // ʱӳ䵽[0, 2)
 
@@ -78,4 +87,7 @@ void Camera::rotateAroundAxis(
     // 5. ǰָԭ㣩
     glm::vec3 forward = glm::normalize(glm::vec3(0.0f) - mPosition);
     mRight = glm::normalize(glm::cross(forward, mUp));
+
+    // 6. ÿ֡ڸıػģʽ±Ⱦ
+    RedrawTracker::markDirty();
 }
\ No newline at end of file
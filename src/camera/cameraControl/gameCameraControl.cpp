@@ -1,5 +1,6 @@
 #include "gameCameraControl.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include "../../../include/glframework/redrawTracker.h"
 
 GameCameraControl::GameCameraControl() 
     : mSensitivity(0.1f), mSpeed(0.05f), mPitch(0.0f) {}
@@ -13,6 +14,7 @@ void GameCameraControl::onCursor(float xpos, float ypos) {
     if (mRightMouseDown && mCamera) {
         pitch(deltaY);
         yaw(deltaX);
+        RedrawTracker::markDirty();     // 相机动了，按需重绘模式下需要画新的一帧
     }
     
     // 更新鼠标位置
@@ -48,6 +50,7 @@ void GameCameraControl::update() {
     if (glm::length(direction) > 0.0001f) {
         direction = glm::normalize(direction);
         mCamera->mPosition += direction * mSpeed;
+        RedrawTracker::markDirty();     // 按住按键期间每帧都会标记，松开后回到空闲
     }
 }
 
@@ -1,4 +1,5 @@
 #include"trackBallCameraControl.h"
+#include "../../../include/glframework/redrawTracker.h"
 
 TrackBallCameraControl::TrackBallCameraControl() {
 
@@ -16,6 +17,7 @@ void TrackBallCameraControl::onCursor(float xpos, float ypos) {
 		// 2 ֿpitch  yaw Լ
 		pitch(-deltaY);
 		yaw(-deltaX);
+		RedrawTracker::markDirty();		// ˣػģʽҪµһ֡
 	}
 	else if (mMiddleMouseDown) {
 		float deltaX = (xpos - mCurrentX) * mMoveSpeed;
@@ -23,6 +25,7 @@ void TrackBallCameraControl::onCursor(float xpos, float ypos) {
 
 		mCamera->mPosition -= mCamera->mRight * deltaX;
 		mCamera->mPosition += mCamera->mUp * deltaY;
+		RedrawTracker::markDirty();
 	}
 	//λ
 	mCurrentX = xpos;
@@ -53,4 +56,5 @@ void TrackBallCameraControl::setMoveSpeed(float speed) {
 
 void TrackBallCameraControl::onScroll(float offset) {
 	mCamera->scale(mScaleSpeed * offset);
+	RedrawTracker::markDirty();
 }
\ No newline at end of file
@@ -15,7 +15,7 @@ orthographicCamera::~orthographicCamera() {
 
 glm::mat4 orthographicCamera::getProjectionMatrix() {
     float scale = std::pow(2.0f, mScale);
-    return glm::ortho(mLeft * scale, mRight * scale, mTop * scale, mBottom * scale, mNear, mFar);   // Ҫ޸nearfar
+    return applyJitter(glm::ortho(mLeft * scale, mRight * scale, mTop * scale, mBottom * scale, mNear, mFar));   // Ҫ޸nearfar
 }
 
 void orthographicCamera::scale(float deltScale) {
@@ -15,7 +15,7 @@ perspectiveCamera::~perspectiveCamera() {
 }
 
 glm::mat4 perspectiveCamera::getProjectionMatrix() {
-    return glm::perspective(glm::radians(mFovy), mAspect, mNear, mFar);
+    return applyJitter(glm::perspective(glm::radians(mFovy), mAspect, mNear, mFar));
 }
 
 void perspectiveCamera::scale(float deltScale) {
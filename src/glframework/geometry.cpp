@@ -1,8 +1,15 @@
 #include "geometry.h"
+#include "renderStats.h"
+#include "tools/profiler.h"
+#include "glDebug.h"
+#include "tools/jobSystem.h"
 #include <fstream>
 #include <sstream>
 #include <stdexcept> // ׳ļȡ
 #include <cstring>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 
 // 캯ʼOpenGLΪ0
 Geometry::Geometry()
@@ -17,6 +24,7 @@ Geometry::Geometry(
 ) {
     // 1. ʼã
     mIndicesCount = static_cast<unsigned int>(indices.size());
+    computeBounds(positions.data(), positions.size() / 3);
 
     // 2. ġȴ VAO VBO/EBO ö VAO ¼
     glGenVertexArrays(1, &mVao);
@@ -90,6 +98,11 @@ Geometry::Geometry(
     // 8. Ĳ EBO 󶨣ѡƼӰ Buffer 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
+    updateMemoryStats();
+
+    // 9. ̨ BVHʰȡã
+    buildTriangleBVHAsync(positions, indices);
+
     /***********************************************************/
     /*          Buffer 
 	* VBO/EBO ̣CPU ڴ --> Դ棨GPU ڴ棩
@@ -115,12 +128,176 @@ Geometry::Geometry(
 
 // ͷOpenGLԴOpenGLЧʱã
 Geometry::~Geometry() {
+    RenderStats::addBufferMemory(-mBufferBytes);
     glDeleteBuffers(1, &mPosVbo);
     glDeleteBuffers(1, &mUvVbo);
     glDeleteBuffers(1, &mNormalVbo);
     glDeleteBuffers(1, &mTangentVbo);
     glDeleteBuffers(1, &mEbo);
+    if (mDepthVao != 0 && mDepthVao != mVao) {
+        glDeleteVertexArrays(1, &mDepthVao);
+    }
     glDeleteVertexArrays(1, &mVao);
+
+    TriangleBVH::release(mTriangleBVH);
+}
+
+void Geometry::buildTriangleBVHAsync(std::vector<float> positions, std::vector<unsigned int> indices) {
+    TriangleBVH::release(mTriangleBVH);
+    mTriangleBVH = new TriangleBVH(std::move(positions), std::move(indices));
+    TriangleBVH::buildAsync(mTriangleBVH);
+}
+
+bool Geometry::buildSortedIndexOrders(int directionCount) {
+    PROFILE_FUNCTION();
+    // λ BVH  CPU ݣֻ̨ڼҲԶȡ
+    if (mTriangleBVH == nullptr || mEbo == 0 || directionCount <= 0) {
+        std::cerr << "ERROR[Geometry]: û CPU ˵Ķݣ޷Ԥ" << std::endl;
+        return false;
+    }
+    const std::vector<glm::vec3>& positions = mTriangleBVH->getPositions();
+    const std::vector<unsigned int>& indices = mTriangleBVH->getIndices();
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || indices.size() != static_cast<size_t>(mIndicesCount)) {
+        std::cerr << "ERROR[Geometry]: CPU  EBO һ£޷Ԥ" << std::endl;
+        return false;
+    }
+
+    //1 ۲췽Fibonacci Ͼȷֲ directionCount 
+    mSortDirections.clear();
+    const float goldenAngle = glm::pi<float>() * (3.0f - std::sqrt(5.0f));
+    for (int k = 0; k < directionCount; k++) {
+        float y = 1.0f - 2.0f * (k + 0.5f) / static_cast<float>(directionCount);
+        float radius = std::sqrt(std::max(0.0f, 1.0f - y * y));
+        float theta = goldenAngle * k;
+        mSortDirections.push_back(glm::vec3(radius * std::cos(theta), y, radius * std::sin(theta)));
+    }
+
+    //2 ģֻڱȽϣʡȥ 3
+    std::vector<glm::vec3> centroids(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        centroids[t] = positions[indices[t * 3]] + positions[indices[t * 3 + 1]] + positions[indices[t * 3 + 2]];
+    }
+
+    //3 ÿڹ۲췽ϵͶӰɴСԶдԭʼ
+    std::vector<unsigned int> allIndices;
+    allIndices.reserve(indices.size() * (mSortDirections.size() + 1));
+    allIndices.insert(allIndices.end(), indices.begin(), indices.end());
+
+    std::vector<uint32_t> order(triangleCount);
+    std::vector<float> keys(triangleCount);
+    for (const auto& direction : mSortDirections) {
+        for (size_t t = 0; t < triangleCount; t++) {
+            order[t] = static_cast<uint32_t>(t);
+            keys[t] = glm::dot(centroids[t], direction);
+        }
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+        for (auto t : order) {
+            allIndices.push_back(indices[t * 3]);
+            allIndices.push_back(indices[t * 3 + 1]);
+            allIndices.push_back(indices[t * 3 + 2]);
+        }
+    }
+
+    //4 · EBOVAO ڼ VAO ¼ EBO 
+    glBindVertexArray(mVao);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, allIndices.size() * sizeof(unsigned int), allIndices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    updateMemoryStats();
+    return true;
+}
+
+void Geometry::updateMemoryStats() {
+    int64_t bytes = 0;
+    for (GLuint buffer : { mPosVbo, mUvVbo, mNormalVbo, mTangentVbo, mEbo }) {
+        if (buffer != 0 && glIsBuffer(buffer)) {
+            GLint64 size = 0;
+            glGetNamedBufferParameteri64v(buffer, GL_BUFFER_SIZE, &size);
+            bytes += size;
+        }
+    }
+    RenderStats::addBufferMemory(bytes - mBufferBytes);
+    mBufferBytes = bytes;
+}
+
+GLuint Geometry::getDepthVAO() {
+    if (mDepthVao != 0) {
+        return mDepthVao;
+    }
+
+    // Ķ㲼ֲͬ VBO 򽻴ţ VAO ȡ 0 λ
+    GLint enabled = 0;
+    GLint buffer = 0;
+    GLint size = 3;
+    GLint type = GL_FLOAT;
+    GLint normalized = GL_FALSE;
+    GLint stride = 0;
+    GLint elementBuffer = 0;
+    void* pointer = nullptr;
+    glBindVertexArray(mVao);
+    glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+    glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &buffer);
+    glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_SIZE, &size);
+    glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_TYPE, &type);
+    glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, &normalized);
+    glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_STRIDE, &stride);
+    glGetVertexAttribPointerv(0, GL_VERTEX_ATTRIB_ARRAY_POINTER, &pointer);
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &elementBuffer);
+    glBindVertexArray(0);
+
+    // ȡλʱ˻ VAO
+    if (!enabled || buffer == 0) {
+        mDepthVao = mVao;
+        return mDepthVao;
+    }
+
+    glGenVertexArrays(1, &mDepthVao);
+    glBindVertexArray(mDepthVao);
+    glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(buffer));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, size, static_cast<GLenum>(type), static_cast<GLboolean>(normalized), stride, pointer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLuint>(elementBuffer));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return mDepthVao;
+}
+
+size_t Geometry::pickSortedIndexOffset(const glm::vec3& localViewDirection) const {
+    if (mSortDirections.empty()) {
+        return 0;
+    }
+
+    // ķӽǰӽ
+    size_t best = 0;
+    float bestDot = -2.0f;
+    for (size_t k = 0; k < mSortDirections.size(); k++) {
+        float d = glm::dot(mSortDirections[k], localViewDirection);
+        if (d > bestDot) {
+            bestDot = d;
+            best = k;
+        }
+    }
+    return (best + 1) * static_cast<size_t>(mIndicesCount) * sizeof(unsigned int);
+}
+
+// ݶλüֲռΧ
+void Geometry::computeBounds(const float* positions, size_t vertexCount, size_t stride) {
+    if (positions == nullptr || vertexCount == 0) {
+        mHasBounds = false;
+        return;
+    }
+
+    mBoundsMin = glm::vec3(positions[0], positions[1], positions[2]);
+    mBoundsMax = mBoundsMin;
+    for (size_t i = 1; i < vertexCount; i++) {
+        const float* p = positions + i * stride;
+        glm::vec3 point(p[0], p[1], p[2]);
+        mBoundsMin = glm::min(mBoundsMin, point);
+        mBoundsMax = glm::max(mBoundsMax, point);
+    }
+    mHasBounds = true;
 }
 
 // 1. 
@@ -209,6 +386,7 @@ Geometry* Geometry::createBox(float size) {
     glGenBuffers(1, &posVbo);
     glBindBuffer(GL_ARRAY_BUFFER, posVbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(positions), positions, GL_STATIC_DRAW);
+    geometry->computeBounds(positions, sizeof(positions) / sizeof(float) / 3);
 
     GLuint& uvVbo = geometry->mUvVbo;
     glGenBuffers(1, &uvVbo);
@@ -252,6 +430,7 @@ Geometry* Geometry::createBox(float size) {
     // VAOȾ
     glBindVertexArray(0);
 
+    geometry->updateMemoryStats();
     return geometry;
 }
 
@@ -323,6 +502,7 @@ Geometry* Geometry::createSphere(float radius, int numLatLines, int numLongLines
         positions.data(),
         GL_STATIC_DRAW
     );
+    geometry->computeBounds(positions.data(), positions.size() / 3);
 
     GLuint& uvVbo = geometry->mUvVbo;
     glGenBuffers(1, &uvVbo);
@@ -381,6 +561,7 @@ Geometry* Geometry::createSphere(float radius, int numLatLines, int numLongLines
     // VAO
     glBindVertexArray(0);
 
+    geometry->updateMemoryStats();
     return geometry;
 }
 
@@ -403,6 +584,7 @@ Geometry* Geometry::createTriangle() {
     glGenBuffers(1, &posUvVbo);
     glBindBuffer(GL_ARRAY_BUFFER, posUvVbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    geometry->computeBounds(vertices, sizeof(vertices) / sizeof(float) / 5, 5);
 
     // 2. VAOԣ
     GLuint& vao = geometry->mVao;
@@ -435,6 +617,7 @@ Geometry* Geometry::createTriangle() {
     // 5. VAOȾ
     glBindVertexArray(0);
 
+    geometry->updateMemoryStats();
     return geometry;
 }
 
@@ -483,6 +666,7 @@ Geometry* Geometry::createPlane(float width, float height)
     glGenBuffers(1, &posVbo);
     glBindBuffer(GL_ARRAY_BUFFER, posVbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(positions), positions, GL_STATIC_DRAW);
+    geometry->computeBounds(positions, sizeof(positions) / sizeof(float) / 3);
 
     // UV VBO
     GLuint& uvVbo = geometry->mUvVbo;
@@ -532,6 +716,7 @@ Geometry* Geometry::createPlane(float width, float height)
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
+    geometry->updateMemoryStats();
     return geometry;
 }
 
@@ -594,6 +779,7 @@ Geometry* Geometry::createScreenPlane() {
 	// VAO
 	glBindVertexArray(0);       // VAOȾ
 
+	geometry->updateMemoryStats();
 	return geometry;
 }
 
@@ -629,6 +815,7 @@ Geometry* Geometry::createCanvas(float width, float height) {
     GL_CALL(glGenBuffers(1, &geometry->mPosVbo));
     GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, geometry->mPosVbo));
     GL_CALL(glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW));
+    geometry->computeBounds(vertices.data(), vertices.size() / 5, 5);
 
     // EBO
     GL_CALL(glGenBuffers(1, &geometry->mEbo));
@@ -646,6 +833,7 @@ Geometry* Geometry::createCanvas(float width, float height) {
     // VAO
     GL_CALL(glBindVertexArray(0));
 
+    geometry->updateMemoryStats();
     return geometry;
 }
 
@@ -657,17 +845,19 @@ struct OBJFaceIndex {
     unsigned int vn; // Ӧobj"vn"1-based
 };
 
-// OBJļ·Geometry
-Geometry* Geometry::createFromOBJ(const std::string& objFilePath) {
+// OBJļֻCPU˽ȥأҪOpenGLģ
+GeometryData Geometry::parseOBJ(const std::string& objFilePath) {
+    PROFILE_SCOPE_DETAIL("Geometry::parseOBJ", objFilePath);
     // 1. ʼ
     std::vector<glm::vec3> objVertices;    // 洢OBJе"v"
     std::vector<glm::vec2> objUVs;         // 洢OBJе"vt"
     std::vector<glm::vec3> objNormals;     // 洢OBJе"vn"ߣ
     std::vector<OBJFaceIndex> faceIndices; // 洢Ķϣv/vt/vn
-    std::vector<GLfloat> outVertices;      // մVBOĶ
-    std::vector<GLfloat> outUVs;           // մVBOUV
-    std::vector<GLfloat> outNormals;       // մVBOķߣ
-    std::vector<GLuint> outIndices;        // մEBO
+    GeometryData data;
+    std::vector<GLfloat>& outVertices = data.positions;    // մVBOĶ
+    std::vector<GLfloat>& outUVs = data.uvs;               // մVBOUV
+    std::vector<GLfloat>& outNormals = data.normals;       // մVBOķߣ
+    std::vector<GLuint>& outIndices = data.indices;        // մEBO
 
     // 2. 򿪲ȡOBJļ
     std::ifstream objFile(objFilePath);
@@ -788,12 +978,27 @@ Geometry* Geometry::createFromOBJ(const std::string& objFilePath) {
         // ¼ǰ
         outIndices.push_back(vertexUVNormalMap[key]);
     }
+    return data;
+}
 
-    // 4. Geometry󲢳ʼ
+// OBJļ·Geometry
+Geometry* Geometry::createFromOBJ(const std::string& objFilePath) {
+    PROFILE_SCOPE_DETAIL("Geometry::createFromOBJ", objFilePath);
+    return createFromData(parseOBJ(objFilePath), objFilePath);
+}
+
+Geometry* Geometry::createFromData(GeometryData data, const std::string& label) {
+    PROFILE_SCOPE_DETAIL("Geometry::createFromData", label);
+    std::vector<GLfloat>& outVertices = data.positions;
+    std::vector<GLfloat>& outUVs = data.uvs;
+    std::vector<GLfloat>& outNormals = data.normals;
+    std::vector<GLuint>& outIndices = data.indices;
+
+    // 1. Geometry󲢳ʼ
     Geometry* geometry = new Geometry();
     geometry->mIndicesCount = static_cast<GLsizei>(outIndices.size());
 
-    // 4.1 VBO
+    // 1.1 VBO
     glGenBuffers(1, &geometry->mPosVbo);
     glBindBuffer(GL_ARRAY_BUFFER, geometry->mPosVbo);
     glBufferData(
@@ -802,19 +1007,22 @@ Geometry* Geometry::createFromOBJ(const std::string& objFilePath) {
         outVertices.data(),
         GL_STATIC_DRAW
     );
+    geometry->computeBounds(outVertices.data(), outVertices.size() / 3);
+
+    // 1.2 UV VBOSTL û꣬
+    if (!outUVs.empty()) {
+        glGenBuffers(1, &geometry->mUvVbo);
+        glBindBuffer(GL_ARRAY_BUFFER, geometry->mUvVbo);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            outUVs.size() * sizeof(GLfloat),
+            outUVs.data(),
+            GL_STATIC_DRAW
+        );
+    }
 
-    // 4.2 UV VBO
-    glGenBuffers(1, &geometry->mUvVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, geometry->mUvVbo);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        outUVs.size() * sizeof(GLfloat),
-        outUVs.data(),
-        GL_STATIC_DRAW
-    );
-
-    // 4.3 VBO
-    glGenBuffers(1, &geometry->mNormalVbo);  // GeometrymNormalVboԱ
+    // 1.3 VBO
+    glGenBuffers(1, &geometry->mNormalVbo);
     glBindBuffer(GL_ARRAY_BUFFER, geometry->mNormalVbo);
     glBufferData(
         GL_ARRAY_BUFFER,
@@ -823,7 +1031,7 @@ Geometry* Geometry::createFromOBJ(const std::string& objFilePath) {
         GL_STATIC_DRAW
     );
 
-    // 4.4 EBO
+    // 1.4 EBO
     glGenBuffers(1, &geometry->mEbo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry->mEbo);
     glBufferData(
@@ -833,7 +1041,7 @@ Geometry* Geometry::createFromOBJ(const std::string& objFilePath) {
         GL_STATIC_DRAW
     );
 
-    // 4.5 VAO
+    // 1.5 VAO
     glGenVertexArrays(1, &geometry->mVao);
     glBindVertexArray(geometry->mVao);
 
@@ -843,11 +1051,13 @@ Geometry* Geometry::createFromOBJ(const std::string& objFilePath) {
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (void*)0);
 
     // UVԣlocation=1
-    glBindBuffer(GL_ARRAY_BUFFER, geometry->mUvVbo);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (void*)0);
+    if (geometry->mUvVbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, geometry->mUvVbo);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (void*)0);
+    }
 
-    // ÷ԣlocation=2
+    // ÷ԣlocation=2
     glBindBuffer(GL_ARRAY_BUFFER, geometry->mNormalVbo);
     glEnableVertexAttribArray(2);
     glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (void*)0);
@@ -858,11 +1068,49 @@ Geometry* Geometry::createFromOBJ(const std::string& objFilePath) {
     // VAO
     glBindVertexArray(0);
 
+    // ̨ BVHʰȡãCPU ݲҪֱƽ
+    geometry->buildTriangleBVHAsync(std::move(outVertices), std::move(outIndices));
+
+    geometry->updateMemoryStats();
+    GLDebug::setLabel(GL_VERTEX_ARRAY, geometry->mVao, label);
     return geometry;
 }
 
+// 첽أΪ̨ڹִ߳Уɺ GL ̴߳ٻصģ̻߳ص
+static JobTask loadGeometryAsync(std::function<GeometryData()> parse, std::string label, std::function<void(Geometry*)> onLoaded) {
+    co_await JobSystem::background();
+    GeometryData data;
+    bool parsed = false;
+    try {
+        data = parse();
+        parsed = true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "ERROR[Geometry]: 첽ʧܣ" << e.what() << std::endl;
+    }
+
+    co_await JobSystem::mainThread();
+    Geometry* geometry = parsed ? Geometry::createFromData(std::move(data), label) : nullptr;
+
+    // صͨѼ볡ֻģ߳޸
+    co_await JobSystem::simulationThread();
+    if (onLoaded) {
+        onLoaded(geometry);
+    }
+}
+
+void Geometry::createFromOBJAsync(const std::string& objFilePath, std::function<void(Geometry*)> onLoaded) {
+    loadGeometryAsync([objFilePath] { return parseOBJ(objFilePath); }, objFilePath, std::move(onLoaded));
+}
+
+void Geometry::createFromSTLAsync(const std::string& stlFilePath, bool useSmoothNormals, std::function<void(Geometry*)> onLoaded) {
+    loadGeometryAsync([stlFilePath, useSmoothNormals] { return parseSTL(stlFilePath, useSmoothNormals); }, stlFilePath, std::move(onLoaded));
+}
+
+
 
 Geometry* Geometry::createFromOBJ_nvn(const std::string& objFilePath) {
+    PROFILE_SCOPE_DETAIL("Geometry::createFromOBJ_nvn", objFilePath);
     // 1. ʼ
     std::vector<glm::vec3> objVertices;    // 洢OBJе"v"㣨ԭʼݣ
     std::vector<glm::vec2> objUVs;         // 洢OBJе"vt"꣨ԭʼݣ
@@ -977,6 +1225,7 @@ Geometry* Geometry::createFromOBJ_nvn(const std::string& objFilePath) {
         outVertices.data(),
         GL_STATIC_DRAW
     );
+    geometry->computeBounds(outVertices.data(), outVertices.size() / 3);
 
     // 4.2 UV VBOݣ
     glGenBuffers(1, &geometry->mUvVbo);
@@ -1032,11 +1281,17 @@ Geometry* Geometry::createFromOBJ_nvn(const std::string& objFilePath) {
     // VAOȾ
     glBindVertexArray(0);
 
+    // ̨ BVHʰȡãCPU ݲҪֱƽ
+    geometry->buildTriangleBVHAsync(std::move(outVertices), std::move(outIndices));
+
+    geometry->updateMemoryStats();
+    GLDebug::setLabel(GL_VERTEX_ARRAY, geometry->mVao, objFilePath);
     return geometry;
 }
 
 
 Geometry* Geometry::createFromOBJwithTangent(const std::string& objFilePath) {
+    PROFILE_SCOPE_DETAIL("Geometry::createFromOBJwithTangent", objFilePath);
     // 1. ʼ
     std::vector<glm::vec3> objVertices;
     std::vector<glm::vec2> objUVs;
@@ -1197,6 +1452,7 @@ Geometry* Geometry::createFromOBJwithTangent(const std::string& objFilePath) {
     glGenBuffers(1, &geometry->mPosVbo);
     glBindBuffer(GL_ARRAY_BUFFER, geometry->mPosVbo);
     glBufferData(GL_ARRAY_BUFFER, outVertices.size() * sizeof(GLfloat), outVertices.data(), GL_STATIC_DRAW);
+    geometry->computeBounds(outVertices.data(), outVertices.size() / 3);
 
     glGenBuffers(1, &geometry->mUvVbo);
     glBindBuffer(GL_ARRAY_BUFFER, geometry->mUvVbo);
@@ -1241,6 +1497,11 @@ Geometry* Geometry::createFromOBJwithTangent(const std::string& objFilePath) {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
+    // ̨ BVHʰȡãCPU ݲҪֱƽ
+    geometry->buildTriangleBVHAsync(std::move(outVertices), std::move(outIndices));
+
+    geometry->updateMemoryStats();
+    GLDebug::setLabel(GL_VERTEX_ARRAY, geometry->mVao, objFilePath);
     return geometry;
 }
 
@@ -1277,13 +1538,16 @@ struct Vec3Compare {
 };
 
 
-Geometry* Geometry::createFromSTL(const std::string& stlFilePath, bool useSmoothNormals) {
+// STLļֻCPU˽ƽȥأҪOpenGLģ
+GeometryData Geometry::parseSTL(const std::string& stlFilePath, bool useSmoothNormals) {
+    PROFILE_SCOPE_DETAIL("Geometry::parseSTL", stlFilePath);
     // 1. ʼ
     std::vector<glm::vec3> stlNormals;       // 洢Ƭķ
     std::vector<STLFaceVertex> faceVertices; // 洢ж㣨ԭʼ
-    std::vector<GLfloat> outVertices;        // VBO
-    std::vector<GLfloat> outNormals;         // VBO
-    std::vector<GLuint> outIndices;          // EBO
+    GeometryData data;
+    std::vector<GLfloat>& outVertices = data.positions;    // VBO
+    std::vector<GLfloat>& outNormals = data.normals;       // VBO
+    std::vector<GLuint>& outIndices = data.indices;        // EBO
 
     // 2. Զģʽļ
     std::ifstream stlFile(stlFilePath, std::ios::in | std::ios::binary);
@@ -1427,59 +1691,10 @@ Geometry* Geometry::createFromSTL(const std::string& stlFilePath, bool useSmooth
 
         outIndices.push_back(vertexNormalMap[key]);
     }
+    return data;
+}
 
-    // 8. ʼGPU
-    Geometry* geometry = new Geometry();
-    geometry->mIndicesCount = static_cast<GLsizei>(outIndices.size());
-
-    // 8.1 VBO
-    glGenBuffers(1, &geometry->mPosVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, geometry->mPosVbo);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        outVertices.size() * sizeof(GLfloat),
-        outVertices.data(),
-        GL_STATIC_DRAW
-    );
-
-    // 8.2 VBO
-    glGenBuffers(1, &geometry->mNormalVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, geometry->mNormalVbo);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        outNormals.size() * sizeof(GLfloat),
-        outNormals.data(),
-        GL_STATIC_DRAW
-    );
-
-    // 8.3 EBO
-    glGenBuffers(1, &geometry->mEbo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry->mEbo);
-    glBufferData(
-        GL_ELEMENT_ARRAY_BUFFER,
-        outIndices.size() * sizeof(GLuint),
-        outIndices.data(),
-        GL_STATIC_DRAW
-    );
-
-    // 8.4 VAO
-    glGenVertexArrays(1, &geometry->mVao);
-    glBindVertexArray(geometry->mVao);
-
-    // ԣlocation=0
-    glBindBuffer(GL_ARRAY_BUFFER, geometry->mPosVbo);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (void*)0);
-
-    // ԣlocation=2
-    glBindBuffer(GL_ARRAY_BUFFER, geometry->mNormalVbo);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (void*)0);
-
-    // EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry->mEbo);
-
-    glBindVertexArray(0);
-
-    return geometry;
+Geometry* Geometry::createFromSTL(const std::string& stlFilePath, bool useSmoothNormals) {
+    PROFILE_SCOPE_DETAIL("Geometry::createFromSTL", stlFilePath);
+    return createFromData(parseSTL(stlFilePath, useSmoothNormals), stlFilePath);
 }
\ No newline at end of file
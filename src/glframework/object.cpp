@@ -1,66 +1,71 @@
 #include "object.h"
+#include <algorithm>
 
 Object::Object() {
 	mType = ObjectType::Object;
+	mTransform = TransformStorage::create();
 }
 Object::~Object() {
-
+	// ӱΪڵ㣬յĸָ
+	for (auto child : mChildren) {
+		child->mParent = nullptr;
+	}
+	if (mParent != nullptr) {
+		auto& siblings = mParent->mChildren;
+		siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+	}
+	TransformStorage::destroy(mTransform);
 }
 
 void Object::setPosition(glm::vec3 pos) {
-	mPosition = pos;
+	TransformStorage::setPosition(mTransform, pos);
 }
 
 // ת
 void Object::rotateX(float angle) {
-	mAngleX += angle;
+	glm::vec3 angles = TransformStorage::getAngles(mTransform);
+	angles.x += angle;
+	TransformStorage::setAngles(mTransform, angles);
 }
 void Object::rotateY(float angle) {
-	mAngleY += angle;
+	glm::vec3 angles = TransformStorage::getAngles(mTransform);
+	angles.y += angle;
+	TransformStorage::setAngles(mTransform, angles);
 }
 void Object::rotateZ(float angle) {
-	mAngleZ += angle;
+	glm::vec3 angles = TransformStorage::getAngles(mTransform);
+	angles.z += angle;
+	TransformStorage::setAngles(mTransform, angles);
 }
 
 
 // תǶ
 void Object::setAngleX(float angle) {
-	mAngleX = angle;
+	glm::vec3 angles = TransformStorage::getAngles(mTransform);
+	angles.x = angle;
+	TransformStorage::setAngles(mTransform, angles);
 }
 void Object::setAngleY(float angle) {
-	mAngleY = angle;
+	glm::vec3 angles = TransformStorage::getAngles(mTransform);
+	angles.y = angle;
+	TransformStorage::setAngles(mTransform, angles);
 }
 void Object::setAngleZ(float angle) {
-	mAngleZ = angle;
+	glm::vec3 angles = TransformStorage::getAngles(mTransform);
+	angles.z = angle;
+	TransformStorage::setAngles(mTransform, angles);
 }
 
 
 void Object::setScale(glm::vec3 scale) {
-	mScale = scale;
+	TransformStorage::setScale(mTransform, scale);
 }
 
 
 glm::mat4 Object::getModelMatrx() {
-	//Ȼȡ׵ı任
-	glm::mat4 parentMatrix{ 1.0f };
-	if (mParent != nullptr) {
-		parentMatrix = mParent->getModelMatrx();
-	}
-
-	// unity˳  ת ƽ
-	glm::mat4 transform{ 1.0f };
-
-	transform = glm::scale(transform, mScale);
-
-	// unity ת׼
-	transform = glm::rotate(transform, glm::radians(mAngleX), glm::vec3(1.0f, 0.0f, 0.0f));
-	transform = glm::rotate(transform, glm::radians(mAngleY), glm::vec3(0.0f, 1.0f, 0.0f));
-	transform = glm::rotate(transform, glm::radians(mAngleZ), glm::vec3(0.0f, 0.0f, 1.0f));
-
-	// ϵ², ǰı/ֲϵ
-	transform = parentMatrix * glm::translate(glm::mat4(1.0f), mPosition) * transform;	// źת֮ƽƵϵµmPosition
-	// ǰ parentMatrix ӱر任ת任
-	return transform;
+	// unity˳  ת ƽƣٳϸ׵
+	//  TransformStorage а㼶ɣֻȡ
+	return TransformStorage::getWorldMatrix(mTransform);
 }
 
 void Object::addChild(Object* obj) {
@@ -76,11 +81,12 @@ void Object::addChild(Object* obj) {
 
 	//3 ¼ĺİְ˭
 	obj->mParent = this;
+	TransformStorage::setParent(obj->mTransform, mTransform);
 }
 
-std::vector<Object*> Object::getChildren() {
+const std::vector<Object*>& Object::getChildren() const {
 	return mChildren;
 }
-Object* Object::getParent() {
+Object* Object::getParent() const {
 	return mParent;
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "picker.h"
+#include <cfloat>
+#include <algorithm>
+
+Picker::Picker(Scene* scene) : mScene(scene) {}
+
+Picker::~Picker() {}
+
+void Picker::setViewport(int width, int height) {
+    mWidth = std::max(width, 1);
+    mHeight = std::max(height, 1);
+}
+
+void Picker::update() {
+    mSceneBVH.update(mScene);
+}
+
+void Picker::screenToRay(Camera* camera, float mouseX, float mouseY, glm::vec3& origin, glm::vec3& direction) const {
+    // 窗口坐标 -> NDC（y 轴向上）
+    float x = 2.0f * mouseX / static_cast<float>(mWidth) - 1.0f;
+    float y = 1.0f - 2.0f * mouseY / static_cast<float>(mHeight);
+
+    // 近平面与远平面上的点反投影到世界空间（透视与正交相机通用）
+    glm::mat4 inverseViewProjection = glm::inverse(camera->getProjectionMatrix() * camera->getViewMatrix());
+    glm::vec4 nearPoint = inverseViewProjection * glm::vec4(x, y, -1.0f, 1.0f);
+    glm::vec4 farPoint = inverseViewProjection * glm::vec4(x, y, 1.0f, 1.0f);
+    nearPoint /= nearPoint.w;
+    farPoint /= farPoint.w;
+
+    origin = glm::vec3(nearPoint);
+    direction = glm::normalize(glm::vec3(farPoint) - glm::vec3(nearPoint));
+}
+
+bool Picker::pick(Camera* camera, float mouseX, float mouseY, PickResult& result) {
+    glm::vec3 origin, direction;
+    screenToRay(camera, mouseX, mouseY, origin, direction);
+    update();
+    return pickRay(origin, direction, FLT_MAX, result);
+}
+
+bool Picker::pickRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, PickResult& result) {
+    float length = glm::length(direction);
+    if (length <= 0.0f) {
+        return false;
+    }
+    glm::vec3 unitDirection = direction / length;
+
+    // 1 包围盒与射线相交的 Mesh，由近到远
+    mCandidates.clear();
+    mSceneBVH.queryRay(origin, unitDirection, maxDistance, mCandidates);
+
+    float closest = maxDistance;
+    bool found = false;
+    for (const auto& candidate : mCandidates) {
+        // 2 已经找到的交点比这个包围盒更近，后面的都不用测了
+        if (candidate.t > closest) {
+            break;
+        }
+
+        const TriangleBVH* bvh = candidate.mesh->mGeometry->getTriangleBVH();
+        if (bvh == nullptr) {
+            continue;
+        }
+
+        // 3 射线变换到局部空间：方向不归一化，局部空间的 t 与世界空间的距离一致
+        glm::mat4 modelMatrix = TransformStorage::getWorldMatrix(candidate.mesh->getTransformHandle());
+        glm::mat4 inverseModel = glm::inverse(modelMatrix);
+        glm::vec3 localOrigin = glm::vec3(inverseModel * glm::vec4(origin, 1.0f));
+        glm::vec3 localDirection = glm::vec3(inverseModel * glm::vec4(unitDirection, 0.0f));
+
+        TriangleBVH::Hit hit;
+        if (!bvh->intersect(localOrigin, localDirection, closest, hit)) {
+            continue;
+        }
+
+        closest = hit.t;
+        found = true;
+        result.mesh = candidate.mesh;
+        result.triangle = hit.triangle;
+        result.barycentric = glm::vec3(1.0f - hit.u - hit.v, hit.u, hit.v);
+        result.distance = hit.t;
+        result.worldPosition = origin + unitDirection * hit.t;
+    }
+
+    return found;
+}
@@ -0,0 +1,37 @@
+#include "redrawTracker.h"
+#include <SDL2/SDL.h>
+
+// 必须在cpp中初始化静态成员
+std::atomic<uint64_t> RedrawTracker::sGeneration{ 0 };
+std::atomic<int> RedrawTracker::sPendingFrames{ 1 };     // 第一帧总是要画
+std::atomic<bool> RedrawTracker::sWaiting{ false };
+
+void RedrawTracker::markDirty(int frames) {
+    sGeneration.fetch_add(1, std::memory_order_acq_rel);
+    raisePending(frames);
+}
+
+void RedrawTracker::requestFrame(int frames) {
+    raisePending(frames);
+}
+
+void RedrawTracker::raisePending(int frames) {
+    // 取较大值：连续多次标记不会叠加出多余的帧
+    int pending = sPendingFrames.load(std::memory_order_relaxed);
+    while (pending < frames && !sPendingFrames.compare_exchange_weak(pending, frames)) {
+    }
+
+    // 主线程正阻塞在 SDL_WaitEvent：推送一个空事件唤醒（SDL_PushEvent 线程安全）
+    // 与 Application 中"先 setWaiting 再检查 needsFrame"配对，都用顺序一致的原子操作，唤醒不会丢失
+    if (sWaiting.exchange(false)) {
+        SDL_Event event{};
+        event.type = SDL_USEREVENT;
+        SDL_PushEvent(&event);
+    }
+}
+
+void RedrawTracker::beginFrame() {
+    int pending = sPendingFrames.load(std::memory_order_relaxed);
+    while (pending > 0 && !sPendingFrames.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel)) {
+    }
+}
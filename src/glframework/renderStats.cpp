@@ -0,0 +1,270 @@
+#include "renderStats.h"
+#include "../../include/imgui/imgui.h"
+#include <iostream>
+
+thread_local RenderStats::ThreadCounters* RenderStats::sLocal = nullptr;
+std::mutex RenderStats::sThreadMutex;
+std::vector<std::unique_ptr<RenderStats::ThreadCounters>> RenderStats::sThreads;
+
+std::atomic<int64_t> RenderStats::sBufferBytes{ 0 };
+std::atomic<int64_t> RenderStats::sTextureBytes{ 0 };
+
+RenderCounterValues RenderStats::sLastTotal{};
+RenderCounterValues RenderStats::sFrame{};
+std::deque<RenderCounterValues> RenderStats::sHistory;
+std::deque<double> RenderStats::sHistoryMs;
+size_t RenderStats::sWindowSize = 120;
+double RenderStats::sFrameMs = 0.0;
+uint64_t RenderStats::sFrameIndex = 0;
+std::chrono::high_resolution_clock::time_point RenderStats::sFrameStart{};
+
+std::vector<RenderPassStats> RenderStats::sPasses;
+std::vector<RenderPassStats> RenderStats::sFramePasses;
+std::vector<RenderStats::ActivePass> RenderStats::sPassStack;
+
+std::ofstream RenderStats::sJsonFile;
+
+RenderStats::ThreadCounters* RenderStats::registerThread() {
+    std::lock_guard<std::mutex> lock(sThreadMutex);
+    sThreads.push_back(std::make_unique<ThreadCounters>());
+    return sThreads.back().get();
+}
+
+RenderCounterValues RenderStats::snapshot(const ThreadCounters& counters) {
+    RenderCounterValues result;
+    for (int i = 0; i < RENDER_COUNTER_COUNT; i++) {
+        result.values[i] = counters.values[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void RenderStats::beginPass(const char* name) {
+    size_t index = 0;
+    while (index < sPasses.size() && sPasses[index].name != name) {
+        index++;
+    }
+    if (index == sPasses.size()) {
+        sPasses.emplace_back();
+        sPasses.back().name = name;
+    }
+
+    ActivePass pass;
+    pass.index = index;
+    pass.start = snapshot(local());
+    pass.startTime = std::chrono::high_resolution_clock::now();
+    sPassStack.push_back(pass);
+}
+
+void RenderStats::endPass() {
+    if (sPassStack.empty()) {
+        return;
+    }
+    ActivePass pass = sPassStack.back();
+    sPassStack.pop_back();
+
+    RenderCounterValues end = snapshot(local());
+    RenderPassStats& stats = sPasses[pass.index];
+    for (int i = 0; i < RENDER_COUNTER_COUNT; i++) {
+        stats.counters.values[i] += end.values[i] - pass.start.values[i];
+    }
+    stats.cpuMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - pass.startTime).count();
+    stats.calls++;
+}
+
+void RenderStats::endFrame() {
+    //1 汇总所有线程，与上一帧的总数相减
+    RenderCounterValues total;
+    {
+        std::lock_guard<std::mutex> lock(sThreadMutex);
+        for (const auto& counters : sThreads) {
+            RenderCounterValues values = snapshot(*counters);
+            for (int i = 0; i < RENDER_COUNTER_COUNT; i++) {
+                total.values[i] += values.values[i];
+            }
+        }
+    }
+    for (int i = 0; i < RENDER_COUNTER_COUNT; i++) {
+        sFrame.values[i] = total.values[i] - sLastTotal.values[i];
+    }
+    sLastTotal = total;
+
+    auto now = std::chrono::high_resolution_clock::now();
+    sFrameMs = sFrameStart == std::chrono::high_resolution_clock::time_point{} ? 0.0 :
+        std::chrono::duration<double, std::milli>(now - sFrameStart).count();
+    sFrameStart = now;
+
+    //2 滚动窗口
+    sHistory.push_back(sFrame);
+    sHistoryMs.push_back(sFrameMs);
+    while (sHistory.size() > sWindowSize) {
+        sHistory.pop_front();
+        sHistoryMs.pop_front();
+    }
+
+    //3 pass 结果：只保留本帧出现过的，条目清零后下一帧复用
+    sFramePasses.clear();
+    for (auto& pass : sPasses) {
+        if (pass.calls > 0) {
+            sFramePasses.push_back(pass);
+        }
+        pass.counters = RenderCounterValues{};
+        pass.cpuMs = 0.0;
+        pass.calls = 0;
+    }
+
+    if (sJsonFile.is_open()) {
+        writeJson(sJsonFile);
+        sJsonFile << '\n';
+    }
+    sFrameIndex++;
+}
+
+RenderCounterValues RenderStats::getAverage() {
+    RenderCounterValues result;
+    if (sHistory.empty()) {
+        return result;
+    }
+    for (const auto& frame : sHistory) {
+        for (int i = 0; i < RENDER_COUNTER_COUNT; i++) {
+            result.values[i] += frame.values[i];
+        }
+    }
+    for (int i = 0; i < RENDER_COUNTER_COUNT; i++) {
+        result.values[i] /= sHistory.size();
+    }
+    return result;
+}
+
+double RenderStats::getAverageFrameMs() {
+    if (sHistoryMs.empty()) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (double ms : sHistoryMs) {
+        sum += ms;
+    }
+    return sum / sHistoryMs.size();
+}
+
+bool RenderStats::setJsonOutput(const std::string& path) {
+    if (sJsonFile.is_open()) {
+        sJsonFile.close();
+    }
+    if (path.empty()) {
+        return true;
+    }
+
+    sJsonFile.open(path, std::ios::out | std::ios::app);
+    if (!sJsonFile.is_open()) {
+        std::cerr << "ERROR[RenderStats]: 无法写入 " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+const char* RenderStats::getCounterName(RenderCounter counter) {
+    switch (counter) {
+    case RenderCounter::DrawCalls:
+        return "drawCalls";
+    case RenderCounter::Triangles:
+        return "triangles";
+    case RenderCounter::ShaderBinds:
+        return "shaderBinds";
+    case RenderCounter::TextureBinds:
+        return "textureBinds";
+    case RenderCounter::UniformUploads:
+        return "uniformUploads";
+    case RenderCounter::StateChanges:
+        return "stateChanges";
+    default:
+        return "unknown";
+    }
+}
+
+void RenderStats::writeJson(std::ostream& out) {
+    auto writeCounters = [&out](const RenderCounterValues& values) {
+        for (int i = 0; i < RENDER_COUNTER_COUNT; i++) {
+            out << (i > 0 ? "," : "") << '"' << getCounterName(static_cast<RenderCounter>(i)) << "\":" << values.values[i];
+        }
+    };
+    // pass 名称由代码给出，只需转义引号与反斜杠
+    auto writeString = [&out](const std::string& text) {
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << '"';
+    };
+
+    out << "{\"frame\":" << sFrameIndex << ",\"frameMs\":" << sFrameMs << ",\"counters\":{";
+    writeCounters(sFrame);
+    out << "},\"average\":{\"frameMs\":" << getAverageFrameMs() << ',';
+    writeCounters(getAverage());
+    out << "},\"passes\":[";
+    for (size_t i = 0; i < sFramePasses.size(); i++) {
+        const RenderPassStats& pass = sFramePasses[i];
+        out << (i > 0 ? "," : "") << "{\"name\":";
+        writeString(pass.name);
+        out << ",\"calls\":" << pass.calls << ",\"cpuMs\":" << pass.cpuMs << ',';
+        writeCounters(pass.counters);
+        out << '}';
+    }
+    out << "],\"memory\":{\"bufferBytes\":" << getBufferMemory() << ",\"textureBytes\":" << getTextureMemory() << "}}";
+}
+
+void RenderStats::drawImGui(const char* title) {
+    ImGui::Begin(title);
+    ImGui::Text("Frame %llu  CPU: %.3f ms  (avg %.3f ms)", (unsigned long long)sFrameIndex, sFrameMs, getAverageFrameMs());
+    ImGui::Text("Buffers: %.2f MB  Textures: %.2f MB", getBufferMemory() / (1024.0 * 1024.0), getTextureMemory() / (1024.0 * 1024.0));
+    bool recording = sJsonFile.is_open();
+    if (ImGui::Checkbox("Record render_stats.jsonl", &recording)) {
+        setJsonOutput(recording ? "render_stats.jsonl" : "");
+    }
+
+    // 1 本帧与滚动平均
+    RenderCounterValues average = getAverage();
+    if (ImGui::BeginTable("RenderStatsCounters", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Counter");
+        ImGui::TableSetupColumn("Frame");
+        ImGui::TableSetupColumn("Average");
+        ImGui::TableHeadersRow();
+        for (int i = 0; i < RENDER_COUNTER_COUNT; i++) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(getCounterName(static_cast<RenderCounter>(i)));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)sFrame.values[i]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)average.values[i]);
+        }
+        ImGui::EndTable();
+    }
+
+    // 2 pass 细分
+    if (!sFramePasses.empty() && ImGui::BeginTable("RenderStatsPasses", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("CPU ms");
+        ImGui::TableSetupColumn("Draws");
+        ImGui::TableSetupColumn("Triangles");
+        ImGui::TableSetupColumn("State");
+        ImGui::TableHeadersRow();
+        for (const auto& pass : sFramePasses) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(pass.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", pass.cpuMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)pass.counters[RenderCounter::DrawCalls]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)pass.counters[RenderCounter::Triangles]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)pass.counters[RenderCounter::StateChanges]);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
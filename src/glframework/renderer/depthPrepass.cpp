@@ -0,0 +1,163 @@
+#include "depthPrepass.h"
+#include <string>
+
+DepthPrepass::DepthPrepass(int queryCount) {
+    std::string vertexPath = std::string(SHADER_DIR) + "/depthPrepass/depthOnly.vert";
+    std::string fragmentPath = std::string(SHADER_DIR) + "/depthPrepass/depthOnly.frag";
+    mShader = new Shader(vertexPath.c_str(), fragmentPath.c_str());
+
+    int count = queryCount > 0 ? queryCount : 1;
+    mSlots.resize(count);
+    for (auto& slot : mSlots) {
+        glGenQueries(1, &slot.prepassQuery);
+        glGenQueries(1, &slot.opaqueQuery);
+    }
+}
+
+DepthPrepass::~DepthPrepass() {
+    for (auto& slot : mSlots) {
+        glDeleteQueries(1, &slot.prepassQuery);
+        glDeleteQueries(1, &slot.opaqueQuery);
+    }
+    delete mShader;
+}
+
+void DepthPrepass::setThresholds(float enableOverdraw, float disableOverdraw) {
+    mEnableOverdraw = enableOverdraw;
+    mDisableOverdraw = disableOverdraw < enableOverdraw ? disableOverdraw : enableOverdraw;
+}
+
+bool DepthPrepass::isEligible(const Material* material, Shader* shader) {
+    if (material == nullptr || shader == nullptr || !shader->hasPerDrawBlock()) {
+        return false;
+    }
+    if (material->mType == MaterialType::SreenMaterial) {
+        return false;
+    }
+    return !material->mBlend && material->mDepthTest && material->mDepthWrite &&
+        (material->mDepthFunc == GL_LESS || material->mDepthFunc == GL_LEQUAL);
+}
+
+bool DepthPrepass::beginFrame() {
+    // 读取已经完成的查询，更新过度绘制与 Auto 的决定
+    collect();
+
+    switch (mMode) {
+    case DepthPrepassMode::Off:
+        mActive = false;
+        break;
+    case DepthPrepassMode::On:
+        mActive = true;
+        break;
+    default:
+        mActive = mAutoEnabled;
+        // 关闭时覆盖像素数测不到，定期开启一帧重新测量
+        if (!mActive && ++mFramesSinceProbe >= mProbeInterval) {
+            mActive = true;
+        }
+        if (mActive) {
+            mFramesSinceProbe = 0;
+        }
+        break;
+    }
+
+    // 轮到的查询还没有读取时先等待读取（结果已经落后 queryCount 帧），否则会被覆盖
+    Slot& slot = mSlots[mCurrent];
+    if (slot.pending) {
+        readSlot(slot);
+        updateDecision();
+    }
+    slot.prepass = mActive;
+    return mActive;
+}
+
+void DepthPrepass::beginPrepass(Camera* camera) {
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDisable(GL_BLEND);
+    glDisable(GL_STENCIL_TEST);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+
+    mShader->begin();
+    mShader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());
+    mShader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());
+
+    if (!mQueriesSuspended) {
+        glBeginQuery(GL_SAMPLES_PASSED, mSlots[mCurrent].prepassQuery);
+    }
+}
+
+void DepthPrepass::endPrepass() {
+    if (!mQueriesSuspended) {
+        glEndQuery(GL_SAMPLES_PASSED);
+    }
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glEnable(GL_STENCIL_TEST);
+}
+
+void DepthPrepass::beginOpaque() {
+    if (!mQueriesSuspended) {
+        glBeginQuery(GL_SAMPLES_PASSED, mSlots[mCurrent].opaqueQuery);
+    }
+}
+
+void DepthPrepass::endOpaque() {
+    if (!mQueriesSuspended) {
+        glEndQuery(GL_SAMPLES_PASSED);
+        mSlots[mCurrent].pending = true;
+    }
+    mCurrent = (mCurrent + 1) % static_cast<int>(mSlots.size());
+}
+
+void DepthPrepass::applyEqualDepthState() const {
+    glDepthFunc(GL_EQUAL);
+    glDepthMask(GL_FALSE);
+}
+
+void DepthPrepass::readSlot(Slot& slot) {
+    GLuint64 opaqueSamples = 0;
+    glGetQueryObjectui64v(slot.opaqueQuery, GL_QUERY_RESULT, &opaqueSamples);
+    if (slot.prepass) {
+        // 预深度的片元数 = 不开预深度时的着色数；主 pass 在 GL_EQUAL 下每个像素只通过一次
+        GLuint64 prepassSamples = 0;
+        glGetQueryObjectui64v(slot.prepassQuery, GL_QUERY_RESULT, &prepassSamples);
+        mShadedSamples = prepassSamples;
+        mCoveredSamples = opaqueSamples;
+    }
+    else {
+        mShadedSamples = opaqueSamples;
+    }
+    mOverdraw = mCoveredSamples > 0 ? static_cast<float>(static_cast<double>(mShadedSamples) / static_cast<double>(mCoveredSamples)) : 0.0f;
+    slot.pending = false;
+}
+
+void DepthPrepass::collect() {
+    // 从最早提交的查询开始读取，遇到未完成的就停止
+    int count = static_cast<int>(mSlots.size());
+    for (int i = 0; i < count; i++) {
+        Slot& slot = mSlots[(mCurrent + i) % count];
+        if (!slot.pending) {
+            continue;
+        }
+        GLint available = 0;
+        glGetQueryObjectiv(slot.opaqueQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        readSlot(slot);
+        updateDecision();
+    }
+}
+
+void DepthPrepass::updateDecision() {
+    if (mCoveredSamples == 0) {
+        return;
+    }
+    if (mAutoEnabled && mOverdraw < mDisableOverdraw) {
+        mAutoEnabled = false;
+    }
+    else if (!mAutoEnabled && mOverdraw > mEnableOverdraw) {
+        mAutoEnabled = true;
+    }
+}
@@ -0,0 +1,295 @@
+#include "dualDepthPeeling.h"
+#include "../renderStats.h"
+#include "weightedBlendedOIT.h"
+#include <iostream>
+#include <string>
+
+// 深度范围目标的清空值：小于任何 -depth 与 depth，MAX 混合后等价于“没有片段”
+static const GLfloat DEPTH_CLEAR_VALUE = -1.0f;
+
+// 创建一张最近点采样的二维纹理并挂到 fbo 的 attachment 上
+static GLuint createTarget(GLenum internalFormat, GLenum format, int width, int height, GLenum attachment) {
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture, 0);
+    return texture;
+}
+
+DualDepthPeeling::DualDepthPeeling() {
+    std::string vertexPath = std::string(SHADER_DIR) + "/oit/weightedComposite.vert";     // 同一个全屏三角形
+    std::string blendPath = std::string(SHADER_DIR) + "/oit/depthPeelBlend.frag";
+    std::string compositePath = std::string(SHADER_DIR) + "/oit/depthPeelComposite.frag";
+    mBlendShader = new Shader(vertexPath.c_str(), blendPath.c_str());
+    mCompositeShader = new Shader(vertexPath.c_str(), compositePath.c_str());
+    glGenVertexArrays(1, &mEmptyVao);
+    glGenQueries(1, &mQuery);
+}
+
+DualDepthPeeling::~DualDepthPeeling() {
+    destroyTargets();
+    if (mQuery != 0) {
+        glDeleteQueries(1, &mQuery);
+        mQuery = 0;
+    }
+    if (mEmptyVao != 0) {
+        glDeleteVertexArrays(1, &mEmptyVao);
+        mEmptyVao = 0;
+    }
+    delete mBlendShader;
+    delete mCompositeShader;
+}
+
+bool DualDepthPeeling::createTargets(int width, int height, GLenum depthFormat) {
+    destroyTargets();
+
+    // 1 深度附件：与场景目标同格式，两套剥离目标共用
+    if (depthFormat != GL_NONE) {
+        glGenRenderbuffers(1, &mDepthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, mDepthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, depthFormat, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+    GLenum depthAttachment = mHasStencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+
+    // 2 两套剥离目标：深度范围需要 32 位浮点才能精确比较，颜色用半精度浮点容纳 HDR
+    bool complete = true;
+    for (int i = 0; i < 2; i++) {
+        glGenFramebuffers(1, &mPeelFbos[i]);
+        glBindFramebuffer(GL_FRAMEBUFFER, mPeelFbos[i]);
+        mDepthTextures[i] = createTarget(GL_RG32F, GL_RG, width, height, GL_COLOR_ATTACHMENT0);
+        mFrontTextures[i] = createTarget(GL_RGBA16F, GL_RGBA, width, height, GL_COLOR_ATTACHMENT1);
+        mBackTextures[i] = createTarget(GL_RGBA16F, GL_RGBA, width, height, GL_COLOR_ATTACHMENT2);
+        if (mDepthBuffer != 0) {
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, depthAttachment, GL_RENDERBUFFER, mDepthBuffer);
+        }
+
+        GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+        glDrawBuffers(3, drawBuffers);
+        complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    // 3 后层目标
+    glGenFramebuffers(1, &mBackBlendFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, mBackBlendFbo);
+    mBackBlendTexture = createTarget(GL_RGBA16F, GL_RGBA, width, height, GL_COLOR_ATTACHMENT0);
+    complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (!complete) {
+        std::cerr << "ERROR[DualDepthPeeling]: 深度剥离 FBO 不完整" << std::endl;
+        destroyTargets();
+        return false;
+    }
+
+    mWidth = width;
+    mHeight = height;
+    mDepthFormat = depthFormat;
+    return true;
+}
+
+void DualDepthPeeling::destroyTargets() {
+    glDeleteFramebuffers(2, mPeelFbos);
+    glDeleteTextures(2, mDepthTextures);
+    glDeleteTextures(2, mFrontTextures);
+    glDeleteTextures(2, mBackTextures);
+    for (int i = 0; i < 2; i++) {
+        mPeelFbos[i] = 0;
+        mDepthTextures[i] = 0;
+        mFrontTextures[i] = 0;
+        mBackTextures[i] = 0;
+    }
+    if (mBackBlendFbo != 0) {
+        glDeleteFramebuffers(1, &mBackBlendFbo);
+        mBackBlendFbo = 0;
+    }
+    if (mBackBlendTexture != 0) {
+        glDeleteTextures(1, &mBackBlendTexture);
+        mBackBlendTexture = 0;
+    }
+    if (mDepthBuffer != 0) {
+        glDeleteRenderbuffers(1, &mDepthBuffer);
+        mDepthBuffer = 0;
+    }
+    mWidth = 0;
+    mHeight = 0;
+    mDepthFormat = GL_NONE;
+}
+
+bool DualDepthPeeling::begin(GLuint sceneFbo, int width, int height, int maxLayers) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    // 1 尺寸或深度格式变化时重建附件
+    bool hasStencil = false;
+    GLenum depthFormat = WeightedBlendedOIT::queryDepthFormat(sceneFbo, hasStencil);
+    if (mPeelFbos[0] == 0 || width != mWidth || height != mHeight || depthFormat != mDepthFormat || hasStencil != mHasStencil) {
+        mHasStencil = hasStencil;
+        if (!createTargets(width, height, depthFormat)) {
+            glBindFramebuffer(GL_FRAMEBUFFER, sceneFbo);
+            return false;
+        }
+    }
+
+    // 2 复制不透明物体的深度（以及模板），透明物体被不透明物体遮挡的部分不参与剥离
+    if (mDepthFormat != GL_NONE) {
+        GLbitfield mask = GL_DEPTH_BUFFER_BIT | (mHasStencil ? GL_STENCIL_BUFFER_BIT : 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, sceneFbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mPeelFbos[0]);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, mask, GL_NEAREST);
+    }
+
+    // 3 后层目标清空为完全透明
+    glBindFramebuffer(GL_FRAMEBUFFER, mBackBlendFbo);
+    const GLfloat zero[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClearBufferfv(GL_COLOR, 0, zero);
+
+    // 4 初始化 pass：写入第 0 套目标的深度范围
+    int layers = maxLayers < 1 ? 1 : maxLayers;
+    mMaxPasses = (layers + 1) / 2;
+    mPassCount = 0;
+    mLayerCount = 0;
+    mCurrent = 0;
+    mInit = true;
+    beginPeelTarget(0, true);
+    return true;
+}
+
+void DualDepthPeeling::beginPeelTarget(int index, bool init) {
+    glBindFramebuffer(GL_FRAMEBUFFER, mPeelFbos[index]);
+    const GLfloat depthClear[] = { DEPTH_CLEAR_VALUE, DEPTH_CLEAR_VALUE, 0.0f, 0.0f };
+    const GLfloat zero[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClearBufferfv(GL_COLOR, 0, depthClear);
+    glClearBufferfv(GL_COLOR, 1, zero);
+    glClearBufferfv(GL_COLOR, 2, zero);
+
+    // 上一次的深度范围与前层颜色；初始化 pass 不读取，解绑避免与当前附件形成反馈
+    int previous = 1 - index;
+    glActiveTexture(GL_TEXTURE0 + DEPTH_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, init ? 0 : mDepthTextures[previous]);
+    glActiveTexture(GL_TEXTURE0 + FRONT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, init ? 0 : mFrontTextures[previous]);
+    glActiveTexture(GL_TEXTURE0);
+
+    // 三个附件都取最大值；透明物体只做深度测试不写深度
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_MAX);
+}
+
+bool DualDepthPeeling::blendBackLayer(int index, bool readQuery) {
+    glBindFramebuffer(GL_FRAMEBUFFER, mBackBlendFbo);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    mBlendShader->begin();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, mBackTextures[index]);
+    mBlendShader->setInt("backTexture", 0);
+
+    // 混合 shader 丢弃 alpha 为 0 的像素，查询结果为 0 表示这一 pass 没有剥离出任何最远层
+    if (readQuery) {
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, mQuery);
+    }
+    drawFullscreen();
+    if (!readQuery) {
+        return false;
+    }
+    glEndQuery(GL_ANY_SAMPLES_PASSED);
+
+    // 读取结果会等待本次 pass 完成，这是提前结束的代价；剩余的 pass 通常比这次等待贵得多
+    GLuint anySamples = 0;
+    glGetQueryObjectuiv(mQuery, GL_QUERY_RESULT, &anySamples);
+    return anySamples == 0;
+}
+
+bool DualDepthPeeling::nextPass() {
+    // 1 初始化 pass 结束：进入第一个剥离 pass，读取第 0 套、写入第 1 套
+    if (mInit) {
+        mInit = false;
+        mCurrent = 1;
+        beginPeelTarget(mCurrent, false);
+        return true;
+    }
+
+    // 2 剥离 pass 结束：最远层混合到后层目标
+    mPassCount++;
+    bool last = mPassCount >= mMaxPasses;
+    bool empty = blendBackLayer(mCurrent, !last);
+    if (empty) {
+        // 最后一个 pass 最多只剥离出最近层
+        mLayerCount = 2 * mPassCount - 1;
+        return false;
+    }
+    mLayerCount = 2 * mPassCount;
+    if (last) {
+        return false;
+    }
+
+    // 3 下一个剥离 pass：交换读写目标
+    mCurrent = 1 - mCurrent;
+    beginPeelTarget(mCurrent, false);
+    return true;
+}
+
+void DualDepthPeeling::applyUniforms(Shader* shader) const {
+    shader->setBool("depthPeelInit", mInit);
+    shader->setInt("depthPeelDepth", DEPTH_TEXTURE_UNIT);
+    shader->setInt("depthPeelFront", FRONT_TEXTURE_UNIT);
+}
+
+void DualDepthPeeling::composite(GLuint sceneFbo) {
+    glBindFramebuffer(GL_FRAMEBUFFER, sceneFbo);
+
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    mCompositeShader->begin();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, mFrontTextures[mCurrent]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, mBackBlendTexture);
+    mCompositeShader->setInt("frontTexture", 0);
+    mCompositeShader->setInt("backTexture", 1);
+    drawFullscreen();
+
+    // 解绑剥离读取的纹理单元，恢复常用状态
+    glActiveTexture(GL_TEXTURE0 + DEPTH_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0 + FRONT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+}
+
+void DualDepthPeeling::drawFullscreen() {
+    glBindVertexArray(mEmptyVao);
+    RenderStats::add(RenderCounter::DrawCalls);
+    RenderStats::add(RenderCounter::Triangles);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+}
+
+size_t DualDepthPeeling::getMemoryBytes() const {
+    size_t pixels = static_cast<size_t>(mWidth) * static_cast<size_t>(mHeight);
+    size_t depthBytes = (mDepthFormat == GL_NONE) ? 0 : (mDepthFormat == GL_DEPTH32F_STENCIL8 ? 8 : 4);
+    // 两套 (RG32F + 2 x RGBA16F) + 后层 RGBA16F + 深度
+    return pixels * (2 * (8 + 8 + 8) + 8 + depthBytes);
+}
@@ -0,0 +1,120 @@
+#include "dynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+DynamicResolution::DynamicResolution(int queryCount) {
+    int count = queryCount > 0 ? queryCount : 1;
+    mStartQueries.assign(count, 0);
+    mEndQueries.assign(count, 0);
+    mPending.assign(count, false);
+    glGenQueries(count, mStartQueries.data());
+    glGenQueries(count, mEndQueries.data());
+}
+
+DynamicResolution::~DynamicResolution() {
+    if (!mStartQueries.empty()) {
+        glDeleteQueries(static_cast<GLsizei>(mStartQueries.size()), mStartQueries.data());
+        glDeleteQueries(static_cast<GLsizei>(mEndQueries.size()), mEndQueries.data());
+    }
+}
+
+void DynamicResolution::setEnabled(bool enabled) {
+    mEnabled = enabled;
+    if (!mEnabled) {
+        // 重新开启时从最高比例开始收敛
+        mScale = mMaxScale;
+    }
+}
+
+void DynamicResolution::setScaleRange(float minScale, float maxScale) {
+    mMinScale = std::max(0.1f, std::min(minScale, 1.0f));
+    mMaxScale = std::max(mMinScale, std::min(maxScale, 1.0f));
+    mScale = std::max(mMinScale, std::min(mScale, mMaxScale));
+}
+
+void DynamicResolution::beginScene() {
+    if (mActive) {
+        return;
+    }
+
+    // 下一组查询还没有读取时先读取（结果已经落后 queryCount 帧），否则会被覆盖
+    collect();
+    if (mPending[mNext]) {
+        GLuint64 start = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(mStartQueries[mNext], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(mEndQueries[mNext], GL_QUERY_RESULT, &end);
+        mPending[mNext] = false;
+        updateScale((end - start) / 1000000.0);
+    }
+
+    glQueryCounter(mStartQueries[mNext], GL_TIMESTAMP);
+    mActive = true;
+}
+
+void DynamicResolution::endScene() {
+    if (!mActive) {
+        return;
+    }
+
+    glQueryCounter(mEndQueries[mNext], GL_TIMESTAMP);
+    mPending[mNext] = true;
+    mNext = (mNext + 1) % static_cast<int>(mStartQueries.size());
+    mActive = false;
+
+    collect();
+}
+
+void DynamicResolution::collect() {
+    // 从最早提交的查询开始读取，遇到未完成的就停止
+    int count = static_cast<int>(mStartQueries.size());
+    for (int i = 0; i < count; i++) {
+        int index = (mNext + i) % count;
+        if (!mPending[index]) {
+            continue;
+        }
+
+        // 结束时间戳可用时开始时间戳一定可用
+        GLint available = 0;
+        glGetQueryObjectiv(mEndQueries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+
+        GLuint64 start = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(mStartQueries[index], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(mEndQueries[index], GL_QUERY_RESULT, &end);
+        mPending[index] = false;
+        updateScale((end - start) / 1000000.0);
+    }
+}
+
+void DynamicResolution::updateScale(double gpuMs) {
+    mGpuMs = gpuMs;
+    if (!mEnabled || gpuMs <= 0.0) {
+        return;
+    }
+
+    // 1 片元开销与像素数（比例的平方）成正比，估算刚好达到预算的比例
+    float desired = mScale * static_cast<float>(std::sqrt(mTargetMs / gpuMs));
+
+    // 2 超出预算时快速下降，有余量时缓慢回升；结果落后几帧，阻尼避免来回振荡
+    float rate = desired < mScale ? 0.5f : 0.1f;
+    mScale += (desired - mScale) * rate;
+    mScale = std::max(mMinScale, std::min(mScale, mMaxScale));
+}
+
+float DynamicResolution::getScale() const {
+    if (!mEnabled) {
+        return 1.0f;
+    }
+    float scale = std::floor(mScale * 20.0f + 0.5f) / 20.0f;
+    return std::max(mMinScale, std::min(scale, mMaxScale));
+}
+
+void DynamicResolution::getRenderSize(int width, int height, int& renderWidth, int& renderHeight) const {
+    float scale = getScale();
+    renderWidth = std::max(1, static_cast<int>(width * scale + 0.5f));
+    renderHeight = std::max(1, static_cast<int>(height * scale + 0.5f));
+}
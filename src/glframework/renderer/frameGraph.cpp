@@ -0,0 +1,277 @@
+#include "frameGraph.h"
+#include "../renderStats.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+GLuint FrameGraphContext::getTexture(FrameGraphResource resource) const {
+    if (mGraph == nullptr || !mGraph->isValid(resource)) {
+        return 0;
+    }
+    return mGraph->mResources[resource].object;
+}
+
+FrameGraphResource FrameGraph::Builder::create(const std::string& name, const FrameGraphTextureDesc& desc) {
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    mGraph->mResources.push_back(resource);
+    return static_cast<FrameGraphResource>(mGraph->mResources.size() - 1);
+}
+
+FrameGraphResource FrameGraph::Builder::read(FrameGraphResource resource) {
+    if (!mGraph->isValid(resource)) {
+        std::cerr << "ERROR[FrameGraph]: Pass " << mGraph->mPasses[mPass].name << " 读取了无效资源" << std::endl;
+        return -1;
+    }
+    mGraph->mPasses[mPass].reads.push_back(resource);
+    return resource;
+}
+
+FrameGraphResource FrameGraph::Builder::write(FrameGraphResource resource) {
+    if (!mGraph->isValid(resource)) {
+        std::cerr << "ERROR[FrameGraph]: Pass " << mGraph->mPasses[mPass].name << " 写入了无效资源" << std::endl;
+        return -1;
+    }
+    mGraph->mPasses[mPass].colorWrites.push_back(resource);
+    mGraph->mResources[resource].producer = mPass;
+    return resource;
+}
+
+FrameGraphResource FrameGraph::Builder::writeDepth(FrameGraphResource resource) {
+    if (!mGraph->isValid(resource)) {
+        std::cerr << "ERROR[FrameGraph]: Pass " << mGraph->mPasses[mPass].name << " 写入了无效资源" << std::endl;
+        return -1;
+    }
+    mGraph->mPasses[mPass].depthWrite = resource;
+    mGraph->mResources[resource].producer = mPass;
+    return resource;
+}
+
+void FrameGraph::Builder::sideEffect() {
+    mGraph->mPasses[mPass].sideEffect = true;
+}
+
+FrameGraph::FrameGraph() {}
+
+FrameGraph::~FrameGraph() {}
+
+bool FrameGraph::isValid(FrameGraphResource resource) const {
+    return resource >= 0 && resource < static_cast<FrameGraphResource>(mResources.size());
+}
+
+void FrameGraph::setBackbufferSize(int width, int height) {
+    if (width == mBackbufferWidth && height == mBackbufferHeight) {
+        return;
+    }
+
+    // 旧尺寸下跟随后台缓冲的目标不会再被用到，立即释放；固定尺寸的目标按描述中的标记区分，不受影响
+    bool hadSize = mBackbufferWidth > 0 && mBackbufferHeight > 0;
+    mBackbufferWidth = width;
+    mBackbufferHeight = height;
+    if (hadSize) {
+        mPool.purgeBackbufferRelative();
+    }
+}
+
+FrameGraphResource FrameGraph::importFramebuffer(const std::string& name, GLuint fbo, int width, int height) {
+    Resource resource;
+    resource.name = name;
+    resource.imported = true;
+    resource.importedFbo = fbo;
+    resource.importedWidth = width;
+    resource.importedHeight = height;
+    mResources.push_back(resource);
+    return static_cast<FrameGraphResource>(mResources.size() - 1);
+}
+
+void FrameGraph::addPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute) {
+    Pass pass;
+    pass.name = name;
+    pass.execute = execute;
+    mPasses.push_back(pass);
+    mCompiled = false;
+
+    Builder builder(this, static_cast<int>(mPasses.size() - 1));
+    setup(builder);
+}
+
+RenderTargetDesc FrameGraph::resolveDesc(const Resource& resource) const {
+    RenderTargetDesc desc;
+    desc.internalFormat = resource.desc.format;
+    desc.renderbuffer = resource.desc.renderbuffer;
+    if (resource.desc.width > 0 && resource.desc.height > 0) {
+        desc.width = resource.desc.width;
+        desc.height = resource.desc.height;
+    }
+    else {
+        desc.width = std::max(1, static_cast<int>(std::lround(mBackbufferWidth * resource.desc.scale)));
+        desc.height = std::max(1, static_cast<int>(std::lround(mBackbufferHeight * resource.desc.scale)));
+        desc.backbufferRelative = true;
+    }
+    return desc;
+}
+
+void FrameGraph::compile() {
+    // 1 引用计数：Pass 被写入的资源个数 + 副作用；资源被读取的次数
+    for (auto& pass : mPasses) {
+        pass.refCount = static_cast<int>(pass.colorWrites.size()) + (pass.depthWrite >= 0 ? 1 : 0);
+        pass.culled = false;
+        for (auto resource : pass.reads) {
+            mResources[resource].refCount++;
+        }
+    }
+
+    // 2 没有读者的临时资源出栈，其生产者的引用减一，减到 0 的 Pass 被剔除，并继续释放它读取的资源
+    //   导入资源（最终输出）与有副作用的 Pass 是根，永远保留
+    std::vector<FrameGraphResource> unreferenced;
+    for (size_t i = 0; i < mResources.size(); i++) {
+        if (mResources[i].refCount == 0 && !mResources[i].imported) {
+            unreferenced.push_back(static_cast<FrameGraphResource>(i));
+        }
+    }
+    while (!unreferenced.empty()) {
+        FrameGraphResource resource = unreferenced.back();
+        unreferenced.pop_back();
+
+        int producer = mResources[resource].producer;
+        if (producer < 0) {
+            continue;
+        }
+        Pass& pass = mPasses[producer];
+        if (pass.sideEffect || pass.culled) {
+            continue;
+        }
+        if (--pass.refCount > 0) {
+            continue;
+        }
+
+        pass.culled = true;
+        for (auto input : pass.reads) {
+            if (--mResources[input].refCount == 0 && !mResources[input].imported) {
+                unreferenced.push_back(input);
+            }
+        }
+    }
+
+    // 3 生命周期：第一次与最后一次被保留的 Pass 使用
+    for (size_t p = 0; p < mPasses.size(); p++) {
+        const Pass& pass = mPasses[p];
+        if (pass.culled) {
+            continue;
+        }
+        auto touch = [&](FrameGraphResource resource) {
+            Resource& r = mResources[resource];
+            if (r.firstUse < 0) {
+                r.firstUse = static_cast<int>(p);
+            }
+            r.lastUse = static_cast<int>(p);
+        };
+        for (auto resource : pass.reads) {
+            touch(resource);
+        }
+        for (auto resource : pass.colorWrites) {
+            touch(resource);
+        }
+        if (pass.depthWrite >= 0) {
+            touch(pass.depthWrite);
+        }
+    }
+
+    mCompiled = true;
+}
+
+void FrameGraph::execute() {
+    if (!mCompiled) {
+        compile();
+    }
+
+    mPool.beginFrame();
+    mStats = Stats();
+
+    for (size_t p = 0; p < mPasses.size(); p++) {
+        Pass& pass = mPasses[p];
+        mStats.passCount++;
+        if (pass.culled) {
+            mStats.culledPassCount++;
+            continue;
+        }
+
+        // 1 第一次使用的临时资源从池中取出（此时之前 Pass 归还的同描述对象可以被复用）
+        auto acquire = [&](FrameGraphResource resource) {
+            Resource& r = mResources[resource];
+            if (r.imported || r.object != 0 || r.firstUse != static_cast<int>(p)) {
+                return;
+            }
+            RenderTargetDesc desc = resolveDesc(r);
+            r.object = mPool.acquire(desc);
+            mStats.resourceCount++;
+            mStats.virtualBytes += RenderTargetPool::getMemoryBytes(desc);
+        };
+        for (auto resource : pass.colorWrites) {
+            acquire(resource);
+        }
+        if (pass.depthWrite >= 0) {
+            acquire(pass.depthWrite);
+        }
+        for (auto resource : pass.reads) {
+            acquire(resource);
+        }
+
+        // 2 目标 FBO：写入导入资源时直接用外部 FBO，否则由池按附件组合缓存
+        FrameGraphContext context;
+        context.mGraph = this;
+        int width = mBackbufferWidth;
+        int height = mBackbufferHeight;
+        bool importedTarget = false;
+        for (auto resource : pass.colorWrites) {
+            const Resource& r = mResources[resource];
+            if (r.imported) {
+                context.mFramebuffer = r.importedFbo;
+                width = r.importedWidth;
+                height = r.importedHeight;
+                importedTarget = true;
+                break;
+            }
+        }
+        if (!importedTarget && (!pass.colorWrites.empty() || pass.depthWrite >= 0)) {
+            std::vector<GLuint> colors;
+            for (auto resource : pass.colorWrites) {
+                colors.push_back(mResources[resource].object);
+            }
+            GLuint depth = pass.depthWrite >= 0 ? mResources[pass.depthWrite].object : 0;
+            context.mFramebuffer = mPool.getFramebuffer(colors, depth);
+
+            RenderTargetDesc desc = resolveDesc(mResources[pass.colorWrites.empty() ? pass.depthWrite : pass.colorWrites[0]]);
+            width = desc.width;
+            height = desc.height;
+        }
+        context.mWidth = width;
+        context.mHeight = height;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, context.mFramebuffer);
+        glViewport(0, 0, width, height);
+        if (pass.execute) {
+            RenderStatsScope statsScope(pass.name.c_str());
+            pass.execute(context);
+        }
+
+        // 3 最后一次使用的临时资源归还给池，后续 Pass 可以复用
+        for (auto& resource : mResources) {
+            if (!resource.imported && resource.object != 0 && resource.lastUse == static_cast<int>(p)) {
+                mPool.release(resource.object);
+            }
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, mBackbufferWidth, mBackbufferHeight);
+
+    // 4 长时间没有使用的目标（如关闭的特效）释放掉
+    mPool.trim();
+    mStats.physicalBytes = mPool.getMemoryBytes();
+
+    mPasses.clear();
+    mResources.clear();
+    mCompiled = false;
+}
@@ -0,0 +1,125 @@
+#include "frameSnapshot.h"
+#include "../tools/profiler.h"
+#include <algorithm>
+#include <functional>
+
+void FrameLights::capture(const DirectionalLight* dirLight, const std::vector<PointLight*>& pointLights, const AmbientLight* ambLight) {
+    directional = dirLight != nullptr ? *dirLight : DirectionalLight();
+    ambient = ambLight != nullptr ? *ambLight : AmbientLight();
+
+    points.resize(pointLights.size());
+    for (size_t i = 0; i < pointLights.size(); i++) {
+        PointLight* light = pointLights[i];
+        PointLightData& data = points[i];
+        data.position = light->getPosition();
+        data.color = light->getColor();
+        data.specularIntensity = light->getSpecularIntensity();
+        data.ambient = light->mAmbient;
+        data.diffuse = light->mDiffuse;
+        data.specular = light->mSpecular;
+        data.kc = light->mKc;
+        data.k1 = light->mK1;
+        data.k2 = light->mK2;
+    }
+}
+
+void SnapshotCamera::capture(Camera* camera) {
+    mPosition = camera->mPosition;
+    mUp = camera->mUp;
+    mRight = camera->mRight;
+    mNear = camera->mNear;
+    mFar = camera->mFar;
+    mJitter = camera->mJitter;
+    mProjection = camera->getProjectionMatrix();    // 已经包含抖动
+}
+
+void FrameSnapshot::capture(RenderQueue& queue, Scene* scene, Camera* sourceCamera,
+    const DirectionalLight* dirLight, const std::vector<PointLight*>& pointLights, const AmbientLight* ambLight) {
+    PROFILE_SCOPE("FrameSnapshot::capture");
+    camera.capture(sourceCamera);
+    lights.capture(dirLight, pointLights, ambLight);
+
+    queue.build(scene, sourceCamera);
+    ArrayView<RenderPacket> opaquePackets = queue.getOpaquePackets();
+    ArrayView<RenderPacket> transparentPackets = queue.getTransparentPackets();
+    opaque.assign(opaquePackets.begin(), opaquePackets.end());
+    transparent.assign(transparentPackets.begin(), transparentPackets.end());
+    copyMaterials();
+    copyNames();
+}
+
+// 辅助函数：按类型把材质复制到 copies 的第 next 个位置（数组事先按数量分配好，地址不再变化）
+template<typename T>
+static Material* copyMaterial(std::vector<T>& copies, size_t& next, Material* source) {
+    T& copy = copies[next++];
+    copy = *static_cast<T*>(source);
+    return &copy;
+}
+
+void FrameSnapshot::copyMaterials() {
+    //1 渲染包引用的材质去重（排序后去掉相邻的重复项，不需要哈希表）
+    mMaterialSources.clear();
+    for (const auto& packet : opaque) {
+        mMaterialSources.push_back(packet.material);
+    }
+    for (const auto& packet : transparent) {
+        mMaterialSources.push_back(packet.material);
+    }
+    std::sort(mMaterialSources.begin(), mMaterialSources.end(), std::less<Material*>());
+    mMaterialSources.erase(std::unique(mMaterialSources.begin(), mMaterialSources.end()), mMaterialSources.end());
+
+    //2 按类型分配副本数组
+    size_t counts[5] = { 0, 0, 0, 0, 0 };
+    for (Material* material : mMaterialSources) {
+        counts[static_cast<int>(material->mType)]++;
+    }
+    mPhongMaterials.resize(counts[static_cast<int>(MaterialType::PhongMaterial)]);
+    mWhiteMaterials.resize(counts[static_cast<int>(MaterialType::WhiteMaterial)]);
+    mPBRMaterials.resize(counts[static_cast<int>(MaterialType::PBRMaterial)]);
+    mDepthMaterials.resize(counts[static_cast<int>(MaterialType::DepthMaterial)]);
+    mScreenMaterials.resize(counts[static_cast<int>(MaterialType::SreenMaterial)]);
+
+    //3 复制（按值，贴图、shader 仍是共享的指针）
+    size_t next[5] = { 0, 0, 0, 0, 0 };
+    mMaterialCopies.resize(mMaterialSources.size());
+    for (size_t i = 0; i < mMaterialSources.size(); i++) {
+        Material* source = mMaterialSources[i];
+        size_t& index = next[static_cast<int>(source->mType)];
+        switch (source->mType) {
+        case MaterialType::PhongMaterial: mMaterialCopies[i] = copyMaterial(mPhongMaterials, index, source); break;
+        case MaterialType::WhiteMaterial: mMaterialCopies[i] = copyMaterial(mWhiteMaterials, index, source); break;
+        case MaterialType::PBRMaterial: mMaterialCopies[i] = copyMaterial(mPBRMaterials, index, source); break;
+        case MaterialType::DepthMaterial: mMaterialCopies[i] = copyMaterial(mDepthMaterials, index, source); break;
+        case MaterialType::SreenMaterial: mMaterialCopies[i] = copyMaterial(mScreenMaterials, index, source); break;
+        }
+    }
+
+    //4 渲染包改为引用副本
+    auto remap = [this](RenderPacket& packet) {
+        auto it = std::lower_bound(mMaterialSources.begin(), mMaterialSources.end(), packet.material, std::less<Material*>());
+        packet.material = mMaterialCopies[it - mMaterialSources.begin()];
+    };
+    for (auto& packet : opaque) {
+        remap(packet);
+    }
+    for (auto& packet : transparent) {
+        remap(packet);
+    }
+}
+
+void FrameSnapshot::copyNames() {
+    // 数组先调整好大小再取地址；字符串跨帧复用，名字不变时不再分配内存
+    mMeshNames.resize(opaque.size() + transparent.size());
+    size_t next = 0;
+    auto copy = [this, &next](RenderPacket& packet) {
+        std::string& name = mMeshNames[next++];
+        name = *packet.name;
+        packet.name = &name;
+    };
+    for (auto& packet : opaque) {
+        copy(packet);
+    }
+    for (auto& packet : transparent) {
+        copy(packet);
+    }
+}
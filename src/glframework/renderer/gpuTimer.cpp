@@ -0,0 +1,74 @@
+#include "gpuTimer.h"
+
+GpuTimer::GpuTimer(int queryCount) {
+    int count = queryCount > 0 ? queryCount : 1;
+    mQueries.assign(count, 0);
+    mPending.assign(count, false);
+    glGenQueries(count, mQueries.data());
+}
+
+GpuTimer::~GpuTimer() {
+    if (!mQueries.empty()) {
+        glDeleteQueries(static_cast<GLsizei>(mQueries.size()), mQueries.data());
+    }
+}
+
+void GpuTimer::begin() {
+    if (mActive) {
+        return;
+    }
+
+    // 下一个查询还没有读取结果时先读取（只会发生在结果已经落后 queryCount 帧时），否则结果会被覆盖
+    collect();
+    if (mPending[mNext]) {
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(mQueries[mNext], GL_QUERY_RESULT, &elapsed);
+        mPending[mNext] = false;
+        mLastMs = elapsed / 1000000.0;
+        mTotalMs += mLastMs;
+        mResultCount++;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, mQueries[mNext]);
+    mActive = true;
+}
+
+void GpuTimer::end() {
+    if (!mActive) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    mPending[mNext] = true;
+    mNext = (mNext + 1) % static_cast<int>(mQueries.size());
+    mActive = false;
+}
+
+double GpuTimer::getLastMs() {
+    collect();
+    return mLastMs;
+}
+
+void GpuTimer::collect() {
+    // 从最早提交的查询开始读取，遇到未完成的就停止，保证结果按提交顺序更新
+    int count = static_cast<int>(mQueries.size());
+    for (int i = 0; i < count; i++) {
+        int index = (mNext + i) % count;
+        if (!mPending[index]) {
+            continue;
+        }
+
+        GLint available = 0;
+        glGetQueryObjectiv(mQueries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(mQueries[index], GL_QUERY_RESULT, &elapsed);
+        mPending[index] = false;
+        mLastMs = elapsed / 1000000.0;
+        mTotalMs += mLastMs;
+        mResultCount++;
+    }
+}
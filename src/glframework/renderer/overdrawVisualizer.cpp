@@ -0,0 +1,269 @@
+#include "overdrawVisualizer.h"
+#include "../renderStats.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+OverdrawVisualizer::OverdrawVisualizer(int readbackCount) {
+    std::string countVertexPath = std::string(SHADER_DIR) + "/depthPrepass/depthOnly.vert";
+    std::string countFragmentPath = std::string(SHADER_DIR) + "/overdraw/overdrawCount.frag";
+    std::string reducePath = std::string(SHADER_DIR) + "/overdraw/overdrawReduce.comp";
+    std::string heatmapVertexPath = std::string(SHADER_DIR) + "/postprocess/fullscreen.vert";
+    std::string heatmapFragmentPath = std::string(SHADER_DIR) + "/overdraw/heatmap.frag";
+    mCountShader = new Shader(countVertexPath.c_str(), countFragmentPath.c_str());
+    mReduceShader = Shader::createCompute(reducePath.c_str());
+    mHeatmapShader = new Shader(heatmapVertexPath.c_str(), heatmapFragmentPath.c_str());
+    glGenVertexArrays(1, &mEmptyVao);
+
+    // 归约结果：4 个 uint，几帧之后读取
+    int count = readbackCount > 0 ? readbackCount : 1;
+    mReadbacks.resize(count);
+    for (auto& readback : mReadbacks) {
+        glGenBuffers(1, &readback.buffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, readback.buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, 4 * sizeof(GLuint), nullptr, GL_DYNAMIC_READ);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+OverdrawVisualizer::~OverdrawVisualizer() {
+    for (auto& readback : mReadbacks) {
+        if (readback.fence != nullptr) {
+            glDeleteSync(readback.fence);
+        }
+        glDeleteBuffers(1, &readback.buffer);
+    }
+    for (auto& set : mQuerySets) {
+        if (!set.queries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(set.queries.size()), set.queries.data());
+        }
+    }
+    if (mCountTexture != 0) {
+        glDeleteTextures(1, &mCountTexture);
+        mCountTexture = 0;
+    }
+    if (mEmptyVao != 0) {
+        glDeleteVertexArrays(1, &mEmptyVao);
+        mEmptyVao = 0;
+    }
+    delete mCountShader;
+    delete mReduceShader;
+    delete mHeatmapShader;
+}
+
+void OverdrawVisualizer::resizeCounts(int width, int height) {
+    if (mCountTexture != 0) {
+        glDeleteTextures(1, &mCountTexture);
+        mCountTexture = 0;
+    }
+
+    glGenTextures(1, &mCountTexture);
+    glBindTexture(GL_TEXTURE_2D, mCountTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32UI, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    mWidth = width;
+    mHeight = height;
+}
+
+void OverdrawVisualizer::beginFrame() {
+    //1 读取已经完成的结果
+    collectTotals();
+    QuerySet& previous = mQuerySets[1 - mCurrentQuerySet];
+    collectMeshes(previous);
+    mCurrentQuerySet = 1 - mCurrentQuerySet;
+    mQuerySets[mCurrentQuerySet].used = 0;
+
+    //2 计数图像覆盖整个视口（gl_FragCoord 直接作为坐标）
+    glGetIntegerv(GL_VIEWPORT, mViewport);
+    int width = mViewport[0] + mViewport[2];
+    int height = mViewport[1] + mViewport[3];
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    if (mCountTexture == 0 || width != mWidth || height != mHeight) {
+        resizeCounts(width, height);
+    }
+
+    const GLuint zero = 0;
+    glClearTexImage(mCountTexture, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindImageTexture(0, mCountTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+}
+
+void OverdrawVisualizer::beginMesh(const std::string& name, TransformHandle handle, uint32_t triangles) {
+    QuerySet& set = mQuerySets[mCurrentQuerySet];
+    if (set.used == set.queries.size()) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        set.queries.push_back(query);
+        set.meshes.emplace_back();
+    }
+
+    OverdrawMeshStat& stat = set.meshes[set.used];
+    stat.name = name.empty() ? "Mesh " + std::to_string(handle) : name;
+    stat.triangles = triangles;
+    stat.fragments = 0;
+
+    glBeginQuery(GL_SAMPLES_PASSED, set.queries[set.used]);
+    mQueryActive = true;
+}
+
+void OverdrawVisualizer::endMesh() {
+    if (!mQueryActive) {
+        return;
+    }
+    glEndQuery(GL_SAMPLES_PASSED);
+    mQuerySets[mCurrentQuerySet].used++;
+    mQueryActive = false;
+}
+
+void OverdrawVisualizer::endFrame(GLuint fbo) {
+    if (mCountTexture == 0) {
+        return;
+    }
+
+    //1 归约：上一轮还没读到的结果直接丢弃，不等待 GPU
+    Readback& readback = mReadbacks[mCurrentReadback];
+    if (readback.fence != nullptr) {
+        glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+    }
+    const GLuint zeros[4] = { 0, 0, 0, 0 };
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, readback.buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zeros), zeros);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, readback.buffer);
+
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    mReduceShader->begin();
+    glBindImageTexture(0, mCountTexture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32UI);
+    glDispatchCompute((mWidth + 15) / 16, (mHeight + 15) / 16, 1);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    mCurrentReadback = (mCurrentReadback + 1) % static_cast<int>(mReadbacks.size());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+
+    //2 热力图覆盖本帧画面
+    if (!mShowHeatmap) {
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(mViewport[0], mViewport[1], mViewport[2], mViewport[3]);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_BLEND);
+
+    mHeatmapShader->begin();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, mCountTexture);
+    mHeatmapShader->setInt("overdrawCounts", 0);
+    mHeatmapShader->setFloat("heatmapMax", static_cast<float>(mHeatmapMax));
+
+    glBindVertexArray(mEmptyVao);
+    RenderStats::add(RenderCounter::DrawCalls);
+    RenderStats::add(RenderCounter::Triangles);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    // 恢复常用状态
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+}
+
+void OverdrawVisualizer::collectTotals() {
+    // 从最早提交的结果开始读取，遇到未完成的就停止
+    int count = static_cast<int>(mReadbacks.size());
+    for (int i = 0; i < count; i++) {
+        Readback& readback = mReadbacks[(mCurrentReadback + i) % count];
+        if (readback.fence == nullptr) {
+            continue;
+        }
+
+        GLenum status = glClientWaitSync(readback.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+
+        GLuint totals[4] = { 0, 0, 0, 0 };
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, readback.buffer);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(totals), totals);
+        mFrameStat.fragments = totals[0];
+        mFrameStat.coveredPixels = totals[1];
+        mFrameStat.maxCount = totals[2];
+        mFrameStat.ratio = totals[1] > 0 ? static_cast<float>(totals[0]) / static_cast<float>(totals[1]) : 0.0f;
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void OverdrawVisualizer::collectMeshes(QuerySet& set) {
+    if (set.used == 0) {
+        return;
+    }
+
+    // 查询按提交顺序完成，最后一个可用时全部可用；未完成时保留上一次的结果
+    GLint available = 0;
+    glGetQueryObjectiv(set.queries[set.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return;
+    }
+
+    mMeshStats.resize(set.used);
+    for (size_t i = 0; i < set.used; i++) {
+        GLuint64 samples = 0;
+        glGetQueryObjectui64v(set.queries[i], GL_QUERY_RESULT, &samples);
+        mMeshStats[i] = set.meshes[i];
+        mMeshStats[i].fragments = samples;
+    }
+}
+
+bool OverdrawVisualizer::exportCSV(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR[OverdrawVisualizer]: 无法写入 " << path << std::endl;
+        return false;
+    }
+
+    // 名称中的引号按 CSV 规则写成两个
+    auto quote = [](const std::string& text) {
+        std::string result = "\"";
+        for (char c : text) {
+            result += c;
+            if (c == '"') {
+                result += '"';
+            }
+        }
+        return result + "\"";
+    };
+
+    uint64_t meshFragments = 0;
+    uint64_t triangles = 0;
+    for (const auto& stat : mMeshStats) {
+        meshFragments += stat.fragments;
+        triangles += stat.triangles;
+    }
+
+    file << "mesh,triangles,fragments,fragments_per_triangle,fragment_share\n";
+    for (const auto& stat : mMeshStats) {
+        double perTriangle = stat.triangles > 0 ? static_cast<double>(stat.fragments) / stat.triangles : 0.0;
+        double share = meshFragments > 0 ? static_cast<double>(stat.fragments) / meshFragments : 0.0;
+        file << quote(stat.name) << ',' << stat.triangles << ',' << stat.fragments << ',' << perTriangle << ',' << share << '\n';
+    }
+    file << quote("total") << ',' << triangles << ',' << meshFragments << ','
+        << (triangles > 0 ? static_cast<double>(meshFragments) / triangles : 0.0) << ',' << 1.0 << '\n';
+
+    // 整帧结果单独一段（GPU 归约得到）
+    file << '\n';
+    file << "covered_pixels,shaded_fragments,overdraw_ratio,max_layers\n";
+    file << mFrameStat.coveredPixels << ',' << mFrameStat.fragments << ',' << mFrameStat.ratio << ',' << mFrameStat.maxCount << '\n';
+    return true;
+}
+
+size_t OverdrawVisualizer::getMemoryBytes() const {
+    size_t pixels = static_cast<size_t>(mWidth) * static_cast<size_t>(mHeight);
+    return pixels * 4 + mReadbacks.size() * 4 * sizeof(GLuint);
+}
@@ -0,0 +1,350 @@
+#include "postProcessStack.h"
+#include "../renderStats.h"
+#include <iostream>
+#include <string>
+#include <algorithm>
+
+// 逐像素效果：位与宏名一一对应，顺序即执行顺序（与 composite.frag 中一致）
+static const unsigned int PER_PIXEL_EFFECTS[] = { POST_BLOOM, POST_EXPOSURE, POST_TONEMAP, POST_COLOR_GRADING, POST_VIGNETTE };
+static const char* PER_PIXEL_MACROS[] = { "BLOOM", "EXPOSURE", "TONEMAP", "COLOR_GRADING", "VIGNETTE" };
+static const unsigned int PER_PIXEL_MASK = POST_BLOOM | POST_EXPOSURE | POST_TONEMAP | POST_COLOR_GRADING | POST_VIGNETTE;
+
+// 带宽估算：中间目标与场景颜色按 RGBA16F，最终目标按 RGBA8
+static const size_t HDR_PIXEL_BYTES = 8;
+static const size_t LDR_PIXEL_BYTES = 4;
+
+static int groupCount(int size) {
+    return (size + 7) / 8;
+}
+
+PostProcessStack::PostProcessStack() {
+    std::string fxaaVertexPath = std::string(SHADER_DIR) + "/postprocess/fullscreen.vert";
+    std::string fxaaFragmentPath = std::string(SHADER_DIR) + "/postprocess/fxaa.frag";
+    mFxaaShader = new Shader(fxaaVertexPath.c_str(), fxaaFragmentPath.c_str());
+
+    std::string downsamplePath = std::string(SHADER_DIR) + "/postprocess/bloomDownsample.comp";
+    std::string upsamplePath = std::string(SHADER_DIR) + "/postprocess/bloomUpsample.comp";
+    mDownsamplePrefilterShader = Shader::createCompute(downsamplePath.c_str(), { ShaderMacro("PREFILTER", ShaderTarget::COMPUTE) });
+    mDownsampleShader = Shader::createCompute(downsamplePath.c_str());
+    mUpsampleShader = Shader::createCompute(upsamplePath.c_str());
+
+    glGenVertexArrays(1, &mEmptyVao);
+    mTimers[0] = new GpuTimer();
+    mTimers[1] = new GpuTimer();
+}
+
+PostProcessStack::~PostProcessStack() {
+    destroyTargets();
+    if (mEmptyVao != 0) {
+        glDeleteVertexArrays(1, &mEmptyVao);
+        mEmptyVao = 0;
+    }
+    for (auto& shader : mCompositeShaders) {
+        delete shader.second;
+    }
+    delete mFxaaShader;
+    delete mDownsamplePrefilterShader;
+    delete mDownsampleShader;
+    delete mUpsampleShader;
+    delete mTimers[0];
+    delete mTimers[1];
+}
+
+bool PostProcessStack::ensureTargets(int width, int height) {
+    // 金字塔第 0 层为源图的一半，层数不超过最短边能减半的次数
+    int bloomWidth = std::max(1, width / 2);
+    int bloomHeight = std::max(1, height / 2);
+    int maxLevels = 1;
+    for (int size = std::min(bloomWidth, bloomHeight); size > 1; size /= 2) {
+        maxLevels++;
+    }
+    int bloomLevels = std::max(1, std::min(mSettings.bloomLevels, maxLevels));
+
+    if (mPingPongFbos[0] != 0 && width == mWidth && height == mHeight && bloomLevels == mBloomLevels) {
+        return true;
+    }
+    destroyTargets();
+
+    // 1 两张中间目标
+    glGenFramebuffers(2, mPingPongFbos);
+    glGenTextures(2, mPingPongTextures);
+    for (int i = 0; i < 2; i++) {
+        glBindTexture(GL_TEXTURE_2D, mPingPongTextures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, mPingPongFbos[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mPingPongTextures[i], 0);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "ERROR[PostProcessStack]: 中间目标 FBO 不完整，错误码：" << status << std::endl;
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            destroyTargets();
+            return false;
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // 2 泛光金字塔：不可变存储，每层都可以绑定为 image；上采样按 lod 双线性采样，需要 mipmap 过滤
+    glGenTextures(1, &mBloomTexture);
+    glBindTexture(GL_TEXTURE_2D, mBloomTexture);
+    glTexStorage2D(GL_TEXTURE_2D, bloomLevels, GL_RGBA16F, bloomWidth, bloomHeight);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, bloomLevels - 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    mWidth = width;
+    mHeight = height;
+    mBloomLevels = bloomLevels;
+    return true;
+}
+
+void PostProcessStack::destroyTargets() {
+    if (mPingPongFbos[0] != 0) {
+        glDeleteFramebuffers(2, mPingPongFbos);
+        mPingPongFbos[0] = mPingPongFbos[1] = 0;
+    }
+    if (mPingPongTextures[0] != 0) {
+        glDeleteTextures(2, mPingPongTextures);
+        mPingPongTextures[0] = mPingPongTextures[1] = 0;
+    }
+    if (mBloomTexture != 0) {
+        glDeleteTextures(1, &mBloomTexture);
+        mBloomTexture = 0;
+    }
+    mWidth = 0;
+    mHeight = 0;
+    mBloomLevels = 0;
+}
+
+size_t PostProcessStack::getMemoryBytes() const {
+    size_t bytes = static_cast<size_t>(mWidth) * static_cast<size_t>(mHeight) * HDR_PIXEL_BYTES * 2;
+    int levelWidth = std::max(1, mWidth / 2);
+    int levelHeight = std::max(1, mHeight / 2);
+    for (int level = 0; level < mBloomLevels; level++) {
+        bytes += static_cast<size_t>(levelWidth) * static_cast<size_t>(levelHeight) * HDR_PIXEL_BYTES;
+        levelWidth = std::max(1, levelWidth / 2);
+        levelHeight = std::max(1, levelHeight / 2);
+    }
+    return bytes;
+}
+
+int PostProcessStack::renderBloom(GLuint sourceTexture, int width, int height, Stats& stats) {
+    std::vector<int> levelWidths(mBloomLevels);
+    std::vector<int> levelHeights(mBloomLevels);
+    levelWidths[0] = std::max(1, width / 2);
+    levelHeights[0] = std::max(1, height / 2);
+    for (int level = 1; level < mBloomLevels; level++) {
+        levelWidths[level] = std::max(1, levelWidths[level - 1] / 2);
+        levelHeights[level] = std::max(1, levelHeights[level - 1] / 2);
+    }
+    auto levelBytes = [&](int level) {
+        return static_cast<size_t>(levelWidths[level]) * static_cast<size_t>(levelHeights[level]) * HDR_PIXEL_BYTES;
+    };
+
+    glActiveTexture(GL_TEXTURE0);
+
+    // 1 第 0 层：从场景颜色下采样，同时做亮度阈值
+    mDownsamplePrefilterShader->begin();
+    mDownsamplePrefilterShader->setInt("sourceTexture", 0);
+    mDownsamplePrefilterShader->setInt("sourceLod", 0);
+    mDownsamplePrefilterShader->setFloat("threshold", mSettings.bloomThreshold);
+    mDownsamplePrefilterShader->setFloat("knee", std::max(mSettings.bloomKnee, 0.0001f));
+    glBindTexture(GL_TEXTURE_2D, sourceTexture);
+    glBindImageTexture(0, mBloomTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    glDispatchCompute(groupCount(levelWidths[0]), groupCount(levelHeights[0]), 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    stats.dispatchCount++;
+    stats.bandwidthBytes += static_cast<size_t>(width) * static_cast<size_t>(height) * HDR_PIXEL_BYTES + levelBytes(0);
+
+    // 2 逐层下采样：读上一层，写当前层
+    glBindTexture(GL_TEXTURE_2D, mBloomTexture);
+    mDownsampleShader->begin();
+    mDownsampleShader->setInt("sourceTexture", 0);
+    for (int level = 1; level < mBloomLevels; level++) {
+        mDownsampleShader->setInt("sourceLod", level - 1);
+        glBindImageTexture(0, mBloomTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+        glDispatchCompute(groupCount(levelWidths[level]), groupCount(levelHeights[level]), 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        stats.dispatchCount++;
+        stats.bandwidthBytes += levelBytes(level - 1) + levelBytes(level);
+    }
+
+    // 3 逐层上采样：下一层做帐篷滤波后叠加到当前层，最终第 0 层是所有层的和
+    mUpsampleShader->begin();
+    mUpsampleShader->setInt("lowerTexture", 0);
+    mUpsampleShader->setFloat("radius", mSettings.bloomRadius);
+    for (int level = mBloomLevels - 2; level >= 0; level--) {
+        mUpsampleShader->setInt("lowerLod", level + 1);
+        glBindImageTexture(0, mBloomTexture, level, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA16F);
+        glDispatchCompute(groupCount(levelWidths[level]), groupCount(levelHeights[level]), 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        stats.dispatchCount++;
+        stats.bandwidthBytes += levelBytes(level + 1) + levelBytes(level) * 2;
+    }
+
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return mBloomLevels;
+}
+
+Shader* PostProcessStack::getCompositeShader(unsigned int effects) {
+    auto iter = mCompositeShaders.find(effects);
+    if (iter != mCompositeShaders.end()) {
+        return iter->second;
+    }
+
+    std::vector<ShaderMacro> macros;
+    for (int i = 0; i < 5; i++) {
+        if (effects & PER_PIXEL_EFFECTS[i]) {
+            macros.push_back(ShaderMacro(PER_PIXEL_MACROS[i], ShaderTarget::FRAGMENT));
+        }
+    }
+    std::string vertexPath = std::string(SHADER_DIR) + "/postprocess/fullscreen.vert";
+    std::string fragmentPath = std::string(SHADER_DIR) + "/postprocess/composite.frag";
+    Shader* shader = new Shader(vertexPath.c_str(), fragmentPath.c_str(), macros);
+    mCompositeShaders.emplace(effects, shader);
+    return shader;
+}
+
+void PostProcessStack::drawComposite(unsigned int effects, GLuint input, GLuint targetFbo, int width, int height, Stats& stats, bool finalTarget) {
+    Shader* shader = getCompositeShader(effects);
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFbo);
+    glViewport(0, 0, width, height);
+
+    shader->begin();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, input);
+    shader->setInt("sourceTexture", 0);
+
+    size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+    size_t bytes = pixels * (HDR_PIXEL_BYTES + (finalTarget ? LDR_PIXEL_BYTES : HDR_PIXEL_BYTES));
+
+    if (effects & POST_BLOOM) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, mBloomTexture);
+        shader->setInt("bloomTexture", 1);
+        shader->setFloat("bloomIntensity", mSettings.bloomIntensity);
+        bytes += static_cast<size_t>(std::max(1, width / 2)) * static_cast<size_t>(std::max(1, height / 2)) * HDR_PIXEL_BYTES;
+    }
+    if (effects & POST_EXPOSURE) {
+        shader->setFloat("exposure", mSettings.exposure);
+    }
+    if (effects & POST_COLOR_GRADING) {
+        Texture* lut = mSettings.colorGradingLut;
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, lut->getID());
+        shader->setInt("lutTexture", 2);
+        shader->setFloat("lutSize", static_cast<float>(lut->getHeight()));
+    }
+    if (effects & POST_VIGNETTE) {
+        shader->setFloat("vignetteIntensity", mSettings.vignetteIntensity);
+        shader->setFloat("vignetteRadius", mSettings.vignetteRadius);
+    }
+
+    glBindVertexArray(mEmptyVao);
+    RenderStats::add(RenderCounter::DrawCalls);
+    RenderStats::add(RenderCounter::Triangles);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+
+    stats.fullscreenPassCount++;
+    stats.bandwidthBytes += bytes;
+}
+
+void PostProcessStack::drawFxaa(GLuint input, GLuint targetFbo, int width, int height, Stats& stats) {
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFbo);
+    glViewport(0, 0, width, height);
+
+    mFxaaShader->begin();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, input);
+    mFxaaShader->setInt("sourceTexture", 0);
+
+    glBindVertexArray(mEmptyVao);
+    RenderStats::add(RenderCounter::DrawCalls);
+    RenderStats::add(RenderCounter::Triangles);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    stats.fullscreenPassCount++;
+    stats.bandwidthBytes += static_cast<size_t>(width) * static_cast<size_t>(height) * (HDR_PIXEL_BYTES + LDR_PIXEL_BYTES);
+}
+
+void PostProcessStack::apply(GLuint sourceTexture, int width, int height, GLuint targetFbo) {
+    if (width <= 0 || height <= 0 || !ensureTargets(width, height)) {
+        return;
+    }
+    RenderStatsScope statsScope("PostProcess");
+
+    int statsIndex = mFused ? 1 : 0;
+    Stats& stats = mStats[statsIndex];
+    stats = Stats();
+    mTimers[statsIndex]->begin();
+
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_BLEND);
+
+    // 1 没有 LUT 时跳过调色；泛光先生成金字塔
+    unsigned int effects = mSettings.effects;
+    if (mSettings.colorGradingLut == nullptr) {
+        effects &= ~static_cast<unsigned int>(POST_COLOR_GRADING);
+    }
+    if (effects & POST_BLOOM) {
+        renderBloom(sourceTexture, width, height, stats);
+    }
+
+    // 2 逐像素效果：融合时一个 Pass，否则每个效果一个 Pass
+    unsigned int perPixel = effects & PER_PIXEL_MASK;
+    bool fxaa = (effects & POST_FXAA) != 0;
+    std::vector<unsigned int> passes;
+    if (mFused) {
+        if (perPixel != 0 || !fxaa) {
+            passes.push_back(perPixel);     // 没有任何逐像素效果时作为直接复制
+        }
+    }
+    else {
+        for (int i = 0; i < 5; i++) {
+            if (perPixel & PER_PIXEL_EFFECTS[i]) {
+                passes.push_back(PER_PIXEL_EFFECTS[i]);
+            }
+        }
+        if (passes.empty() && !fxaa) {
+            passes.push_back(0);
+        }
+    }
+
+    GLuint input = sourceTexture;
+    int ping = 0;
+    for (size_t i = 0; i < passes.size(); i++) {
+        bool last = (i + 1 == passes.size()) && !fxaa;
+        GLuint target = last ? targetFbo : mPingPongFbos[ping];
+        drawComposite(passes[i], input, target, width, height, stats, last);
+        if (!last) {
+            input = mPingPongTextures[ping];
+            ping ^= 1;
+        }
+    }
+
+    // 3 FXAA 读取最终颜色的邻域
+    if (fxaa) {
+        drawFxaa(input, targetFbo, width, height, stats);
+    }
+
+    // 恢复常用状态
+    glEnable(GL_DEPTH_TEST);
+    glActiveTexture(GL_TEXTURE0);
+
+    mTimers[statsIndex]->end();
+    stats.gpuMs = mTimers[statsIndex]->getLastMs();
+}
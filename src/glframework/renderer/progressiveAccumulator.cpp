@@ -0,0 +1,184 @@
+#include "progressiveAccumulator.h"
+#include "../renderStats.h"
+#include "../redrawTracker.h"
+#include <iostream>
+#include <string>
+#include <algorithm>
+
+ProgressiveAccumulator::ProgressiveAccumulator() {
+    std::string vertexPath = std::string(SHADER_DIR) + "/postprocess/fullscreen.vert";
+    std::string fragmentPath = std::string(SHADER_DIR) + "/postprocess/accumulate.frag";
+    mShader = new Shader(vertexPath.c_str(), fragmentPath.c_str());
+
+    glGenVertexArrays(1, &mEmptyVao);
+}
+
+ProgressiveAccumulator::~ProgressiveAccumulator() {
+    destroyTarget();
+    if (mEmptyVao != 0) {
+        glDeleteVertexArrays(1, &mEmptyVao);
+        mEmptyVao = 0;
+    }
+    delete mShader;
+}
+
+void ProgressiveAccumulator::setEnabled(bool enabled) {
+    if (mEnabled != enabled) {
+        mEnabled = enabled;
+        reset();
+        RedrawTracker::requestFrame();
+    }
+}
+
+void ProgressiveAccumulator::setMaxSamples(int samples) {
+    mMaxSamples = std::max(1, samples);
+    // 调大时继续累积；调小时已有的结果仍然有效，下一帧直接停止
+    if (mSampleCount < mMaxSamples) {
+        RedrawTracker::requestFrame();
+    }
+}
+
+bool ProgressiveAccumulator::ensureTarget(int width, int height) {
+    if (mFbo != 0 && width == mWidth && height == mHeight) {
+        return true;
+    }
+    destroyTarget();
+
+    // 累积 N 帧的平均值，半精度在权重很小时误差明显，用 RGBA32F
+    glGenTextures(1, &mTexture);
+    glBindTexture(GL_TEXTURE_2D, mTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &mFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, mFbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTexture, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR[ProgressiveAccumulator]: 累积目标 FBO 不完整，错误码：" << status << std::endl;
+        destroyTarget();
+        return false;
+    }
+
+    RenderStats::addTextureMemory(static_cast<int64_t>(width) * height * 16);
+    mWidth = width;
+    mHeight = height;
+    return true;
+}
+
+void ProgressiveAccumulator::destroyTarget() {
+    if (mFbo != 0) {
+        glDeleteFramebuffers(1, &mFbo);
+        mFbo = 0;
+    }
+    if (mTexture != 0) {
+        glDeleteTextures(1, &mTexture);
+        mTexture = 0;
+        RenderStats::addTextureMemory(-static_cast<int64_t>(mWidth) * mHeight * 16);
+    }
+    mWidth = 0;
+    mHeight = 0;
+    mSampleCount = 0;
+}
+
+void ProgressiveAccumulator::reset() {
+    mSampleCount = 0;
+}
+
+float ProgressiveAccumulator::halton(int index, int base) {
+    float result = 0.0f;
+    float fraction = 1.0f / static_cast<float>(base);
+    while (index > 0) {
+        result += fraction * static_cast<float>(index % base);
+        index /= base;
+        fraction /= static_cast<float>(base);
+    }
+    return result;
+}
+
+bool ProgressiveAccumulator::beginFrame(Camera* camera, int width, int height) {
+    mFrameActive = false;
+    if (camera == nullptr || width <= 0 || height <= 0 || !ensureTarget(width, height)) {
+        return true;
+    }
+
+    // 1 画面是否变化：相机矩阵在清除抖动后比较，动画直接修改相机时也能发现
+    camera->mJitter = glm::vec2(0.0f);
+    glm::mat4 view = camera->getViewMatrix();
+    glm::mat4 projection = camera->getProjectionMatrix();
+    uint64_t generation = RedrawTracker::getGeneration();
+    if (generation != mGeneration || view != mViewMatrix || projection != mProjectionMatrix) {
+        mGeneration = generation;
+        mViewMatrix = view;
+        mProjectionMatrix = projection;
+        reset();
+    }
+
+    // 2 关闭时每帧都是第 0 帧（权重 1，直接覆盖）
+    if (!mEnabled) {
+        reset();
+    }
+    else if (mSampleCount >= mMaxSamples) {
+        return false;
+    }
+
+    // 3 第 0 帧不抖动；之后偏移 [-0.5, 0.5) 个像素，换算到 NDC
+    if (mSampleCount > 0) {
+        glm::vec2 offset(halton(mSampleCount, 2) - 0.5f, halton(mSampleCount, 3) - 0.5f);
+        camera->mJitter = glm::vec2(2.0f * offset.x / static_cast<float>(width), 2.0f * offset.y / static_cast<float>(height));
+    }
+    mCamera = camera;
+    mFrameActive = true;
+    return true;
+}
+
+void ProgressiveAccumulator::accumulate(GLuint sourceTexture, glm::vec2 uvScale) {
+    if (!mFrameActive) {
+        return;
+    }
+    mFrameActive = false;
+    mCamera->mJitter = glm::vec2(0.0f);
+    mCamera = nullptr;
+
+    RenderStatsScope statsScope("Accumulate");
+    glBindFramebuffer(GL_FRAMEBUFFER, mFbo);
+    glViewport(0, 0, mWidth, mHeight);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_CULL_FACE);
+
+    // 累积值 = 新值 * w + 累积值 * (1 - w)，w = 1 / (n + 1)；第 0 帧 w = 1，不需要先清空
+    float weight = 1.0f / static_cast<float>(mSampleCount + 1);
+    glEnable(GL_BLEND);
+    glBlendColor(0.0f, 0.0f, 0.0f, weight);
+    glBlendFuncSeparate(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA, GL_ONE, GL_ZERO);
+
+    mShader->begin();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, sourceTexture);
+    mShader->setInt("sourceTexture", 0);
+    mShader->setVector2("uvScale", uvScale);
+
+    glBindVertexArray(mEmptyVao);
+    RenderStats::add(RenderCounter::DrawCalls);
+    RenderStats::add(RenderCounter::Triangles);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    mShader->end();
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // 没有累积满：按需重绘模式下继续画下一帧
+    mSampleCount++;
+    if (mEnabled && mSampleCount < mMaxSamples) {
+        RedrawTracker::requestFrame();
+    }
+}
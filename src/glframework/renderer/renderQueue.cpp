@@ -0,0 +1,250 @@
+#include "renderQueue.h"
+#include "../transformStorage.h"
+#include "../tools/jobSystem.h"
+#include "../tools/profiler.h"
+#include <algorithm>
+#include <chrono>
+
+RenderQueue::RenderQueue() {}
+
+RenderQueue::~RenderQueue() {}
+
+void RenderQueue::build(Scene* scene, Camera* camera) {
+    PROFILE_SCOPE("RenderQueue::build");
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // 世界矩阵必须在分发给工作线程之前更新完，之后各线程只读
+    {
+        PROFILE_SCOPE("TransformStorage::update");
+        TransformStorage::update();
+    }
+
+    // 1 准备本帧相机数据：视锥平面（Gribb-Hartmann 方法，从 VP 矩阵的行中提取）
+    mViewMatrix = camera->getViewMatrix();
+    mFar = camera->mFar > 0.0f ? camera->mFar : 1.0f;
+    glm::mat4 viewProjection = camera->getProjectionMatrix() * mViewMatrix;
+    glm::mat4 rows = glm::transpose(viewProjection);
+    mFrustumPlanes[0] = rows[3] + rows[0];  // 左
+    mFrustumPlanes[1] = rows[3] - rows[0];  // 右
+    mFrustumPlanes[2] = rows[3] + rows[1];  // 下
+    mFrustumPlanes[3] = rows[3] - rows[1];  // 上
+    mFrustumPlanes[4] = rows[3] + rows[2];  // 近
+    mFrustumPlanes[5] = rows[3] - rows[2];  // 远
+
+    // 2 每个线程一份缓冲区（按线程编号索引，主线程与渲染线程的编号也不同），清空但保留容量
+    size_t threadCount = JobSystem::getWorkerCount() + 1;
+    if (mThreadBuffers.size() != JobSystem::getThreadCount()) {
+        mThreadBuffers.resize(JobSystem::getThreadCount());
+    }
+    for (auto& buffer : mThreadBuffers) {
+        buffer.opaque.clear();
+        buffer.transparent.clear();
+        buffer.visited = 0;
+        buffer.culled = 0;
+    }
+
+    // 3 剔除并并行生成渲染包
+    bool useBVH = mFrustumCulling && mUseBVH;
+    if (useBVH) {
+        PROFILE_SCOPE("RenderQueue::cullBVH");
+        // BVH 层次剔除：代价与可见部分相关，而不是与场景中的物体总数成正比
+        mSceneBVH.update(scene);
+        mVisibleMeshes.clear();
+        mSceneBVH.queryFrustum(mFrustumPlanes, mVisibleMeshes);
+        const auto& unbounded = mSceneBVH.getUnboundedMeshes();
+        mVisibleMeshes.insert(mVisibleMeshes.end(), unbounded.begin(), unbounded.end());
+
+        JobSystem::parallelFor(mVisibleMeshes.size(), mMinBatch * 16, [this](size_t begin, size_t end) {
+            ThreadBuffer& buffer = mThreadBuffers[JobSystem::getThreadIndex()];
+            for (size_t i = begin; i < end; i++) {
+                processMesh(mVisibleMeshes[i], buffer, false);
+            }
+        });
+    }
+    else {
+        PROFILE_SCOPE("RenderQueue::traverse");
+        collectTasks(scene, threadCount);
+        JobSystem::parallelFor(mTasks.size(), mMinBatch, [this](size_t begin, size_t end) {
+            ThreadBuffer& buffer = mThreadBuffers[JobSystem::getThreadIndex()];
+            for (size_t i = begin; i < end; i++) {
+                processTask(mTasks[i], buffer);
+            }
+        });
+    }
+
+    // 4 合并各线程的结果到本帧的 FrameArena 中并排序
+    size_t opaqueCount = 0;
+    size_t transparentCount = 0;
+    mVisitedCount = 0;
+    mCulledCount = 0;
+    for (auto& buffer : mThreadBuffers) {
+        opaqueCount += buffer.opaque.size();
+        transparentCount += buffer.transparent.size();
+        mVisitedCount += buffer.visited;
+        mCulledCount += buffer.culled;
+    }
+    if (useBVH) {
+        // BVH 模式下：访问数为 BVH 节点数，剔除数为未通过查询的 Mesh 数
+        mVisitedCount = mSceneBVH.getLastVisitedNodes();
+        mCulledCount = mSceneBVH.getMeshCount() + mSceneBVH.getUnboundedMeshes().size() - mVisibleMeshes.size();
+    }
+
+    mFrameArena.reset();
+    RenderPacket* opaque = mFrameArena.allocateArray<RenderPacket>(opaqueCount);
+    RenderPacket* transparent = mFrameArena.allocateArray<RenderPacket>(transparentCount);
+    size_t opaqueOffset = 0;
+    size_t transparentOffset = 0;
+    for (auto& buffer : mThreadBuffers) {
+        std::copy(buffer.opaque.begin(), buffer.opaque.end(), opaque + opaqueOffset);
+        std::copy(buffer.transparent.begin(), buffer.transparent.end(), transparent + transparentOffset);
+        opaqueOffset += buffer.opaque.size();
+        transparentOffset += buffer.transparent.size();
+    }
+
+    auto compare = [](const RenderPacket& a, const RenderPacket& b) {
+        return a.sortKey < b.sortKey;
+    };
+    {
+        PROFILE_SCOPE("RenderQueue::sort");
+        std::sort(opaque, opaque + opaqueCount, compare);
+        if (mSortTransparent) {
+            std::sort(transparent, transparent + transparentCount, compare);
+        }
+    }
+    mOpaquePackets = ArrayView<RenderPacket>(opaque, opaqueCount);
+    mTransparentPackets = ArrayView<RenderPacket>(transparent, transparentCount);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    mBuildTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+void RenderQueue::collectTasks(Scene* scene, size_t threadCount) {
+    mTasks.clear();
+    mFrontier.clear();
+    mFrontier.push_back(scene);
+
+    // 逐层展开根部，直到子树数量足够分给所有线程（展开过的节点只处理自身）
+    size_t wanted = threadCount * 16;
+    for (int depth = 0; depth < 8 && mFrontier.size() < wanted; depth++) {
+        mNextFrontier.clear();
+        for (auto node : mFrontier) {
+            mTasks.push_back({ node, false });
+            const auto& children = node->getChildren();
+            mNextFrontier.insert(mNextFrontier.end(), children.begin(), children.end());
+        }
+        mFrontier.swap(mNextFrontier);
+        if (mFrontier.empty()) {
+            return;
+        }
+    }
+
+    for (auto node : mFrontier) {
+        mTasks.push_back({ node, true });
+    }
+}
+
+void RenderQueue::processTask(const TraverseTask& task, ThreadBuffer& buffer) {
+    if (!task.recursive) {
+        processNode(task.node, buffer);
+        return;
+    }
+
+    // 深度优先遍历子树（显式栈，避免递归）
+    auto& stack = buffer.stack;
+    stack.clear();
+    stack.push_back(task.node);
+    while (!stack.empty()) {
+        Object* node = stack.back();
+        stack.pop_back();
+        processNode(node, buffer);
+
+        const auto& children = node->getChildren();
+        stack.insert(stack.end(), children.rbegin(), children.rend());
+    }
+}
+
+void RenderQueue::processNode(Object* node, ThreadBuffer& buffer) {
+    buffer.visited++;
+    if (node->getType() != ObjectType::Mesh) {
+        return;
+    }
+
+    processMesh(static_cast<Mesh*>(node), buffer, mFrustumCulling);
+}
+
+void RenderQueue::processMesh(Mesh* mesh, ThreadBuffer& buffer, bool cull) {
+    if (mesh->mGeometry == nullptr || mesh->mMaterial == nullptr) {
+        return;
+    }
+
+    glm::mat4 modelMatrix = mesh->getModelMatrx();
+    if (cull && !isVisible(mesh->mGeometry, modelMatrix)) {
+        buffer.culled++;
+        return;
+    }
+
+    RenderPacket packet;
+    packet.modelMatrix = modelMatrix;
+    packet.normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
+    packet.material = mesh->mMaterial;
+    packet.geometry = mesh->mGeometry;
+    packet.name = &mesh->getName();
+    packet.transformHandle = mesh->getTransformHandle();
+    packet.triangleCount = static_cast<uint32_t>(mesh->mGeometry->getIndicesCount() / 3);
+
+    // 以物体原点在相机空间的深度作为排序依据（与原透明排序一致）
+    glm::vec4 viewPosition = mViewMatrix * modelMatrix[3];
+    packet.viewDepth = -viewPosition.z;
+
+    bool transparent = packet.material->mBlend;
+    packet.sortKey = makeSortKey(packet.material, packet.viewDepth, transparent);
+    if (transparent) {
+        buffer.transparent.push_back(packet);
+    }
+    else {
+        buffer.opaque.push_back(packet);
+    }
+}
+
+bool RenderQueue::isVisible(const Geometry* geometry, const glm::mat4& modelMatrix) const {
+    if (!geometry->hasBounds()) {
+        return true;
+    }
+
+    // 局部包围盒变换到世界空间：中心点直接变换，半长取矩阵绝对值后变换
+    glm::vec3 localCenter = (geometry->getBoundsMin() + geometry->getBoundsMax()) * 0.5f;
+    glm::vec3 localExtent = (geometry->getBoundsMax() - geometry->getBoundsMin()) * 0.5f;
+    glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(localCenter, 1.0f));
+    glm::mat3 absMatrix = glm::mat3(modelMatrix);
+    for (int c = 0; c < 3; c++) {
+        absMatrix[c] = glm::abs(absMatrix[c]);
+    }
+    glm::vec3 extent = absMatrix * localExtent;
+
+    for (int i = 0; i < 6; i++) {
+        const glm::vec4& plane = mFrustumPlanes[i];
+        glm::vec3 normal(plane);
+        float distance = glm::dot(normal, center) + plane.w;
+        float radius = glm::dot(glm::abs(normal), extent);
+        if (distance + radius < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t RenderQueue::makeSortKey(const Material* material, float viewDepth, bool transparent) const {
+    // 深度量化为 24 位
+    float normalizedDepth = glm::clamp(viewDepth / mFar, 0.0f, 1.0f);
+    uint64_t depth = static_cast<uint64_t>(normalizedDepth * 16777215.0f);
+
+    if (transparent) {
+        // 透明物体：由远到近
+        return 16777215ull - depth;
+    }
+
+    // 不透明物体：先按材质类型（决定 shader）、再按材质分组以减少状态切换，组内由近到远
+    uint64_t shaderBits = static_cast<uint64_t>(material->mType) & 0xFFFFull;
+    uint64_t materialBits = (reinterpret_cast<uintptr_t>(material) >> 4) & 0xFFFFFFull;
+    return (shaderBits << 48) | (materialBits << 24) | depth;
+}
@@ -0,0 +1,328 @@
+#include "renderTargetPool.h"
+#include "../renderStats.h"
+#include <iostream>
+#include <algorithm>
+
+// 内部格式对应的上传格式与类型（创建空纹理时 glTexImage2D 需要合法的组合）
+static void getUploadFormat(GLenum internalFormat, GLenum& format, GLenum& type) {
+    switch (internalFormat) {
+    case GL_DEPTH_COMPONENT16:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32:
+        format = GL_DEPTH_COMPONENT;
+        type = GL_UNSIGNED_INT;
+        break;
+    case GL_DEPTH_COMPONENT32F:
+        format = GL_DEPTH_COMPONENT;
+        type = GL_FLOAT;
+        break;
+    case GL_DEPTH24_STENCIL8:
+        format = GL_DEPTH_STENCIL;
+        type = GL_UNSIGNED_INT_24_8;
+        break;
+    case GL_DEPTH32F_STENCIL8:
+        format = GL_DEPTH_STENCIL;
+        type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+        break;
+    case GL_R8:
+    case GL_R16F:
+    case GL_R32F:
+        format = GL_RED;
+        type = GL_FLOAT;
+        break;
+    case GL_RG8:
+    case GL_RG16F:
+    case GL_RG32F:
+        format = GL_RG;
+        type = GL_FLOAT;
+        break;
+    case GL_RGB8:
+    case GL_RGB16F:
+    case GL_RGB32F:
+    case GL_R11F_G11F_B10F:
+        format = GL_RGB;
+        type = GL_FLOAT;
+        break;
+    default:
+        format = GL_RGBA;
+        type = GL_FLOAT;
+        break;
+    }
+}
+
+RenderTargetPool::RenderTargetPool() {}
+
+RenderTargetPool::~RenderTargetPool() {
+    clear();
+}
+
+bool RenderTargetPool::isDepthFormat(GLenum internalFormat) {
+    switch (internalFormat) {
+    case GL_DEPTH_COMPONENT16:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32:
+    case GL_DEPTH_COMPONENT32F:
+    case GL_DEPTH24_STENCIL8:
+    case GL_DEPTH32F_STENCIL8:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool RenderTargetPool::hasStencil(GLenum internalFormat) {
+    return internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+}
+
+size_t RenderTargetPool::getMemoryBytes(const RenderTargetDesc& desc) {
+    size_t bytesPerPixel = 4;
+    switch (desc.internalFormat) {
+    case GL_R8:
+        bytesPerPixel = 1;
+        break;
+    case GL_RG8:
+    case GL_R16F:
+    case GL_DEPTH_COMPONENT16:
+        bytesPerPixel = 2;
+        break;
+    case GL_RGB8:
+        bytesPerPixel = 3;
+        break;
+    case GL_RG16F:
+    case GL_R32F:
+        bytesPerPixel = 4;
+        break;
+    case GL_RGB16F:
+        bytesPerPixel = 6;
+        break;
+    case GL_RGBA16F:
+    case GL_RG32F:
+    case GL_DEPTH32F_STENCIL8:
+        bytesPerPixel = 8;
+        break;
+    case GL_RGB32F:
+        bytesPerPixel = 12;
+        break;
+    case GL_RGBA32F:
+        bytesPerPixel = 16;
+        break;
+    default:
+        break;
+    }
+    return static_cast<size_t>(desc.width) * static_cast<size_t>(desc.height) * bytesPerPixel;
+}
+
+void RenderTargetPool::beginFrame() {
+    mFrame++;
+}
+
+GLuint RenderTargetPool::createObject(const RenderTargetDesc& desc) {
+    GLuint object = 0;
+    if (desc.renderbuffer) {
+        glGenRenderbuffers(1, &object);
+        glBindRenderbuffer(GL_RENDERBUFFER, object);
+        glRenderbufferStorage(GL_RENDERBUFFER, desc.internalFormat, desc.width, desc.height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+    else {
+        GLenum format = GL_RGBA;
+        GLenum type = GL_FLOAT;
+        getUploadFormat(desc.internalFormat, format, type);
+
+        glGenTextures(1, &object);
+        glBindTexture(GL_TEXTURE_2D, object);
+        glTexImage2D(GL_TEXTURE_2D, 0, desc.internalFormat, desc.width, desc.height, 0, format, type, nullptr);
+        // 后处理常用双线性采样；深度纹理用最近点
+        GLint filter = isDepthFormat(desc.internalFormat) ? GL_NEAREST : GL_LINEAR;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    mCreatedCount++;
+    RenderStats::addTextureMemory(static_cast<int64_t>(getMemoryBytes(desc)));
+    return object;
+}
+
+GLuint RenderTargetPool::acquire(const RenderTargetDesc& desc) {
+    if (desc.width <= 0 || desc.height <= 0) {
+        return 0;
+    }
+
+    // 1 复用描述相同的空闲对象
+    for (auto& entry : mEntries) {
+        if (!entry.inUse && entry.desc == desc) {
+            entry.inUse = true;
+            entry.lastUsedFrame = mFrame;
+            return entry.object;
+        }
+    }
+
+    // 2 没有可复用的对象才创建
+    Entry entry;
+    entry.desc = desc;
+    entry.object = createObject(desc);
+    entry.inUse = true;
+    entry.lastUsedFrame = mFrame;
+    if (entry.object == 0) {
+        std::cerr << "ERROR[RenderTargetPool]: 渲染目标创建失败" << std::endl;
+        return 0;
+    }
+    mEntries.push_back(entry);
+    return entry.object;
+}
+
+void RenderTargetPool::release(GLuint object) {
+    for (auto& entry : mEntries) {
+        if (entry.object == object) {
+            entry.inUse = false;
+            entry.lastUsedFrame = mFrame;
+            return;
+        }
+    }
+}
+
+const RenderTargetPool::Entry* RenderTargetPool::findEntry(GLuint object) const {
+    for (const auto& entry : mEntries) {
+        if (entry.object == object) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+GLuint RenderTargetPool::getFramebuffer(const std::vector<GLuint>& colors, GLuint depth) {
+    for (const auto& framebuffer : mFramebuffers) {
+        if (framebuffer.colors == colors && framebuffer.depth == depth) {
+            return framebuffer.fbo;
+        }
+    }
+
+    Framebuffer framebuffer;
+    framebuffer.colors = colors;
+    framebuffer.depth = depth;
+    glGenFramebuffers(1, &framebuffer.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.fbo);
+
+    // 颜色附件按顺序挂到 GL_COLOR_ATTACHMENTi
+    std::vector<GLenum> drawBuffers;
+    for (size_t i = 0; i < colors.size(); i++) {
+        GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+        const Entry* entry = findEntry(colors[i]);
+        if (entry != nullptr && entry->desc.renderbuffer) {
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, colors[i]);
+        }
+        else {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, colors[i], 0);
+        }
+        drawBuffers.push_back(attachment);
+    }
+    if (drawBuffers.empty()) {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+    else {
+        glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    }
+
+    // 深度附件：带模板的格式挂到深度模板附件点
+    if (depth != 0) {
+        const Entry* entry = findEntry(depth);
+        bool stencil = entry != nullptr && hasStencil(entry->desc.internalFormat);
+        GLenum attachment = stencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        if (entry != nullptr && entry->desc.renderbuffer) {
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, depth);
+        }
+        else {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, depth, 0);
+        }
+    }
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR[RenderTargetPool]: FBO 不完整，错误码：" << status << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    mFramebuffers.push_back(framebuffer);
+    return framebuffer.fbo;
+}
+
+void RenderTargetPool::destroyEntry(size_t index) {
+    GLuint object = mEntries[index].object;
+
+    // 先删除引用了该对象的 FBO
+    for (size_t i = 0; i < mFramebuffers.size();) {
+        const Framebuffer& framebuffer = mFramebuffers[i];
+        bool uses = framebuffer.depth == object ||
+            std::find(framebuffer.colors.begin(), framebuffer.colors.end(), object) != framebuffer.colors.end();
+        if (uses) {
+            glDeleteFramebuffers(1, &mFramebuffers[i].fbo);
+            mFramebuffers[i] = mFramebuffers.back();
+            mFramebuffers.pop_back();
+        }
+        else {
+            i++;
+        }
+    }
+
+    RenderStats::addTextureMemory(-static_cast<int64_t>(getMemoryBytes(mEntries[index].desc)));
+    if (mEntries[index].desc.renderbuffer) {
+        glDeleteRenderbuffers(1, &object);
+    }
+    else {
+        glDeleteTextures(1, &object);
+    }
+    mEntries[index] = mEntries.back();
+    mEntries.pop_back();
+}
+
+void RenderTargetPool::trim(int maxIdleFrames) {
+    for (size_t i = 0; i < mEntries.size();) {
+        const Entry& entry = mEntries[i];
+        if (!entry.inUse && mFrame - entry.lastUsedFrame > static_cast<uint64_t>(maxIdleFrames)) {
+            destroyEntry(i);
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+void RenderTargetPool::purgeBackbufferRelative() {
+    for (size_t i = 0; i < mEntries.size();) {
+        const Entry& entry = mEntries[i];
+        if (!entry.inUse && entry.desc.backbufferRelative) {
+            destroyEntry(i);
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+void RenderTargetPool::clear() {
+    for (auto& framebuffer : mFramebuffers) {
+        glDeleteFramebuffers(1, &framebuffer.fbo);
+    }
+    mFramebuffers.clear();
+    for (auto& entry : mEntries) {
+        RenderStats::addTextureMemory(-static_cast<int64_t>(getMemoryBytes(entry.desc)));
+        if (entry.desc.renderbuffer) {
+            glDeleteRenderbuffers(1, &entry.object);
+        }
+        else {
+            glDeleteTextures(1, &entry.object);
+        }
+    }
+    mEntries.clear();
+}
+
+size_t RenderTargetPool::getMemoryBytes() const {
+    size_t bytes = 0;
+    for (const auto& entry : mEntries) {
+        bytes += getMemoryBytes(entry.desc);
+    }
+    return bytes;
+}
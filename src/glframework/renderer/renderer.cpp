@@ -3,10 +3,14 @@
 #include "../material/whiteMaterial.h"
 #include "../material/PBRMaterial.h"
 #include "../material/screenMaterial.h"
+#include "../renderStats.h"
+#include "../tools/profiler.h"
+#include "../../wrapper/glDebug.h"
 
 #include<iostream>
 #include <string>
 #include <algorithm>
+#include <chrono>
 
 Renderer::Renderer(){}
 
@@ -14,17 +18,18 @@ Renderer::Renderer(){}
 // δЧ·shadernullptr״̬
 Renderer::Renderer(const std::string& phongVertexPath, const std::string& phongFragmentPath,
     const std::string& whiteVertexPath, const std::string& whiteFragmentPath,
-    const std::string& pbrVertexPath, const std::string& pbrFragmentPath)
+    const std::string& pbrVertexPath, const std::string& pbrFragmentPath,
+    const std::vector<ShaderMacro>& macros)
 {
     // ֻеƬ·ЧʱŴӦshader
     if (!phongVertexPath.empty() && !phongFragmentPath.empty()) {
-        mPhongShader = new Shader(phongVertexPath.c_str(), phongFragmentPath.c_str());
+        mPhongShader = new Shader(phongVertexPath.c_str(), phongFragmentPath.c_str(), macros);
     }
     if (!whiteVertexPath.empty() && !whiteFragmentPath.empty()) {
-        mWhiteShader = new Shader(whiteVertexPath.c_str(), whiteFragmentPath.c_str());
+        mWhiteShader = new Shader(whiteVertexPath.c_str(), whiteFragmentPath.c_str(), macros);
     }
     if (!pbrVertexPath.empty() && !pbrFragmentPath.empty()) {
-        mPBRShader = new Shader(pbrVertexPath.c_str(), pbrFragmentPath.c_str());
+        mPBRShader = new Shader(pbrVertexPath.c_str(), pbrFragmentPath.c_str(), macros);
     }
 }
 
@@ -40,6 +45,14 @@ Renderer::Renderer(const std::string& vertexshaderPath, const std::string& fragm
 
 Renderer::~Renderer()
 {
+    for (auto timer : mTransparencyTimers) {
+        delete timer;
+    }
+    delete mOverdraw;
+    delete mDepthPrepass;
+    delete mOIT;
+    delete mPeeling;
+    delete mPerDrawBuffer;
     delete mPBRShader;
     delete mWhiteShader;
     delete mPhongShader;
@@ -69,12 +82,251 @@ Shader* Renderer::pickShader(MaterialType type) {
     return result;
 }
 
+Shader* Renderer::passShader(Shader* base) {
+    if (base == nullptr) {
+        return nullptr;
+    }
+
+    // ȻƵԣлƸüɫ״ֲ̬
+    if (mOverdrawActive) {
+        return mOverdraw->getShader();
+    }
+
+    // һʹʱ룺fragmentOutput.glsl ݺΪ OIT ۻֵȰĿ
+    switch (mTransparentPass) {
+    case TransparentPass::WeightedBlended:
+        return base->getVariant("OIT_PASS", "oitRevealage");
+    case TransparentPass::DepthPeel:
+        return base->getVariant("DEPTH_PEEL_PASS", "peelBackColor");
+    default:
+        return base;
+    }
+}
+
+void Renderer::setTransparencyMode(TransparencyMode mode) {
+    mTransparencyMode = mode;
+    // OIT Ȱ붼˳޹أ͸Ⱦ
+    mRenderQueue.setSortTransparent(mode == TransparencyMode::Sorted);
+}
+
+void Renderer::beginPerDrawFrame() {
+    // λҪЧOpenGLģڵһȾʱ
+    // ÿ 4MB 256 ֽڶԼ 16000 λ
+    // дʱ֡ڻһһ֡ʼʱ
+    if (mPerDrawBuffer == nullptr) {
+        mPerDrawBuffer = new UniformRingBuffer(4 * 1024 * 1024, 3);
+    }
+
+    // λ֡RenderStats ֡ţApplication / Ⱦ߳ڽƽл
+    // ͬһ֡ڵĶ render糡 pass Ļ passͬһм䣻
+    // һ֡ fence һ֡һ render ʱ룬λһ֡ȫ֮
+    uint64_t frameIndex = RenderStats::getFrameIndex();
+    if (!mPerDrawFrameStarted || frameIndex != mPerDrawFrameIndex) {
+        mPerDrawBuffer->endFrame();
+        mPerDrawBuffer->beginFrame();
+        mPerDrawFrameIndex = frameIndex;
+        mPerDrawFrameStarted = true;
+    }
+
+    // ÿ֡ uniform ʳļ¼ֻڱ render Чʲ render ֮ı䣩
+    mFrameShaders.clear();
+    mShaderMaterials.clear();
+}
+
+bool Renderer::isMaterialBound(Shader* shader, const Material* material) {
+    for (auto& bound : mShaderMaterials) {
+        if (bound.first == shader) {
+            if (bound.second == material) {
+                return true;
+            }
+            bound.second = material;
+            return false;
+        }
+    }
+    mShaderMaterials.emplace_back(shader, material);
+    return false;
+}
+
+// PBR ͼ󶨵ԵԪԪȫ״̬ÿλƶҪ󶨣
+static void bindPBRMaps(const PBRMaterial* material) {
+    Texture* maps[] = { material->mAlbedoMap, material->mNormalMap, material->mMetallicMap, material->mRoughnessMap, material->mAoMap };
+    for (Texture* map : maps) {
+        if (map != nullptr) {
+            map->bind();
+        }
+    }
+}
+
+// PBR ͼڵԪ
+static void setPBRMapUniforms(Shader* shader, const PBRMaterial* material) {
+    shader->setBool("useAlbedoMap", material->mAlbedoMap != nullptr);
+    if (material->mAlbedoMap != nullptr) {
+        shader->setInt("albedoMap", material->mAlbedoMap->getUnit());
+    }
+    shader->setBool("useNormalMap", material->mNormalMap != nullptr);
+    if (material->mNormalMap != nullptr) {
+        shader->setInt("normalMap", material->mNormalMap->getUnit());
+    }
+    shader->setBool("useMetallicMap", material->mMetallicMap != nullptr);
+    if (material->mMetallicMap != nullptr) {
+        shader->setInt("metallicMap", material->mMetallicMap->getUnit());
+    }
+    shader->setBool("useRoughnessMap", material->mRoughnessMap != nullptr);
+    if (material->mRoughnessMap != nullptr) {
+        shader->setInt("roughnessMap", material->mRoughnessMap->getUnit());
+    }
+    shader->setBool("useAoMap", material->mAoMap != nullptr);
+    if (material->mAoMap != nullptr) {
+        shader->setInt("aoMap", material->mAoMap->getUnit());
+    }
+    shader->setVector3("albedo", glm::vec3(0.5f));  // ģɫ
+}
+
+// ͸ PBR PerDraw ݿҲһݣƬɫ uniform ȡã
+static void setMaterialScalarUniforms(Shader* shader, const Material* material) {
+    shader->setFloat("opacity", material->mOpacity);    // ͸
+    if (material->mType == MaterialType::PBRMaterial) {
+        const PBRMaterial* PBRMat = static_cast<const PBRMaterial*>(material);
+        shader->setFloat("metallic", PBRMat->getMetallic());    // ȣ0=ǽ1=
+        shader->setFloat("roughness", PBRMat->getRoughness());   // ֲڶȣ0=⻬1=ֲڣ
+        shader->setFloat("ao", PBRMat->getAo());    // ڱ
+    }
+}
+
+bool Renderer::isFirstUseInFrame(Shader* shader) {
+    if (std::find(mFrameShaders.begin(), mFrameShaders.end(), shader) != mFrameShaders.end()) {
+        return false;
+    }
+    mFrameShaders.push_back(shader);
+    return true;
+}
+
+void Renderer::setPerDrawData(Shader* shader, const Material* material, const glm::mat4& modelMatrix, const glm::mat3& normalMatrix) {
+    if (shader->hasPerDrawBlock()) {
+        PerDrawData data;
+        data.modelMatrix = modelMatrix;
+        data.normalMatrix = glm::mat4(normalMatrix);
+        data.material = glm::vec4(material->mOpacity, 0.0f, 1.0f, 1.0f);
+        if (material->mType == MaterialType::PBRMaterial) {
+            const PBRMaterial* PBRMat = static_cast<const PBRMaterial*>(material);
+            data.material.y = PBRMat->getMetallic();
+            data.material.z = PBRMat->getRoughness();
+            data.material.w = PBRMat->getAo();
+        }
+
+        // дһΣƫư󶨣ÿλֻʣ glBindBufferRange һ
+        // дʱλỻһֻڵ÷© beginPerDrawFrame ʱʧ
+        size_t offset = 0;
+        if (mPerDrawBuffer != nullptr && mPerDrawBuffer->push(&data, sizeof(PerDrawData), offset)) {
+            mPerDrawBuffer->bindRange(PER_DRAW_BLOCK_BINDING, offset, sizeof(PerDrawData));
+        }
+        else {
+            std::cerr << "ERROR[Renderer]: ÿλƵд뻷λʧ" << std::endl;
+        }
+        return;
+    }
+
+    // û PerDraw ݿ shaderԶľ shaderuniform
+    shader->setMatrix4x4("ModelMatrix", modelMatrix);	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
+    shader->setMatrix3x3("normalMatrix", normalMatrix);
+}
+
+void Renderer::drawGeometry(Geometry* geometry, const Material* material, const glm::mat4& modelMatrix, Camera* camera) {
+    // ֻҪ˳OIT Ȱ˳޹
+    size_t offset = 0;
+    if (mUseSortedIndices && material->mBlend && mTransparentPass == TransparentPass::Forward && geometry->hasSortedIndexOrders()) {
+        // ֲռָΧĵķ
+        glm::vec3 center = (geometry->getBoundsMin() + geometry->getBoundsMax()) * 0.5f;
+        glm::vec3 localCamera = glm::vec3(glm::inverse(modelMatrix) * glm::vec4(camera->mPosition, 1.0f));
+        glm::vec3 direction = center - localCamera;
+        if (glm::dot(direction, direction) > 1e-12f) {
+            offset = geometry->pickSortedIndexOffset(glm::normalize(direction));
+        }
+    }
+
+    glBindVertexArray(geometry->getVAO());
+    RenderStats::add(RenderCounter::DrawCalls);
+    RenderStats::add(RenderCounter::Triangles, geometry->getIndicesCount() / 3);
+    glDrawElements(GL_TRIANGLES, geometry->getIndicesCount(), GL_UNSIGNED_INT, reinterpret_cast<const void*>(offset));
+}
+
+bool Renderer::renderDepthPrepass(unsigned int fbo, Camera* camera, size_t count, const std::function<void(size_t)>& drawDepth) {
+    mDepthPrepassActive = false;
+    if (mDepthPrepass == nullptr) {
+        if (mDepthPrepassMode == DepthPrepassMode::Off) {
+            return false;
+        }
+        mDepthPrepass = new DepthPrepass();
+    }
+    mDepthPrepass->setMode(mDepthPrepassMode);
+    // ͬһʱֻһڵѯ Mesh ʱͣԤȵĲѯ
+    mDepthPrepass->setQueriesSuspended(mOverdrawActive);
+
+    if (mDepthPrepass->beginFrame()) {
+        RenderStatsScope statsScope("DepthPrepass");
+        PROFILE_GPU_SCOPE("DepthPrepass");
+        GL_DEBUG_GROUP("DepthPrepass");
+        mDepthPrepass->beginPrepass(camera);
+        for (size_t i = 0; i < count; i++) {
+            drawDepth(i);
+        }
+        mDepthPrepass->endPrepass();
+
+        if (mDepthPrepassCallback) {
+            mDepthPrepassCallback(fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        }
+        mDepthPrepassActive = true;
+    }
+
+    mDepthPrepass->beginOpaque();
+    return mDepthPrepassActive;
+}
+
+void Renderer::endOpaquePass() {
+    if (mDepthPrepass != nullptr) {
+        mDepthPrepass->endOpaque();
+    }
+    mDepthPrepassActive = false;
+}
+
+void Renderer::drawDepthOnly(Geometry* geometry, Material* material, const glm::mat4& modelMatrix) {
+    setPolygonOffsetState(material);
+    setFaceCullingState(material);
+    setPerDrawData(mDepthPrepass->getShader(), material, modelMatrix, glm::mat3(1.0f));
+
+    glBindVertexArray(geometry->getDepthVAO());
+    RenderStats::add(RenderCounter::DrawCalls);
+    RenderStats::add(RenderCounter::Triangles, geometry->getIndicesCount() / 3);
+    glDrawElements(GL_TRIANGLES, geometry->getIndicesCount(), GL_UNSIGNED_INT, nullptr);
+}
+
+void Renderer::beginOverdrawFrame() {
+    mOverdrawActive = mOverdrawDebug;
+    if (!mOverdrawActive) {
+        return;
+    }
+    if (mOverdraw == nullptr) {
+        mOverdraw = new OverdrawVisualizer();
+    }
+    mOverdraw->beginFrame();
+}
+
+void Renderer::endOverdrawFrame(unsigned int fbo) {
+    if (!mOverdrawActive) {
+        return;
+    }
+    mOverdraw->endFrame(fbo);
+    mOverdrawActive = false;
+}
+
 void Renderer::setClearColor(glm::vec3 color) {
     glClearColor(color.r, color.g, color.b, 1.0);
 }
 
 
 void Renderer::setDepthState(Material* material) {
+    RenderStats::add(RenderCounter::StateChanges);
     // Ȳ״̬
     if (material->mDepthTest) {
         glEnable(GL_DEPTH_TEST);
@@ -92,6 +344,7 @@ void Renderer::setDepthState(Material* material) {
     }
 }
 void Renderer::setPolygonOffsetState(Material* material) {
+    RenderStats::add(RenderCounter::StateChanges);
     // polygonOffset
     if (material->mPolygonOffset) {
         glEnable(material->mPolygonOffsetType);
@@ -107,6 +360,7 @@ void Renderer::setPolygonOffsetState(Material* material) {
 
 
 void Renderer::setStencilState(Material* material) {
+    RenderStats::add(RenderCounter::StateChanges);
     if (material->mStencilTest) {
         glEnable(GL_STENCIL_TEST);
         //unsigned int mSFail{ GL_KEEP };     // ģʧô
@@ -129,6 +383,7 @@ void Renderer::setStencilState(Material* material) {
 }
 
 void Renderer::setBlenderState(Material* material) {
+    RenderStats::add(RenderCounter::StateChanges);
     if (material->mBlend) {
         glEnable(GL_BLEND);
         glBlendFunc(material->mBlendSFactor, material->mBlendDFactor);
@@ -139,6 +394,7 @@ void Renderer::setBlenderState(Material* material) {
 }
 
 void Renderer::setFaceCullingState(Material* material) {
+    RenderStats::add(RenderCounter::StateChanges);
     if(material->mFaceCulling) {
         glEnable(GL_CULL_FACE);
         glFrontFace(material->mFrontFace);   
@@ -149,23 +405,6 @@ void Renderer::setFaceCullingState(Material* material) {
 	}
 }
 
-void Renderer::projectObject(Object* obj) {
-    if(obj->getType() == ObjectType::Mesh) {
-        Mesh* mesh = static_cast<Mesh*>(obj);
-        Material* material = mesh->mMaterial;
-		if (material->mBlend) {     // ͸͸
-            mTransparentObjects.push_back(mesh);
-        }
-        else {
-            mOpaqueObjects.push_back(mesh);
-        }
-	}
-
-    auto children = obj->getChildren();
-    for (auto child : children) {
-        projectObject(child);
-	}
-}
 void Renderer::render(
     const std::vector<Mesh*>& meshes,
     Camera* camera,
@@ -175,6 +414,8 @@ void Renderer::render(
     AmbientLight* ambLight,
 	unsigned int fbo   // Ĭ00ϵͳĬϵFBO, ﴫ0ֵʾȾԶFBO0űʾȾĻ
 ) {
+    PROFILE_GPU_SCOPE("Renderer::render");
+    GL_DEBUG_GROUP("Renderer::render");
 	glBindFramebuffer(GL_FRAMEBUFFER, fbo);     // 󶨵ָFBOϽȾ
 
     //1 õǰ֡ƵʱopenglıҪ״̬
@@ -199,6 +440,9 @@ void Renderer::render(
     //2 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT); //GL_STENCIL_BUFFER_BIT ģ建
 
+    // лλһ򣬲ñrenderuniformü¼
+    beginPerDrawFrame();
+
     //3 meshл
     for (int i = 0; i < meshes.size(); i++) {
         auto mesh = meshes[i];
@@ -239,89 +483,92 @@ void Renderer::render(
 
         //2 shaderuniform
         shader->begin();
-        /* ----------------------- ȴͨõuniform----------------------------*/
-        /*    Դuniform    */ 
-        // spotlightĸ
-        for (int i = 0; i < spotLights.size(); i++) {
-            auto spotLight = spotLights[i];
-            std::string baseName = "spotLights[";
-            baseName.append(std::to_string(i));
-            baseName.append("]");
-
-            shader->setVector3(baseName + ".position", spotLight->getPosition());
-            shader->setVector3(baseName + ".color", spotLight->getColor());
-            shader->setFloat(baseName + ".specularIntensity", spotLight->getSpecularIntensity());
-            shader->setFloat(baseName + ".k2", spotLight->mK2);
-            shader->setFloat(baseName + ".k1", spotLight->mK1);
-            shader->setFloat(baseName + ".kc", spotLight->mKc);
-        }
-
-
-        // directionallightĸ
-        for (int i = 0; i < directionLights.size(); i++) {
-            auto directionLight = directionLights[i];
-            std::string baseName = "directionLights[";
-            baseName.append(std::to_string(i));
-            baseName.append("]");
-
-            shader->setVector3(baseName + ".direction", directionLight->getDirection());
-            shader->setVector3(baseName + ".color", directionLight->getColor());
-            shader->setFloat(baseName + ".specularIntensity", directionLight->getSpecularIntensity());
-            shader->setVector3(baseName + ".ambient", directionLight->getAmbient());
-            shader->setVector3(baseName + ".diffuse", directionLight->getDiffuse());
-            shader->setVector3(baseName + ".specular", directionLight->getSpecular());
-        }
-
-        // pointlightĸ
-        for (int i = 0; i < pointLights.size(); i++) {
-            auto pointLight = pointLights[i];
-            std::string baseName = "pointLights[";
-            baseName.append(std::to_string(i));
-            baseName.append("]");
-
-            shader->setVector3(baseName + ".position", pointLight->getPosition());
-            shader->setVector3(baseName + ".color", pointLight->getColor());
-            shader->setFloat(baseName + ".specularIntensity", pointLight->getSpecularIntensity());
-            shader->setFloat(baseName + ".k2", pointLight->getK2());
-            shader->setFloat(baseName + ".k1", pointLight->getK1());
-            shader->setFloat(baseName + ".kc", pointLight->getKc());
-
-            shader->setVector3(baseName + ".ambient", pointLight->getAmbient());
-            shader->setVector3(baseName + ".diffuse", pointLight->getDiffuse());
-            shader->setVector3(baseName + ".specular", pointLight->getSpecular());
-        }
-
-        // 
-        shader->setVector3("ambientLight.color", ambLight->getColor());
-        shader->setFloat("ambientLight.Intensity", ambLight->getIntensity());
-
-        /*    uniform    */
-        shader->setVector3("cameraPosition", camera->mPosition);
-        shader->setFloat("far", camera->mFar);
-        shader->setFloat("near", camera->mNear);
-
-        /*    MVPnormalMatrix    */
-        shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
-        shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-        shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
-
-        auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(mesh->getModelMatrx())));
-        shader->setMatrix3x3("normalMatrix", normalMatrix);
-
-        /*         */
-        shader->setFloat("opacityUniform", 1.0f);   // ͸ȣfloatͣĬ1.0fȫ͸
-
-        /* Phong */
-        shader->setFloat("ambientIntensity", 1.0f);
-        shader->setVector3("ambientColorUniform", glm::vec3(1.0, 1.0, 1.0));
-        shader->setFloat("diffuseIntensity", 1.0f);
-        shader->setVector3("diffuseColorUniform", glm::vec3(1.0, 1.0, 1.0));
-
-        shader->setFloat("specularIntensity", 1.0f);    // ߹ǿȣfloatͣĬ1.0f
-        shader->setFloat("specularPowerUniform", 32.0f);    // ߹ݴΣfloatͣĬ32.0fƸ߹ߴСֵԽԽУ
-        shader->setVector3("specularColorUniform", glm::vec3(1.0, 1.0, 1.0));
-
-        
+        // Դÿ֡uniformͬһshaderڱrenderֻһ
+        if (isFirstUseInFrame(shader)) {
+            /* ----------------------- ȴͨõuniform----------------------------*/
+            /*    Դuniform    */ 
+            // spotlightĸ
+            for (int i = 0; i < spotLights.size(); i++) {
+                auto spotLight = spotLights[i];
+                std::string baseName = "spotLights[";
+                baseName.append(std::to_string(i));
+                baseName.append("]");
+
+                shader->setVector3(baseName + ".position", spotLight->getPosition());
+                shader->setVector3(baseName + ".color", spotLight->getColor());
+                shader->setFloat(baseName + ".specularIntensity", spotLight->getSpecularIntensity());
+                shader->setFloat(baseName + ".k2", spotLight->mK2);
+                shader->setFloat(baseName + ".k1", spotLight->mK1);
+                shader->setFloat(baseName + ".kc", spotLight->mKc);
+            }
+
+
+            // directionallightĸ
+            for (int i = 0; i < directionLights.size(); i++) {
+                auto directionLight = directionLights[i];
+                std::string baseName = "directionLights[";
+                baseName.append(std::to_string(i));
+                baseName.append("]");
+
+                shader->setVector3(baseName + ".direction", directionLight->getDirection());
+                shader->setVector3(baseName + ".color", directionLight->getColor());
+                shader->setFloat(baseName + ".specularIntensity", directionLight->getSpecularIntensity());
+                shader->setVector3(baseName + ".ambient", directionLight->getAmbient());
+                shader->setVector3(baseName + ".diffuse", directionLight->getDiffuse());
+                shader->setVector3(baseName + ".specular", directionLight->getSpecular());
+            }
+
+            // pointlightĸ
+            for (int i = 0; i < pointLights.size(); i++) {
+                auto pointLight = pointLights[i];
+                std::string baseName = "pointLights[";
+                baseName.append(std::to_string(i));
+                baseName.append("]");
+
+                shader->setVector3(baseName + ".position", pointLight->getPosition());
+                shader->setVector3(baseName + ".color", pointLight->getColor());
+                shader->setFloat(baseName + ".specularIntensity", pointLight->getSpecularIntensity());
+                shader->setFloat(baseName + ".k2", pointLight->getK2());
+                shader->setFloat(baseName + ".k1", pointLight->getK1());
+                shader->setFloat(baseName + ".kc", pointLight->getKc());
+
+                shader->setVector3(baseName + ".ambient", pointLight->getAmbient());
+                shader->setVector3(baseName + ".diffuse", pointLight->getDiffuse());
+                shader->setVector3(baseName + ".specular", pointLight->getSpecular());
+            }
+
+            // 
+            shader->setVector3("ambientLight.color", ambLight->getColor());
+            shader->setFloat("ambientLight.Intensity", ambLight->getIntensity());
+
+            /*    uniform    */
+            shader->setVector3("cameraPosition", camera->mPosition);
+            shader->setFloat("far", camera->mFar);
+            shader->setFloat("near", camera->mNear);
+
+            /*    MVPnormalMatrix    */
+            shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
+            shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
+
+            /*         */
+            shader->setFloat("opacityUniform", 1.0f);   // ͸ȣfloatͣĬ1.0fȫ͸
+
+            /* Phong */
+            shader->setFloat("ambientIntensity", 1.0f);
+            shader->setVector3("ambientColorUniform", glm::vec3(1.0, 1.0, 1.0));
+            shader->setFloat("diffuseIntensity", 1.0f);
+            shader->setVector3("diffuseColorUniform", glm::vec3(1.0, 1.0, 1.0));
+
+            shader->setFloat("specularIntensity", 1.0f);    // ߹ǿȣfloatͣĬ1.0f
+            shader->setFloat("specularPowerUniform", 32.0f);    // ߹ݴΣfloatͣĬ32.0fƸ߹ߴСֵԽԽУ
+            shader->setVector3("specularColorUniform", glm::vec3(1.0, 1.0, 1.0));
+        }
+
+        /*    ÿλƵݣģ;󡢷߾͸ʱ    */
+        // shader  PerDraw ݿʱд뻷λƫư󶨣˻ glUniform
+        auto modelMatrix = mesh->getModelMatrx();
+        auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
+        setPerDrawData(shader, material, modelMatrix, normalMatrix);
 
         switch (material->mType) {
         case MaterialType::PhongMaterial: {
@@ -330,19 +577,22 @@ void Renderer::render(
             // Ԫйҹ
             // mDiffuseԪ phongMat->mDiffuse->getUnit()Shader
             phongMat->mDiffuse->bind();     // ID - mTextureӦԪ mUnit
-            shader->setInt("sampler", phongMat->mDiffuse->getUnit());	// 󶨲Ԫ
-            // specular ͼ
             if (phongMat->mSpecularMask != nullptr) {
-                phongMat->mSpecularMask->bind();     // ID - mTextureӦԪ mUnit
-                shader->setInt("specularMaskSampler", phongMat->mSpecularMask->getUnit());	// 󶨲Ԫ
+                phongMat->mSpecularMask->bind();
             }
-            shader->setVector3("material.ambient", phongMat->getAmbientColor());
-            shader->setVector3("material.diffuse", phongMat->getDiffuseColor());
-            shader->setVector3("material.specular", phongMat->getSpecularColor());
-            shader->setFloat("material.shiness", phongMat->getShiness());
 
-            shader->setFloat("material.shiness", phongMat->getShiness());
-            shader->setFloat("opacity", phongMat->mOpacity);    // ͸
+            // ʳͬһ shader ͬһʱظϴ
+            if (!isMaterialBound(shader, material)) {
+                shader->setInt("sampler", phongMat->mDiffuse->getUnit());	// 󶨲Ԫ
+                if (phongMat->mSpecularMask != nullptr) {
+                    shader->setInt("specularMaskSampler", phongMat->mSpecularMask->getUnit());	// 󶨲Ԫ
+                }
+                shader->setVector3("material.ambient", phongMat->getAmbientColor());
+                shader->setVector3("material.diffuse", phongMat->getDiffuseColor());
+                shader->setVector3("material.specular", phongMat->getSpecularColor());
+                shader->setFloat("material.shiness", phongMat->getShiness());
+                setMaterialScalarUniforms(shader, material);
+            }
             
             break;
         }
@@ -351,95 +601,41 @@ void Renderer::render(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
             break;
         }
         case MaterialType::PBRMaterial: {
             PBRMaterial* PBRMat = (PBRMaterial*)material;     // ǿתͰȫ飿ΪⲿmaterialʱnewһPBRMaterial
 
-            // Ԫйҹ
-            // AlbedoMap
-            if (PBRMat->mAlbedoMap == nullptr) {
-                shader->setBool("useAlbedoMap", false);
-            }
-            else {
-                shader->setBool("useAlbedoMap", true);
-                // mAlbedoMapԪ PBRMat->mAlbedoMap->getUnit()Shader
-                PBRMat->mAlbedoMap->bind();
-                shader->setInt("albedoMap", PBRMat->mAlbedoMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // NormalMap
-            if (PBRMat->mNormalMap == nullptr) {
-                shader->setBool("useNormalMap", false);
-            }
-            else {
-                shader->setBool("useNormalMap", true);
-                // normalMapԪ PBRMat->mNormalMap->getUnit()Shader
-                PBRMat->mNormalMap->bind();
-                shader->setInt("normalMap", PBRMat->mNormalMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // MetallicMap
-            if (PBRMat->mMetallicMap == nullptr) {
-                shader->setBool("useMetallicMap", false);
-            }
-            else {
-                shader->setBool("useMetallicMap", true);
-                PBRMat->mMetallicMap->bind();
-                shader->setInt("metallicMap", PBRMat->mMetallicMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // RoughnessMap
-            if (PBRMat->mRoughnessMap == nullptr) {
-                shader->setBool("useRoughnessMap", false);
-            }
-            else {
-                shader->setBool("useRoughnessMap", true);
-                PBRMat->mRoughnessMap->bind();
-                shader->setInt("roughnessMap", PBRMat->mRoughnessMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // AoMap
-            if (PBRMat->mAoMap == nullptr) {
-                shader->setBool("useAoMap", false);
+            bindPBRMaps(PBRMat);
+
+            // ʳͬһ shader ͬһʱظϴ
+            if (!isMaterialBound(shader, material)) {
+                setPBRMapUniforms(shader, PBRMat);
+                setMaterialScalarUniforms(shader, material);
+
+                /* PBR */
+                shader->setFloat("normalScaleUniform", 1.0f); // ϵfloatͣĬ1.0fŷߣ
+                shader->setFloat("metallicUniform", 1.0f); // ʽȣfloatͣĬ1.0fȫʣ
+                shader->setFloat("roughnessUniform", 1.0f); // ʴֲڶȣfloatͣĬ1.0fȫֲڲʣ
+                shader->setVector3("emissiveFactorUniform", glm::vec3(0.0, 0.0, 0.0)); // Էӣvec3ͣĬ(0.0,0.0,0.0)Ĭϲ⣩
+                shader->setFloat("aoStrengthUniform", 1.0f); // ʻڱǿȣfloatͣĬ1.0fȫӦAOЧ
+
+                float n1 = PBRMat->n1;
+                float n2 = 1.0;
+                float f0 = ((n1 - n2) * (n1 - n2)) / ((n1 + n2) * (n1 + n2));
+                shader->setFloat("baseF0Uniform", f0);    // ʱʣfloatͣĬ0.04fǽ
+                shader->setVector3("edgeTintUniform", glm::vec3(1.0, 1.0, 1.0)); // ʱԵɫvec3ͣĬϰɫɫuniformĬֵͳһ
+
+
+                float coatn1 = PBRMat->coatn1;
+                float coatn2 = 1.0;
+                float coatf0 = ((coatn1 - coatn2) * (coatn1 - coatn2)) / ((coatn1 + coatn2) * (coatn1 + coatn2));
+                /*  coat  */
+                shader->setFloat("coatF0Uniform", coatf0); // Ϳ㷨ʱʣfloatͣĬ1.0fͿ㷴ʣ
+                shader->setFloat("coatRoughnessUniform", PBRMat->coatRoughness); // ͿֲڶȣfloatͣĬ1.0fȫֲͿ㣩
+                shader->setFloat("coatStrengthUniform", PBRMat->coatStrength); // ͿǿȣfloatͣĬ1.0fȫӦͿЧ
+                shader->setVector3("coatColorUniform", PBRMat->coatColor); // Ϳɫvec3ͣĬϰɫɫuniformĬֵͳһ
             }
-            else {
-                shader->setBool("useAoMap", true);
-                PBRMat->mAoMap->bind();
-                shader->setInt("aoMap", PBRMat->mAoMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // ÷ͼPBR
-            shader->setVector3("albedo", glm::vec3(0.5f));  // ģɫ
-            shader->setFloat("metallic", PBRMat->getMetallic());    // ȣ0=ǽ1=
-            shader->setFloat("roughness", PBRMat->getRoughness());   // ֲڶȣ0=⻬1=ֲڣ
-            shader->setFloat("ao", PBRMat->getAo());    // ڱ
-
-			shader->setFloat("opacity", PBRMat->mOpacity);    // ͸
-
-            /* PBR */
-            shader->setFloat("normalScaleUniform", 1.0f); // ϵfloatͣĬ1.0fŷߣ
-            shader->setFloat("metallicUniform", 1.0f); // ʽȣfloatͣĬ1.0fȫʣ
-            shader->setFloat("roughnessUniform", 1.0f); // ʴֲڶȣfloatͣĬ1.0fȫֲڲʣ
-            shader->setVector3("emissiveFactorUniform", glm::vec3(0.0, 0.0, 0.0)); // Էӣvec3ͣĬ(0.0,0.0,0.0)Ĭϲ⣩
-            shader->setFloat("aoStrengthUniform", 1.0f); // ʻڱǿȣfloatͣĬ1.0fȫӦAOЧ
-
-            float n1 = PBRMat->n1;
-            float n2 = 1.0;
-            float f0 = ((n1 - n2) * (n1 - n2)) / ((n1 + n2) * (n1 + n2));
-            shader->setFloat("baseF0Uniform", f0);    // ʱʣfloatͣĬ0.04fǽ
-            shader->setVector3("edgeTintUniform", glm::vec3(1.0, 1.0, 1.0)); // ʱԵɫvec3ͣĬϰɫɫuniformĬֵͳһ
-
-
-            float coatn1 = PBRMat->coatn1;
-            float coatn2 = 1.0;
-            float coatf0 = ((coatn1 - coatn2) * (coatn1 - coatn2)) / ((coatn1 + coatn2) * (coatn1 + coatn2));
-            /*  coat  */
-            shader->setFloat("coatF0Uniform", coatf0); // Ϳ㷨ʱʣfloatͣĬ1.0fͿ㷴ʣ
-            shader->setFloat("coatRoughnessUniform", PBRMat->coatRoughness); // ͿֲڶȣfloatͣĬ1.0fȫֲͿ㣩
-            shader->setFloat("coatStrengthUniform", PBRMat->coatStrength); // ͿǿȣfloatͣĬ1.0fȫӦͿЧ
-            shader->setVector3("coatColorUniform", PBRMat->coatColor); // Ϳɫvec3ͣĬϰɫɫuniformĬֵͳһ
 
             break;
         }
@@ -461,6 +657,9 @@ void Renderer::render(
                 screenMat->mColorWeightTexture->bind();
                 shader->setInt("colorWeightTexture", screenMat->mColorWeightTexture->getUnit());
             }
+
+            shader->setVector2("uvScale", screenMat->mUvScale);
+            shader->setFloat("sharpness", screenMat->mSharpness);
 			
             break;
         }
@@ -473,6 +672,8 @@ default:
         glBindVertexArray(geometry->getVAO());
 
         //4 ִл
+        RenderStats::add(RenderCounter::DrawCalls);
+        RenderStats::add(RenderCounter::Triangles, geometry->getIndicesCount() / 3);
         glDrawElements(GL_TRIANGLES, geometry->getIndicesCount(), GL_UNSIGNED_INT, 0);
     }
 }
@@ -487,6 +688,8 @@ void Renderer::render(
     AmbientLight* ambLight,
     unsigned int fbo   // Ĭ00ϵͳĬϵFBO, ﴫ0ֵʾȾԶFBO0űʾȾĻ
 ) {
+    PROFILE_GPU_SCOPE("Renderer::render");
+    GL_DEBUG_GROUP("Renderer::render");
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);     // 󶨵ָFBOϽȾ
 
     //1 õǰ֡ƵʱopenglıҪ״̬
@@ -511,16 +714,25 @@ void Renderer::render(
     //2 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT); //GL_STENCIL_BUFFER_BIT ģ建
 
+    // лλһ򣬲ñrenderuniformü¼
+    beginPerDrawFrame();
+
     //3 meshл
-    for (int i = 0; i < meshes.size(); i++) {
-        auto mesh = meshes[i];
+    // MeshĻƣ͸׶εÿ pass Ҳͨύshader  passShader ǰ pass ѡ
+    auto drawMesh = [&](Mesh* mesh) {
         auto geometry = mesh->mGeometry;
         auto material = mesh->mMaterial;
 
         setDepthState(material);
         setPolygonOffsetState(material);
         setStencilState(material);
-        setBlenderState(material);
+        if (mTransparentPass != TransparentPass::Forward) {
+            // OIT ۻ / Ȱ룺״̬ WeightedBlendedOIT / DualDepthPeeling ãֻȲԲд
+            glDepthMask(GL_FALSE);
+        }
+        else {
+            setBlenderState(material);
+        }
         setFaceCullingState(material);
 
         /*
@@ -544,99 +756,110 @@ void Renderer::render(
         }
         */
         //1 ʹĸShader
-        Shader* shader = material->getShader();
+        Shader* shader = passShader(material->getShader());
         if (shader == nullptr) {
             throw std::runtime_error("The Shader is nullptr.");
         }
+        if (mDepthPrepassActive && DepthPrepass::isEligible(material, shader)) {
+            // ԤȣȲͨд
+            mDepthPrepass->applyEqualDepthState();
+        }
 
         //2 shaderuniform
         shader->begin();
-        /* ----------------------- ȴͨõuniform----------------------------*/
-        /*    Դuniform    */
-        // spotlightĸ
-        shader->setVector3("spotLight.position", spotLight->getPosition());
-        shader->setVector3("spotLight.targetDirection", spotLight->getTargetDirection());
-        shader->setVector3("spotLight.color", spotLight->getColor());
-        shader->setFloat("spotLight.specularIntensity", spotLight->getSpecularIntensity());
-        shader->setFloat("spotLight.innerLine", glm::cos(glm::radians(spotLight->getInnerAngle())));   // cos ֵ
-        shader->setFloat("spotLight.outerLine", glm::cos(glm::radians(spotLight->getOuterAngle())));   // cos ֵ
-        shader->setFloat("spotLight.k2", spotLight->mK2);
-        shader->setFloat("spotLight.k1", spotLight->mK1);
-        shader->setFloat("spotLight.kc", spotLight->mKc);
-
-        // directionallightĸ
-        shader->setVector3("directionLight.direction", dirLight->getDirection());
-        shader->setVector3("directionLight.color", dirLight->getColor());
-        shader->setFloat("directionLight.specularIntensity", dirLight->getSpecularIntensity());
-        shader->setVector3("directionLight.ambient", dirLight->getAmbient());
-        shader->setVector3("directionLight.diffuse", dirLight->getDiffuse());
-        shader->setVector3("directionLight.specular", dirLight->getSpecular());
-
-
-        // pointlightĸ
-        for (int i = 0; i < pointLights.size(); i++) {
-            auto pointLight = pointLights[i];
-            std::string baseName = "pointLights[";
-            baseName.append(std::to_string(i));
-            baseName.append("]");
-
-            shader->setVector3(baseName + ".position", pointLight->getPosition());
-            shader->setVector3(baseName + ".color", pointLight->getColor());
-            shader->setFloat(baseName + ".specularIntensity", pointLight->getSpecularIntensity());
-            shader->setFloat(baseName + ".k2", pointLight->getK2());
-            shader->setFloat(baseName + ".k1", pointLight->getK1());
-            shader->setFloat(baseName + ".kc", pointLight->getKc());
-
-            shader->setVector3(baseName + ".ambient", pointLight->getAmbient());
-            shader->setVector3(baseName + ".diffuse", pointLight->getDiffuse());
-            shader->setVector3(baseName + ".specular", pointLight->getSpecular());
-        }
-
-        // 
-        shader->setVector3("ambientLight.color", ambLight->getColor());
-        shader->setFloat("ambientLight.Intensity", ambLight->getIntensity());
-
-        /*    uniform    */
-        shader->setVector3("cameraPosition", camera->mPosition);
-        shader->setFloat("far", camera->mFar);
-        shader->setFloat("near", camera->mNear);
-
-        /*    MVPnormalMatrix    */
-        shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
-        shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-        shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
-
-        auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(mesh->getModelMatrx())));
-        shader->setMatrix3x3("normalMatrix", normalMatrix);
-
-        /*         */
-        shader->setFloat("opacityUniform", 1.0f);   // ͸ȣfloatͣĬ1.0fȫ͸
-
-        /* Phong */
-        shader->setFloat("ambientIntensity", 1.0f);
-        shader->setVector3("ambientColorUniform", glm::vec3(1.0, 1.0, 1.0));
-        shader->setFloat("diffuseIntensity", 1.0f);
-        shader->setVector3("diffuseColorUniform", glm::vec3(1.0, 1.0, 1.0));
-
-        shader->setFloat("specularIntensity", 1.0f);    // ߹ǿȣfloatͣĬ1.0f
-        shader->setFloat("specularPowerUniform", 32.0f);    // ߹ݴΣfloatͣĬ32.0fƸ߹ߴСֵԽԽУ
-        shader->setVector3("specularColorUniform", glm::vec3(1.0, 1.0, 1.0));
-
-        /* PBR */
-        shader->setFloat("normalScaleUniform", 1.0f); // ϵfloatͣĬ1.0fŷߣ
-        shader->setFloat("metallicUniform", 1.0f); // ʽȣfloatͣĬ1.0fȫʣ
-        shader->setFloat("roughnessUniform", 1.0f); // ʴֲڶȣfloatͣĬ1.0fȫֲڲʣ
-        shader->setVector3("emissiveFactorUniform", glm::vec3(0.0, 0.0, 0.0)); // Էӣvec3ͣĬ(0.0,0.0,0.0)Ĭϲ⣩
-        shader->setFloat("aoStrengthUniform", 1.0f); // ʻڱǿȣfloatͣĬ1.0fȫӦAOЧ
-        shader->setFloat("baseF0Uniform", 1.0f);    // ʱʣfloatͣĬ1.0fʣ
-        shader->setVector3("edgeTintUniform", glm::vec3(1.0, 1.0, 1.0)); // ʱԵɫvec3ͣĬϰɫɫuniformĬֵͳһ
-
-        /*  coat  */
-        shader->setFloat("coatF0Uniform", 1.0f); // Ϳ㷨ʱʣfloatͣĬ1.0fͿ㷴ʣ
-        shader->setFloat("coatRoughnessUniform", 1.0f); // ͿֲڶȣfloatͣĬ1.0fȫֲͿ㣩
-        shader->setFloat("coatStrengthUniform", 1.0f); // ͿǿȣfloatͣĬ1.0fȫӦͿЧ
-        shader->setVector3("coatColorUniform", glm::vec3(1.0, 1.0, 1.0)); // Ϳɫvec3ͣĬϰɫɫuniformĬֵͳһ
+        if (mTransparentPass == TransparentPass::DepthPeel) {
+            mPeeling->applyUniforms(shader);
+        }
+        // Դÿ֡uniformͬһshaderڱrenderֻһ
+        if (isFirstUseInFrame(shader)) {
+            /* ----------------------- ȴͨõuniform----------------------------*/
+            /*    Դuniform    */
+            // spotlightĸ
+            shader->setVector3("spotLight.position", spotLight->getPosition());
+            shader->setVector3("spotLight.targetDirection", spotLight->getTargetDirection());
+            shader->setVector3("spotLight.color", spotLight->getColor());
+            shader->setFloat("spotLight.specularIntensity", spotLight->getSpecularIntensity());
+            shader->setFloat("spotLight.innerLine", glm::cos(glm::radians(spotLight->getInnerAngle())));   // cos ֵ
+            shader->setFloat("spotLight.outerLine", glm::cos(glm::radians(spotLight->getOuterAngle())));   // cos ֵ
+            shader->setFloat("spotLight.k2", spotLight->mK2);
+            shader->setFloat("spotLight.k1", spotLight->mK1);
+            shader->setFloat("spotLight.kc", spotLight->mKc);
+
+            // directionallightĸ
+            shader->setVector3("directionLight.direction", dirLight->getDirection());
+            shader->setVector3("directionLight.color", dirLight->getColor());
+            shader->setFloat("directionLight.specularIntensity", dirLight->getSpecularIntensity());
+            shader->setVector3("directionLight.ambient", dirLight->getAmbient());
+            shader->setVector3("directionLight.diffuse", dirLight->getDiffuse());
+            shader->setVector3("directionLight.specular", dirLight->getSpecular());
+
+
+            // pointlightĸ
+            for (int i = 0; i < pointLights.size(); i++) {
+                auto pointLight = pointLights[i];
+                std::string baseName = "pointLights[";
+                baseName.append(std::to_string(i));
+                baseName.append("]");
+
+                shader->setVector3(baseName + ".position", pointLight->getPosition());
+                shader->setVector3(baseName + ".color", pointLight->getColor());
+                shader->setFloat(baseName + ".specularIntensity", pointLight->getSpecularIntensity());
+                shader->setFloat(baseName + ".k2", pointLight->getK2());
+                shader->setFloat(baseName + ".k1", pointLight->getK1());
+                shader->setFloat(baseName + ".kc", pointLight->getKc());
+
+                shader->setVector3(baseName + ".ambient", pointLight->getAmbient());
+                shader->setVector3(baseName + ".diffuse", pointLight->getDiffuse());
+                shader->setVector3(baseName + ".specular", pointLight->getSpecular());
+            }
+
+            // 
+            shader->setVector3("ambientLight.color", ambLight->getColor());
+            shader->setFloat("ambientLight.Intensity", ambLight->getIntensity());
+
+            /*    uniform    */
+            shader->setVector3("cameraPosition", camera->mPosition);
+            shader->setFloat("far", camera->mFar);
+            shader->setFloat("near", camera->mNear);
+
+            /*    MVPnormalMatrix    */
+            shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
+            shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
+
+            /*         */
+            shader->setFloat("opacityUniform", 1.0f);   // ͸ȣfloatͣĬ1.0fȫ͸
+
+            /* Phong */
+            shader->setFloat("ambientIntensity", 1.0f);
+            shader->setVector3("ambientColorUniform", glm::vec3(1.0, 1.0, 1.0));
+            shader->setFloat("diffuseIntensity", 1.0f);
+            shader->setVector3("diffuseColorUniform", glm::vec3(1.0, 1.0, 1.0));
 
+            shader->setFloat("specularIntensity", 1.0f);    // ߹ǿȣfloatͣĬ1.0f
+            shader->setFloat("specularPowerUniform", 32.0f);    // ߹ݴΣfloatͣĬ32.0fƸ߹ߴСֵԽԽУ
+            shader->setVector3("specularColorUniform", glm::vec3(1.0, 1.0, 1.0));
+
+            /* PBR */
+            shader->setFloat("normalScaleUniform", 1.0f); // ϵfloatͣĬ1.0fŷߣ
+            shader->setFloat("metallicUniform", 1.0f); // ʽȣfloatͣĬ1.0fȫʣ
+            shader->setFloat("roughnessUniform", 1.0f); // ʴֲڶȣfloatͣĬ1.0fȫֲڲʣ
+            shader->setVector3("emissiveFactorUniform", glm::vec3(0.0, 0.0, 0.0)); // Էӣvec3ͣĬ(0.0,0.0,0.0)Ĭϲ⣩
+            shader->setFloat("aoStrengthUniform", 1.0f); // ʻڱǿȣfloatͣĬ1.0fȫӦAOЧ
+            shader->setFloat("baseF0Uniform", 1.0f);    // ʱʣfloatͣĬ1.0fʣ
+            shader->setVector3("edgeTintUniform", glm::vec3(1.0, 1.0, 1.0)); // ʱԵɫvec3ͣĬϰɫɫuniformĬֵͳһ
+
+            /*  coat  */
+            shader->setFloat("coatF0Uniform", 1.0f); // Ϳ㷨ʱʣfloatͣĬ1.0fͿ㷴ʣ
+            shader->setFloat("coatRoughnessUniform", 1.0f); // ͿֲڶȣfloatͣĬ1.0fȫֲͿ㣩
+            shader->setFloat("coatStrengthUniform", 1.0f); // ͿǿȣfloatͣĬ1.0fȫӦͿЧ
+            shader->setVector3("coatColorUniform", glm::vec3(1.0, 1.0, 1.0)); // Ϳɫvec3ͣĬϰɫɫuniformĬֵͳһ
+        }
+
+        /*    ÿλƵݣģ;󡢷߾͸ʱ    */
+        // shader  PerDraw ݿʱд뻷λƫư󶨣˻ glUniform
+        auto modelMatrix = mesh->getModelMatrx();
+        auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
+        setPerDrawData(shader, material, modelMatrix, normalMatrix);
 
         switch (material->mType) {
         case MaterialType::PhongMaterial: {
@@ -645,19 +868,22 @@ void Renderer::render(
             // Ԫйҹ
             // mDiffuseԪ phongMat->mDiffuse->getUnit()Shader
             phongMat->mDiffuse->bind();     // ID - mTextureӦԪ mUnit
-            shader->setInt("sampler", phongMat->mDiffuse->getUnit());	// 󶨲Ԫ
-            // specular ͼ
             if (phongMat->mSpecularMask != nullptr) {
-                phongMat->mSpecularMask->bind();     // ID - mTextureӦԪ mUnit
-                shader->setInt("specularMaskSampler", phongMat->mSpecularMask->getUnit());	// 󶨲Ԫ
+                phongMat->mSpecularMask->bind();
             }
-            shader->setVector3("material.ambient", phongMat->getAmbientColor());
-            shader->setVector3("material.diffuse", phongMat->getDiffuseColor());
-            shader->setVector3("material.specular", phongMat->getSpecularColor());
-            shader->setFloat("material.shiness", phongMat->getShiness());
 
-            shader->setFloat("material.shiness", phongMat->getShiness());
-            shader->setFloat("opacity", phongMat->mOpacity);    // ͸
+            // ʳͬһ shader ͬһʱظϴ
+            if (!isMaterialBound(shader, material)) {
+                shader->setInt("sampler", phongMat->mDiffuse->getUnit());	// 󶨲Ԫ
+                if (phongMat->mSpecularMask != nullptr) {
+                    shader->setInt("specularMaskSampler", phongMat->mSpecularMask->getUnit());	// 󶨲Ԫ
+                }
+                shader->setVector3("material.ambient", phongMat->getAmbientColor());
+                shader->setVector3("material.diffuse", phongMat->getDiffuseColor());
+                shader->setVector3("material.specular", phongMat->getSpecularColor());
+                shader->setFloat("material.shiness", phongMat->getShiness());
+                setMaterialScalarUniforms(shader, material);
+            }
 
             break;
         }
@@ -666,72 +892,18 @@ void Renderer::render(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
             break;
         }
         case MaterialType::PBRMaterial: {
             PBRMaterial* PBRMat = (PBRMaterial*)material;     // ǿתͰȫ飿ΪⲿmaterialʱnewһPBRMaterial
 
-            // Ԫйҹ
-            // AlbedoMap
-            if (PBRMat->mAlbedoMap == nullptr) {
-                shader->setBool("useAlbedoMap", false);
-            }
-            else {
-                shader->setBool("useAlbedoMap", true);
-                // mAlbedoMapԪ PBRMat->mAlbedoMap->getUnit()Shader
-                PBRMat->mAlbedoMap->bind();
-                shader->setInt("albedoMap", PBRMat->mAlbedoMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // NormalMap
-            if (PBRMat->mNormalMap == nullptr) {
-                shader->setBool("useNormalMap", false);
-            }
-            else {
-                shader->setBool("useNormalMap", true);
-                // normalMapԪ PBRMat->mNormalMap->getUnit()Shader
-                PBRMat->mNormalMap->bind();
-                shader->setInt("normalMap", PBRMat->mNormalMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // MetallicMap
-            if (PBRMat->mMetallicMap == nullptr) {
-                shader->setBool("useMetallicMap", false);
-            }
-            else {
-                shader->setBool("useMetallicMap", true);
-                PBRMat->mMetallicMap->bind();
-                shader->setInt("metallicMap", PBRMat->mMetallicMap->getUnit());	// 󶨲ӦԪ
-            }
+            bindPBRMaps(PBRMat);
 
-            // RoughnessMap
-            if (PBRMat->mRoughnessMap == nullptr) {
-                shader->setBool("useRoughnessMap", false);
+            // ʳͬһ shader ͬһʱظϴ
+            if (!isMaterialBound(shader, material)) {
+                setPBRMapUniforms(shader, PBRMat);
+                setMaterialScalarUniforms(shader, material);
             }
-            else {
-                shader->setBool("useRoughnessMap", true);
-                PBRMat->mRoughnessMap->bind();
-                shader->setInt("roughnessMap", PBRMat->mRoughnessMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // AoMap
-            if (PBRMat->mAoMap == nullptr) {
-                shader->setBool("useAoMap", false);
-            }
-            else {
-                shader->setBool("useAoMap", true);
-                PBRMat->mAoMap->bind();
-                shader->setInt("aoMap", PBRMat->mAoMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // ÷ͼPBR
-            shader->setVector3("albedo", glm::vec3(0.5f));  // ģɫ
-            shader->setFloat("metallic", PBRMat->getMetallic());    // ȣ0=ǽ1=
-            shader->setFloat("roughness", PBRMat->getRoughness());   // ֲڶȣ0=⻬1=ֲڣ
-            shader->setFloat("ao", PBRMat->getAo());    // ڱ
-
-            shader->setFloat("opacity", PBRMat->mOpacity);    // ͸
 
             break;
         }
@@ -754,19 +926,78 @@ void Renderer::render(
                 shader->setInt("colorWeightTexture", screenMat->mColorWeightTexture->getUnit());
             }
 
+            shader->setVector2("uvScale", screenMat->mUvScale);
+            shader->setFloat("sharpness", screenMat->mSharpness);
+
             break;
         }
         default:
             std::cerr << "Unknown material type: " << static_cast<int>(material->mType) << std::endl;
-            continue;
+            return;
         }
 
-        //3 vao
-        glBindVertexArray(geometry->getVAO());
+        //3 vaoƣ͸尴ӽѡԤ
+        if (mOverdrawActive) {
+            mOverdraw->beginMesh(mesh->getName(), mesh->getTransformHandle(), static_cast<uint32_t>(geometry->getIndicesCount() / 3));
+        }
+        drawGeometry(geometry, material, modelMatrix, camera);
+        if (mOverdrawActive) {
+            mOverdraw->endMesh();
+        }
+    };
 
-        //4 ִл
-        glDrawElements(GL_TRIANGLES, geometry->getIndicesCount(), GL_UNSIGNED_INT, 0);
+    beginOverdrawFrame();
+
+    // ԤȣֻԲĲ͸Mesh
+    renderDepthPrepass(fbo, camera, meshes.size(), [&](size_t i) {
+        Mesh* mesh = meshes[i];
+        if (DepthPrepass::isEligible(mesh->mMaterial, mesh->mMaterial->getShader())) {
+            drawDepthOnly(mesh->mGeometry, mesh->mMaterial, mesh->getModelMatrx());
+        }
+    });
+
+    // ˳޹͸ģʽ£ϵMeshӺ󵽲͸֮ͳһģʽִ˳
+    mTransparentMeshes.clear();
+    {
+        PROFILE_GPU_SCOPE("Opaque");
+        GL_DEBUG_GROUP("Opaque");
+        RenderStats::beginPass("Opaque");
+        for (int i = 0; i < meshes.size(); i++) {
+            auto mesh = meshes[i];
+            if (mTransparencyMode != TransparencyMode::Sorted && mesh->mMaterial->mBlend) {
+                mTransparentMeshes.push_back(mesh);
+                continue;
+            }
+            drawMesh(mesh);
+        }
+        endOpaquePass();
+        RenderStats::endPass();
+    }
+
+    //4 ͸MeshOIT / Ȱ룬ûбĲںϳɺ󰴴˳
+    if (!mTransparentMeshes.empty()) {
+        RenderStatsScope statsScope("Transparent");
+        PROFILE_GPU_SCOPE("Transparent");
+        GL_DEBUG_GROUP("Transparent");
+        beginTransparencyTiming();
+        bool orderIndependent = renderOrderIndependent(fbo, mTransparentMeshes.size(),
+            [&](size_t i) { return mTransparentMeshes[i]->mMaterial->getShader(); },
+            [&](size_t i) { drawMesh(mTransparentMeshes[i]); },
+            mFallbackItems);
+
+        if (orderIndependent) {
+            for (auto index : mFallbackItems) {
+                drawMesh(mTransparentMeshes[index]);
+            }
+        }
+        else {
+            for (auto mesh : mTransparentMeshes) {
+                drawMesh(mesh);
+            }
+        }
+        endTransparencyTiming(mTransparentMeshes.size());
     }
+    endOverdrawFrame(fbo);
 }
 
 void Renderer::render(
@@ -777,6 +1008,8 @@ void Renderer::render(
     SpotLight* spotLight,
     AmbientLight* ambLight
 ) {
+    PROFILE_GPU_SCOPE("Renderer::render");
+    GL_DEBUG_GROUP("Renderer::render");
     //1 õǰ֡ƵʱopenglıҪ״̬
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);       // ȲԹܣƬεֵСڴ洢ֵͨ
@@ -784,6 +1017,9 @@ void Renderer::render(
     //2 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // ģ;ͨ PerDraw ݿ鴫룬лλµһ֡ʱñrenderļ¼
+    beginPerDrawFrame();
+
     //3 meshл
     for (int i = 0; i < meshes.size(); i++) {
         auto mesh = meshes[i];
@@ -845,11 +1081,10 @@ void Renderer::render(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
 
-            // normalMatrix
+            // ģ;normalMatrixͨ PerDraw ݿ鴫
             auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(mesh->getModelMatrx())));
-            shader->setMatrix3x3("normalMatrix", normalMatrix);
+            setPerDrawData(shader, material, mesh->getModelMatrx(), normalMatrix);
 
             break;
         }
@@ -858,7 +1093,7 @@ void Renderer::render(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
+            setPerDrawData(shader, material, mesh->getModelMatrx(), glm::mat3(1.0f));	// ɫshaderʹ÷߾
             break;
         }
         default:
@@ -870,6 +1105,8 @@ void Renderer::render(
         glBindVertexArray(geometry->getVAO());
 
         //4 ִл
+        RenderStats::add(RenderCounter::DrawCalls);
+        RenderStats::add(RenderCounter::Triangles, geometry->getIndicesCount() / 3);
         glDrawElements(GL_TRIANGLES, geometry->getIndicesCount(), GL_UNSIGNED_INT, 0);
     }
 }
@@ -881,6 +1118,8 @@ void Renderer::render(
     SpotLight* spotLight,
     AmbientLight* ambLight
 ) {
+    PROFILE_GPU_SCOPE("Renderer::render");
+    GL_DEBUG_GROUP("Renderer::render");
     //1 õǰ֡ƵʱopenglıҪ״̬
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);       // ȲԹܣƬεֵСڴ洢ֵͨ
@@ -888,6 +1127,9 @@ void Renderer::render(
     //2 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // ģ;ͨ PerDraw ݿ鴫룬лλµһ֡ʱñrenderļ¼
+    beginPerDrawFrame();
+
     //3 meshл
     for (int i = 0; i < meshes.size(); i++) {
         auto mesh = meshes[i];
@@ -946,11 +1188,10 @@ void Renderer::render(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
 
-            // normalMatrix
+            // ģ;normalMatrixͨ PerDraw ݿ鴫
             auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(mesh->getModelMatrx())));
-            shader->setMatrix3x3("normalMatrix", normalMatrix);
+            setPerDrawData(shader, material, mesh->getModelMatrx(), normalMatrix);
 
             break;
         }
@@ -959,7 +1200,7 @@ void Renderer::render(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
+            setPerDrawData(shader, material, mesh->getModelMatrx(), glm::mat3(1.0f));	// ɫshaderʹ÷߾
             break;
         }
         default:
@@ -971,6 +1212,8 @@ void Renderer::render(
         glBindVertexArray(geometry->getVAO());
 
         //4 ִл
+        RenderStats::add(RenderCounter::DrawCalls);
+        RenderStats::add(RenderCounter::Triangles, geometry->getIndicesCount() / 3);
         glDrawElements(GL_TRIANGLES, geometry->getIndicesCount(), GL_UNSIGNED_INT, 0);
     }
 }
@@ -982,6 +1225,8 @@ void Renderer::render(
     PointLight* pointLight,
     AmbientLight* ambLight
 ) {
+    PROFILE_GPU_SCOPE("Renderer::render");
+    GL_DEBUG_GROUP("Renderer::render");
     //1 õǰ֡ƵʱopenglıҪ״̬
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);       // ȲԹܣƬεֵСڴ洢ֵͨ
@@ -989,6 +1234,9 @@ void Renderer::render(
     //2 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // ģ;ͨ PerDraw ݿ鴫룬лλµһ֡ʱñrenderļ¼
+    beginPerDrawFrame();
+
     //3 meshл
     for (int i = 0; i < meshes.size(); i++) {
         auto mesh = meshes[i];
@@ -1033,11 +1281,10 @@ void Renderer::render(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
 
-            // normalMatrix
+            // ģ;normalMatrixͨ PerDraw ݿ鴫
             auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(mesh->getModelMatrx())));
-            shader->setMatrix3x3("normalMatrix", normalMatrix);
+            setPerDrawData(shader, material, mesh->getModelMatrx(), normalMatrix);
 
             break;
         }
@@ -1046,7 +1293,7 @@ void Renderer::render(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
+            setPerDrawData(shader, material, mesh->getModelMatrx(), glm::mat3(1.0f));	// ɫshaderʹ÷߾
             break;
         }
         default:
@@ -1058,6 +1305,8 @@ void Renderer::render(
         glBindVertexArray(geometry->getVAO());
 
         //4 ִл
+        RenderStats::add(RenderCounter::DrawCalls);
+        RenderStats::add(RenderCounter::Triangles, geometry->getIndicesCount() / 3);
         glDrawElements(GL_TRIANGLES, geometry->getIndicesCount(), GL_UNSIGNED_INT, 0);
     }
 }
@@ -1069,6 +1318,8 @@ void Renderer::render(
     DirectionalLight* dirLight,
     AmbientLight* ambLight
 ) {
+    PROFILE_GPU_SCOPE("Renderer::render");
+    GL_DEBUG_GROUP("Renderer::render");
     //1 õǰ֡ƵʱopenglıҪ״̬
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
@@ -1076,6 +1327,9 @@ void Renderer::render(
     //2 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // ģ;ͨ PerDraw ݿ鴫룬лλµһ֡ʱñrenderļ¼
+    beginPerDrawFrame();
+
     //3 meshл
     for (int i = 0; i < meshes.size(); i++) {
         auto mesh = meshes[i];
@@ -1117,11 +1371,10 @@ void Renderer::render(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
 
-            // normalMatrix
+            // ģ;normalMatrixͨ PerDraw ݿ鴫
             auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(mesh->getModelMatrx())));
-            shader->setMatrix3x3("normalMatrix", normalMatrix);
+            setPerDrawData(shader, material, mesh->getModelMatrx(), normalMatrix);
 
             break;
         }
@@ -1130,7 +1383,7 @@ void Renderer::render(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
+            setPerDrawData(shader, material, mesh->getModelMatrx(), glm::mat3(1.0f));	// ɫshaderʹ÷߾
             break;
         }
         default:
@@ -1142,6 +1395,8 @@ void Renderer::render(
         glBindVertexArray(geometry->getVAO());
 
         //4 ִл
+        RenderStats::add(RenderCounter::DrawCalls);
+        RenderStats::add(RenderCounter::Triangles, geometry->getIndicesCount() / 3);
         glDrawElements(GL_TRIANGLES, geometry->getIndicesCount(), GL_UNSIGNED_INT, 0);
     }
 }
@@ -1154,6 +1409,30 @@ void Renderer::render(
     const AmbientLight* ambLight,
     unsigned int fbo   // Ĭ00ϵͳĬϵFBO
 ) {
+    PROFILE_GPU_SCOPE("Renderer::render");
+    GL_DEBUG_GROUP("Renderer::render");
+    beginSceneFrame(fbo);
+
+    // ̲߳б޳Ⱦϲ
+    // ͸尴ʷ顢ɽԶ͸Զ
+    mRenderQueue.build(scene, camera);
+    mFrameLights.capture(dirLight, pointLights, ambLight);
+    renderPackets(fbo, camera, mFrameLights, mRenderQueue.getOpaquePackets(), mRenderQueue.getTransparentPackets());
+}
+
+void Renderer::render(const FrameSnapshot& snapshot, unsigned int fbo) {
+    PROFILE_GPU_SCOPE("Renderer::render");
+    GL_DEBUG_GROUP("Renderer::render");
+    beginSceneFrame(fbo);
+
+    // ȾѾ̹߳ź
+    mSnapshotCamera = snapshot.camera;
+    renderPackets(fbo, &mSnapshotCamera, snapshot.lights,
+        ArrayView<RenderPacket>(snapshot.opaque.data(), snapshot.opaque.size()),
+        ArrayView<RenderPacket>(snapshot.transparent.data(), snapshot.transparent.size()));
+}
+
+void Renderer::beginSceneFrame(unsigned int fbo) {
 	glBindFramebuffer(GL_FRAMEBUFFER, fbo);     // Ȱ󶨵ָFBOϽȾ
 
     //1 õǰ֡ƵʱopenglıҪ״̬
@@ -1177,42 +1456,176 @@ void Renderer::render(
 
     //2 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT); //GL_STENCIL_BUFFER_BIT ģ建
+}
 
-
-    // 
-    mOpaqueObjects.clear();
-    mTransparentObjects.clear();
-    projectObject(scene);
-
-	// ʱҪ͸򣬱֤ԶȾ
-    std::sort(
-        mTransparentObjects.begin(),
-        mTransparentObjects.end(),
-        [camera](Mesh* a, Mesh* b) {
-            // AϵZ
-			auto modelMatrixA = a->getModelMatrx();
-			auto worldPositionA = modelMatrixA * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);     // ԭƵеĳ
-			auto cameraPositionA = camera->getViewMatrix() * worldPositionA;
-            float zA = cameraPositionA.z;
-			// BϵZ
-			auto modelMatrixB = b->getModelMatrx();
-			auto worldPositionB = modelMatrixB * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-            auto cameraPositionB = camera->getViewMatrix() * worldPositionB;
-            float zB = cameraPositionB.z;
-            // zֵСǰ棬
-			return zA < zB;
-        }
-	);
+void Renderer::renderPackets(
+    unsigned int fbo,
+    Camera* camera,
+    const FrameLights& lights,
+    ArrayView<RenderPacket> opaquePackets,
+    ArrayView<RenderPacket> transparentPackets
+) {
+    beginPerDrawFrame();
+    beginOverdrawFrame();
+
+    // Ԥȣֻ͸ȣ pass ÿֻɫһ
+    renderDepthPrepass(fbo, camera, opaquePackets.size(), [&](size_t i) {
+        const RenderPacket& packet = opaquePackets[i];
+        if (DepthPrepass::isEligible(packet.material, pickShader(packet.material->mType))) {
+            drawDepthOnly(packet.geometry, packet.material, packet.modelMatrix);
+        }
+    });
 
 	// Ⱦ͸
-    for(int i = 0; i < mOpaqueObjects.size(); i++) {
-        renderObject(mOpaqueObjects[i], camera, dirLight, pointLights, ambLight);
-	}
+    {
+        PROFILE_GPU_SCOPE("Opaque");
+        GL_DEBUG_GROUP("Opaque");
+        RenderStats::beginPass("Opaque");
+        for (const auto& packet : opaquePackets) {
+            renderPacket(packet, camera, lights);
+        }
+        endOpaquePass();
+        RenderStats::endPass();
+    }
+
+	// Ⱦ͸壨ϻ OIT
+    RenderStats::beginPass("Transparent");
+    renderTransparent(fbo, camera, lights, transparentPackets);
+    RenderStats::endPass();
+
+    endOverdrawFrame(fbo);
+}
+
+bool Renderer::renderOrderIndependent(
+    unsigned int fbo,
+    size_t count,
+    const std::function<Shader*(size_t)>& shaderOf,
+    const std::function<void(size_t)>& draw,
+    std::vector<size_t>& fallback
+) {
+    fallback.clear();
+    // ȻƵģʽ͸Ҳüɫֱӻƣϵķʽ
+    if (mTransparencyMode == TransparencyMode::Sorted || count == 0 || mOverdrawActive) {
+        return false;
+    }
+    TransparentPass pass = mTransparencyMode == TransparencyMode::WeightedBlended ?
+        TransparentPass::WeightedBlended : TransparentPass::DepthPeel;
+
+    //1 еǰģʽ壨һα룩
+    mTransparentPass = pass;
+    mOrderIndependentItems.clear();
+    for (size_t i = 0; i < count; i++) {
+        if (passShader(shaderOf(i)) != nullptr) {
+            mOrderIndependentItems.push_back(i);
+        }
+        else {
+            fallback.push_back(i);
+        }
+    }
+    mTransparentPass = TransparentPass::Forward;
+    if (mOrderIndependentItems.empty()) {
+        return true;
+    }
+
+    // Ŀ뵱ǰӿһ
+    GLint viewport[4] = { 0, 0, 0, 0 };
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    int width = viewport[0] + viewport[2];
+    int height = viewport[1] + viewport[3];
+
+    if (pass == TransparentPass::WeightedBlended) {
+        //2 Ȩ OITһۻҪ
+        if (mOIT == nullptr) {
+            mOIT = new WeightedBlendedOIT();
+        }
+        if (!mOIT->begin(fbo, width, height)) {
+            fallback.clear();
+            return false;
+        }
+        mTransparentPass = pass;
+        for (auto index : mOrderIndependentItems) {
+            draw(index);
+        }
+        mTransparentPass = TransparentPass::Forward;
+        mOIT->composite(fbo);
+    }
+    else {
+        //2 Ȱ룺ʼ pass + ɰ passÿ pass ȫ
+        if (mPeeling == nullptr) {
+            mPeeling = new DualDepthPeeling();
+        }
+        if (!mPeeling->begin(fbo, width, height, mMaxPeelLayers)) {
+            fallback.clear();
+            return false;
+        }
+        mTransparentPass = pass;
+        do {
+            for (auto index : mOrderIndependentItems) {
+                draw(index);
+            }
+        } while (mPeeling->nextPass());
+        mTransparentPass = TransparentPass::Forward;
+        mPeeling->composite(fbo);
+    }
+    return true;
+}
+
+void Renderer::beginTransparencyTiming() {
+    int modeIndex = static_cast<int>(mTransparencyMode);
+    if (mTransparencyTimers[modeIndex] == nullptr) {
+        mTransparencyTimers[modeIndex] = new GpuTimer();
+    }
+    mTransparencyStart = std::chrono::high_resolution_clock::now();
+    mTransparencyTimers[modeIndex]->begin();
+}
 
-	// Ⱦ͸
-    for (int i = 0; i < mTransparentObjects.size(); i++) {
-        renderObject(mTransparentObjects[i], camera, dirLight, pointLights, ambLight);
+void Renderer::endTransparencyTiming(size_t drawCount) {
+    int modeIndex = static_cast<int>(mTransparencyMode);
+    GpuTimer* timer = mTransparencyTimers[modeIndex];
+    timer->end();
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    TransparencyTiming& timing = mTransparencyTimings[modeIndex];
+    timing.cpuMs = std::chrono::duration<double, std::milli>(endTime - mTransparencyStart).count();
+    timing.gpuMs = timer->getLastMs();
+    timing.drawCount = drawCount;
+    bool peeled = mTransparencyMode == TransparencyMode::DualDepthPeeling && mPeeling != nullptr && !mOrderIndependentItems.empty();
+    timing.peelPassCount = peeled ? mPeeling->getPassCount() : 0;
+    timing.peelLayerCount = peeled ? mPeeling->getLayerCount() : 0;
+}
+
+void Renderer::renderTransparent(
+    unsigned int fbo,
+    Camera* camera,
+    const FrameLights& lights,
+    ArrayView<RenderPacket> packets
+) {
+    PROFILE_GPU_SCOPE("Transparent");
+    GL_DEBUG_GROUP("Transparent");
+    beginTransparencyTiming();
+
+    //1 OIT / Ȱ룺б͸
+    bool orderIndependent = renderOrderIndependent(fbo, packets.size(),
+        [&](size_t i) { return pickShader(packets[i].material->mType); },
+        [&](size_t i) { renderPacket(packets[i], camera, lights); },
+        mFallbackItems);
+
+    if (orderIndependent) {
+        //2 ûбĲʣϳɺԶϣ˳޹ģʽȾû
+        std::sort(mFallbackItems.begin(), mFallbackItems.end(),
+            [&](size_t a, size_t b) { return packets[a].sortKey < packets[b].sortKey; });
+        for (auto index : mFallbackItems) {
+            renderPacket(packets[index], camera, lights);
+        }
+    }
+    else {
+        // ϣȾѾԶźã˳޹ģʽ˻ʱ˳򲻱֤
+        for (const auto& packet : packets) {
+            renderPacket(packet, camera, lights);
+        }
     }
+
+    endTransparencyTiming(packets.size());
 }
 
 // ԵobjectȾ
@@ -1226,152 +1639,140 @@ void Renderer::renderObject(
     // 1 жMeshObjectMeshҪȾ
     if (object->getType() == ObjectType::Mesh) {
         auto mesh = (Mesh*)object;  // objectѾȷMesh࣬Կǿת
-        auto geometry = mesh->mGeometry;
-        auto material = mesh->mMaterial;
-
-        setDepthState(material);
-        setPolygonOffsetState(material);
-        setStencilState(material);
-        setBlenderState(material);
 
-        //1 ʹĸShader
-        Shader* shader = pickShader(material->mType);
+        RenderPacket packet;
+        packet.modelMatrix = mesh->getModelMatrx();
+        packet.normalMatrix = glm::transpose(glm::inverse(glm::mat3(packet.modelMatrix)));
+        packet.material = mesh->mMaterial;
+        packet.geometry = mesh->mGeometry;
+        packet.name = &mesh->getName();
+        packet.transformHandle = mesh->getTransformHandle();
+        packet.triangleCount = mesh->mGeometry != nullptr ? static_cast<uint32_t>(mesh->mGeometry->getIndicesCount() / 3) : 0;
+        mFrameLights.capture(dirLight, pointLights, ambLight);
+        beginPerDrawFrame();    // Ⱦһ壬uniform
+        renderPacket(packet, camera, mFrameLights);
+    }
 
-        //2 shaderuniform
-        shader->begin();
+    // 2 objectӽڵ㣬ÿӽڵ㶼Ҫ renderObjectDFS
+    auto children = object->getChildren();
+    for (int i = 0; i < children.size(); i++) {
+        renderObject(children[i], camera, dirLight, pointLights, ambLight);
+    }
+}
 
-        switch (material->mType) {
-        case MaterialType::PhongMaterial: {
-            PhongMaterial* phongMat = (PhongMaterial*)material;     // ǿתͰȫ飿ΪⲿmaterialʱnewһPhongMaterialTexture0ŵԪ
-            // diffuse ͼ
-            // Ԫйҹ
-            shader->setInt("sampler", 0);	// 󶨲Ԫ0Ϊǰ漤0
+// ύȾ
+void Renderer::renderPacket(
+    const RenderPacket& packet,
+    Camera* camera,
+    const FrameLights& lights
+) {
+    auto geometry = packet.geometry;
+    auto material = packet.material;
+
+    setDepthState(material);
+    setPolygonOffsetState(material);
+    setStencilState(material);
+    if (mTransparentPass != TransparentPass::Forward) {
+        // OIT ۻ / Ȱ룺𸽼Ļ״̬ WeightedBlendedOIT / DualDepthPeeling ã͸ֻȲԲд
+        glDepthMask(GL_FALSE);
+    }
+    else {
+        setBlenderState(material);
+    }
 
-            // Ԫйҹ
-            phongMat->mDiffuse->bind(); // Ԫ
+    //1 ʹĸShader
+    Shader* shader = passShader(pickShader(material->mType));
+    if (mDepthPrepassActive && DepthPrepass::isEligible(material, shader)) {
+        // ԤȣȲͨд
+        mDepthPrepass->applyEqualDepthState();
+    }
 
-            // specular ͼ
-            shader->setInt("specularMaskSampler", 1);	// 󶨲Ԫ1Ϊǰ漤1
-            phongMat->mSpecularMask->bind(); // Ԫ
+    //2 shaderuniform
+    shader->begin();
+    if (mTransparentPass == TransparentPass::DepthPeel) {
+        mPeeling->applyUniforms(shader);
+    }
 
-            // Դuniform
-            shader->setVector3("lightDirection", dirLight->mDirection);
-            shader->setVector3("lightColor", dirLight->getColor());
-            shader->setFloat("specularIntensity", dirLight->getSpecularIntensity());
+    switch (material->mType) {
+    case MaterialType::PhongMaterial: {
+        PhongMaterial* phongMat = (PhongMaterial*)material;     // ǿתͰȫ飿ΪⲿmaterialʱnewһPhongMaterialTexture0ŵԪ
+        // Ԫйҹdiffuse ͼ0ŵԪspecular ͼ1ŵԪ
+        phongMat->mDiffuse->bind(); // Ԫ
+        phongMat->mSpecularMask->bind(); // Ԫ
 
-            shader->setFloat("shiness", phongMat->getShiness());
-            shader->setBool("blinn", phongMat->getBlinn());
-            shader->setVector3("ambientColor", ambLight->getColor());
+        // Դͬһshaderڱrenderֻһ
+        if (isFirstUseInFrame(shader)) {
+            shader->setVector3("lightDirection", lights.directional.mDirection);
+            shader->setVector3("lightColor", lights.directional.getColor());
+            shader->setFloat("specularIntensity", lights.directional.getSpecularIntensity());
+            shader->setVector3("ambientColor", lights.ambient.getColor());
 
-            // Ϣ
             shader->setVector3("cameraPosition", camera->mPosition);
-
-            // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
-
-            // normalMatrix
-            auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(mesh->getModelMatrx())));
-            shader->setMatrix3x3("normalMatrix", normalMatrix);
+        }
 
-            break;
+        // ʳȾʷ飬ͬһʱظϴ
+        if (!isMaterialBound(shader, material)) {
+            shader->setInt("sampler", 0);	// 󶨲Ԫ0
+            shader->setInt("specularMaskSampler", 1);	// 󶨲Ԫ1
+            shader->setFloat("shiness", phongMat->getShiness());
+            shader->setBool("blinn", phongMat->getBlinn());
+            setMaterialScalarUniforms(shader, material);
         }
-        case MaterialType::WhiteMaterial: {
-            // ʹðɫShader
-            // MVP
+
+        // ģ;normalMatrixȾмãͨ PerDraw ݿ鴫
+        setPerDrawData(shader, material, packet.modelMatrix, packet.normalMatrix);
+
+        break;
+    }
+    case MaterialType::WhiteMaterial: {
+        // ʹðɫShader
+        if (isFirstUseInFrame(shader)) {
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
-            break;
         }
-        case MaterialType::PBRMaterial: {
-            PBRMaterial* PBRMat = (PBRMaterial*)material;     // ǿתͰȫ飿ΪⲿmaterialʱnewһPBRMaterial
-
-            // Ԫйҹ
-            // AlbedoMap
-            if (PBRMat->mAlbedoMap == nullptr) {
-                shader->setBool("useAlbedoMap", false);
-            }
-            else {
-                shader->setBool("useAlbedoMap", true);
-                shader->setInt("albedoMap", PBRMat->mAlbedoMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // NormalMap
-            if (PBRMat->mNormalMap == nullptr) {
-                shader->setBool("useNormalMap", false);
-            }
-            else {
-                shader->setBool("useNormalMap", true);
-                shader->setInt("normalMap", PBRMat->mNormalMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // MetallicMap
-            if (PBRMat->mMetallicMap == nullptr) {
-                shader->setBool("useMetallicMap", false);
-            }
-            else {
-                shader->setBool("useMetallicMap", true);
-                shader->setInt("metallicMap", PBRMat->mMetallicMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // RoughnessMap
-            if (PBRMat->mRoughnessMap == nullptr) {
-                shader->setBool("useRoughnessMap", false);
-            }
-            else {
-                shader->setBool("useRoughnessMap", true);
-                shader->setInt("roughnessMap", PBRMat->mRoughnessMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // AoMap
-            if (PBRMat->mAoMap == nullptr) {
-                shader->setBool("useAoMap", false);
-            }
-            else {
-                shader->setBool("useAoMap", true);
-                shader->setInt("aoMap", PBRMat->mAoMap->getUnit());	// 󶨲ӦԪ
-            }
-
-            // ÷ͼPBR
-            shader->setVector3("albedo", glm::vec3(0.5f));  // ģɫ
-            shader->setFloat("metallic", PBRMat->getMetallic());    // ȣ0=ǽ1=
-            shader->setFloat("roughness", PBRMat->getRoughness());   // ֲڶȣ0=⻬1=ֲڣ
-            shader->setFloat("ao", PBRMat->getAo());    // ڱ
+        setPerDrawData(shader, material, packet.modelMatrix, packet.normalMatrix);
+        break;
+    }
+    case MaterialType::PBRMaterial: {
+        PBRMaterial* PBRMat = (PBRMaterial*)material;     // ǿתͰȫ飿ΪⲿmaterialʱnewһPBRMaterial
 
-            shader->setFloat("opacity", PBRMat->mOpacity);    // ͸
+        // ʳͼ͸
+        if (!isMaterialBound(shader, material)) {
+            setPBRMapUniforms(shader, PBRMat);
+            setMaterialScalarUniforms(shader, material);
+        }
 
-            // Դuniform
+        // Դͬһshaderڱrenderֻһ
+        if (isFirstUseInFrame(shader)) {
             // pointlightĸ
-            for (int i = 0; i < pointLights.size(); i++) {
-                auto pointLight = pointLights[i];
+            for (int i = 0; i < lights.points.size(); i++) {
+                const PointLightData& pointLight = lights.points[i];
                 std::string baseName = "pointLights[";
                 baseName.append(std::to_string(i));
                 baseName.append("]");
 
-                shader->setVector3(baseName + ".position", pointLight->getPosition());
-                //std::cout << "pointlight[" << i << "].position = " << pointLight->getPosition().x<<", "<< pointLight->getPosition().y << ", "<< pointLight->getPosition().z<< std::endl;
-                shader->setVector3(baseName + ".color", pointLight->getColor());
-                shader->setFloat(baseName + ".specularIntensity", pointLight->getSpecularIntensity());
-                shader->setFloat(baseName + ".k2", pointLight->getK2());
-                shader->setFloat(baseName + ".k1", pointLight->getK1());
-                shader->setFloat(baseName + ".kc", pointLight->getKc());
-
-                shader->setVector3(baseName + ".ambient", pointLight->getAmbient());
-                shader->setVector3(baseName + ".diffuse", pointLight->getDiffuse());
-                shader->setVector3(baseName + ".specular", pointLight->getSpecular());
+                shader->setVector3(baseName + ".position", pointLight.position);
+                shader->setVector3(baseName + ".color", pointLight.color);
+                shader->setFloat(baseName + ".specularIntensity", pointLight.specularIntensity);
+                shader->setFloat(baseName + ".k2", pointLight.k2);
+                shader->setFloat(baseName + ".k1", pointLight.k1);
+                shader->setFloat(baseName + ".kc", pointLight.kc);
 
+                shader->setVector3(baseName + ".ambient", pointLight.ambient);
+                shader->setVector3(baseName + ".diffuse", pointLight.diffuse);
+                shader->setVector3(baseName + ".specular", pointLight.specular);
             }
 
             // directionallightĸ
-            shader->setVector3("directionLight.direction", dirLight->getDirection());
-            shader->setVector3("directionLight.color", dirLight->getColor());
-            shader->setFloat("directionLight.specularIntensity", dirLight->getSpecularIntensity());
+            shader->setVector3("directionLight.direction", lights.directional.getDirection());
+            shader->setVector3("directionLight.color", lights.directional.getColor());
+            shader->setFloat("directionLight.specularIntensity", lights.directional.getSpecularIntensity());
 
             // û
-            shader->setVector3("ambientLight.color", ambLight->getColor());
-            shader->setFloat("ambientLight.Intensity", ambLight->getIntensity());
+            shader->setVector3("ambientLight.color", lights.ambient.getColor());
+            shader->setFloat("ambientLight.Intensity", lights.ambient.getIntensity());
 
             // Ϣ
             shader->setVector3("cameraPosition", camera->mPosition);
@@ -1381,36 +1782,37 @@ void Renderer::renderObject(
             // MVP
             shader->setMatrix4x4("ProjectionMatrix", camera->getProjectionMatrix());    // ͶӰ任
             shader->setMatrix4x4("ViewMatrix", camera->getViewMatrix());    // ͼ任camera
-            shader->setMatrix4x4("ModelMatrix", mesh->getModelMatrx());	// ʵĿÿһ֡Ҫ޸ModelMatrixrenderø uniform 
+        }
 
-            // normalMatrix
-            auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(mesh->getModelMatrx())));
-            shader->setMatrix3x3("normalMatrix", normalMatrix);
+        // ģ;normalMatrixȾмãͨ PerDraw ݿ鴫
+        setPerDrawData(shader, material, packet.modelMatrix, packet.normalMatrix);
 
-            break;
-        }
-        case MaterialType::SreenMaterial: {
-            ScreenMaterial* screenMat = (ScreenMaterial*)material;
+        break;
+    }
+    case MaterialType::SreenMaterial: {
+        ScreenMaterial* screenMat = (ScreenMaterial*)material;
 
+        // ûĻʱ֡ͼĸɵ÷󶨵 0 Ԫ
+        if (screenMat->mScreenTexture != nullptr) {
+            screenMat->mScreenTexture->bind();
             shader->setInt("screenTexture", screenMat->mScreenTexture->getUnit());
-
-            break;
-        }
-        default:
-            std::cerr << "Unknown material type: " << static_cast<int>(material->mType) << std::endl;
-            break;
         }
+        shader->setVector2("uvScale", screenMat->mUvScale);
+        shader->setFloat("sharpness", screenMat->mSharpness);
 
-        //3 vao
-        glBindVertexArray(geometry->getVAO());
-
-        //4 ִл
-        glDrawElements(GL_TRIANGLES, geometry->getIndicesCount(), GL_UNSIGNED_INT, 0);
+        break;
+    }
+    default:
+        std::cerr << "Unknown material type: " << static_cast<int>(material->mType) << std::endl;
+        break;
     }
 
-    // 2 objectӽڵ㣬ÿӽڵ㶼Ҫ renderObjectDFS
-    auto children = object->getChildren();
-    for (int i = 0; i < children.size(); i++) {
-        renderObject(children[i], camera, dirLight, pointLights, ambLight);
+    //3 vaoƣ͸尴ӽѡԤ
+    if (mOverdrawActive) {
+        mOverdraw->beginMesh(*packet.name, packet.transformHandle, packet.triangleCount);
     }
-}
+    drawGeometry(geometry, material, packet.modelMatrix, camera);
+    if (mOverdrawActive) {
+        mOverdraw->endMesh();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "uniformRingBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+UniformRingBuffer::UniformRingBuffer(size_t regionSize, int regionCount, GLenum target) {
+    mTarget = target;
+    mRegionCount = regionCount > 0 ? regionCount : 1;
+
+    // 区域大小按偏移对齐要求向上取整，保证每个区域的起点都是合法偏移
+    GLint alignment = 256;
+    glGetIntegerv(target == GL_SHADER_STORAGE_BUFFER ? GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT : GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    mAlignment = alignment > 0 ? static_cast<size_t>(alignment) : 256;
+    mRegionSize = (regionSize + mAlignment - 1) / mAlignment * mAlignment;
+    mFences.assign(mRegionCount, nullptr);
+
+    // glBufferStorage 需要 OpenGL 4.4 或 ARB_buffer_storage
+    if (glBufferStorage == nullptr) {
+        std::cerr << "WARNING[UniformRingBuffer]: glBufferStorage 不可用，退回 glBufferSubData 传输每次绘制的数据" << std::endl;
+    }
+    create();
+}
+
+UniformRingBuffer::~UniformRingBuffer() {
+    destroy();
+}
+
+void UniformRingBuffer::create() {
+    GLsizeiptr totalSize = static_cast<GLsizeiptr>(mRegionSize * mRegionCount);
+
+    glGenBuffers(1, &mBuffer);
+    glBindBuffer(mTarget, mBuffer);
+    if (glBufferStorage != nullptr) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(mTarget, totalSize, nullptr, flags);
+        mMappedData = static_cast<uint8_t*>(glMapBufferRange(mTarget, 0, totalSize, flags));
+        if (mMappedData == nullptr) {
+            std::cerr << "ERROR[UniformRingBuffer]: 持久映射失败" << std::endl;
+            glBindBuffer(mTarget, 0);
+            glDeleteBuffers(1, &mBuffer);
+            mBuffer = 0;
+            return;
+        }
+    }
+    else {
+        glBufferData(mTarget, totalSize, nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBindBuffer(mTarget, 0);
+}
+
+void UniformRingBuffer::destroy() {
+    for (auto& fence : mFences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    if (mBuffer != 0) {
+        if (mMappedData != nullptr) {
+            glBindBuffer(mTarget, mBuffer);
+            glUnmapBuffer(mTarget);
+            glBindBuffer(mTarget, 0);
+            mMappedData = nullptr;
+        }
+        glDeleteBuffers(1, &mBuffer);
+        mBuffer = 0;
+    }
+}
+
+void UniformRingBuffer::fenceRegion(int region) {
+    GLsync& fence = mFences[region];
+    if (fence != nullptr) {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void UniformRingBuffer::waitRegion(int region) {
+    // 该区域上一次写入的数据可能还在被 GPU 读取，先等待它的 fence
+    GLsync& fence = mFences[region];
+    if (fence == nullptr) {
+        return;
+    }
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        // GPU 落后了 regionCount 个区域：记录一次停顿并阻塞等待
+        auto startTime = std::chrono::high_resolution_clock::now();
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);     // 每次最多等 1ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+        auto endTime = std::chrono::high_resolution_clock::now();
+
+        mStallCount++;
+        mStallTimeMs += std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void UniformRingBuffer::beginFrame() {
+    if (!isValid()) {
+        return;
+    }
+
+    // 上一帧写满过：等 GPU 读完所有区域后按新的区域大小重新分配
+    if (mPendingRegionSize > mRegionSize) {
+        for (int region = 0; region < mRegionCount; region++) {
+            waitRegion(region);
+        }
+        destroy();
+        mRegionSize = mPendingRegionSize;
+        create();
+        mCurrentRegion = -1;
+        mGrowCount++;
+        std::cout << "[UniformRingBuffer] region grown to " << mRegionSize << " bytes" << std::endl;
+        if (!isValid()) {
+            return;
+        }
+    }
+
+    mCurrentRegion = (mCurrentRegion + 1) % mRegionCount;
+    mRegionOffset = 0;
+    mFrameBytes = 0;
+    mInFrame = true;
+    waitRegion(mCurrentRegion);
+}
+
+void UniformRingBuffer::endFrame() {
+    if (!isValid() || !mInFrame) {
+        return;
+    }
+    mInFrame = false;
+
+    fenceRegion(mCurrentRegion);
+    mLastFrameBytes = mFrameBytes + mRegionOffset;
+}
+
+bool UniformRingBuffer::reserve(size_t size, size_t& offset) {
+    if (!isValid() || !mInFrame) {
+        return false;
+    }
+
+    size_t alignedSize = (size + mAlignment - 1) / mAlignment * mAlignment;
+    if (alignedSize > mRegionSize) {
+        std::cerr << "ERROR[UniformRingBuffer]: 单块数据 " << size << " 字节超过区域大小 " << mRegionSize << std::endl;
+        return false;
+    }
+
+    if (mRegionOffset + alignedSize > mRegionSize) {
+        // 区域写满：已写入的数据插入 fence，换到下一个区域继续（等待它上一次的 fence）；
+        // 下一帧开始时区域扩大一倍，避免每帧都在帧内换区域
+        mOverflowCount++;
+        mPendingRegionSize = std::max(mPendingRegionSize, mRegionSize * 2);
+        mFrameBytes += mRegionOffset;
+        fenceRegion(mCurrentRegion);
+        mCurrentRegion = (mCurrentRegion + 1) % mRegionCount;
+        mRegionOffset = 0;
+        waitRegion(mCurrentRegion);
+    }
+
+    offset = mCurrentRegion * mRegionSize + mRegionOffset;
+    mRegionOffset += alignedSize;
+    return true;
+}
+
+bool UniformRingBuffer::push(const void* data, size_t size, size_t& offset) {
+    if (!reserve(size, offset)) {
+        return false;
+    }
+
+    if (mMappedData != nullptr) {
+        std::memcpy(mMappedData + offset, data, size);   // 一致性映射：写入后无需 flush
+    }
+    else {
+        glBindBuffer(mTarget, mBuffer);
+        glBufferSubData(mTarget, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+        glBindBuffer(mTarget, 0);
+    }
+    return true;
+}
+
+void UniformRingBuffer::bindRange(GLuint bindingPoint, size_t offset, size_t size) const {
+    glBindBufferRange(mTarget, bindingPoint, mBuffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+}
+
+void UniformRingBuffer::printStats() const {
+    std::cout << "[UniformRingBuffer] region " << mRegionSize << " bytes x " << mRegionCount
+        << (isPersistent() ? " (persistent)" : " (glBufferSubData)")
+        << ", last frame " << mLastFrameBytes << " bytes"
+        << ", stalls " << mStallCount << " (" << mStallTimeMs << " ms)"
+        << ", overflows " << mOverflowCount << ", grows " << mGrowCount << std::endl;
+}
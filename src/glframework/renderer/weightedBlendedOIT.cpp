@@ -0,0 +1,207 @@
+#include "weightedBlendedOIT.h"
+#include "../renderStats.h"
+#include <iostream>
+#include <string>
+
+WeightedBlendedOIT::WeightedBlendedOIT() {
+    std::string vertexPath = std::string(SHADER_DIR) + "/oit/weightedComposite.vert";
+    std::string fragmentPath = std::string(SHADER_DIR) + "/oit/weightedComposite.frag";
+    mCompositeShader = new Shader(vertexPath.c_str(), fragmentPath.c_str());
+    glGenVertexArrays(1, &mEmptyVao);
+}
+
+WeightedBlendedOIT::~WeightedBlendedOIT() {
+    destroyTargets();
+    if (mEmptyVao != 0) {
+        glDeleteVertexArrays(1, &mEmptyVao);
+        mEmptyVao = 0;
+    }
+    delete mCompositeShader;
+}
+
+GLenum WeightedBlendedOIT::queryDepthFormat(GLuint fbo, bool& hasStencil) {
+    hasStencil = false;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+
+    // 默认帧缓冲用 GL_DEPTH / GL_STENCIL 查询，FBO 用附件点查询
+    GLenum depthAttachment = (fbo == 0) ? GL_DEPTH : GL_DEPTH_ATTACHMENT;
+    GLenum stencilAttachment = (fbo == 0) ? GL_STENCIL : GL_STENCIL_ATTACHMENT;
+
+    GLint objectType = GL_NONE;
+    glGetFramebufferAttachmentParameteriv(GL_READ_FRAMEBUFFER, depthAttachment, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &objectType);
+    if (objectType == GL_NONE) {
+        return GL_NONE;
+    }
+
+    GLint depthSize = 0;
+    GLint componentType = GL_UNSIGNED_NORMALIZED;
+    glGetFramebufferAttachmentParameteriv(GL_READ_FRAMEBUFFER, depthAttachment, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE, &depthSize);
+    glGetFramebufferAttachmentParameteriv(GL_READ_FRAMEBUFFER, depthAttachment, GL_FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE, &componentType);
+
+    GLint stencilType = GL_NONE;
+    glGetFramebufferAttachmentParameteriv(GL_READ_FRAMEBUFFER, stencilAttachment, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &stencilType);
+    if (stencilType != GL_NONE) {
+        GLint stencilSize = 0;
+        glGetFramebufferAttachmentParameteriv(GL_READ_FRAMEBUFFER, stencilAttachment, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencilSize);
+        hasStencil = stencilSize > 0;
+    }
+
+    // glBlitFramebuffer 复制深度要求两边格式完全一致
+    if (componentType == GL_FLOAT) {
+        return hasStencil ? GL_DEPTH32F_STENCIL8 : GL_DEPTH_COMPONENT32F;
+    }
+    if (hasStencil) {
+        return GL_DEPTH24_STENCIL8;
+    }
+    if (depthSize >= 32) {
+        return GL_DEPTH_COMPONENT32;
+    }
+    return depthSize <= 16 ? GL_DEPTH_COMPONENT16 : GL_DEPTH_COMPONENT24;
+}
+
+bool WeightedBlendedOIT::createTargets(int width, int height, GLenum depthFormat) {
+    destroyTargets();
+
+    glGenFramebuffers(1, &mFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, mFbo);
+
+    // 1 累积目标：半精度浮点，权重最大 3000，足够容纳多层叠加
+    glGenTextures(1, &mAccumTexture);
+    glBindTexture(GL_TEXTURE_2D, mAccumTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mAccumTexture, 0);
+
+    // 2 透射率目标：单通道
+    glGenTextures(1, &mRevealageTexture);
+    glBindTexture(GL_TEXTURE_2D, mRevealageTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, width, height, 0, GL_RED, GL_HALF_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, mRevealageTexture, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // 3 深度附件：与场景目标同格式，方便直接复制
+    if (depthFormat != GL_NONE) {
+        glGenRenderbuffers(1, &mDepthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, mDepthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, depthFormat, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        GLenum attachment = mHasStencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, mDepthBuffer);
+    }
+
+    GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, drawBuffers);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR[WeightedBlendedOIT]: OIT FBO 不完整，错误码：" << status << std::endl;
+        destroyTargets();
+        return false;
+    }
+
+    mWidth = width;
+    mHeight = height;
+    mDepthFormat = depthFormat;
+    return true;
+}
+
+void WeightedBlendedOIT::destroyTargets() {
+    if (mFbo != 0) {
+        glDeleteFramebuffers(1, &mFbo);
+        mFbo = 0;
+    }
+    if (mAccumTexture != 0) {
+        glDeleteTextures(1, &mAccumTexture);
+        mAccumTexture = 0;
+    }
+    if (mRevealageTexture != 0) {
+        glDeleteTextures(1, &mRevealageTexture);
+        mRevealageTexture = 0;
+    }
+    if (mDepthBuffer != 0) {
+        glDeleteRenderbuffers(1, &mDepthBuffer);
+        mDepthBuffer = 0;
+    }
+    mWidth = 0;
+    mHeight = 0;
+    mDepthFormat = GL_NONE;
+}
+
+bool WeightedBlendedOIT::begin(GLuint sceneFbo, int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    // 1 尺寸或深度格式变化时重建附件
+    bool hasStencil = false;
+    GLenum depthFormat = queryDepthFormat(sceneFbo, hasStencil);
+    if (mFbo == 0 || width != mWidth || height != mHeight || depthFormat != mDepthFormat || hasStencil != mHasStencil) {
+        mHasStencil = hasStencil;
+        if (!createTargets(width, height, depthFormat)) {
+            glBindFramebuffer(GL_FRAMEBUFFER, sceneFbo);
+            return false;
+        }
+    }
+
+    // 2 复制不透明物体的深度（以及模板）
+    if (mDepthFormat != GL_NONE) {
+        GLbitfield mask = GL_DEPTH_BUFFER_BIT | (mHasStencil ? GL_STENCIL_BUFFER_BIT : 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, sceneFbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFbo);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, mask, GL_NEAREST);
+    }
+
+    // 3 清空：累积为 0，透射率为 1
+    glBindFramebuffer(GL_FRAMEBUFFER, mFbo);
+    const GLfloat zero[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    const GLfloat one[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glClearBufferfv(GL_COLOR, 0, zero);
+    glClearBufferfv(GL_COLOR, 1, one);
+
+    // 4 混合状态：累积相加，透射率累乘 (1 - alpha)；深度只测试不写入
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFunci(0, GL_ONE, GL_ONE);
+    glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+    glDepthMask(GL_FALSE);
+    return true;
+}
+
+void WeightedBlendedOIT::composite(GLuint sceneFbo) {
+    glBindFramebuffer(GL_FRAMEBUFFER, sceneFbo);
+
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA);
+
+    mCompositeShader->begin();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, mAccumTexture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, mRevealageTexture);
+    mCompositeShader->setInt("accumTexture", 0);
+    mCompositeShader->setInt("revealageTexture", 1);
+
+    glBindVertexArray(mEmptyVao);
+    RenderStats::add(RenderCounter::DrawCalls);
+    RenderStats::add(RenderCounter::Triangles);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    // 恢复常用状态
+    glActiveTexture(GL_TEXTURE0);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+}
+
+size_t WeightedBlendedOIT::getMemoryBytes() const {
+    size_t pixels = static_cast<size_t>(mWidth) * static_cast<size_t>(mHeight);
+    size_t depthBytes = (mDepthFormat == GL_NONE) ? 0 : (mDepthFormat == GL_DEPTH32F_STENCIL8 ? 8 : 4);
+    return pixels * (8 + 2 + depthBytes);
+}
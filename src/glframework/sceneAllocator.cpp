@@ -0,0 +1,121 @@
+#include "sceneAllocator.h"
+#include "mesh.h"
+#include "scene.h"
+#include <algorithm>
+
+std::vector<SceneAllocator::PoolEntry>& SceneAllocator::getEntries() {
+    static std::vector<PoolEntry> entries;
+    return entries;
+}
+
+void SceneAllocator::destroyTree(Object* root) {
+    if (root == nullptr) {
+        return;
+    }
+
+    // 1 收集整棵子树（显式栈，避免深层递归）
+    std::vector<Object*> nodes;
+    std::vector<Object*> stack{ root };
+    while (!stack.empty()) {
+        Object* node = stack.back();
+        stack.pop_back();
+        nodes.push_back(node);
+        stack.insert(stack.end(), node->mChildren.begin(), node->mChildren.end());
+    }
+
+    // 2 断开关系并批量删除变换数据，再逐个释放
+    detachNodes(nodes);
+    for (auto node : nodes) {
+        releaseNode(node);
+    }
+}
+
+void SceneAllocator::releaseAll() {
+    // 1 先处理场景节点：批量断开父子关系、删除变换数据，避免逐个析构时反复查找父节点
+    std::vector<Object*> nodes;
+    auto collect = [&nodes](Object* node) { nodes.push_back(node); };
+    getPool<Object>().forEach(collect);
+    getPool<Mesh>().forEach(collect);
+    getPool<Scene>().forEach(collect);
+    detachNodes(nodes);
+
+    // 2 按登记的逆序清空所有池
+    auto& entries = getEntries();
+    for (auto iter = entries.rbegin(); iter != entries.rend(); ++iter) {
+        iter->clear(iter->pool);
+    }
+}
+
+size_t SceneAllocator::getLiveCount() {
+    size_t count = 0;
+    for (const auto& entry : getEntries()) {
+        count += entry.liveCount(entry.pool);
+    }
+    return count;
+}
+
+size_t SceneAllocator::getBlockAllocations() {
+    size_t count = 0;
+    for (const auto& entry : getEntries()) {
+        count += entry.blockAllocations(entry.pool);
+    }
+    return count;
+}
+
+void SceneAllocator::releaseNode(Object* node) {
+    switch (node->getType()) {
+    case ObjectType::Mesh: {
+        Mesh* mesh = static_cast<Mesh*>(node);
+        if (getPool<Mesh>().owns(mesh)) {
+            getPool<Mesh>().destroy(mesh);
+            return;
+        }
+        break;
+    }
+    case ObjectType::Scene: {
+        Scene* scene = static_cast<Scene*>(node);
+        if (getPool<Scene>().owns(scene)) {
+            getPool<Scene>().destroy(scene);
+            return;
+        }
+        break;
+    }
+    default:
+        if (getPool<Object>().owns(node)) {
+            getPool<Object>().destroy(node);
+            return;
+        }
+        break;
+    }
+
+    // 不在池中：是用 new 创建的
+    delete node;
+}
+
+void SceneAllocator::detachNodes(const std::vector<Object*>& nodes) {
+    // 1 孩子的父指针清空（集合外的孩子变为根节点）
+    for (auto node : nodes) {
+        for (auto child : node->mChildren) {
+            child->mParent = nullptr;
+        }
+        node->mChildren.clear();
+    }
+
+    // 2 父节点仍然存在的，说明父节点不在集合中，需要从它的孩子列表中移除
+    std::vector<TransformHandle> handles;
+    handles.reserve(nodes.size());
+    for (auto node : nodes) {
+        if (node->mParent != nullptr) {
+            auto& siblings = node->mParent->mChildren;
+            siblings.erase(std::remove(siblings.begin(), siblings.end(), node), siblings.end());
+            node->mParent = nullptr;
+        }
+        if (node->mTransform != INVALID_TRANSFORM) {
+            handles.push_back(node->mTransform);
+            node->mTransform = INVALID_TRANSFORM;
+        }
+    }
+
+    // 3 变换数据一次性压缩删除，析构时不再逐个处理
+    TransformStorage::destroyBatch(handles);
+}
@@ -0,0 +1,630 @@
+#include "sceneBVH.h"
+#include "transformStorage.h"
+#include "tools/jobSystem.h"
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cfloat>
+#include <functional>
+
+static const uint32_t INVALID_NODE = 0xFFFFFFFFu;
+static const uint32_t MAX_LEAF_SIZE = 4;
+static const int BIN_COUNT = 16;
+
+// 遍历栈每个线程一份，跨帧复用
+struct BVHStackEntry {
+    uint32_t node;
+    uint32_t planeMask;
+};
+static thread_local std::vector<BVHStackEntry> tStack;
+
+SceneBVH::SceneBVH() {}
+
+SceneBVH::~SceneBVH() {}
+
+void SceneBVH::update(Scene* scene) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // 包围盒计算会在工作线程读取世界矩阵，先在当前线程更新完
+    TransformStorage::update();
+
+    if (scene != mScene || TransformStorage::getStructureVersion() != mStructureVersion) {
+        build(scene);
+    }
+    else {
+        refit();
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    mUpdateTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+void SceneBVH::build(Scene* scene) {
+    TransformStorage::update();
+    mScene = scene;
+    mStructureVersion = TransformStorage::getStructureVersion();
+
+    // 1 收集场景中可以绘制的 Mesh
+    mMeshes.clear();
+    mUnbounded.clear();
+    if (scene != nullptr) {
+        std::vector<Object*> stack{ scene };
+        while (!stack.empty()) {
+            Object* node = stack.back();
+            stack.pop_back();
+            const auto& children = node->getChildren();
+            stack.insert(stack.end(), children.rbegin(), children.rend());
+
+            if (node->getType() != ObjectType::Mesh) {
+                continue;
+            }
+            Mesh* mesh = static_cast<Mesh*>(node);
+            if (mesh->mGeometry == nullptr || mesh->mMaterial == nullptr) {
+                continue;
+            }
+            if (mesh->mGeometry->hasBounds()) {
+                mMeshes.push_back(mesh);
+            }
+            else {
+                mUnbounded.push_back(mesh);
+            }
+        }
+    }
+
+    // 2 并行计算每个 Mesh 的世界包围盒
+    size_t count = mMeshes.size();
+    mPrimMin.resize(count);
+    mPrimMax.resize(count);
+    mPrimCentroid.resize(count);
+    mPrimVersion.resize(count);
+    mPrimLeaf.resize(count);
+    JobSystem::parallelFor(count, 256, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Mesh* mesh = mMeshes[i];
+            computeWorldBounds(mesh->mGeometry, mesh->getModelMatrx(), mPrimMin[i], mPrimMax[i]);
+            mPrimCentroid[i] = (mPrimMin[i] + mPrimMax[i]) * 0.5f;
+            mPrimVersion[i] = TransformStorage::getWorldVersion(mesh->getTransformHandle());
+        }
+    });
+
+    // 3 构建
+    rebuild();
+}
+
+void SceneBVH::rebuild() {
+    uint32_t count = static_cast<uint32_t>(mMeshes.size());
+    mPrimIndices.resize(count);
+    std::iota(mPrimIndices.begin(), mPrimIndices.end(), 0u);
+
+    mFullRebuilds++;
+    mOrphanNodes = 0;
+    if (count == 0) {
+        mNodeCount = 0;
+        return;
+    }
+
+    // 最多 2N - 1 个节点，预先分配好，并行构建时只需原子地领取下标
+    size_t capacity = static_cast<size_t>(count) * 2;
+    mNodes.resize(capacity);
+    mNodeParents.resize(capacity);
+    mNodeRangeBegin.resize(capacity);
+    mNodeRangeEnd.resize(capacity);
+    mNodeBuildArea.resize(capacity);
+    mNodeAllocator.store(1);
+    mNodeParents[0] = INVALID_NODE;
+
+    // 根部串行展开，图元数不超过 grain 的子树作为任务并行构建
+    size_t threadCount = JobSystem::getWorkerCount() + 1;
+    mParallelGrain = std::max<uint32_t>(1024, static_cast<uint32_t>(count / (threadCount * 8)));
+    std::vector<BuildTask> tasks;
+    buildNode(0, 0, count, &tasks);
+    JobSystem::parallelFor(tasks.size(), 1, [this, &tasks](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            buildNode(tasks[i].nodeIndex, tasks[i].begin, tasks[i].end, nullptr);
+        }
+    });
+
+    mNodeCount = mNodeAllocator.load();
+}
+
+void SceneBVH::buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, std::vector<BuildTask>* parallelTasks) {
+    uint32_t count = end - begin;
+    if (parallelTasks != nullptr && count <= mParallelGrain) {
+        BuildTask task;
+        task.nodeIndex = nodeIndex;
+        task.begin = begin;
+        task.end = end;
+        parallelTasks->push_back(task);
+        return;
+    }
+
+    // 1 节点包围盒与图元中心的包围盒
+    glm::vec3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+    glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t prim = mPrimIndices[i];
+        boundsMin = glm::min(boundsMin, mPrimMin[prim]);
+        boundsMax = glm::max(boundsMax, mPrimMax[prim]);
+        centroidMin = glm::min(centroidMin, mPrimCentroid[prim]);
+        centroidMax = glm::max(centroidMax, mPrimCentroid[prim]);
+    }
+
+    Node& node = mNodes[nodeIndex];
+    node.boundsMin = boundsMin;
+    node.boundsMax = boundsMax;
+    mNodeRangeBegin[nodeIndex] = begin;
+    mNodeRangeEnd[nodeIndex] = end;
+    mNodeBuildArea[nodeIndex] = surfaceArea(boundsMin, boundsMax);
+
+    // 2 选择划分位置：SAH 不值得划分且图元不多时做成叶子，否则退回中位数划分
+    uint32_t split = begin;
+    if (count > 2) {
+        split = partition(begin, end, centroidMin, centroidMax);
+    }
+    if (split == begin && count > MAX_LEAF_SIZE) {
+        glm::vec3 extent = centroidMax - centroidMin;
+        int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        split = begin + count / 2;
+        std::nth_element(mPrimIndices.begin() + begin, mPrimIndices.begin() + split, mPrimIndices.begin() + end,
+            [this, axis](uint32_t a, uint32_t b) { return mPrimCentroid[a][axis] < mPrimCentroid[b][axis]; });
+    }
+
+    if (split == begin) {
+        node.first = begin;
+        node.count = count;
+        for (uint32_t i = begin; i < end; i++) {
+            mPrimLeaf[mPrimIndices[i]] = nodeIndex;
+        }
+        return;
+    }
+
+    // 3 内部节点：左右孩子相邻存放
+    uint32_t children = allocateNodePair();
+    node.first = children;
+    node.count = 0;
+    mNodeParents[children] = nodeIndex;
+    mNodeParents[children + 1] = nodeIndex;
+    buildNode(children, begin, split, parallelTasks);
+    buildNode(children + 1, split, end, parallelTasks);
+}
+
+uint32_t SceneBVH::partition(uint32_t begin, uint32_t end, const glm::vec3& centroidMin, const glm::vec3& centroidMax) {
+    struct Bin {
+        glm::vec3 boundsMin{ FLT_MAX };
+        glm::vec3 boundsMax{ -FLT_MAX };
+        uint32_t count{ 0 };
+    };
+
+    uint32_t count = end - begin;
+    float bestCost = FLT_MAX;
+    int bestBin = -1;
+
+    // 只在图元中心分布最长的轴上分桶（比三个轴都试一遍快约三倍，质量相差不大）
+    glm::vec3 extent = centroidMax - centroidMin;
+    int bestAxis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+    if (extent[bestAxis] <= 1e-6f) {
+        return begin;
+    }
+
+    // 1 图元按中心分到各个桶
+    Bin bins[BIN_COUNT];
+    float scale = BIN_COUNT / extent[bestAxis];
+    float minimum = centroidMin[bestAxis];
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t prim = mPrimIndices[i];
+        int b = std::min(BIN_COUNT - 1, static_cast<int>((mPrimCentroid[prim][bestAxis] - minimum) * scale));
+        bins[b].boundsMin = glm::min(bins[b].boundsMin, mPrimMin[prim]);
+        bins[b].boundsMax = glm::max(bins[b].boundsMax, mPrimMax[prim]);
+        bins[b].count++;
+    }
+
+    // 2 从左右两侧累加，得到每个划分平面两侧的面积与图元数
+    float leftArea[BIN_COUNT - 1], rightArea[BIN_COUNT - 1];
+    uint32_t leftCount[BIN_COUNT - 1], rightCount[BIN_COUNT - 1];
+    glm::vec3 leftMin(FLT_MAX), leftMax(-FLT_MAX), rightMin(FLT_MAX), rightMax(-FLT_MAX);
+    uint32_t leftSum = 0, rightSum = 0;
+    for (int i = 0; i < BIN_COUNT - 1; i++) {
+        leftSum += bins[i].count;
+        leftMin = glm::min(leftMin, bins[i].boundsMin);
+        leftMax = glm::max(leftMax, bins[i].boundsMax);
+        leftCount[i] = leftSum;
+        leftArea[i] = leftSum > 0 ? surfaceArea(leftMin, leftMax) : 0.0f;
+
+        int j = BIN_COUNT - 1 - i;
+        rightSum += bins[j].count;
+        rightMin = glm::min(rightMin, bins[j].boundsMin);
+        rightMax = glm::max(rightMax, bins[j].boundsMax);
+        rightCount[j - 1] = rightSum;
+        rightArea[j - 1] = rightSum > 0 ? surfaceArea(rightMin, rightMax) : 0.0f;
+    }
+
+    for (int i = 0; i < BIN_COUNT - 1; i++) {
+        if (leftCount[i] == 0 || rightCount[i] == 0) {
+            continue;
+        }
+        float cost = leftArea[i] * leftCount[i] + rightArea[i] * rightCount[i];
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestBin = i;
+        }
+    }
+
+    if (bestBin < 0) {
+        return begin;
+    }
+
+    // 3 与不划分（所有图元留在一个叶子中）比较：遍历代价取 1，单个图元检测代价取 1
+    if (count <= MAX_LEAF_SIZE) {
+        glm::vec3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+        for (uint32_t i = begin; i < end; i++) {
+            boundsMin = glm::min(boundsMin, mPrimMin[mPrimIndices[i]]);
+            boundsMax = glm::max(boundsMax, mPrimMax[mPrimIndices[i]]);
+        }
+        float area = surfaceArea(boundsMin, boundsMax);
+        if (area <= 0.0f || 1.0f + bestCost / area >= static_cast<float>(count)) {
+            return begin;
+        }
+    }
+
+    // 4 按桶下标原地划分图元
+    auto middle = std::partition(mPrimIndices.begin() + begin, mPrimIndices.begin() + end, [&](uint32_t prim) {
+        int b = std::min(BIN_COUNT - 1, static_cast<int>((mPrimCentroid[prim][bestAxis] - minimum) * scale));
+        return b <= bestBin;
+    });
+    uint32_t split = static_cast<uint32_t>(middle - mPrimIndices.begin());
+    return (split == begin || split == end) ? begin : split;
+}
+
+void SceneBVH::refit() {
+    mRefitCount = 0;
+    if (mNodeCount == 0) {
+        return;
+    }
+
+    // 1 找出移动过的 Mesh（比较世界矩阵版本号），重新计算包围盒，记录所在叶子
+    mDirtyNodes.clear();
+    mNodeFlags.resize(mNodes.size(), 0);
+    for (uint32_t i = 0; i < mMeshes.size(); i++) {
+        Mesh* mesh = mMeshes[i];
+        uint32_t version = TransformStorage::getWorldVersion(mesh->getTransformHandle());
+        if (version == mPrimVersion[i]) {
+            continue;
+        }
+        mPrimVersion[i] = version;
+        computeWorldBounds(mesh->mGeometry, mesh->getModelMatrx(), mPrimMin[i], mPrimMax[i]);
+        mPrimCentroid[i] = (mPrimMin[i] + mPrimMax[i]) * 0.5f;
+        mRefitCount++;
+
+        // 沿父链向上标记，已经标记过的祖先不再重复
+        for (uint32_t node = mPrimLeaf[i]; node != INVALID_NODE && !mNodeFlags[node]; node = mNodeParents[node]) {
+            mNodeFlags[node] = 1;
+            mDirtyNodes.push_back(node);
+        }
+    }
+    if (mDirtyNodes.empty()) {
+        return;
+    }
+
+    // 2 孩子的下标总是大于父节点，按下标从大到小更新即可保证先孩子后父亲
+    std::sort(mDirtyNodes.begin(), mDirtyNodes.end(), std::greater<uint32_t>());
+    for (auto nodeIndex : mDirtyNodes) {
+        Node& node = mNodes[nodeIndex];
+        if (node.count > 0) {
+            glm::vec3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                boundsMin = glm::min(boundsMin, mPrimMin[mPrimIndices[i]]);
+                boundsMax = glm::max(boundsMax, mPrimMax[mPrimIndices[i]]);
+            }
+            node.boundsMin = boundsMin;
+            node.boundsMax = boundsMax;
+        }
+        else {
+            const Node& left = mNodes[node.first];
+            const Node& right = mNodes[node.first + 1];
+            node.boundsMin = glm::min(left.boundsMin, right.boundsMin);
+            node.boundsMax = glm::max(left.boundsMax, right.boundsMax);
+        }
+    }
+
+    // 3 找出退化的子树：从上往下，已经选中的子树内部不再重复选择
+    std::vector<uint32_t> rebuildRoots;
+    for (auto iter = mDirtyNodes.rbegin(); iter != mDirtyNodes.rend(); ++iter) {
+        uint32_t nodeIndex = *iter;
+        const Node& node = mNodes[nodeIndex];
+        if (node.count > 0) {
+            continue;
+        }
+        if (surfaceArea(node.boundsMin, node.boundsMax) <= mNodeBuildArea[nodeIndex] * mDegradeFactor) {
+            continue;
+        }
+
+        bool covered = false;
+        for (uint32_t parent = mNodeParents[nodeIndex]; parent != INVALID_NODE; parent = mNodeParents[parent]) {
+            if (mNodeFlags[parent] == 2) {
+                covered = true;
+                break;
+            }
+        }
+        if (!covered) {
+            mNodeFlags[nodeIndex] = 2;
+            rebuildRoots.push_back(nodeIndex);
+        }
+    }
+
+    for (auto nodeIndex : mDirtyNodes) {
+        mNodeFlags[nodeIndex] = 0;
+    }
+
+    // 4 局部重建；废弃节点过多时整体重建以压缩节点数组
+    for (auto nodeIndex : rebuildRoots) {
+        if (nodeIndex == 0) {
+            rebuild();
+            return;
+        }
+        rebuildSubtree(nodeIndex);
+    }
+    if (mOrphanNodes > mNodeCount / 2) {
+        rebuild();
+    }
+}
+
+void SceneBVH::rebuildSubtree(uint32_t nodeIndex) {
+    // 统计旧子树的节点数（根节点原地复用）
+    uint32_t oldNodes = 0;
+    auto& stack = tStack;
+    stack.clear();
+    stack.push_back({ nodeIndex, 0 });
+    while (!stack.empty()) {
+        const Node& node = mNodes[stack.back().node];
+        stack.pop_back();
+        if (node.count == 0) {
+            oldNodes += 2;
+            stack.push_back({ node.first, 0 });
+            stack.push_back({ node.first + 1, 0 });
+        }
+    }
+
+    // 新节点追加到数组末尾
+    uint32_t begin = mNodeRangeBegin[nodeIndex];
+    uint32_t end = mNodeRangeEnd[nodeIndex];
+    size_t capacity = static_cast<size_t>(mNodeAllocator.load()) + static_cast<size_t>(end - begin) * 2;
+    if (capacity > mNodes.size()) {
+        mNodes.resize(capacity);
+        mNodeParents.resize(capacity);
+        mNodeRangeBegin.resize(capacity);
+        mNodeRangeEnd.resize(capacity);
+        mNodeBuildArea.resize(capacity);
+        mNodeFlags.resize(capacity, 0);
+    }
+
+    buildNode(nodeIndex, begin, end, nullptr);
+    mNodeCount = mNodeAllocator.load();
+    mOrphanNodes += oldNodes;
+    mPartialRebuilds++;
+}
+
+uint32_t SceneBVH::allocateNodePair() {
+    return mNodeAllocator.fetch_add(2);
+}
+
+void SceneBVH::queryFrustum(const glm::vec4 planes[6], std::vector<Mesh*>& out) const {
+    if (mNodeCount == 0) {
+        mVisitedNodes.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    // planeMask 中为 1 的平面还需要检测；包围盒完全在某个平面内侧时，其子树不再检测该平面
+    size_t visited = 0;
+    auto& stack = tStack;
+    stack.clear();
+    stack.push_back({ 0, 0x3F });
+    while (!stack.empty()) {
+        BVHStackEntry entry = stack.back();
+        stack.pop_back();
+        const Node& node = mNodes[entry.node];
+        visited++;
+
+        glm::vec3 center = (node.boundsMin + node.boundsMax) * 0.5f;
+        glm::vec3 extent = (node.boundsMax - node.boundsMin) * 0.5f;
+        uint32_t mask = entry.planeMask;
+        bool outside = false;
+        for (int i = 0; i < 6; i++) {
+            if (!(mask & (1u << i))) {
+                continue;
+            }
+            glm::vec3 normal(planes[i]);
+            float distance = glm::dot(normal, center) + planes[i].w;
+            float radius = glm::dot(glm::abs(normal), extent);
+            if (distance + radius < 0.0f) {
+                outside = true;
+                break;
+            }
+            if (distance - radius >= 0.0f) {
+                mask &= ~(1u << i);
+            }
+        }
+        if (outside) {
+            continue;
+        }
+
+        // 整棵子树都在视锥内：直接输出子树中的所有 Mesh
+        if (mask == 0) {
+            for (uint32_t i = mNodeRangeBegin[entry.node]; i < mNodeRangeEnd[entry.node]; i++) {
+                out.push_back(mMeshes[mPrimIndices[i]]);
+            }
+            continue;
+        }
+
+        if (node.count > 0) {
+            // 叶子中的图元逐个检测剩余的平面
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                uint32_t prim = mPrimIndices[i];
+                glm::vec3 primCenter = (mPrimMin[prim] + mPrimMax[prim]) * 0.5f;
+                glm::vec3 primExtent = (mPrimMax[prim] - mPrimMin[prim]) * 0.5f;
+                bool visible = true;
+                for (int p = 0; p < 6 && visible; p++) {
+                    if (!(mask & (1u << p))) {
+                        continue;
+                    }
+                    glm::vec3 normal(planes[p]);
+                    float distance = glm::dot(normal, primCenter) + planes[p].w;
+                    visible = distance + glm::dot(glm::abs(normal), primExtent) >= 0.0f;
+                }
+                if (visible) {
+                    out.push_back(mMeshes[prim]);
+                }
+            }
+            continue;
+        }
+
+        stack.push_back({ node.first + 1, mask });
+        stack.push_back({ node.first, mask });
+    }
+
+    mVisitedNodes.store(visited, std::memory_order_relaxed);
+}
+
+void SceneBVH::queryAABB(const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<Mesh*>& out) const {
+    if (mNodeCount == 0) {
+        return;
+    }
+
+    auto overlaps = [&](const glm::vec3& otherMin, const glm::vec3& otherMax) {
+        return glm::all(glm::lessThanEqual(boundsMin, otherMax)) && glm::all(glm::lessThanEqual(otherMin, boundsMax));
+    };
+
+    size_t visited = 0;
+    auto& stack = tStack;
+    stack.clear();
+    stack.push_back({ 0, 0 });
+    while (!stack.empty()) {
+        const Node& node = mNodes[stack.back().node];
+        stack.pop_back();
+        visited++;
+        if (!overlaps(node.boundsMin, node.boundsMax)) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                uint32_t prim = mPrimIndices[i];
+                if (overlaps(mPrimMin[prim], mPrimMax[prim])) {
+                    out.push_back(mMeshes[prim]);
+                }
+            }
+            continue;
+        }
+        stack.push_back({ node.first + 1, 0 });
+        stack.push_back({ node.first, 0 });
+    }
+
+    mVisitedNodes.store(visited, std::memory_order_relaxed);
+}
+
+void SceneBVH::querySphere(const glm::vec3& center, float radius, std::vector<Mesh*>& out) const {
+    if (mNodeCount == 0) {
+        return;
+    }
+
+    // 球心到包围盒的最近点距离不超过半径即相交
+    float radiusSquared = radius * radius;
+    auto overlaps = [&](const glm::vec3& otherMin, const glm::vec3& otherMax) {
+        glm::vec3 closest = glm::clamp(center, otherMin, otherMax);
+        glm::vec3 offset = closest - center;
+        return glm::dot(offset, offset) <= radiusSquared;
+    };
+
+    size_t visited = 0;
+    auto& stack = tStack;
+    stack.clear();
+    stack.push_back({ 0, 0 });
+    while (!stack.empty()) {
+        const Node& node = mNodes[stack.back().node];
+        stack.pop_back();
+        visited++;
+        if (!overlaps(node.boundsMin, node.boundsMax)) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                uint32_t prim = mPrimIndices[i];
+                if (overlaps(mPrimMin[prim], mPrimMax[prim])) {
+                    out.push_back(mMeshes[prim]);
+                }
+            }
+            continue;
+        }
+        stack.push_back({ node.first + 1, 0 });
+        stack.push_back({ node.first, 0 });
+    }
+
+    mVisitedNodes.store(visited, std::memory_order_relaxed);
+}
+
+void SceneBVH::queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<RayHit>& out) const {
+    if (mNodeCount == 0) {
+        return;
+    }
+
+    // slab 方法：返回射线进入包围盒的参数，不相交时返回负数
+    glm::vec3 invDirection = 1.0f / direction;
+    auto intersect = [&](const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        glm::vec3 t0 = (boundsMin - origin) * invDirection;
+        glm::vec3 t1 = (boundsMax - origin) * invDirection;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+        return enter <= exit ? enter : -1.0f;
+    };
+
+    size_t firstHit = out.size();
+    size_t visited = 0;
+    auto& stack = tStack;
+    stack.clear();
+    stack.push_back({ 0, 0 });
+    while (!stack.empty()) {
+        const Node& node = mNodes[stack.back().node];
+        stack.pop_back();
+        visited++;
+        if (intersect(node.boundsMin, node.boundsMax) < 0.0f) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                uint32_t prim = mPrimIndices[i];
+                float t = intersect(mPrimMin[prim], mPrimMax[prim]);
+                if (t >= 0.0f) {
+                    RayHit hit;
+                    hit.mesh = mMeshes[prim];
+                    hit.t = t;
+                    out.push_back(hit);
+                }
+            }
+            continue;
+        }
+        stack.push_back({ node.first + 1, 0 });
+        stack.push_back({ node.first, 0 });
+    }
+
+    std::sort(out.begin() + firstHit, out.end(), [](const RayHit& a, const RayHit& b) { return a.t < b.t; });
+    mVisitedNodes.store(visited, std::memory_order_relaxed);
+}
+
+void SceneBVH::computeWorldBounds(const Geometry* geometry, const glm::mat4& modelMatrix, glm::vec3& boundsMin, glm::vec3& boundsMax) {
+    // 中心点直接变换，半长取矩阵绝对值后变换
+    glm::vec3 localCenter = (geometry->getBoundsMin() + geometry->getBoundsMax()) * 0.5f;
+    glm::vec3 localExtent = (geometry->getBoundsMax() - geometry->getBoundsMin()) * 0.5f;
+    glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(localCenter, 1.0f));
+    glm::mat3 absMatrix = glm::mat3(modelMatrix);
+    for (int c = 0; c < 3; c++) {
+        absMatrix[c] = glm::abs(absMatrix[c]);
+    }
+    glm::vec3 extent = absMatrix * localExtent;
+    boundsMin = center - extent;
+    boundsMax = center + extent;
+}
+
+float SceneBVH::surfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    glm::vec3 size = glm::max(boundsMax - boundsMin, glm::vec3(0.0f));
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
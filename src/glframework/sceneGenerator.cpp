@@ -0,0 +1,233 @@
+#include "sceneGenerator.h"
+#include "sceneAllocator.h"
+#include "shader.h"
+#include "texture.h"
+#include "material/phongMaterial.h"
+#include "material/PBRMaterial.h"
+#include "material/whiteMaterial.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+// 只使用 mt19937 的原始输出，保证同一个种子在各平台上生成同样的场景
+class SceneRandom {
+public:
+    explicit SceneRandom(uint32_t seed) : mEngine(seed) {}
+
+    // [0, 1)
+    float next() { return static_cast<float>(mEngine() >> 8) * (1.0f / 16777216.0f); }
+    float range(float min, float max) { return min + (max - min) * next(); }
+
+    // [0, count)
+    int index(int count) { return count > 0 ? static_cast<int>(mEngine() % static_cast<uint32_t>(count)) : 0; }
+
+    glm::vec3 inCube(float halfSize) { return glm::vec3(range(-halfSize, halfSize), range(-halfSize, halfSize), range(-halfSize, halfSize)); }
+    glm::vec3 color(float min) { return glm::vec3(range(min, 1.0f), range(min, 1.0f), range(min, 1.0f)); }
+
+private:
+    std::mt19937 mEngine;
+};
+
+GeneratedScene::~GeneratedScene() {
+    SceneAllocator::destroyTree(mScene);
+    // Material 的析构函数不是虚函数，按类型释放
+    for (auto material : mMaterials) {
+        switch (material->mType) {
+        case MaterialType::PhongMaterial:
+            delete static_cast<PhongMaterial*>(material);
+            break;
+        case MaterialType::PBRMaterial:
+            delete static_cast<PBRMaterial*>(material);
+            break;
+        default:
+            delete static_cast<WhiteMaterial*>(material);
+            break;
+        }
+    }
+    for (auto geometry : mGeometries) {
+        delete geometry;
+    }
+    for (auto shader : mShaders) {
+        delete shader;
+    }
+    for (auto light : mDirectionalLights) {
+        delete light;
+    }
+    for (auto light : mPointLights) {
+        delete light;
+    }
+    for (auto light : mSpotLights) {
+        delete light;
+    }
+    delete mAmbientLight;
+}
+
+std::vector<ShaderMacro> SceneGenerator::getShaderMacros(const SceneGeneratorConfig& config) {
+    // 没有点光源时仍保留一个（颜色为 0 的占位光源），GLSL 不允许长度为 0 的数组
+    int pointLights = std::max(1, config.pointLightCount);
+    return { ShaderMacro("POINT_LIGHT_COUNT", std::to_string(pointLights), ShaderTarget::FRAGMENT, "点光源数量") };
+}
+
+GeneratedScene* SceneGenerator::generate(const SceneGeneratorConfig& config) {
+    SceneRandom random(config.seed);
+    GeneratedScene* result = new GeneratedScene();
+
+    int meshCount = std::max(0, config.meshCount);
+    float halfSize = config.spacing * std::cbrt(static_cast<float>(std::max(1, meshCount))) * 0.5f;
+    result->mRadius = halfSize * std::sqrt(3.0f) + config.spacing;
+
+    //1 几何体：立方体 / 球 / 平面轮流，尺寸与细分随机
+    int geometryCount = std::max(1, config.geometryCount);
+    for (int i = 0; i < geometryCount; i++) {
+        Geometry* geometry = nullptr;
+        switch (i % 3) {
+        case 0:
+            geometry = Geometry::createBox(random.range(0.5f, 1.5f));
+            break;
+        case 1: {
+            int segments = 8 + random.index(41);
+            geometry = Geometry::createSphere(random.range(0.4f, 0.9f), segments, segments);
+            break;
+        }
+        default:
+            geometry = Geometry::createPlane(random.range(0.8f, 2.0f), random.range(0.8f, 2.0f));
+            break;
+        }
+        result->mGeometries.push_back(geometry);
+    }
+
+    //2 shader 与材质
+    std::vector<ShaderMacro> macros = getShaderMacros(config);
+    std::string shaderDir = SHADER_DIR;
+    Shader* phongShader = new Shader((shaderDir + getPhongVertexPath()).c_str(), (shaderDir + getPhongFragmentPath()).c_str(), macros);
+    Shader* pbrShader = new Shader((shaderDir + getPBRVertexPath()).c_str(), (shaderDir + getPBRFragmentPath()).c_str(), macros);
+    Shader* whiteShader = new Shader((shaderDir + getWhiteVertexPath()).c_str(), (shaderDir + getWhiteFragmentPath()).c_str());
+    result->mShaders = { phongShader, pbrShader, whiteShader };
+
+    // Phong 材质的 Renderer 需要漫反射贴图与高光蒙版，所有 Phong 材质共用（纹理有缓存）
+    Texture* diffuse = Texture::createTexture(std::string(TEXTURE_DIR) + "/container2.png", 0);
+    Texture* specularMask = Texture::createTexture(std::string(TEXTURE_DIR) + "/container2_specular.png", 1);
+
+    auto createMaterial = [&](int type) -> Material* {
+        if (type == 0) {
+            PhongMaterial* material = new PhongMaterial();
+            material->mDiffuse = diffuse;
+            material->mSpecularMask = specularMask;
+            material->setShiness(random.range(8.0f, 128.0f));
+            material->setDiffuseColor(random.color(0.2f));
+            material->setShader(phongShader);
+            return material;
+        }
+        if (type == 1) {
+            PBRMaterial* material = new PBRMaterial();
+            material->setMetallic(random.next());
+            material->setRoughness(random.range(0.1f, 1.0f));
+            material->setShader(pbrShader);
+            return material;
+        }
+        WhiteMaterial* material = new WhiteMaterial();
+        material->setShader(whiteShader);
+        return material;
+    };
+
+    std::vector<int> types;
+    types.insert(types.end(), std::max(0, config.phongMaterialCount), 0);
+    types.insert(types.end(), std::max(0, config.pbrMaterialCount), 1);
+    types.insert(types.end(), std::max(0, config.whiteMaterialCount), 2);
+    if (types.empty()) {
+        types.push_back(2);
+    }
+    for (int type : types) {
+        result->mMaterials.push_back(createMaterial(type));
+    }
+
+    // 透明：每个材质一个混合版本（与 setModelBlend 相同的设置）
+    float transparentRatio = std::min(1.0f, std::max(0.0f, config.transparentRatio));
+    size_t opaqueCount = result->mMaterials.size();
+    if (transparentRatio > 0.0f) {
+        for (int type : types) {
+            Material* material = createMaterial(type);
+            material->mBlend = true;
+            material->mDepthWrite = false;
+            material->mOpacity = random.range(0.3f, 0.8f);
+            result->mMaterials.push_back(material);
+        }
+    }
+
+    //3 节点：第 0 层挂在 Scene 下均匀分布在立方体内，更深的层挂在上一层的随机节点下，相对父节点偏移
+    result->mScene = SceneAllocator::create<Scene>();
+    result->mScene->setName("StressScene");
+    int depth = std::max(1, config.hierarchyDepth);
+    std::vector<std::vector<Mesh*>> levels(depth);
+    result->mMeshes.reserve(meshCount);
+    for (int i = 0; i < meshCount; i++) {
+        int level = random.index(depth);
+        while (level > 0 && levels[level - 1].empty()) {
+            level--;
+        }
+
+        bool transparent = transparentRatio > 0.0f && random.next() < transparentRatio;
+        size_t materialIndex = static_cast<size_t>(random.index(static_cast<int>(opaqueCount)));
+        Material* material = result->mMaterials[transparent ? opaqueCount + materialIndex : materialIndex];
+        Geometry* geometry = result->mGeometries[random.index(geometryCount)];
+
+        Mesh* mesh = SceneAllocator::create<Mesh>(geometry, material);
+        if (level == 0) {
+            mesh->setPosition(random.inCube(halfSize));
+            result->mScene->addChild(mesh);
+        }
+        else {
+            const auto& parents = levels[level - 1];
+            mesh->setPosition(random.inCube(config.spacing));
+            parents[random.index(static_cast<int>(parents.size()))]->addChild(mesh);
+        }
+        mesh->setAngleX(random.range(0.0f, 360.0f));
+        mesh->setAngleY(random.range(0.0f, 360.0f));
+
+        levels[level].push_back(mesh);
+        result->mMeshes.push_back(mesh);
+        result->mTriangleCount += geometry->getIndicesCount() / 3;
+        if (transparent) {
+            result->mTransparentCount++;
+        }
+    }
+
+    //4 光源：数量为 0 时生成一个颜色为 0 的占位光源（Renderer 的接口需要至少一个）
+    int directionalCount = std::max(1, config.directionalLightCount);
+    for (int i = 0; i < directionalCount; i++) {
+        DirectionalLight* light = new DirectionalLight();
+        light->setDirection(glm::vec3(random.range(-1.0f, 1.0f), random.range(-1.0f, -0.2f), random.range(-1.0f, 1.0f)));
+        light->setColor(config.directionalLightCount > 0 ? random.color(0.5f) : glm::vec3(0.0f));
+        result->mDirectionalLights.push_back(light);
+    }
+
+    int pointCount = std::max(1, config.pointLightCount);
+    for (int i = 0; i < pointCount; i++) {
+        PointLight* light = new PointLight();
+        light->setPosition(random.inCube(halfSize));
+        light->setColor(config.pointLightCount > 0 ? random.color(0.3f) : glm::vec3(0.0f));
+        light->setK1(0.09f);
+        light->setK2(0.032f);
+        light->setKc(1.0f);
+        result->mPointLights.push_back(light);
+    }
+
+    int spotCount = std::max(1, config.spotLightCount);
+    for (int i = 0; i < spotCount; i++) {
+        SpotLight* light = new SpotLight();
+        glm::vec3 position = random.inCube(halfSize);
+        glm::vec3 direction = glm::length(position) > 0.0f ? glm::normalize(-position) : glm::vec3(0.0f, -1.0f, 0.0f);
+        light->setPosition(position);
+        light->setTargetDirection(direction);
+        light->setInnerAngle(random.range(15.0f, 30.0f));
+        light->setOuterAngle(light->getInnerAngle() + 15.0f);
+        light->setColor(config.spotLightCount > 0 ? random.color(0.3f) : glm::vec3(0.0f));
+        result->mSpotLights.push_back(light);
+    }
+
+    result->mAmbientLight = new AmbientLight();
+    result->mAmbientLight->setColor(glm::vec3(0.2f));
+
+    return result;
+}
@@ -1,5 +1,8 @@
 #include "shader.h"
+#include "shaderPreprocessor.h"
 #include "checkError.h"  // OpenGL飨SDL2ģ
+#include "renderStats.h"
+#include "profiler.h"
 
 #include<glad/glad.h>	// Ҫ glfw3.h ǰ
 #include <string>
@@ -9,39 +12,17 @@
 #include <glm/gtc/type_ptr.hpp>
 
 // 캯ļزʼɫ
-Shader::Shader(const char* vertexPath, const char* fragmentPath) {
+Shader::Shader(const char* vertexPath, const char* fragmentPath)
+    : mVertexPath(vertexPath), mFragmentPath(fragmentPath) {
+    PROFILE_SCOPE_DETAIL("Shader::compile", fragmentPath);
     // SDL2ؼԼ˹캯ڡSDL_GL_CreateContext()֮á
     // ԭOpenGLglCreateShaderҪЧĲִУ򴥷GL_INVALID_OPERATION
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-
-    // ļ׳쳣ļ/ȡʧܣ
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-    try {
-        // ɫļ·SDLĿ¼ƥ䣩
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-
-        // ȡļݵַ
-        std::stringstream vShaderStream, fShaderStream;
-        vShaderStream << vShaderFile.rdbuf();  // ȡɫ
-        fShaderStream << fShaderFile.rdbuf();  // ȡƬɫ
-
-        // رļȡɺͷԴ
-        vShaderFile.close();
-        fShaderFile.close();
-
-        // תΪַʽɫԴ
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    }
-    catch (std::ifstream::failure& e) {
-        std::cerr << "ERROR[Shader]: ɫļʧ - " << e.what() << std::endl;
-        std::cerr << "ʾɫļ·ǷSDLĿ¼һ" << std::endl;
+    // ͨԤȡ֧ #includeظȡͬһļл
+    std::string vertexCode = ShaderPreprocessor::process(vertexPath, std::vector<ShaderMacro>{});
+    std::string fragmentCode = ShaderPreprocessor::process(fragmentPath, std::vector<ShaderMacro>{});
+    if (vertexCode.empty() || fragmentCode.empty()) {
+        std::cerr << "ERROR[Shader]: ɫļȡʧ" << std::endl;
+        std::cerr << "ʾɫļ·ǷSDLĿ¼һ" << std::endl;
     }
 
     // תΪCַOpenGLӿҪ
@@ -66,6 +47,8 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     GL_CALL(glAttachShader(mProgram, fragmentShader));// Ƭɫ
     GL_CALL(glLinkProgram(mProgram));                 // ִ
     checkShaderErrors(mProgram, "LINK");              // Ӵ
+    bindUniformBlocks();                              //  uniform ݿ
+    GLDebug::setLabel(GL_PROGRAM, mProgram, mFragmentPath);  // Ϣʾ shader ļ
 
     // 4. мԴɺ󣬵ɫɾ
     GL_CALL(glDeleteShader(vertexShader));
@@ -74,7 +57,9 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
 
 
 // 캯Դַأֱù෵صַ
-Shader::Shader(const char* vertexPath, const char* fragmentPath, std::vector<ShaderMacro> macros) {
+Shader::Shader(const char* vertexPath, const char* fragmentPath, std::vector<ShaderMacro> macros)
+    : mVertexPath(vertexPath), mFragmentPath(fragmentPath), mMacros(macros) {
+    PROFILE_SCOPE_DETAIL("Shader::compile", fragmentPath);
     std::string VertSource = Tools::readShaderSourceWithMacros(vertexPath, macros);
     std::string FragSource = Tools::readShaderSourceWithMacros(fragmentPath, macros);
 
@@ -100,16 +85,49 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath, std::vector<Sha
     GL_CALL(glAttachShader(mProgram, fragmentShader));// Ƭɫ
     GL_CALL(glLinkProgram(mProgram));                 // ִ
     checkShaderErrors(mProgram, "LINK");              // Ӵ
+    bindUniformBlocks();                              //  uniform ݿ
+    GLDebug::setLabel(GL_PROGRAM, mProgram, mFragmentPath);  // Ϣʾ shader ļ
 
     // 4. мԴɺ󣬵ɫɾ
     GL_CALL(glDeleteShader(vertexShader));
     GL_CALL(glDeleteShader(fragmentShader));
 }
 
+// ɫһ׶Σͬ
+Shader* Shader::createCompute(const char* computePath, std::vector<ShaderMacro> macros) {
+    PROFILE_SCOPE_DETAIL("Shader::createCompute", computePath);
+    std::string computeCode = Tools::readShaderSourceWithMacros(computePath, macros);
+    if (computeCode.empty()) {
+        std::cerr << "ERROR[Shader]: ɫļȡʧܣ" << computePath << std::endl;
+    }
+    const char* computeShaderSource = computeCode.c_str();
+
+    Shader* shader = new Shader();
+    shader->mMacros = macros;
+
+    GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
+    GL_CALL(glShaderSource(computeShader, 1, &computeShaderSource, nullptr));
+    GL_CALL(glCompileShader(computeShader));
+    shader->checkShaderErrors(computeShader, "COMPILE");
+
+    shader->mProgram = glCreateProgram();
+    GL_CALL(glAttachShader(shader->mProgram, computeShader));
+    GL_CALL(glLinkProgram(shader->mProgram));
+    shader->checkShaderErrors(shader->mProgram, "LINK");
+    shader->bindUniformBlocks();
+    GLDebug::setLabel(GL_PROGRAM, shader->mProgram, computePath);
+
+    GL_CALL(glDeleteShader(computeShader));
+    return shader;
+}
+
 // ͷOpenGLɫ
 Shader::~Shader() {
     // SDL2ؼԼڡSDL_GL_DeleteContext()֮ǰá
     // ԭٺOpenGLmProgram޷ٷʣᴥЧ
+    for (auto& variant : mVariants) {
+        delete variant.second;
+    }
     if (mProgram != 0) {
         GL_CALL(glDeleteProgram(mProgram));
         mProgram = 0;
@@ -118,6 +136,7 @@ Shader::~Shader() {
 
 // ǰɫ򣨺OpenGLȾʹô˳
 void Shader::begin() {
+    RenderStats::add(RenderCounter::ShaderBinds);
     GL_CALL(glUseProgram(mProgram));
 }
 
@@ -128,25 +147,25 @@ void Shader::end() {
 
 // Uniformfloatͣǿȡ͸ȣ
 void Shader::setFloat(const std::string& name, float value) {
-    GLint location = GL_CALL(glGetUniformLocation(mProgram, name.c_str()));
+    GLint location = getUniformLocation(name);
     GL_CALL(glUniform1f(location, value));
 }
 
 // Uniformbool
 void Shader::setBool(const std::string& name, bool value) {
-    GLint location = GL_CALL(glGetUniformLocation(mProgram, name.c_str()));
+    GLint location = getUniformLocation(name);
     GL_CALL(glUniform1i(location, value));
 }
 
 // UniformintͣԪglActiveTextureĲ
 void Shader::setInt(const std::string& name, int value) {
-    GLint location = GL_CALL(glGetUniformLocation(mProgram, name.c_str()));
+    GLint location = getUniformLocation(name);
     GL_CALL(glUniform1i(location, value));
 }
 
 // Uniformvec3ͣ1x/y/zɫ꣩
 void Shader::setVector3(const std::string& name, float x, float y, float z) {
-    GLint location = GL_CALL(glGetUniformLocation(mProgram, name.c_str()));
+    GLint location = getUniformLocation(name);
     if (location != -1) {
         GL_CALL(glUniform3f(location, x, y, z));
     }
@@ -157,18 +176,23 @@ void Shader::setVector3(const std::string& name, float x, float y, float z) {
 
 // Uniformvec3ͣ2float飬꣩
 void Shader::setVector3(const std::string& name, float* values) {
-    GLint location = GL_CALL(glGetUniformLocation(mProgram, name.c_str()));
+    GLint location = getUniformLocation(name);
     GL_CALL(glUniform3fv(location, 1, values));  // v=vectorʾ
 }
 
+void Shader::setVector2(const std::string& name, glm::vec2 value) {
+    GLint location = getUniformLocation(name);
+    GL_CALL(glUniform2fv(location, 1, glm::value_ptr(value)));
+}
+
 void Shader::setVector3(const std::string& name, glm::vec3 value) {
-    GLint location = GL_CALL(glGetUniformLocation(mProgram, name.c_str()));
+    GLint location = getUniformLocation(name);
     GL_CALL(glUniform3fv(location, 1, glm::value_ptr(value)));// ʹglm::value_ptr(value)ȡָ
 }
 
 // Uniformmat4ͣ4x4MVPģͱ任
 void Shader::setMatrix4x4(const std::string& name, glm::mat4 value) {
-    GLint location = GL_CALL(glGetUniformLocation(mProgram, name.c_str()));
+    GLint location = getUniformLocation(name);
     if (location != -1) {
         // GL_FALSEתãGLMOpenGLȾ洢תã
         GL_CALL(glUniformMatrix4fv(
@@ -181,11 +205,59 @@ void Shader::setMatrix4x4(const std::string& name, glm::mat4 value) {
 }
 
 void Shader::setMatrix3x3(const std::string& name, glm::mat3 value) {
-    GLint location = GL_CALL(glGetUniformLocation(mProgram, name.c_str()));
+    GLint location = getUniformLocation(name);
     // GL_FALSEתãGLMOpenGLȾ洢תã
     GL_CALL(glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value)));
 }
 
+// ѯuniformλãһβѯ󻺴棬֮ÿ֡ set ٵ glGetUniformLocation
+GLint Shader::getUniformLocation(const std::string& name) {
+    // ÿ set һϴ
+    RenderStats::add(RenderCounter::UniformUploads);
+    auto iter = mUniformLocations.find(name);
+    if (iter != mUniformLocations.end()) {
+        return iter->second;
+    }
+
+    GLint location = glGetUniformLocation(mProgram, name.c_str());
+    mUniformLocations.emplace(name, location);
+    return location;
+}
+
+// ˽з PerDraw ݿ󶨵̶󶨵㣬Renderer ֻ glBindBufferRange ͬһ󶨵
+void Shader::bindUniformBlocks() {
+    GLuint blockIndex = glGetUniformBlockIndex(mProgram, "PerDraw");
+    mHasPerDrawBlock = blockIndex != GL_INVALID_INDEX;
+    if (mHasPerDrawBlock) {
+        GL_CALL(glUniformBlockBinding(mProgram, blockIndex, PER_DRAW_BLOCK_BINDING));
+    }
+}
+
+// ѯƬɫλãδŻʱΪ -1
+bool Shader::hasFragmentOutput(const std::string& name) const {
+    return glGetFragDataLocation(mProgram, name.c_str()) != -1;
+}
+
+Shader* Shader::getVariant(const std::string& macro, const std::string& requiredOutput) {
+    auto iter = mVariants.find(macro);
+    if (iter != mVariants.end()) {
+        return iter->second;
+    }
+
+    // ԭеĺ걣ֲ䣬ֻƬɫ׷ӱ
+    std::vector<ShaderMacro> macros = mMacros;
+    macros.push_back(ShaderMacro(macro, ShaderTarget::FRAGMENT));
+    Shader* variant = new Shader(mVertexPath.c_str(), mFragmentPath.c_str(), macros);
+    if (!variant->hasFragmentOutput(requiredOutput)) {
+        std::cerr << "WARNING[Shader]: " << mFragmentPath << "  " << macro << " û " << requiredOutput
+            << " common/fragmentOutput.glsl ͨ writeFragment " << std::endl;
+        delete variant;
+        variant = nullptr;
+    }
+    mVariants.emplace(macro, variant);
+    return variant;
+}
+
 // ˽зɫ/Ӵ
 void Shader::checkShaderErrors(GLuint target, std::string type) {
     GLint success = 0;
@@ -197,7 +269,7 @@ void Shader::checkShaderErrors(GLuint target, std::string type) {
         if (!success) {
             GL_CALL(glGetShaderInfoLog(target, 1024, nullptr, infoLog));
             std::cerr << "===================== Shader  =====================" << std::endl;
-            std::cerr << "־: " << infoLog << std::endl;
+            std::cerr << "־: " << ShaderPreprocessor::remapLog(infoLog) << std::endl;
             std::cerr << "ʾɫ﷨汾ǷOpenGL 4.6ƥ䣩" << std::endl;
             std::cerr << "================================================================" << std::endl;
         }
@@ -208,7 +280,7 @@ void Shader::checkShaderErrors(GLuint target, std::string type) {
         if (!success) {
             GL_CALL(glGetProgramInfoLog(target, 1024, nullptr, infoLog));
             std::cerr << "===================== Shader Ӵ =======================" << std::endl;
-            std::cerr << "־: " << infoLog << std::endl;
+            std::cerr << "־: " << ShaderPreprocessor::remapLog(infoLog) << std::endl;
             std::cerr << "ʾ鶥/ƬɫĽӿǷƥ䣨out/in" << std::endl;
             std::cerr << "================================================================" << std::endl;
         }
@@ -1,16 +1,25 @@
 #include "texture.h"
+#include "renderStats.h"
+#include "profiler.h"
+#include "glDebug.h"
+#include "jobSystem.h"
 #include <SDL2/SDL_image.h>
 #include <glad/glad.h>
 #include <stdexcept>
 #include <cstring>
+#include <mutex>
 #include<iostream>
 
 // cppгʼ̬Ա
 bool Texture::sInitialized = false;
 std::map<std::string, Texture*> Texture::mTextureCache{};
 
+// Ⱦ߳ģʽ£첽Ⱦ̣߳GL ̣߳д뻺棬̣߳ģ̣߳ѯ
+static std::mutex sTextureCacheMutex;
+
 Texture* Texture::createTexture(const std::string& path, unsigned int unit) {
     // 黺Ƿи
+    std::lock_guard<std::mutex> lock(sTextureCacheMutex);
     auto it = mTextureCache.find(path);
     if (it != mTextureCache.end()) {
         return it->second; // ѻ
@@ -29,6 +38,7 @@ Texture* Texture::createTextureFromMemory(
     uint32_t heightIn
 ) {
     // 黺Ƿи
+    std::lock_guard<std::mutex> lock(sTextureCacheMutex);
     auto it = mTextureCache.find(path);
     if (it != mTextureCache.end()) {
         return it->second; // ѻ
@@ -40,12 +50,65 @@ Texture* Texture::createTextureFromMemory(
     return newTexture;
 }
 
+// 첽أΪ̨ڹִ߳Уɺ GL ߳ϴٻصģ̻߳صصͨ޸ĳ
+static JobTask loadTextureAsync(std::string path, unsigned int unit, std::function<void(Texture*)> onLoaded) {
+    co_await JobSystem::background();
+    SDL_Surface* rgbaSurface = nullptr;
+    try {
+        rgbaSurface = Texture::loadSurface(path);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "ERROR[Texture]: 첽ʧܣ" << e.what() << std::endl;
+    }
+
+    co_await JobSystem::mainThread();
+    Texture* texture = rgbaSurface != nullptr ? Texture::createTextureFromSurface(rgbaSurface, path, unit) : nullptr;
+
+    co_await JobSystem::simulationThread();
+    if (onLoaded) {
+        onLoaded(texture);
+    }
+}
+
+void Texture::createTextureAsync(const std::string& path, unsigned int unit, std::function<void(Texture*)> onLoaded) {
+    // Ѿֱӻص
+    Texture* cached = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(sTextureCacheMutex);
+        auto it = mTextureCache.find(path);
+        if (it != mTextureCache.end()) {
+            cached = it->second;
+        }
+    }
+    if (cached != nullptr) {
+        if (onLoaded) {
+            onLoaded(cached);
+        }
+        return;
+    }
+    loadTextureAsync(path, unit, std::move(onLoaded));
+}
+
+Texture* Texture::createTextureFromSurface(SDL_Surface* rgbaSurface, const std::string& path, unsigned int unit) {
+    // ͬһ·첽ؿͬʱ˶ΣɵĽ뻺棬ֱ֮Ӷ
+    std::lock_guard<std::mutex> lock(sTextureCacheMutex);
+    auto it = mTextureCache.find(path);
+    if (it != mTextureCache.end()) {
+        SDL_FreeSurface(rgbaSurface);
+        return it->second;
+    }
+    Texture* newTexture = new Texture(rgbaSurface, path, unit);
+    mTextureCache[path] = newTexture;
+    return newTexture;
+}
+
 Texture::Texture(
     unsigned int unit,
     unsigned char* dataIn,
     uint32_t widthIn,
     uint32_t heightIn
 ) : mUnit(unit) { // ʼԪԱ
+    PROFILE_SCOPE("Texture::createFromMemory");
     // ͼƬݴСԭ߼
     uint32_t dataInSize = 0;
     if (!heightIn) {
@@ -101,6 +164,7 @@ Texture::Texture(
         GL_UNSIGNED_BYTE,
         rgbaSurface->pixels
     );
+    RenderStats::addTextureMemory(static_cast<int64_t>(mWidth) * mHeight * 4);
 
     // 8. ͷCPUڴ
     SDL_FreeSurface(rgbaSurface);
@@ -115,48 +179,31 @@ Texture::Texture(
 }
 
 Texture::Texture(const std::string& path, unsigned int unit)
+    : Texture(loadSurface(path), path, unit) {
+    // ȡͼƬתΪRGBA32ʽתYᣨCPU֣ίиӱ洴Ĺ캯ϴ
+}
+
+Texture::Texture(SDL_Surface* rgbaSurface, const std::string& label, unsigned int unit)
 	: mUnit(unit), mTexture(0), mWidth(0), mHeight(0) {    
+    PROFILE_SCOPE_DETAIL("Texture::upload", label);
     // mTextureʼΪ 0 ǹ淶 δʼ ״̬ᵼͬһ ID
     // 0 ǡĬ ID ID=0 ȼ ǰûɵЧ ID
     // mTexture ʼֵΪ 0 ֻǡδʼǡջᱻ glGenTextures Ϊ 0 Ч ID 
 
-    if(path.substr(path.size() - 4,path.size()) == ".tif") {
-        // ȷSDL_imageȷʼ֧TIFʽ
-        if (!initImageFormats()) {
-            throw std::runtime_error("SDL_imageʼʧܣ֧TIFʽ");
-        }
-    }
-
-    // 1. ʹSDL_imageͼƬ
-    SDL_Surface* surface = IMG_Load(path.c_str());
-    if (!surface) {
-        throw std::runtime_error("Failed to load texture: " + std::string(IMG_GetError()) +
-            " (Path: " + path + ")");
-    }
-
-    // 2. תΪRGBA32ʽOpenGLݣ
-    SDL_Surface* rgbaSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
-    SDL_FreeSurface(surface); // ͷԭʼ
-    if (!rgbaSurface) {
-        throw std::runtime_error("Failed to convert surface format: " + std::string(SDL_GetError()));
-    }
-
     // ߴ
     mWidth = rgbaSurface->w;
     mHeight = rgbaSurface->h;
 
-    // 3. תYᣨSDLԭϽǣOpenGL½ǣ
-    flipSurfaceVertically(rgbaSurface);
-
-    // 4. ɲ
+    // 1. ɲ
     glGenTextures(1, &mTexture);
     glActiveTexture(GL_TEXTURE0 + mUnit);
     glBindTexture(GL_TEXTURE_2D, mTexture);
+    GLDebug::setLabel(GL_TEXTURE, mTexture, label);
 
-    // 5. ض뷽ʽ
+    // 2. ض뷽ʽ
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    // 6. ݵGPU
+    // 3. ݵGPU
     glTexImage2D(
         GL_TEXTURE_2D,
         0,
@@ -168,15 +215,16 @@ Texture::Texture(const std::string& path, unsigned int unit)
         GL_UNSIGNED_BYTE,
         rgbaSurface->pixels
     );
+    RenderStats::addTextureMemory(static_cast<int64_t>(mWidth) * mHeight * 4);
 
-    // 7. ͷCPUڴ
+    // 4. ͷCPUڴ
     SDL_FreeSurface(rgbaSurface);
 
-    // 8. ˷ʽ
+    // 5. ˷ʽ
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
-    // 9. ʽ
+    // 6. ʽ
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 }
@@ -202,6 +250,7 @@ Texture::Texture(unsigned int width, unsigned int height, unsigned int unit)
         GL_UNSIGNED_BYTE,
         NULL
 	);      // glTexImage2DһյΪNULL
+    RenderStats::addTextureMemory(static_cast<int64_t>(mWidth) * mHeight * 4);
 
 	// 2. ˷ʽ
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -216,16 +265,47 @@ Texture::Texture(unsigned int width, unsigned int height, unsigned int unit)
 
 Texture::~Texture() {
     if (mTexture != 0) {
+        RenderStats::addTextureMemory(-static_cast<int64_t>(mWidth) * mHeight * 4);
         glDeleteTextures(1, &mTexture);
         mTexture = 0;
     }
 }
 
 void Texture::bind() {
+    RenderStats::add(RenderCounter::TextureBinds);
     glActiveTexture(GL_TEXTURE0 + mUnit);
     glBindTexture(GL_TEXTURE_2D, mTexture);
 }
 
+SDL_Surface* Texture::loadSurface(const std::string& path) {
+    PROFILE_SCOPE("Texture::loadSurface");
+    if(path.substr(path.size() - 4,path.size()) == ".tif") {
+        // ȷSDL_imageȷʼ֧TIFʽ
+        if (!initImageFormats()) {
+            throw std::runtime_error("SDL_imageʼʧܣ֧TIFʽ");
+        }
+    }
+
+    // 1. ʹSDL_imageͼƬ
+    SDL_Surface* surface = IMG_Load(path.c_str());
+    if (!surface) {
+        throw std::runtime_error("Failed to load texture: " + std::string(IMG_GetError()) +
+            " (Path: " + path + ")");
+    }
+
+    // 2. תΪRGBA32ʽOpenGLݣ
+    SDL_Surface* rgbaSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(surface); // ͷԭʼ
+    if (!rgbaSurface) {
+        throw std::runtime_error("Failed to convert surface format: " + std::string(SDL_GetError()));
+    }
+
+    // 3. תYᣨSDLԭϽǣOpenGL½ǣ
+    flipSurfaceVertically(rgbaSurface);
+
+    return rgbaSurface;
+}
+
 void Texture::flipSurfaceVertically(SDL_Surface* surface) {
     if (!surface) return;
 
@@ -248,6 +328,9 @@ void Texture::flipSurfaceVertically(SDL_Surface* surface) {
 }
 
 bool Texture::initImageFormats() {
+    // 첽ʱڶ߳ͬʱ
+    static std::mutex initMutex;
+    std::lock_guard<std::mutex> lock(initMutex);
     if (sInitialized) return true;
 
     // ڳʼǰӣ鿴SDL_imageֵ֧ĸʽ
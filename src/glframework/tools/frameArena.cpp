@@ -0,0 +1,61 @@
+#include "frameArena.h"
+#include <algorithm>
+
+FrameArena::FrameArena(size_t initialSize) {
+    addBlock(std::max<size_t>(initialSize, 1024));
+}
+
+FrameArena::~FrameArena() {
+    for (auto& block : mBlocks) {
+        ::operator delete(block.data);
+    }
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    // 先在当前（最后一块）内存中尝试
+    Block* block = &mBlocks.back();
+    uintptr_t base = reinterpret_cast<uintptr_t>(block->data);
+    size_t offset = ((base + block->offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    if (offset + size > block->size) {
+        // 放不下：追加一块至少能容纳本次分配的内存，reset() 时再合并
+        addBlock(std::max(block->size * 2, size + alignment));
+        block = &mBlocks.back();
+        base = reinterpret_cast<uintptr_t>(block->data);
+        offset = ((base + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    }
+
+    block->offset = offset + size;
+    mUsedBytes += size;
+    mPeakBytes = std::max(mPeakBytes, mUsedBytes);
+    return block->data + offset;
+}
+
+void FrameArena::reset() {
+    if (mBlocks.size() > 1) {
+        // 本帧用到了多块：合并成一块，下一帧不再追加
+        size_t total = getCapacity();
+        for (auto& block : mBlocks) {
+            ::operator delete(block.data);
+        }
+        mBlocks.clear();
+        addBlock(total);
+    }
+    mBlocks.back().offset = 0;
+    mUsedBytes = 0;
+}
+
+size_t FrameArena::getCapacity() const {
+    size_t total = 0;
+    for (const auto& block : mBlocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+void FrameArena::addBlock(size_t minSize) {
+    Block block;
+    block.size = minSize;
+    block.data = static_cast<unsigned char*>(::operator new(minSize));
+    mBlocks.push_back(block);
+    mBlockAllocations++;
+}
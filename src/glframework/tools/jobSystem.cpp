@@ -0,0 +1,500 @@
+#include "jobSystem.h"
+#include "profiler.h"
+#include "../redrawTracker.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// 必须在cpp中初始化静态成员
+std::mutex JobSystem::sStartMutex;
+std::atomic<bool> JobSystem::sStarted{ false };
+std::vector<std::thread> JobSystem::sThreads{};
+std::vector<std::unique_ptr<JobSystem::Queue>> JobSystem::sQueues{};
+JobSystem::Queue JobSystem::sBackgroundQueue;
+
+std::atomic<bool> JobSystem::sStop{ false };
+std::atomic<size_t> JobSystem::sPendingJobs{ 0 };
+std::atomic<size_t> JobSystem::sSleepingWorkers{ 0 };
+std::mutex JobSystem::sSleepMutex;
+std::condition_variable JobSystem::sSleepCondition;
+
+std::atomic<uint64_t> JobSystem::sExecuted{ 0 };
+std::atomic<uint64_t> JobSystem::sStolen{ 0 };
+
+JobSystem::ThreadQueue JobSystem::sMainQueue;
+JobSystem::ThreadQueue JobSystem::sSimulationQueue;
+
+// 非工作线程编号的占用位：第 i 位为 1 表示编号 i 已被某个线程领取
+static std::atomic<uint32_t> sExternalSlots{ 0 };
+static_assert(JobSystem::MAX_EXTERNAL_THREADS <= 32, "sExternalSlots 只有 32 位");
+
+// 当前线程的编号：工作线程启动时设置，非工作线程第一次使用时领取，线程退出时归还
+static constexpr size_t INVALID_THREAD_INDEX = SIZE_MAX;
+struct ThreadSlot {
+    size_t index{ INVALID_THREAD_INDEX };
+    bool external{ false };     // 领取了非工作线程编号，退出时归还
+
+    ~ThreadSlot() {
+        if (external) {
+            sExternalSlots.fetch_and(~(1u << index), std::memory_order_release);
+        }
+    }
+};
+static thread_local ThreadSlot tThread;
+
+static size_t currentThreadIndex() {
+    if (tThread.index != INVALID_THREAD_INDEX) {
+        return tThread.index;
+    }
+
+    // 领取最小的空闲编号
+    uint32_t used = sExternalSlots.load(std::memory_order_relaxed);
+    while (true) {
+        size_t index = 0;
+        while (index < JobSystem::MAX_EXTERNAL_THREADS && (used & (1u << index)) != 0) {
+            index++;
+        }
+        if (index == JobSystem::MAX_EXTERNAL_THREADS) {
+            // 编号用完：共用编号会让两个线程写同一个每线程缓冲区，直接终止（发布版也不继续运行）
+            std::cerr << "ERROR[JobSystem]: 使用任务系统的非工作线程超过 " << JobSystem::MAX_EXTERNAL_THREADS << " 个" << std::endl;
+            assert(false && "JobSystem: more than MAX_EXTERNAL_THREADS non-worker threads");
+            std::abort();
+        }
+        if (sExternalSlots.compare_exchange_weak(used, used | (1u << index), std::memory_order_acquire, std::memory_order_relaxed)) {
+            tThread.index = index;
+            tThread.external = true;
+            return index;
+        }
+    }
+}
+
+void JobCounter::finish() {
+    // 在锁内减一：等待者看到归零后会先获取一次这把锁再返回（可能随即销毁计数器），
+    // 解锁之后这里不再访问计数器；与 addWaiter 也在这把锁下交接，等待者不会丢失
+    std::vector<JobFunction> waiters;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mValue.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        waiters.swap(mWaiters);
+    }
+    for (auto& waiter : waiters) {
+        JobSystem::run(std::move(waiter));
+    }
+}
+
+void JobCounter::addWaiter(JobFunction job) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!isDone()) {
+            mWaiters.push_back(std::move(job));
+            return;
+        }
+    }
+    JobSystem::run(std::move(job));
+}
+
+void JobSystem::run(JobFunc job, JobCounter* counter) {
+    start(0);
+    if (counter != nullptr) {
+        counter->add(1);
+    }
+
+    // 没有工作线程（单核机器）：直接执行
+    if (sThreads.empty()) {
+        Job inlineJob{ std::move(job), counter };
+        execute(inlineJob);
+        return;
+    }
+    submit(*sQueues[currentThreadIndex()], std::move(job), counter);
+}
+
+void JobSystem::runBackground(JobFunc job, JobCounter* counter) {
+    start(0);
+    if (counter != nullptr) {
+        counter->add(1);
+    }
+
+    if (sThreads.empty()) {
+        Job inlineJob{ std::move(job), counter };
+        execute(inlineJob);
+        return;
+    }
+    submit(sBackgroundQueue, std::move(job), counter);
+}
+
+bool JobSystem::push(Queue& queue, Job& job, bool allowOverflow) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tail - queue.head == QUEUE_CAPACITY) {
+        if (!allowOverflow) {
+            return false;
+        }
+        queue.overflow.push_back(std::move(job));
+    }
+    else {
+        queue.slots[queue.tail % QUEUE_CAPACITY] = std::move(job);
+        queue.tail++;
+    }
+    queue.size.store(queue.tail - queue.head + queue.overflow.size(), std::memory_order_release);
+    return true;
+}
+
+void JobSystem::submit(Queue& queue, JobFunc job, JobCounter* counter) {
+    Job entry{ std::move(job), counter };
+
+    // 先计数再入队：取走任务的线程看到的计数不会小于 0
+    // 后台队列满了也不能在提交线程上执行（提交者通常是 GL 线程，解码、BVH 构建会卡住一帧），放进溢出链表
+    sPendingJobs.fetch_add(1, std::memory_order_seq_cst);
+    if (!push(queue, entry, &queue == &sBackgroundQueue)) {
+        // 普通队列满（一次提交了太多任务）：在提交线程上直接执行，不扩容
+        sPendingJobs.fetch_sub(1, std::memory_order_relaxed);
+        execute(entry);
+        return;
+    }
+
+    // 只有在有线程睡眠时才加锁唤醒；加锁保证睡眠的线程检查条件与进入等待之间不会漏掉这次通知
+    if (sSleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+        { std::lock_guard<std::mutex> lock(sSleepMutex); }
+        sSleepCondition.notify_one();
+    }
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    size_t threadIndex = currentThreadIndex();
+    while (!counter.isDone()) {
+        if (!runOne(threadIndex)) {
+            std::this_thread::yield();
+        }
+    }
+    // 等最后一个任务离开 finish，返回后调用者可以销毁计数器
+    std::lock_guard<std::mutex> lock(counter.mMutex);
+}
+
+void JobSystem::parallelFor(size_t count, size_t minBatch, const RangeFunc& func) {
+    if (count == 0) {
+        return;
+    }
+    minBatch = std::max<size_t>(minBatch, 1);
+
+    // 元素太少或没有工作线程：直接串行
+    if (count <= minBatch || getWorkerCount() == 0) {
+        func(0, count);
+        return;
+    }
+
+    // 每个线程大约分到 4 块，兼顾负载均衡与调度开销；块不均匀时由偷任务补齐
+    size_t threadCount = sThreads.size() + 1;
+    size_t batch = std::max(minBatch, (count + threadCount * 4 - 1) / (threadCount * 4));
+    size_t chunkCount = (count + batch - 1) / batch;
+
+    // 第 0 块留给调用线程，其余的放进自己的队列等别的线程偷
+    JobCounter counter;
+    for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+        size_t begin = chunk * batch;
+        size_t end = std::min(begin + batch, count);
+        run([&func, begin, end] {
+            PROFILE_SCOPE("JobSystem::parallelFor");
+            func(begin, end);
+        }, &counter);
+    }
+    {
+        PROFILE_SCOPE("JobSystem::parallelFor");
+        func(0, std::min(batch, count));
+    }
+    wait(counter);
+}
+
+void JobSystem::setMainThread() {
+    sMainQueue.owner.store(std::this_thread::get_id(), std::memory_order_release);
+}
+
+bool JobSystem::isMainThread() {
+    return std::this_thread::get_id() == sMainQueue.owner.load(std::memory_order_acquire);
+}
+
+void JobSystem::runOnMainThread(JobFunc job) {
+    post(sMainQueue, std::move(job));
+}
+
+size_t JobSystem::pumpMainThread() {
+    return runPosted(sMainQueue, "JobSystem::pumpMainThread");
+}
+
+void JobSystem::setSimulationThread() {
+    sSimulationQueue.owner.store(std::this_thread::get_id(), std::memory_order_release);
+}
+
+bool JobSystem::isSimulationThread() {
+    return std::this_thread::get_id() == sSimulationQueue.owner.load(std::memory_order_acquire);
+}
+
+void JobSystem::runOnSimulationThread(JobFunc job) {
+    post(sSimulationQueue, std::move(job));
+}
+
+size_t JobSystem::pumpSimulationThread() {
+    return runPosted(sSimulationQueue, "JobSystem::pumpSimulationThread");
+}
+
+void JobSystem::post(ThreadQueue& queue, JobFunc job) {
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    // 按需重绘模式下主线程可能睡在 SDL_WaitEvent 中，请求一帧把它唤醒（渲染线程也要等主线程提交快照）
+    RedrawTracker::requestFrame();
+}
+
+size_t JobSystem::runPosted(ThreadQueue& queue, const char* scopeName) {
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.running.swap(queue.jobs);
+    }
+    if (queue.running.empty()) {
+        return 0;
+    }
+
+    // 执行期间新提交的任务留到下一帧，避免一帧内无限循环
+    PROFILE_SCOPE(scopeName);
+    (void)scopeName;
+    for (auto& job : queue.running) {
+        job();
+    }
+    size_t count = queue.running.size();
+    queue.running.clear();
+    return count;
+}
+
+size_t JobSystem::getWorkerCount() {
+    start(0);   // 第一次使用时创建
+    return sThreads.size();
+}
+
+size_t JobSystem::getThreadIndex() {
+    return currentThreadIndex();
+}
+
+size_t JobSystem::getThreadCount() {
+    start(0);
+    return MAX_EXTERNAL_THREADS + sThreads.size();
+}
+
+bool JobSystem::isWorkerThread() {
+    return tThread.index != INVALID_THREAD_INDEX && tThread.index >= MAX_EXTERNAL_THREADS;
+}
+
+void JobSystem::setWorkerCount(size_t count) {
+    shutdown();
+    start(count);
+}
+
+void JobSystem::shutdown() {
+    std::lock_guard<std::mutex> startLock(sStartMutex);
+    if (!sStarted.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // 剩余的任务执行完再停止，计数器上的等待者不会丢失；后台任务由工作线程执行，等队列清空
+    size_t threadIndex = currentThreadIndex();
+    while (sPendingJobs.load(std::memory_order_acquire) > 0) {
+        if (!runOne(threadIndex)) {
+            std::this_thread::yield();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sSleepMutex);
+        sStop.store(true);
+    }
+    sSleepCondition.notify_all();
+    for (auto& thread : sThreads) {
+        thread.join();
+    }
+
+    sThreads.clear();
+    sQueues.clear();
+    sStarted.store(false, std::memory_order_release);
+    sStop.store(false);
+}
+
+JobSystem::Stats JobSystem::getStats() {
+    Stats stats;
+    stats.executed = sExecuted.load(std::memory_order_relaxed);
+    stats.stolen = sStolen.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void JobSystem::start(size_t count) {
+    // 已经启动时不加锁（sStarted 只在持有 sStartMutex 且没有任务时改变）
+    if (sStarted.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sStartMutex);
+    if (sStarted.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    if (count == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        count = hardware > 1 ? hardware - 1 : 0;    // 留一个给调用线程
+    }
+
+    // 队列先全部建好，工作线程一启动就可能去偷别人的队列；前 MAX_EXTERNAL_THREADS 个属于非工作线程
+    sQueues.clear();
+    for (size_t i = 0; i < MAX_EXTERNAL_THREADS + count; i++) {
+        sQueues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < count; i++) {
+        sThreads.emplace_back(&JobSystem::workerLoop, MAX_EXTERNAL_THREADS + i);
+    }
+    sStarted.store(true, std::memory_order_release);
+}
+
+void JobSystem::workerLoop(size_t threadIndex) {
+    tThread.index = threadIndex;
+    PROFILE_THREAD("Worker " + std::to_string(threadIndex - MAX_EXTERNAL_THREADS + 1));
+
+    while (!sStop.load(std::memory_order_acquire)) {
+        if (runOne(threadIndex)) {
+            continue;
+        }
+
+        // 没有任务：睡眠到有新任务或停止
+        std::unique_lock<std::mutex> lock(sSleepMutex);
+        sSleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        sSleepCondition.wait(lock, [] {
+            return sStop.load(std::memory_order_acquire) || sPendingJobs.load(std::memory_order_seq_cst) > 0;
+        });
+        sSleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+bool JobSystem::popBack(Queue& queue, Job& job) {
+    if (queue.size.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.overflow.empty()) {
+        // 溢出链表排在环形数组之后，尾部在溢出链表里
+        job = std::move(queue.overflow.back());
+        queue.overflow.pop_back();
+    }
+    else if (queue.tail != queue.head) {
+        queue.tail--;
+        job = std::move(queue.slots[queue.tail % QUEUE_CAPACITY]);
+    }
+    else {
+        return false;
+    }
+    queue.size.store(queue.tail - queue.head + queue.overflow.size(), std::memory_order_release);
+    return true;
+}
+
+bool JobSystem::popFront(Queue& queue, Job& job) {
+    if (queue.size.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tail == queue.head) {
+        return false;
+    }
+    job = std::move(queue.slots[queue.head % QUEUE_CAPACITY]);
+    queue.head++;
+
+    // 环形数组腾出一格：把溢出链表最早的任务移到尾部，保持先进先出
+    if (!queue.overflow.empty()) {
+        queue.slots[queue.tail % QUEUE_CAPACITY] = std::move(queue.overflow.front());
+        queue.overflow.pop_front();
+        queue.tail++;
+    }
+    queue.size.store(queue.tail - queue.head + queue.overflow.size(), std::memory_order_release);
+    return true;
+}
+
+bool JobSystem::runOne(size_t threadIndex) {
+    if (sQueues.empty() || sPendingJobs.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    // 1 自己的队列：尾部
+    Job job;
+    bool found = popBack(*sQueues[threadIndex], job);
+    bool stolen = false;
+
+    // 2 其它队列：头部，从相邻的队列开始，不同线程错开偷的顺序
+    for (size_t i = 1; !found && i < sQueues.size(); i++) {
+        found = popFront(*sQueues[(threadIndex + i) % sQueues.size()], job);
+        stolen = found;
+    }
+
+    // 3 后台队列：只有工作线程执行，先进先出
+    if (!found && threadIndex >= MAX_EXTERNAL_THREADS) {
+        found = popFront(sBackgroundQueue, job);
+    }
+
+    if (!found) {
+        return false;
+    }
+    sPendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+    if (stolen) {
+        sStolen.fetch_add(1, std::memory_order_relaxed);
+    }
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(Job& job) {
+    job.func();
+    sExecuted.fetch_add(1, std::memory_order_relaxed);
+    if (job.counter != nullptr) {
+        job.counter->finish();
+    }
+}
+
+TaskGraph::TaskId TaskGraph::add(std::function<void()> func, const std::vector<TaskId>& dependencies) {
+    TaskId id = mNodes.size();
+    auto node = std::make_unique<Node>();
+    node->func = std::move(func);
+    for (TaskId dependency : dependencies) {
+        if (dependency < id) {
+            mNodes[dependency]->successors.push_back(id);
+            node->dependencyCount++;
+        }
+    }
+    mNodes.push_back(std::move(node));
+    return id;
+}
+
+void TaskGraph::run() {
+    if (mNodes.empty()) {
+        return;
+    }
+    for (auto& node : mNodes) {
+        node->remaining.store(node->dependencyCount, std::memory_order_relaxed);
+    }
+
+    // 先把整个图计入计数器，某个任务完成得早也不会让计数提前归零
+    mCounter.add(static_cast<int>(mNodes.size()));
+    for (TaskId id = 0; id < mNodes.size(); id++) {
+        if (mNodes[id]->dependencyCount == 0) {
+            submit(id);
+        }
+    }
+    JobSystem::wait(mCounter);
+}
+
+void TaskGraph::submit(TaskId id) {
+    JobSystem::run([this, id] {
+        Node& node = *mNodes[id];
+        node.func();
+        for (TaskId successor : node.successors) {
+            if (mNodes[successor]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                submit(successor);
+            }
+        }
+        mCounter.finish();
+    });
+}
@@ -0,0 +1,335 @@
+#include "profiler.h"
+#include "../core.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+// GPU 事件在 trace 中的轨道编号（CPU 线程从 1 开始编号）
+static const uint32_t GPU_TRACK_ID = 1000000;
+
+thread_local Profiler::ThreadBuffer* Profiler::sLocal = nullptr;
+std::mutex Profiler::sMutex;
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>> Profiler::sThreads;
+std::unordered_set<std::string> Profiler::sStrings;
+
+std::atomic<bool> Profiler::sRecording{ false };
+std::atomic<uint32_t> Profiler::sSession{ 0 };
+size_t Profiler::sCapacity = 1 << 16;
+// 程序启动时固定，之后只读，各线程可以直接使用
+std::chrono::steady_clock::time_point Profiler::sEpoch = std::chrono::steady_clock::now();
+
+int64_t Profiler::sGpuOffsetNs = 0;
+std::vector<Profiler::GpuScope> Profiler::sGpuScopes;
+std::vector<Profiler::GpuEvent> Profiler::sGpuEvents;
+std::vector<uint32_t> Profiler::sFreeQueries;
+std::vector<uint64_t> Profiler::sFrameMarks;
+
+// 以下只在 GL 线程访问
+static bool sGpuAvailable = false;          // 会话开始时有 GL 上下文
+static int sGpuFirstId = 0;                 // sGpuScopes[0] 的编号
+static uint64_t sSessionStartNs = 0;
+
+Profiler::ThreadBuffer* Profiler::registerThread() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    sThreads.push_back(std::make_unique<ThreadBuffer>());
+    ThreadBuffer* buffer = sThreads.back().get();
+    buffer->threadId = static_cast<uint32_t>(sThreads.size());
+    buffer->name = "Thread " + std::to_string(buffer->threadId);
+    return buffer;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = local();
+    std::lock_guard<std::mutex> lock(sMutex);
+    buffer.name = name;
+}
+
+const char* Profiler::intern(const std::string& text) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    return sStrings.insert(text).first->c_str();
+}
+
+void Profiler::beginSession(size_t eventsPerThread) {
+    if (sRecording.load()) {
+        std::cerr << "ERROR[Profiler]: 会话已经开始" << std::endl;
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        sCapacity = std::max<size_t>(eventsPerThread, 1024);
+    }
+
+    // GPU 查询的结果换算到 CPU 时钟：同一时刻分别读取两边的时间
+    sGpuAvailable = SDL_GL_GetCurrentContext() != nullptr && glGetInteger64v != nullptr;
+    sGpuScopes.clear();
+    sGpuEvents.clear();
+    sFrameMarks.clear();
+    sGpuFirstId = 0;
+    if (sGpuAvailable) {
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        sGpuOffsetNs = static_cast<int64_t>(gpuNow) - static_cast<int64_t>(now());
+    }
+
+    sSessionStartNs = now();
+    sSession.fetch_add(1, std::memory_order_acq_rel);
+    sRecording.store(true, std::memory_order_release);
+}
+
+void Profiler::record(const char* name, const char* detail, uint64_t beginNs, uint64_t endNs) {
+    ThreadBuffer& buffer = local();
+
+    // 新会话：由所属线程自己清空，读取方只读取会话编号一致的缓冲区
+    uint32_t session = sSession.load(std::memory_order_acquire);
+    if (buffer.session.load(std::memory_order_relaxed) != session) {
+        size_t capacity = 0;
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            capacity = sCapacity;
+        }
+        if (buffer.capacity != capacity) {
+            buffer.events.reset(new Event[capacity]);
+            buffer.capacity = capacity;
+        }
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.session.store(session, std::memory_order_release);
+    }
+
+    size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index >= buffer.capacity) {
+        buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[index] = Event{ name, detail, beginNs, endNs };
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+uint32_t Profiler::acquireQuery() {
+    if (sFreeQueries.empty()) {
+        GLuint queries[32];
+        glGenQueries(32, queries);
+        sFreeQueries.insert(sFreeQueries.end(), queries, queries + 32);
+    }
+    uint32_t query = sFreeQueries.back();
+    sFreeQueries.pop_back();
+    return query;
+}
+
+int Profiler::beginGpu(const char* name) {
+    if (!isRecording() || !sGpuAvailable) {
+        return -1;
+    }
+    GpuScope scope;
+    scope.name = name;
+    scope.queries[0] = acquireQuery();
+    scope.queries[1] = acquireQuery();
+    scope.cpuNs = now();
+    scope.threadId = local().threadId;
+    glQueryCounter(scope.queries[0], GL_TIMESTAMP);
+    sGpuScopes.push_back(scope);
+    return sGpuFirstId + static_cast<int>(sGpuScopes.size()) - 1;
+}
+
+void Profiler::endGpu(int scope) {
+    int index = scope - sGpuFirstId;
+    if (scope < 0 || index < 0 || index >= static_cast<int>(sGpuScopes.size())) {
+        return;
+    }
+    glQueryCounter(sGpuScopes[index].queries[1], GL_TIMESTAMP);
+    sGpuScopes[index].ended = true;
+}
+
+void Profiler::collectGpu(bool wait) {
+    size_t done = 0;
+    for (; done < sGpuScopes.size(); done++) {
+        GpuScope& scope = sGpuScopes[done];
+        if (!scope.ended) {
+            break;
+        }
+        if (!wait) {
+            GLint available = 0;
+            glGetQueryObjectiv(scope.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                break;
+            }
+        }
+
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(scope.queries[0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(scope.queries[1], GL_QUERY_RESULT, &end);
+        GpuEvent event;
+        event.name = scope.name;
+        event.beginNs = static_cast<uint64_t>(std::max<int64_t>(0, static_cast<int64_t>(begin) - sGpuOffsetNs));
+        event.endNs = static_cast<uint64_t>(std::max<int64_t>(0, static_cast<int64_t>(end) - sGpuOffsetNs));
+        event.cpuNs = scope.cpuNs;
+        event.threadId = scope.threadId;
+        sGpuEvents.push_back(event);
+
+        sFreeQueries.push_back(scope.queries[0]);
+        sFreeQueries.push_back(scope.queries[1]);
+    }
+    sGpuScopes.erase(sGpuScopes.begin(), sGpuScopes.begin() + done);
+    sGpuFirstId += static_cast<int>(done);
+}
+
+void Profiler::endFrame() {
+    if (!isRecording()) {
+        return;
+    }
+    sFrameMarks.push_back(now());
+    if (sGpuAvailable) {
+        collectGpu(false);
+    }
+}
+
+uint64_t Profiler::getDroppedCount() {
+    uint32_t session = sSession.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(sMutex);
+    uint64_t dropped = 0;
+    for (const auto& buffer : sThreads) {
+        if (buffer->session.load(std::memory_order_acquire) == session) {
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return dropped;
+}
+
+bool Profiler::endSession(const std::string& path) {
+    if (!sRecording.exchange(false)) {
+        return false;
+    }
+    if (sGpuAvailable) {
+        collectGpu(true);
+    }
+    if (path.empty()) {
+        return true;
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR[Profiler]: 无法写入 " << path << std::endl;
+        return false;
+    }
+    writeJson(file);
+    std::cout << "Profiler: trace 已写入 " << path << std::endl;
+    return true;
+}
+
+// JSON 字符串转义（Windows 路径中的反斜杠等）
+static void writeString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c != '\0'; c++) {
+        switch (*c) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(*c) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(*c));
+                out << escaped;
+            }
+            else {
+                out << *c;
+            }
+            break;
+        }
+    }
+    out << '"';
+}
+
+// 会话开始为 0，单位微秒
+static void writeTimestamp(std::ostream& out, const char* key, uint64_t ns) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.3f", static_cast<double>(ns) / 1000.0);
+    out << ",\"" << key << "\":" << text;
+}
+
+void Profiler::writeJson(std::ostream& out) {
+    uint32_t session = sSession.load(std::memory_order_acquire);
+    uint64_t start = sSessionStartNs;
+    uint64_t dropped = 0;
+    uint32_t mainThread = 1;
+
+    out << "{\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"OpenGLProject\"}}";
+
+    std::lock_guard<std::mutex> lock(sMutex);
+    for (const auto& buffer : sThreads) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":";
+        writeString(out, buffer->name.c_str());
+        out << "}}";
+        if (buffer->name == "Main") {
+            mainThread = buffer->threadId;
+        }
+
+        if (buffer->session.load(std::memory_order_acquire) != session) {
+            continue;
+        }
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; i++) {
+            const Event& event = buffer->events[i];
+            // 上一次会话中开始的作用域
+            if (event.beginNs < start) {
+                continue;
+            }
+            out << ",\n{\"name\":";
+            writeString(out, event.name);
+            out << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId;
+            writeTimestamp(out, "ts", event.beginNs - start);
+            writeTimestamp(out, "dur", event.endNs - event.beginNs);
+            if (event.detail != nullptr) {
+                out << ",\"args\":{\"detail\":";
+                writeString(out, event.detail);
+                out << "}";
+            }
+            out << "}";
+        }
+    }
+
+    // GPU 轨道，每个事件用 flow 箭头连到发出命令的 CPU 线程
+    if (!sGpuEvents.empty()) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << GPU_TRACK_ID << ",\"args\":{\"name\":\"GPU\"}}";
+    }
+    uint64_t flowId = 0;
+    for (const auto& event : sGpuEvents) {
+        if (event.cpuNs < start || event.beginNs < start) {
+            continue;
+        }
+        flowId++;
+        out << ",\n{\"name\":";
+        writeString(out, event.name);
+        out << ",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << GPU_TRACK_ID;
+        writeTimestamp(out, "ts", event.beginNs - start);
+        writeTimestamp(out, "dur", event.endNs > event.beginNs ? event.endNs - event.beginNs : 0);
+        out << "}";
+
+        out << ",\n{\"name\":\"submit\",\"cat\":\"gpu\",\"ph\":\"s\",\"id\":" << flowId << ",\"pid\":1,\"tid\":" << event.threadId;
+        writeTimestamp(out, "ts", event.cpuNs - start);
+        out << "}";
+        out << ",\n{\"name\":\"submit\",\"cat\":\"gpu\",\"ph\":\"f\",\"bp\":\"e\",\"id\":" << flowId << ",\"pid\":1,\"tid\":" << GPU_TRACK_ID;
+        writeTimestamp(out, "ts", event.beginNs - start);
+        out << "}";
+    }
+
+    for (uint64_t mark : sFrameMarks) {
+        out << ",\n{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":" << mainThread;
+        writeTimestamp(out, "ts", mark - start);
+        out << "}";
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+}
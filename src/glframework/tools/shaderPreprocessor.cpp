@@ -0,0 +1,406 @@
+#include "shaderPreprocessor.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <regex>
+#include <algorithm>
+
+// 必须在cpp中初始化静态成员
+std::mutex ShaderPreprocessor::sMutex;
+std::unordered_map<std::string, ShaderPreprocessor::SourceFile> ShaderPreprocessor::sFileCache{};
+std::unordered_map<uint64_t, std::string> ShaderPreprocessor::sExpandedCache{};
+std::vector<std::string> ShaderPreprocessor::sFileNames{};
+std::vector<std::string> ShaderPreprocessor::sIncludeDirectories{ std::string(SHADER_DIR) };
+size_t ShaderPreprocessor::sFileReadCount = 0;
+size_t ShaderPreprocessor::sCacheHitCount = 0;
+
+// 辅助函数：规范化路径（统一分隔符，去掉 ./ 与 dir/../）
+static std::string normalizePath(const std::string& path) {
+    std::string unified = path;
+    std::replace(unified.begin(), unified.end(), '\\', '/');
+
+    bool absolute = !unified.empty() && unified[0] == '/';
+    std::vector<std::string> parts;
+    std::stringstream ss(unified);
+    std::string part;
+    while (std::getline(ss, part, '/')) {
+        if (part.empty() || part == ".") {
+            continue;
+        }
+        if (part == ".." && !parts.empty() && parts.back() != "..") {
+            parts.pop_back();
+            continue;
+        }
+        parts.push_back(part);
+    }
+
+    std::string result = absolute ? "/" : "";
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (i > 0) {
+            result += '/';
+        }
+        result += parts[i];
+    }
+    return result;
+}
+
+// 辅助函数：取文件所在目录（带结尾的 /）
+static std::string getDirectory(const std::string& path) {
+    auto slashPos = path.find_last_of('/');
+    if (slashPos == std::string::npos) {
+        return "";
+    }
+    return path.substr(0, slashPos + 1);
+}
+
+// 辅助函数：解析预处理指令，返回指令名（如 define/include/version），rest 为指令后的内容
+static bool parseDirective(const std::string& line, std::string& directive, std::string& rest) {
+    size_t pos = line.find_first_not_of(" \t");
+    if (pos == std::string::npos || line[pos] != '#') {
+        return false;
+    }
+    pos = line.find_first_not_of(" \t", pos + 1);     // 允许 "#  define" 这种写法
+    if (pos == std::string::npos) {
+        return false;
+    }
+    size_t end = pos;
+    while (end < line.size() && (isalnum(static_cast<unsigned char>(line[end])) || line[end] == '_')) {
+        end++;
+    }
+    directive = line.substr(pos, end - pos);
+    size_t restPos = line.find_first_not_of(" \t", end);
+    rest = (restPos == std::string::npos) ? "" : line.substr(restPos);
+    return true;
+}
+
+// 辅助函数：从 "NAME value" 中取出宏名
+static std::string parseIdentifier(const std::string& text) {
+    size_t end = 0;
+    while (end < text.size() && (isalnum(static_cast<unsigned char>(text[end])) || text[end] == '_')) {
+        end++;
+    }
+    return text.substr(0, end);
+}
+
+uint64_t ShaderPreprocessor::hashString(const std::string& str, uint64_t seed) {
+    uint64_t hash = seed;
+    for (unsigned char c : str) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void ShaderPreprocessor::addIncludeDirectory(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    std::string dir = normalizePath(directory);
+    if (std::find(sIncludeDirectories.begin(), sIncludeDirectories.end(), dir) == sIncludeDirectories.end()) {
+        sIncludeDirectories.push_back(dir);
+    }
+}
+
+void ShaderPreprocessor::clearCache() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    sFileCache.clear();
+    sExpandedCache.clear();
+    // sFileNames 不清空：已编译的 Shader 仍可能用旧编号查询文件名
+}
+
+std::string ShaderPreprocessor::getFileName(int fileId) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    if (fileId <= 0 || fileId > static_cast<int>(sFileNames.size())) {
+        return "";
+    }
+    return sFileNames[fileId - 1];
+}
+
+const ShaderPreprocessor::SourceFile* ShaderPreprocessor::loadFile(const std::string& path) {
+    // 1. 命中头文件缓存，直接返回
+    auto it = sFileCache.find(path);
+    if (it != sFileCache.end()) {
+        return &it->second;
+    }
+
+    // 2. 读取文件
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "[ShaderPreprocessor Error] Failed to open shader file: " << path << std::endl;
+        return nullptr;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    file.close();
+    sFileReadCount++;
+
+    SourceFile source;
+    source.path = path;
+    std::string content = stream.str();
+    source.hash = hashString(content);
+
+    // 源串编号：同一路径只分配一次，清空缓存后重新读取仍然沿用
+    auto nameIt = std::find(sFileNames.begin(), sFileNames.end(), path);
+    if (nameIt == sFileNames.end()) {
+        sFileNames.push_back(path);
+        source.id = static_cast<int>(sFileNames.size());
+    }
+    else {
+        source.id = static_cast<int>(nameIt - sFileNames.begin()) + 1;
+    }
+
+    // 3. 只扫描一遍：切行，同时记录 #define / #include / #version / #pragma once
+    std::istringstream lineStream(content);
+    std::string line;
+    std::string directive, rest;
+    while (std::getline(lineStream, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();    // 兼容 Windows(\r\n) 换行
+        }
+
+        if (parseDirective(line, directive, rest)) {
+            if (directive == "define") {
+                source.defines.insert(parseIdentifier(rest));
+            }
+            else if (directive == "include") {
+                std::string includeName;
+                if (rest.size() > 2 && (rest[0] == '"' || rest[0] == '<')) {
+                    char closing = (rest[0] == '"') ? '"' : '>';
+                    size_t closePos = rest.find(closing, 1);
+                    if (closePos != std::string::npos) {
+                        includeName = rest.substr(1, closePos - 1);
+                    }
+                }
+                source.includes.push_back(resolveInclude(includeName, path));
+            }
+            else if (directive == "version" && source.versionLine < 0) {
+                source.versionLine = static_cast<int>(source.lines.size());
+            }
+            else if (directive == "pragma" && parseIdentifier(rest) == "once") {
+                source.pragmaOnce = true;
+            }
+        }
+        source.lines.push_back(line);
+    }
+
+    auto result = sFileCache.emplace(path, std::move(source));
+    return &result.first->second;
+}
+
+std::string ShaderPreprocessor::resolveInclude(const std::string& includeName, const std::string& currentPath) {
+    if (includeName.empty()) {
+        return "";
+    }
+
+    // 1. 相对于当前文件所在目录
+    std::string candidate = normalizePath(getDirectory(currentPath) + includeName);
+    if (sFileCache.count(candidate) || std::ifstream(candidate).good()) {
+        return candidate;
+    }
+
+    // 2. 依次查找搜索目录
+    for (const auto& dir : sIncludeDirectories) {
+        candidate = normalizePath(dir + "/" + includeName);
+        if (sFileCache.count(candidate) || std::ifstream(candidate).good()) {
+            return candidate;
+        }
+    }
+
+    std::cerr << "[ShaderPreprocessor Error] Cannot resolve #include \"" << includeName << "\" in " << currentPath << std::endl;
+    return "";
+}
+
+void ShaderPreprocessor::collectDefines(
+    const SourceFile* file,
+    std::unordered_set<std::string>& defines,
+    std::unordered_set<std::string>& visited
+) {
+    if (!visited.insert(file->path).second) {
+        return;
+    }
+    defines.insert(file->defines.begin(), file->defines.end());
+    for (const auto& includePath : file->includes) {
+        const SourceFile* included = includePath.empty() ? nullptr : loadFile(includePath);
+        if (included != nullptr) {
+            collectDefines(included, defines, visited);
+        }
+    }
+}
+
+bool ShaderPreprocessor::expand(
+    const SourceFile* file,
+    std::string& out,
+    std::vector<std::string>& includeStack,
+    std::unordered_set<std::string>& onceFiles,
+    const std::string* macroBlock
+) {
+    // 循环包含检测
+    if (std::find(includeStack.begin(), includeStack.end(), file->path) != includeStack.end()) {
+        std::cerr << "[ShaderPreprocessor Error] Recursive #include of " << file->path << std::endl;
+        return false;
+    }
+    if (file->pragmaOnce && !onceFiles.insert(file->path).second) {
+        return true;    // #pragma once 的文件已经展开过
+    }
+    includeStack.push_back(file->path);
+
+    // 没有 #version 的主文件：宏放到文件最前面
+    if (macroBlock != nullptr && file->versionLine < 0) {
+        out += *macroBlock;
+        out += "#line 1 " + std::to_string(file->id) + "\n";
+    }
+
+    std::string directive, rest;
+    size_t includeIndex = 0;
+    for (size_t i = 0; i < file->lines.size(); i++) {
+        const std::string& line = file->lines[i];
+        if (!parseDirective(line, directive, rest)) {
+            out += line;
+            out += '\n';
+            continue;
+        }
+
+        if (directive == "include") {
+            const std::string& includePath = file->includes[includeIndex++];
+            const SourceFile* included = includePath.empty() ? nullptr : loadFile(includePath);
+            if (included == nullptr) {
+                includeStack.pop_back();
+                return false;
+            }
+            // 被包含文件从第1行开始计数，结束后回到当前文件的下一行
+            out += "#line 1 " + std::to_string(included->id) + "\n";
+            if (!expand(included, out, includeStack, onceFiles, nullptr)) {
+                includeStack.pop_back();
+                return false;
+            }
+            out += "#line " + std::to_string(i + 2) + " " + std::to_string(file->id) + "\n";
+        }
+        else if (directive == "version" && macroBlock != nullptr && static_cast<int>(i) == file->versionLine) {
+            // 主文件的 #version：GLSL 要求它是第一条有效语句，宏紧跟其后
+            out += line;
+            out += '\n';
+            out += *macroBlock;
+            out += "#line " + std::to_string(i + 2) + " " + std::to_string(file->id) + "\n";
+        }
+        else if (directive == "version" || (directive == "pragma" && parseIdentifier(rest) == "once")) {
+            out += '\n';    // 头文件里的 #version 与 #pragma once 不能传给 GLSL，保留空行维持行号
+        }
+        else {
+            out += line;
+            out += '\n';
+        }
+    }
+
+    includeStack.pop_back();
+    return true;
+}
+
+std::string ShaderPreprocessor::processImpl(
+    const std::string& filePath,
+    const std::vector<std::pair<std::string, std::string>>& macros,
+    bool skipExisting
+) {
+    std::lock_guard<std::mutex> lock(sMutex);
+
+    // 1. 读取主文件（命中缓存则不会重复读盘）
+    const SourceFile* file = loadFile(normalizePath(filePath));
+    if (file == nullptr) {
+        return "";
+    }
+
+    // 2. 展开缓存：文件路径 + 宏列表 + 是否去重，三者相同则结果相同
+    // 不能只用内容哈希：内容相同、路径不同的文件（如 PhongBlend/vertexShader.vert 与 oit/PhongBlend.vert）
+    // 相对 include 的解析目录与 #line 的源串编号都不同；include 文件的内容变化时两个缓存一起清空
+    uint64_t key = hashString(file->path, file->hash ^ (skipExisting ? 0x9e3779b97f4a7c15ull : 0ull));
+    for (const auto& macro : macros) {
+        key = hashString(macro.second, key);
+    }
+    auto cached = sExpandedCache.find(key);
+    if (cached != sExpandedCache.end()) {
+        sCacheHitCount++;
+        return cached->second;
+    }
+
+    // 3. 宏去重：一次性收集主文件和所有 include 文件里定义过的宏，之后只做集合查询
+    std::unordered_set<std::string> existingDefines;
+    if (skipExisting) {
+        std::unordered_set<std::string> visited;
+        collectDefines(file, existingDefines, visited);
+    }
+    std::string macrosStr;
+    for (const auto& macro : macros) {
+        if (skipExisting && !macro.first.empty() && existingDefines.count(macro.first)) {
+            std::cout << "[Tools Info] Macro '" << macro.first << "' already exists in " << filePath << ", skipped." << std::endl;
+            continue;
+        }
+        macrosStr += macro.second;
+    }
+
+    // 4. 展开：宏插入到 #version 之后，并用 #line 把行号对齐回原文件
+    std::string result;
+    result.reserve(file->lines.size() * 48);
+    std::vector<std::string> includeStack;
+    std::unordered_set<std::string> onceFiles;
+    if (!expand(file, result, includeStack, onceFiles, &macrosStr)) {
+        return "";
+    }
+
+    sExpandedCache[key] = result;
+    return result;
+}
+
+std::string ShaderPreprocessor::process(
+    const std::string& filePath,
+    const std::vector<ShaderMacro>& macros,
+    bool skipExisting
+) {
+    // 类型过滤：只保留 目标类型为 ALL 或 与当前 Shader 类型匹配 的宏
+    ShaderTarget currentShaderType = macros.empty() ? ShaderTarget::ALL : Tools::getShaderTypeFromPath(filePath);
+    std::vector<std::pair<std::string, std::string>> filtered;
+    filtered.reserve(macros.size());
+    for (const auto& macro : macros) {
+        if (macro.target != ShaderTarget::ALL && macro.target != currentShaderType) {
+            continue;
+        }
+        filtered.emplace_back(macro.name, Tools::macroToString(macro));
+    }
+    return processImpl(filePath, filtered, skipExisting);
+}
+
+std::string ShaderPreprocessor::process(
+    const std::string& filePath,
+    const std::vector<std::string>& rawMacros,
+    bool skipExisting
+) {
+    std::vector<std::pair<std::string, std::string>> parsed;
+    parsed.reserve(rawMacros.size());
+    std::string directive, rest;
+    for (const auto& rawMacro : rawMacros) {
+        // 只有 #define 类型的宏才参与去重，其余（如 #extension）原样插入
+        std::string name;
+        if (parseDirective(rawMacro, directive, rest) && directive == "define") {
+            name = parseIdentifier(rest);
+        }
+        parsed.emplace_back(name, rawMacro + "\n");
+    }
+    return processImpl(filePath, parsed, skipExisting);
+}
+
+std::string ShaderPreprocessor::remapLog(const std::string& infoLog) {
+    // NVIDIA: "3(25) : error ..."   Mesa/Intel/AMD: "3:25(7): error ..." / "ERROR: 3:25: ..."
+    static const std::regex locationPattern(R"(^(\s*(?:ERROR:|WARNING:)?\s*)(\d+)([:(])(\d+))");
+
+    std::istringstream logStream(infoLog);
+    std::string line;
+    std::string result;
+    while (std::getline(logStream, line)) {
+        std::smatch match;
+        if (std::regex_search(line, match, locationPattern)) {
+            std::string fileName = getFileName(std::stoi(match[2].str()));
+            if (!fileName.empty()) {
+                line = match[1].str() + fileName + "(" + match[4].str() + ")" + match.suffix().str();
+            }
+        }
+        result += line;
+        result += '\n';
+    }
+    return result;
+}
@@ -1,23 +1,10 @@
 #include "tools.h"
+#include "shaderPreprocessor.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
-#include <regex>
 #include <algorithm>
 
-// תʽеַ
-static std::string escapeRegexSpecialChars(const std::string& input) {
-    const std::string specialChars = R"(\^$.|?*+()[]{})";
-    std::string result;
-    for (char c : input) {
-        if (specialChars.find(c) != std::string::npos) {
-            result += '\\'; // ַת
-        }
-        result += c;
-    }
-    return result;
-}
-
 void Tools::decompose(
 	glm::mat4 matrix, 
 	glm::vec3& position, 
@@ -62,6 +49,9 @@ ShaderTarget Tools::getShaderTypeFromPath(const std::string& filePath) {
     else if (ext == ".frag") {
         return ShaderTarget::FRAGMENT;
     }
+    else if (ext == ".comp") {
+        return ShaderTarget::COMPUTE;
+    }
     else {
         // δ֪׺Ĭϰ ALL ˣ
         std::cerr << "[Tools Warning] Unknown shader file extension: " << filePath << ", treat as ALL target." << std::endl;
@@ -69,40 +59,6 @@ ShaderTarget Tools::getShaderTypeFromPath(const std::string& filePath) {
     }
 }
 
-// ǷѴڣ滻ԭ汾޼⣩
-bool Tools::isMacroExists(const std::string& source, const std::string& macroName) {
-    // Ŀַ"#define "עҪոβ
-    std::string targetPrefix = "#define " + macroName;
-    size_t targetLen = targetPrefix.length();
-
-    // жȡԴ
-    std::istringstream sourceStream(source);
-    std::string line;
-    while (std::getline(sourceStream, line)) {
-        // 1ȥпͷпհ׷ոTab
-        size_t firstNonSpace = line.find_first_not_of(" \t");
-        if (firstNonSpace == std::string::npos) {
-            continue; // У
-        }
-        std::string trimmedLine = line.substr(firstNonSpace);
-
-        // 2Ƿ "#define " ͷ
-        if (trimmedLine.size() < targetLen) {
-            continue;
-        }
-        if (trimmedLine.substr(0, targetLen) != targetPrefix) {
-            continue;
-        }
-
-        // 3Ƿǿհ׷βƥ "_XXX" 
-        if (trimmedLine.size() == targetLen || isspace(trimmedLine[targetLen])) {
-            return true; // ҵѴڵĺ
-        }
-    }
-
-    return false; // δҵ
-}
-
 // ShaderMacro ת GLSL ַ
 std::string Tools::macroToString(const ShaderMacro& macro) {
     std::stringstream ss;
@@ -118,70 +74,13 @@ std::string Tools::macroToString(const ShaderMacro& macro) {
 }
 
 // 1 ShaderMacro б֧͹ˣ
+// ʵʹ ShaderPreprocessorͬһļֻһΣչݹϣ棬֧ #include
 std::string Tools::readShaderSourceWithMacros(
     const std::string& filePath,
     const std::vector<ShaderMacro>& macros,
     bool skipExisting
 ) {
-    // 1. ȡ Shader ļ
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cerr << "[Tools Error] Failed to open shader file: " << filePath << std::endl;
-        return "";
-    }
-    std::stringstream shaderStream;
-    shaderStream << file.rdbuf();
-    file.close();
-    std::string shaderSource = shaderStream.str();
-
-    // 2. ȡǰ Shader ͣ.vert/.frag
-    ShaderTarget currentShaderType = getShaderTypeFromPath(filePath);
-
-    // 3. Ҫĺַ + ȥأ
-    std::stringstream macrosStream;
-    for (const auto& macro : macros) {
-        // ͹ˣ ĿΪ ALL  뵱ǰ Shader ƥ ĺ
-        bool isTargetMatch = (macro.target == ShaderTarget::ALL) || (macro.target == currentShaderType);
-        if (!isTargetMatch) {
-            // Ϣѡ鿴˵ĺ
-            // std::cout << "[Tools Info] Macro '" << macro.name << "' skipped (target mismatch) for " << filePath << std::endl;
-            continue;
-        }
-
-        // ȥعˣѴҿȥأ
-        if (skipExisting && isMacroExists(shaderSource, macro.name)) {
-            std::cout << "[Tools Info] Macro '" << macro.name << "' already exists in " << filePath << ", skipped." << std::endl;
-            continue;
-        }
-
-        // ӵַ
-        macrosStream << macroToString(macro);
-    }
-    std::string macrosStr = macrosStream.str();
-    if (macrosStr.empty()) {
-        return shaderSource;  // ޷ĺ꣬ԭԴ
-    }
-
-    // 4. ȷλã#version ֮GLSL ǿҪ #version ǵһЧ룩
-    size_t versionPos = shaderSource.find("#version");
-    if (versionPos != std::string::npos) {
-        //  Windows(\r\n)  Linux(\n) з
-        size_t newlinePos = shaderSource.find("\n", versionPos);
-        if (newlinePos != std::string::npos) {
-            // 뵽 #version һ
-            shaderSource.insert(newlinePos + 1, macrosStr);
-        }
-        else {
-            // #version һУ׷ӵĩβӻбƴӴ
-            shaderSource += "\n" + macrosStr;
-        }
-    }
-    else {
-        //  #version 뵽ļͷ
-        shaderSource = macrosStr + shaderSource;
-    }
-
-    return shaderSource;
+    return ShaderPreprocessor::process(filePath, macros, skipExisting);
 }
 
 // 2ԭʼַ͹ˣԭȣ
@@ -190,51 +89,5 @@ std::string Tools::readShaderSourceWithMacros(
     const std::vector<std::string>& rawMacros,
     bool skipExisting
 ) {
-    // 1. ȡļ
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cerr << "[Tools Error] Failed to open shader file: " << filePath << std::endl;
-        return "";
-    }
-    std::stringstream shaderStream;
-    shaderStream << file.rdbuf();
-    file.close();
-    std::string shaderSource = shaderStream.str();
-
-    // 2. ɺַ #define ȥأ
-    std::stringstream macrosStream;
-    std::regex definePattern(R"(^\s*#define\s+(\w+))", std::regex_constants::grep);
-    for (const auto& rawMacro : rawMacros) {
-        //  #define ͺȥؼ
-        std::smatch match;
-        if (skipExisting && std::regex_search(rawMacro, match, definePattern) && match.size() > 1) {
-            std::string macroName = match[1].str();
-            if (isMacroExists(shaderSource, macroName)) {
-                std::cout << "[Tools Info] Macro '" << macroName << "' already exists in " << filePath << ", skipped." << std::endl;
-                continue;
-            }
-        }
-        macrosStream << rawMacro << "\n";
-    }
-    std::string macrosStr = macrosStream.str();
-    if (macrosStr.empty()) {
-        return shaderSource;
-    }
-
-    // 3. λ߼1һ£
-    size_t versionPos = shaderSource.find("#version");
-    if (versionPos != std::string::npos) {
-        size_t newlinePos = shaderSource.find("\n", versionPos);
-        if (newlinePos != std::string::npos) {
-            shaderSource.insert(newlinePos + 1, macrosStr);
-        }
-        else {
-            shaderSource += "\n" + macrosStr;
-        }
-    }
-    else {
-        shaderSource = macrosStr + shaderSource;
-    }
-
-    return shaderSource;
-}
\ No newline at end of file
+    return ShaderPreprocessor::process(filePath, rawMacros, skipExisting);
+}
@@ -0,0 +1,400 @@
+#include "transformStorage.h"
+#include "tools/jobSystem.h"
+#include "redrawTracker.h"
+#include <cassert>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define TRANSFORM_USE_SSE 1
+#endif
+
+// 必须在cpp中初始化静态成员
+std::vector<glm::vec3> TransformStorage::sPositions{};
+std::vector<glm::vec3> TransformStorage::sAngles{};
+std::vector<glm::vec3> TransformStorage::sScales{};
+std::vector<glm::mat4> TransformStorage::sLocalMatrices{};
+std::vector<glm::mat4> TransformStorage::sWorldMatrices{};
+std::vector<int32_t> TransformStorage::sParents{};
+std::vector<uint8_t> TransformStorage::sLocalDirty{};
+std::vector<uint8_t> TransformStorage::sWorldDirty{};
+std::vector<TransformHandle> TransformStorage::sHandles{};
+std::vector<uint32_t> TransformStorage::sHandleToIndex{};
+std::vector<TransformHandle> TransformStorage::sFreeHandles{};
+std::vector<uint32_t> TransformStorage::sWorldVersions{};
+uint64_t TransformStorage::sStructureVersion = 0;
+std::vector<size_t> TransformStorage::sLevelOffsets{};
+bool TransformStorage::sHierarchyDirty = false;
+bool TransformStorage::sTransformDirty = false;
+size_t TransformStorage::sParallelThreshold = 2048;
+
+// 4x4 矩阵乘法 out = a * b（glm 列主序）
+static inline void multiplyMatrix(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+#ifdef TRANSFORM_USE_SSE
+    const float* pa = glm::value_ptr(a);
+    const float* pb = glm::value_ptr(b);
+    float* po = glm::value_ptr(out);
+
+    __m128 a0 = _mm_loadu_ps(pa + 0);
+    __m128 a1 = _mm_loadu_ps(pa + 4);
+    __m128 a2 = _mm_loadu_ps(pa + 8);
+    __m128 a3 = _mm_loadu_ps(pa + 12);
+
+    // 结果的第 j 列 = a 的四列按 b 第 j 列的四个分量加权求和
+    for (int j = 0; j < 4; j++) {
+        const float* column = pb + j * 4;
+        __m128 result = _mm_mul_ps(a0, _mm_set1_ps(column[0]));
+        result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_set1_ps(column[1])));
+        result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_set1_ps(column[2])));
+        result = _mm_add_ps(result, _mm_mul_ps(a3, _mm_set1_ps(column[3])));
+        _mm_storeu_ps(po + j * 4, result);
+    }
+#else
+    out = a * b;
+#endif
+}
+
+// 由位置 / 欧拉角 / 缩放计算局部矩阵，与原 Object::getModelMatrx 的顺序一致：T * S * Rx * Ry * Rz
+static inline glm::mat4 composeLocalMatrix(const glm::vec3& position, const glm::vec3& angles, const glm::vec3& scale) {
+    glm::mat4 transform = glm::eulerAngleXYZ(glm::radians(angles.x), glm::radians(angles.y), glm::radians(angles.z));
+
+    // 左乘缩放矩阵 = 每一行乘上对应的缩放分量
+    for (int c = 0; c < 3; c++) {
+        transform[c][0] *= scale.x;
+        transform[c][1] *= scale.y;
+        transform[c][2] *= scale.z;
+    }
+
+    // 左乘平移矩阵 = 第四列写入位置
+    transform[3] = glm::vec4(position, 1.0f);
+    return transform;
+}
+
+TransformHandle TransformStorage::create() {
+    TransformHandle handle;
+    if (!sFreeHandles.empty()) {
+        handle = sFreeHandles.back();
+        sFreeHandles.pop_back();
+    }
+    else {
+        handle = static_cast<TransformHandle>(sHandleToIndex.size());
+        sHandleToIndex.push_back(0);
+        sWorldVersions.push_back(0);
+    }
+
+    uint32_t index = static_cast<uint32_t>(sPositions.size());
+    sHandleToIndex[handle] = index;
+
+    // 新节点没有父节点，放在末尾不会破坏按深度排序
+    sPositions.push_back(glm::vec3(0.0f));
+    sAngles.push_back(glm::vec3(0.0f));
+    sScales.push_back(glm::vec3(1.0f));
+    sLocalMatrices.push_back(glm::mat4(1.0f));
+    sWorldMatrices.push_back(glm::mat4(1.0f));
+    sParents.push_back(-1);
+    sLocalDirty.push_back(0);
+    sWorldDirty.push_back(0);
+    sHandles.push_back(handle);
+
+    // 根节点挂在第 0 层：层级信息需要重新计算
+    sHierarchyDirty = true;
+    sStructureVersion++;
+    return handle;
+}
+
+void TransformStorage::destroy(TransformHandle handle) {
+    if (handle >= sHandleToIndex.size()) {
+        return;
+    }
+
+    uint32_t index = sHandleToIndex[handle];
+    uint32_t last = static_cast<uint32_t>(sPositions.size() - 1);
+
+    // 用最后一个节点填补空位（层级顺序会被打乱，下次 update 时重新排序）
+    if (index != last) {
+        sPositions[index] = sPositions[last];
+        sAngles[index] = sAngles[last];
+        sScales[index] = sScales[last];
+        sLocalMatrices[index] = sLocalMatrices[last];
+        sWorldMatrices[index] = sWorldMatrices[last];
+        sParents[index] = sParents[last];
+        sLocalDirty[index] = sLocalDirty[last];
+        sWorldDirty[index] = sWorldDirty[last];
+        sHandles[index] = sHandles[last];
+        sHandleToIndex[sHandles[index]] = index;
+    }
+
+    sPositions.pop_back();
+    sAngles.pop_back();
+    sScales.pop_back();
+    sLocalMatrices.pop_back();
+    sWorldMatrices.pop_back();
+    sParents.pop_back();
+    sLocalDirty.pop_back();
+    sWorldDirty.pop_back();
+    sHandles.pop_back();
+
+    // 修正父节点下标：被删除节点的孩子变为根节点，指向最后一个节点的改为指向新位置
+    for (size_t i = 0; i < sParents.size(); i++) {
+        if (sParents[i] == static_cast<int32_t>(index)) {
+            sParents[i] = -1;
+            markDirty(static_cast<uint32_t>(i));
+        }
+        else if (sParents[i] == static_cast<int32_t>(last)) {
+            sParents[i] = static_cast<int32_t>(index);
+        }
+    }
+
+    sHandleToIndex[handle] = 0;
+    sFreeHandles.push_back(handle);
+    sHierarchyDirty = true;
+    sStructureVersion++;
+}
+
+void TransformStorage::destroyBatch(const std::vector<TransformHandle>& handles) {
+    if (handles.empty()) {
+        return;
+    }
+
+    // 1 标记要删除的下标，回收句柄
+    std::vector<int32_t> remap(sPositions.size(), 0);
+    for (auto handle : handles) {
+        if (handle >= sHandleToIndex.size()) {
+            continue;
+        }
+        remap[sHandleToIndex[handle]] = -1;
+        sHandleToIndex[handle] = 0;
+        sFreeHandles.push_back(handle);
+    }
+
+    // 2 保持相对顺序压缩数组，remap 记录旧下标 -> 新下标
+    size_t count = 0;
+    for (size_t i = 0; i < sPositions.size(); i++) {
+        if (remap[i] < 0) {
+            continue;
+        }
+        remap[i] = static_cast<int32_t>(count);
+        if (count != i) {
+            sPositions[count] = sPositions[i];
+            sAngles[count] = sAngles[i];
+            sScales[count] = sScales[i];
+            sLocalMatrices[count] = sLocalMatrices[i];
+            sWorldMatrices[count] = sWorldMatrices[i];
+            sParents[count] = sParents[i];
+            sLocalDirty[count] = sLocalDirty[i];
+            sWorldDirty[count] = sWorldDirty[i];
+            sHandles[count] = sHandles[i];
+        }
+        count++;
+    }
+
+    sPositions.resize(count);
+    sAngles.resize(count);
+    sScales.resize(count);
+    sLocalMatrices.resize(count);
+    sWorldMatrices.resize(count);
+    sParents.resize(count);
+    sLocalDirty.resize(count);
+    sWorldDirty.resize(count);
+    sHandles.resize(count);
+
+    // 3 修正句柄映射与父节点下标：父节点被删除的节点变为根节点
+    for (size_t i = 0; i < count; i++) {
+        sHandleToIndex[sHandles[i]] = static_cast<uint32_t>(i);
+        int32_t parent = sParents[i];
+        if (parent < 0) {
+            continue;
+        }
+        if (remap[parent] < 0) {
+            sParents[i] = -1;
+            markDirty(static_cast<uint32_t>(i));
+        }
+        else {
+            sParents[i] = remap[parent];
+        }
+    }
+
+    sHierarchyDirty = true;
+    sStructureVersion++;
+}
+
+void TransformStorage::setParent(TransformHandle child, TransformHandle parent) {
+    uint32_t childIndex = sHandleToIndex[child];
+    sParents[childIndex] = parent == INVALID_TRANSFORM ? -1 : static_cast<int32_t>(sHandleToIndex[parent]);
+    markDirty(childIndex);
+    sHierarchyDirty = true;
+    sStructureVersion++;
+}
+
+void TransformStorage::setPosition(TransformHandle handle, const glm::vec3& position) {
+    uint32_t index = sHandleToIndex[handle];
+    if (sPositions[index] == position) {
+        return;
+    }
+    sPositions[index] = position;
+    markDirty(index);
+}
+
+glm::vec3 TransformStorage::getPosition(TransformHandle handle) {
+    return sPositions[sHandleToIndex[handle]];
+}
+
+void TransformStorage::setAngles(TransformHandle handle, const glm::vec3& angles) {
+    uint32_t index = sHandleToIndex[handle];
+    if (sAngles[index] == angles) {
+        return;
+    }
+    sAngles[index] = angles;
+    markDirty(index);
+}
+
+glm::vec3 TransformStorage::getAngles(TransformHandle handle) {
+    return sAngles[sHandleToIndex[handle]];
+}
+
+void TransformStorage::setScale(TransformHandle handle, const glm::vec3& scale) {
+    uint32_t index = sHandleToIndex[handle];
+    if (sScales[index] == scale) {
+        return;
+    }
+    sScales[index] = scale;
+    markDirty(index);
+}
+
+glm::vec3 TransformStorage::getScale(TransformHandle handle) {
+    return sScales[sHandleToIndex[handle]];
+}
+
+glm::mat4 TransformStorage::getWorldMatrix(TransformHandle handle) {
+    if (isDirty()) {
+        // 工作线程上不能懒更新：同一批任务的其它线程正在读世界矩阵，并行读取之前先在调用线程执行 update()
+        assert(!JobSystem::isWorkerThread() && "TransformStorage::update() must run before parallel reads");
+        if (!JobSystem::isWorkerThread()) {
+            update();
+        }
+    }
+    return sWorldMatrices[sHandleToIndex[handle]];
+}
+
+void TransformStorage::markDirty(uint32_t index) {
+    sLocalDirty[index] = 1;
+    sTransformDirty = true;
+    RedrawTracker::markDirty();
+}
+
+void TransformStorage::update() {
+    if (!isDirty()) {
+        return;
+    }
+
+    if (sHierarchyDirty) {
+        sortByDepth();
+        // 排序后父子位置变化，全部世界矩阵重新计算一次
+        std::fill(sWorldDirty.begin(), sWorldDirty.end(), 1);
+        sHierarchyDirty = false;
+    }
+
+    // 逐层更新：第 i 层只依赖第 i - 1 层的世界矩阵
+    for (size_t level = 0; level + 1 < sLevelOffsets.size(); level++) {
+        size_t levelBegin = sLevelOffsets[level];
+        size_t levelEnd = sLevelOffsets[level + 1];
+
+        JobSystem::parallelFor(levelEnd - levelBegin, sParallelThreshold, [levelBegin](size_t begin, size_t end) {
+            updateRange(levelBegin + begin, levelBegin + end);
+        });
+    }
+
+    std::fill(sLocalDirty.begin(), sLocalDirty.end(), 0);
+    std::fill(sWorldDirty.begin(), sWorldDirty.end(), 0);
+    sTransformDirty = false;
+}
+
+void TransformStorage::updateRange(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        if (sLocalDirty[i]) {
+            sLocalMatrices[i] = composeLocalMatrix(sPositions[i], sAngles[i], sScales[i]);
+            sWorldDirty[i] = 1;
+        }
+
+        int32_t parent = sParents[i];
+        if (parent >= 0 && sWorldDirty[parent]) {
+            sWorldDirty[i] = 1;
+        }
+
+        if (!sWorldDirty[i]) {
+            continue;
+        }
+
+        if (parent < 0) {
+            sWorldMatrices[i] = sLocalMatrices[i];
+        }
+        else {
+            multiplyMatrix(sWorldMatrices[parent], sLocalMatrices[i], sWorldMatrices[i]);
+        }
+        sWorldVersions[sHandles[i]]++;
+    }
+}
+
+void TransformStorage::sortByDepth() {
+    size_t count = sPositions.size();
+
+    // 1 计算每个节点的深度（沿父链向上找到第一个已知深度的节点）
+    std::vector<int32_t> depths(count, -1);
+    std::vector<uint32_t> chain;
+    int32_t maxDepth = -1;
+    for (size_t i = 0; i < count; i++) {
+        int32_t node = static_cast<int32_t>(i);
+        chain.clear();
+        while (node >= 0 && depths[node] < 0) {
+            chain.push_back(static_cast<uint32_t>(node));
+            node = sParents[node];
+        }
+
+        int32_t depth = node >= 0 ? depths[node] : -1;
+        for (auto iter = chain.rbegin(); iter != chain.rend(); ++iter) {
+            depths[*iter] = ++depth;
+        }
+        maxDepth = std::max(maxDepth, depths[i]);
+    }
+
+    // 2 计数排序：统计每层节点个数，得到每层的起始位置
+    sLevelOffsets.assign(static_cast<size_t>(maxDepth + 2), 0);
+    for (size_t i = 0; i < count; i++) {
+        sLevelOffsets[depths[i] + 1]++;
+    }
+    for (size_t level = 1; level < sLevelOffsets.size(); level++) {
+        sLevelOffsets[level] += sLevelOffsets[level - 1];
+    }
+
+    std::vector<uint32_t> newIndex(count);
+    std::vector<size_t> cursor(sLevelOffsets.begin(), sLevelOffsets.end() - 1);
+    for (size_t i = 0; i < count; i++) {
+        newIndex[i] = static_cast<uint32_t>(cursor[depths[i]]++);
+    }
+
+    // 3 按新下标重新排列所有数组
+    auto permute = [&](auto& array) {
+        std::remove_reference_t<decltype(array)> sorted(array.size());
+        for (size_t i = 0; i < count; i++) {
+            sorted[newIndex[i]] = array[i];
+        }
+        array.swap(sorted);
+    };
+    permute(sPositions);
+    permute(sAngles);
+    permute(sScales);
+    permute(sLocalMatrices);
+    permute(sWorldMatrices);
+    permute(sLocalDirty);
+    permute(sWorldDirty);
+    permute(sHandles);
+
+    std::vector<int32_t> parents(count);
+    for (size_t i = 0; i < count; i++) {
+        parents[newIndex[i]] = sParents[i] >= 0 ? static_cast<int32_t>(newIndex[sParents[i]]) : -1;
+    }
+    sParents.swap(parents);
+
+    for (size_t i = 0; i < count; i++) {
+        sHandleToIndex[sHandles[i]] = static_cast<uint32_t>(i);
+    }
+}
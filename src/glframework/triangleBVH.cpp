@@ -0,0 +1,375 @@
+#include "triangleBVH.h"
+#include "tools/profiler.h"
+#include "tools/jobSystem.h"
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cfloat>
+#include <mutex>
+#include <deque>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define TRIANGLE_BVH_USE_SSE 1
+#endif
+
+static const uint32_t MAX_LEAF_SIZE = 4;
+static const int BIN_COUNT = 16;
+static const int MAX_DEPTH = 64;
+
+// 后台构建：每个排队的 TriangleBVH 提交一个后台任务给 JobSystem，任务从队列头部取一个构建；
+// 已经释放的从队列中移除，多出来的任务取不到时直接返回
+class TriangleBVHBuilder {
+public:
+    static TriangleBVHBuilder& get() {
+        static TriangleBVHBuilder builder;
+        return builder;
+    }
+
+    void push(TriangleBVH* bvh) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            bvh->mAsyncState = TriangleBVH::AsyncState::Queued;
+            mQueue.push_back(bvh);
+        }
+        JobSystem::runBackground([this] { buildNext(); });
+    }
+
+    // 返回 true 表示由调用者删除
+    bool release(TriangleBVH* bvh) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (bvh->mAsyncState == TriangleBVH::AsyncState::Queued) {
+            mQueue.erase(std::remove(mQueue.begin(), mQueue.end(), bvh), mQueue.end());
+            bvh->mAsyncState = TriangleBVH::AsyncState::None;
+            return true;
+        }
+        if (bvh->mAsyncState == TriangleBVH::AsyncState::Building) {
+            bvh->mDiscard = true;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void buildNext() {
+        TriangleBVH* bvh = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mQueue.empty()) {
+                return;
+            }
+            bvh = mQueue.front();
+            mQueue.pop_front();
+            bvh->mAsyncState = TriangleBVH::AsyncState::Building;
+        }
+
+        bvh->build();
+
+        bool discard = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            bvh->mAsyncState = TriangleBVH::AsyncState::None;
+            discard = bvh->mDiscard;
+        }
+        if (discard) {
+            delete bvh;
+        }
+    }
+
+private:
+    std::mutex mMutex;
+    std::deque<TriangleBVH*> mQueue;
+};
+
+TriangleBVH::TriangleBVH(std::vector<float> positions, std::vector<unsigned int> indices) {
+    mPositions.resize(positions.size() / 3);
+    for (size_t i = 0; i < mPositions.size(); i++) {
+        mPositions[i] = glm::vec3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+    }
+    mIndices = std::move(indices);
+    mIndices.resize(mIndices.size() / 3 * 3);
+}
+
+TriangleBVH::~TriangleBVH() {}
+
+void TriangleBVH::buildAsync(TriangleBVH* bvh) {
+    TriangleBVHBuilder::get().push(bvh);
+}
+
+void TriangleBVH::release(TriangleBVH* bvh) {
+    if (bvh != nullptr && TriangleBVHBuilder::get().release(bvh)) {
+        delete bvh;
+    }
+}
+
+void TriangleBVH::build() {
+    PROFILE_FUNCTION();
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // 1 每个三角形的包围盒与中心
+    uint32_t count = static_cast<uint32_t>(mIndices.size() / 3);
+    std::vector<glm::vec3> triMin(count), triMax(count), centroids(count);
+    for (uint32_t i = 0; i < count; i++) {
+        glm::vec3 p0, p1, p2;
+        getTriangle(i, p0, p1, p2);
+        triMin[i] = glm::min(p0, glm::min(p1, p2));
+        triMax[i] = glm::max(p0, glm::max(p1, p2));
+        centroids[i] = (triMin[i] + triMax[i]) * 0.5f;
+    }
+
+    // 2 递归构建
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0u);
+    mNodes.clear();
+    mNodes.reserve(std::max<size_t>(1, static_cast<size_t>(count) * 2));
+    mNodes.emplace_back();
+    if (count > 0) {
+        buildNode(0, 0, count, order, centroids, triMin, triMax, 0);
+    }
+    mNodes.shrink_to_fit();
+
+    // 3 三角形按叶子顺序展开
+    mTriangleData.resize(static_cast<size_t>(count) * 3);
+    mTriangleIds.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        glm::vec3 p0, p1, p2;
+        getTriangle(order[i], p0, p1, p2);
+        mTriangleData[i * 3 + 0] = p0;
+        mTriangleData[i * 3 + 1] = p1 - p0;
+        mTriangleData[i * 3 + 2] = p2 - p0;
+        mTriangleIds[i] = order[i];
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    mBuildTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    mReady.store(true, std::memory_order_release);
+}
+
+void TriangleBVH::buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, std::vector<uint32_t>& order, const std::vector<glm::vec3>& centroids,
+    const std::vector<glm::vec3>& triMin, const std::vector<glm::vec3>& triMax, int depth) {
+    uint32_t count = end - begin;
+
+    glm::vec3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+    glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t tri = order[i];
+        boundsMin = glm::min(boundsMin, triMin[tri]);
+        boundsMax = glm::max(boundsMax, triMax[tri]);
+        centroidMin = glm::min(centroidMin, centroids[tri]);
+        centroidMax = glm::max(centroidMax, centroids[tri]);
+    }
+    mNodes[nodeIndex].boundsMin = boundsMin;
+    mNodes[nodeIndex].boundsMax = boundsMax;
+
+    auto makeLeaf = [&]() {
+        mNodes[nodeIndex].first = begin;
+        mNodes[nodeIndex].count = count;
+    };
+    if (count <= MAX_LEAF_SIZE || depth >= MAX_DEPTH) {
+        makeLeaf();
+        return;
+    }
+
+    // 1 在中心分布最长的轴上做 SAH 分桶
+    glm::vec3 extent = centroidMax - centroidMin;
+    int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+    uint32_t split = begin;
+    if (extent[axis] > 1e-12f) {
+        glm::vec3 binMin[BIN_COUNT], binMax[BIN_COUNT];
+        uint32_t binCount[BIN_COUNT] = {};
+        for (int b = 0; b < BIN_COUNT; b++) {
+            binMin[b] = glm::vec3(FLT_MAX);
+            binMax[b] = glm::vec3(-FLT_MAX);
+        }
+        float scale = BIN_COUNT / extent[axis];
+        float minimum = centroidMin[axis];
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t tri = order[i];
+            int b = std::min(BIN_COUNT - 1, static_cast<int>((centroids[tri][axis] - minimum) * scale));
+            binMin[b] = glm::min(binMin[b], triMin[tri]);
+            binMax[b] = glm::max(binMax[b], triMax[tri]);
+            binCount[b]++;
+        }
+
+        auto area = [](const glm::vec3& lo, const glm::vec3& hi) {
+            glm::vec3 size = glm::max(hi - lo, glm::vec3(0.0f));
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        };
+
+        float rightArea[BIN_COUNT];
+        uint32_t rightCount[BIN_COUNT];
+        glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+        uint32_t sum = 0;
+        for (int b = BIN_COUNT - 1; b > 0; b--) {
+            sum += binCount[b];
+            lo = glm::min(lo, binMin[b]);
+            hi = glm::max(hi, binMax[b]);
+            rightCount[b] = sum;
+            rightArea[b] = area(lo, hi);
+        }
+
+        float bestCost = FLT_MAX;
+        int bestBin = -1;
+        lo = glm::vec3(FLT_MAX);
+        hi = glm::vec3(-FLT_MAX);
+        sum = 0;
+        for (int b = 0; b < BIN_COUNT - 1; b++) {
+            sum += binCount[b];
+            lo = glm::min(lo, binMin[b]);
+            hi = glm::max(hi, binMax[b]);
+            if (sum == 0 || rightCount[b + 1] == 0) {
+                continue;
+            }
+            float cost = area(lo, hi) * sum + rightArea[b + 1] * rightCount[b + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestBin = b;
+            }
+        }
+
+        // 划分代价不低于叶子代价（遍历代价 1，三角形求交代价 1）时，少量三角形直接做成叶子
+        float nodeArea = area(boundsMin, boundsMax);
+        if (bestBin >= 0 && count <= MAX_LEAF_SIZE * 2 && nodeArea > 0.0f && 1.0f + bestCost / nodeArea >= static_cast<float>(count)) {
+            bestBin = -1;
+        }
+
+        if (bestBin >= 0) {
+            auto middle = std::partition(order.begin() + begin, order.begin() + end, [&](uint32_t tri) {
+                int b = std::min(BIN_COUNT - 1, static_cast<int>((centroids[tri][axis] - minimum) * scale));
+                return b <= bestBin;
+            });
+            split = static_cast<uint32_t>(middle - order.begin());
+        }
+    }
+
+    // 2 SAH 无法划分时（例如中心重合）退回中位数划分
+    if (split == begin || split == end) {
+        split = begin + count / 2;
+        std::nth_element(order.begin() + begin, order.begin() + split, order.begin() + end,
+            [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+    }
+
+    uint32_t children = static_cast<uint32_t>(mNodes.size());
+    mNodes.emplace_back();
+    mNodes.emplace_back();
+    mNodes[nodeIndex].first = children;
+    mNodes[nodeIndex].count = 0;
+    buildNode(children, begin, split, order, centroids, triMin, triMax, depth + 1);
+    buildNode(children + 1, split, end, order, centroids, triMin, triMax, depth + 1);
+}
+
+void TriangleBVH::getTriangle(uint32_t triangle, glm::vec3& p0, glm::vec3& p1, glm::vec3& p2) const {
+    p0 = mPositions[mIndices[triangle * 3 + 0]];
+    p1 = mPositions[mIndices[triangle * 3 + 1]];
+    p2 = mPositions[mIndices[triangle * 3 + 2]];
+}
+
+// 射线与包围盒求交，返回进入距离，不相交时返回 FLT_MAX
+#ifdef TRIANGLE_BVH_USE_SSE
+static inline float intersectBox(const TriangleBVH::Node& node, __m128 origin, __m128 invDirection, float maxDistance) {
+    // 节点的 boundsMin / boundsMax 后面紧跟一个 uint32，第 4 个分量不参与比较
+    __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&node.boundsMin.x), origin), invDirection);
+    __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&node.boundsMax.x), origin), invDirection);
+    __m128 tNear = _mm_min_ps(t0, t1);
+    __m128 tFar = _mm_max_ps(t0, t1);
+
+    __m128 enter = _mm_max_ss(_mm_max_ss(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(1, 1, 1, 1))), _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(2, 2, 2, 2)));
+    __m128 exit = _mm_min_ss(_mm_min_ss(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(1, 1, 1, 1))), _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(2, 2, 2, 2)));
+    float tEnter = std::max(_mm_cvtss_f32(enter), 0.0f);
+    float tExit = std::min(_mm_cvtss_f32(exit), maxDistance);
+    return tEnter <= tExit ? tEnter : FLT_MAX;
+}
+#else
+static inline float intersectBox(const TriangleBVH::Node& node, const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance) {
+    glm::vec3 t0 = (node.boundsMin - origin) * invDirection;
+    glm::vec3 t1 = (node.boundsMax - origin) * invDirection;
+    glm::vec3 tNear = glm::min(t0, t1);
+    glm::vec3 tFar = glm::max(t0, t1);
+    float tEnter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    float tExit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+    return tEnter <= tExit ? tEnter : FLT_MAX;
+}
+#endif
+
+bool TriangleBVH::intersect(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Hit& hit) const {
+    if (!isReady() || mTriangleIds.empty()) {
+        return false;
+    }
+
+    glm::vec3 invDirection = 1.0f / direction;
+#ifdef TRIANGLE_BVH_USE_SSE
+    __m128 originSSE = _mm_set_ps(0.0f, origin.z, origin.y, origin.x);
+    __m128 invDirectionSSE = _mm_set_ps(0.0f, invDirection.z, invDirection.y, invDirection.x);
+#else
+    const glm::vec3& originSSE = origin;
+    const glm::vec3& invDirectionSSE = invDirection;
+#endif
+
+    float closest = maxDistance;
+    bool found = false;
+    uint32_t stack[MAX_DEPTH * 2 + 2];
+    int stackSize = 0;
+
+    if (intersectBox(mNodes[0], originSSE, invDirectionSSE, closest) == FLT_MAX) {
+        return false;
+    }
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = mNodes[stack[--stackSize]];
+
+        if (node.count > 0) {
+            // Möller-Trumbore 射线三角形求交
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                const glm::vec3& v0 = mTriangleData[i * 3 + 0];
+                const glm::vec3& e1 = mTriangleData[i * 3 + 1];
+                const glm::vec3& e2 = mTriangleData[i * 3 + 2];
+                glm::vec3 p = glm::cross(direction, e2);
+                float determinant = glm::dot(e1, p);
+                if (std::abs(determinant) < 1e-12f) {
+                    continue;
+                }
+                float invDeterminant = 1.0f / determinant;
+                glm::vec3 s = origin - v0;
+                float u = glm::dot(s, p) * invDeterminant;
+                if (u < 0.0f || u > 1.0f) {
+                    continue;
+                }
+                glm::vec3 q = glm::cross(s, e1);
+                float v = glm::dot(direction, q) * invDeterminant;
+                if (v < 0.0f || u + v > 1.0f) {
+                    continue;
+                }
+                float t = glm::dot(e2, q) * invDeterminant;
+                if (t < 0.0f || t >= closest) {
+                    continue;
+                }
+                closest = t;
+                found = true;
+                hit.triangle = mTriangleIds[i];
+                hit.t = t;
+                hit.u = u;
+                hit.v = v;
+            }
+            continue;
+        }
+
+        // 两个孩子都测试，近的后入栈先访问
+        float tLeft = intersectBox(mNodes[node.first], originSSE, invDirectionSSE, closest);
+        float tRight = intersectBox(mNodes[node.first + 1], originSSE, invDirectionSSE, closest);
+        uint32_t nearChild = node.first;
+        uint32_t farChild = node.first + 1;
+        if (tRight < tLeft) {
+            std::swap(tLeft, tRight);
+            std::swap(nearChild, farChild);
+        }
+        if (tRight != FLT_MAX) {
+            stack[stackSize++] = farChild;
+        }
+        if (tLeft != FLT_MAX) {
+            stack[stackSize++] = nearChild;
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,266 @@
+#include "glDebug.h"
+#include "checkError.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+// 必须在cpp中初始化静态成员
+#ifdef DEBUG
+GLDebug::Mode GLDebug::sMode = GLDebug::Mode::Callback;
+#else
+GLDebug::Mode GLDebug::sMode = GLDebug::Mode::Sampled;
+#endif
+int GLDebug::sSampleInterval = 60;
+bool GLDebug::sCallbackActive = false;
+uint64_t GLDebug::sFrameIndex = 0;
+uint64_t GLDebug::sLastCheckedFrame = 0;
+std::atomic<uint64_t> GLDebug::sErrorCount{ 0 };
+
+std::atomic<const char*> GLDebug::sCallFile{ nullptr };
+std::atomic<int> GLDebug::sCallLine{ 0 };
+std::atomic<const char*> GLDebug::sCallExpression{ nullptr };
+
+const char* GLDebug::sGroups[GLDebug::MAX_GROUP_DEPTH]{};
+std::atomic<int> GLDebug::sGroupDepth{ 0 };
+
+// 回调可能在驱动的线程中调用，去重表需要加锁（只在出消息时访问）
+static std::mutex sMessageMutex;
+static std::unordered_map<uint64_t, uint64_t> sMessageCounts;
+
+static const char* getSourceName(GLenum source) {
+    switch (source) {
+    case GL_DEBUG_SOURCE_API: return "API";
+    case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "WINDOW_SYSTEM";
+    case GL_DEBUG_SOURCE_SHADER_COMPILER: return "SHADER_COMPILER";
+    case GL_DEBUG_SOURCE_THIRD_PARTY: return "THIRD_PARTY";
+    case GL_DEBUG_SOURCE_APPLICATION: return "APPLICATION";
+    default: return "OTHER";
+    }
+}
+
+static const char* getTypeName(GLenum type) {
+    switch (type) {
+    case GL_DEBUG_TYPE_ERROR: return "ERROR";
+    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "DEPRECATED";
+    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "UNDEFINED_BEHAVIOR";
+    case GL_DEBUG_TYPE_PORTABILITY: return "PORTABILITY";
+    case GL_DEBUG_TYPE_PERFORMANCE: return "PERFORMANCE";
+    case GL_DEBUG_TYPE_MARKER: return "MARKER";
+    default: return "OTHER";
+    }
+}
+
+static const char* getSeverityName(GLenum severity) {
+    switch (severity) {
+    case GL_DEBUG_SEVERITY_HIGH: return "HIGH";
+    case GL_DEBUG_SEVERITY_MEDIUM: return "MEDIUM";
+    case GL_DEBUG_SEVERITY_LOW: return "LOW";
+    default: return "NOTIFICATION";
+    }
+}
+
+void GLDebug::configure() {
+    const char* env = std::getenv("ENGINE_GL_DEBUG");
+    if (env != nullptr && env[0] != '\0') {
+        if (std::strcmp(env, "off") == 0) {
+            sMode = Mode::Off;
+        }
+        else if (std::strcmp(env, "callback") == 0) {
+            sMode = Mode::Callback;
+        }
+        else if (std::strcmp(env, "sync") == 0) {
+            sMode = Mode::Synchronous;
+        }
+        else if (std::strncmp(env, "sampled", 7) == 0) {
+            sMode = Mode::Sampled;
+            if (env[7] == ':') {
+                setSampleInterval(std::atoi(env + 8));
+            }
+        }
+        else {
+            std::cerr << "ERROR[GLDebug]: ENGINE_GL_DEBUG 应为 off | callback | sync | sampled[:N]：" << env << std::endl;
+        }
+    }
+
+    // 没有调试上下文时部分驱动不产生消息
+    if (sMode == Mode::Callback || sMode == Mode::Synchronous) {
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
+    }
+}
+
+void GLDebug::init() {
+    sCallbackActive = false;
+    sFrameIndex = 0;
+    sLastCheckedFrame = 0;
+    if (sMode != Mode::Callback && sMode != Mode::Synchronous) {
+        return;
+    }
+    if (!GLAD_GL_VERSION_4_3 || glDebugMessageCallback == nullptr) {
+        std::cerr << "WARNING[GLDebug]: 上下文不支持 KHR_debug，退回到 glGetError 检查" << std::endl;
+        return;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+    if (sMode == Mode::Synchronous) {
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+    else {
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+    glDebugMessageCallback(onMessage, nullptr);
+
+    // 通知级别的消息（缓冲区放在显存中等）与调试组自身的消息不输出
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+    glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PUSH_GROUP, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+    glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_POP_GROUP, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+
+    // 回调安装之前的错误标志
+    while (glGetError() != GL_NO_ERROR) {
+    }
+    sCallbackActive = true;
+}
+
+void GLDebug::shutdown() {
+    if (sCallbackActive) {
+        glDebugMessageCallback(nullptr, nullptr);
+        glDisable(GL_DEBUG_OUTPUT);
+        sCallbackActive = false;
+    }
+    if (sMode == Mode::Sampled) {
+        checkSampled();
+    }
+
+    std::lock_guard<std::mutex> lock(sMessageMutex);
+    for (const auto& entry : sMessageCounts) {
+        if (entry.second > 1) {
+            std::cerr << "GLDebug: 消息 0x" << std::hex << (entry.first & 0xFFFFFFFFu) << std::dec
+                << " 共出现 " << entry.second << " 次" << std::endl;
+        }
+    }
+    sMessageCounts.clear();
+}
+
+void GLDebug::endFrame() {
+    sFrameIndex++;
+    if (sMode == Mode::Sampled && sFrameIndex - sLastCheckedFrame >= static_cast<uint64_t>(sSampleInterval)) {
+        checkSampled();
+    }
+}
+
+void GLDebug::flush() {
+    if (sMode == Mode::Sampled) {
+        checkSampled();
+    }
+}
+
+void GLDebug::afterCall() {
+    // 要求回调但上下文不支持（或还没有 init）：退回原来每次调用后的检查；Sampled 模式留到 endFrame
+    if (!sCallbackActive && (sMode == Mode::Callback || sMode == Mode::Synchronous)) {
+        checkError();
+    }
+}
+
+void GLDebug::setLabel(GLenum identifier, GLuint name, const std::string& label) {
+    if (!sCallbackActive || name == 0) {
+        return;
+    }
+    glObjectLabel(identifier, name, static_cast<GLsizei>(label.size()), label.c_str());
+}
+
+void GLDebug::pushGroup(const char* name) {
+    if (!sCallbackActive) {
+        return;
+    }
+    int depth = sGroupDepth.load(std::memory_order_relaxed);
+    if (depth < MAX_GROUP_DEPTH) {
+        sGroups[depth] = name;
+    }
+    sGroupDepth.store(depth + 1, std::memory_order_release);
+    glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+}
+
+void GLDebug::popGroup() {
+    if (!sCallbackActive) {
+        return;
+    }
+    int depth = sGroupDepth.load(std::memory_order_relaxed);
+    if (depth > 0) {
+        sGroupDepth.store(depth - 1, std::memory_order_release);
+        glPopDebugGroup();
+    }
+}
+
+std::string GLDebug::describeLocation() {
+    std::string location;
+    int depth = std::min(sGroupDepth.load(std::memory_order_acquire), MAX_GROUP_DEPTH);
+    for (int i = 0; i < depth; i++) {
+        location += (i == 0 ? "" : " / ");
+        location += sGroups[i] != nullptr ? sGroups[i] : "?";
+    }
+
+    const char* file = sCallFile.load(std::memory_order_relaxed);
+    if (file != nullptr) {
+        const char* name = std::strrchr(file, '/');
+        const char* backslash = std::strrchr(file, '\\');
+        name = backslash > name ? backslash : name;
+        location += location.empty() ? "" : ", ";
+        location += "最近的 GL_CALL ";
+        location += name != nullptr ? name + 1 : file;
+        location += ":" + std::to_string(sCallLine.load(std::memory_order_relaxed));
+        const char* expression = sCallExpression.load(std::memory_order_relaxed);
+        if (expression != nullptr) {
+            location += " ";
+            location += expression;
+        }
+    }
+    return location.empty() ? "未知" : location;
+}
+
+void APIENTRY GLDebug::onMessage(GLenum source, GLenum type, GLuint id, GLenum severity,
+    GLsizei length, const GLchar* message, const void* /*userParam*/) {
+    // 去重：来源、类型与 ID 相同的消息只输出第一次
+    uint64_t key = (static_cast<uint64_t>(source & 0xFFFF) << 48) | (static_cast<uint64_t>(type & 0xFFFF) << 32) | id;
+    if (type == GL_DEBUG_TYPE_ERROR) {
+        sErrorCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(sMessageMutex);
+        if (++sMessageCounts[key] > 1) {
+            return;
+        }
+        std::cerr << "GLDebug[" << getSeverityName(severity) << "][" << getSourceName(source) << "][" << getTypeName(type)
+            << "] 0x" << std::hex << id << std::dec << ": " << std::string(message, length >= 0 ? length : std::strlen(message))
+            << std::endl;
+        std::cerr << "  位置：" << describeLocation() << (sMode == Mode::Callback ? "（异步，仅供参考）" : "") << std::endl;
+    }
+
+    // 同步模式下回调发生在出错的调用之内，断言停在调用栈上
+    if (sMode == Mode::Synchronous && type == GL_DEBUG_TYPE_ERROR) {
+        assert(false && "OpenGL错误已触发断言");
+    }
+}
+
+void GLDebug::checkSampled() {
+    uint64_t from = sLastCheckedFrame;
+    sLastCheckedFrame = sFrameIndex;
+
+    // 一次 glGetError 只返回一个标志，取到 GL_NO_ERROR 为止
+    int count = 0;
+    GLenum error = GL_NO_ERROR;
+    while ((error = glGetError()) != GL_NO_ERROR && count < 16) {
+        sErrorCount.fetch_add(1, std::memory_order_relaxed);
+        uint64_t key = (static_cast<uint64_t>(0xFFFF) << 48) | error;
+        std::lock_guard<std::mutex> lock(sMessageMutex);
+        if (++sMessageCounts[key] == 1) {
+            std::cerr << "GLDebug[Sampled]: 第 " << from << " ~ " << sFrameIndex << " 帧之间出现 OpenGL 错误 0x"
+                << std::hex << error << std::dec << "，位置：" << describeLocation()
+                << "（用 ENGINE_GL_DEBUG=sync 重新运行可以定位）" << std::endl;
+        }
+        count++;
+    }
+}